@@ -320,6 +320,22 @@ gkfs_define_option(
   EXTRA_INFO "Guided data distributor input file path: ${GKFS_USE_GUIDED_DISTRIBUTION_PATH}"
 )
 
+## Striped distribution
+gkfs_define_option(
+  GKFS_USE_STRIPED_DISTRIBUTION
+  HELP_TEXT "Use striped data distributor"
+  DEFAULT_VALUE OFF
+  DESCRIPTION "Stripe the chunks of a file across a fixed number of daemons instead of all"
+)
+
+## Weighted distribution
+gkfs_define_option(
+  GKFS_USE_WEIGHTED_DISTRIBUTION
+  HELP_TEXT "Use weighted data distributor"
+  DEFAULT_VALUE OFF
+  DESCRIPTION "Spread chunks across daemons in proportion to their weight, e.g., their capacity"
+)
+
 
 ################################################################################
 # Logging and tracing support
@@ -371,3 +387,16 @@ gkfs_define_option(
 )
 
 
+################################################################################
+# Node-local proxy
+################################################################################
+
+## Proxy support
+gkfs_define_option(
+  GKFS_ENABLE_PROXY
+  HELP_TEXT "Build the node-local proxy"
+  DEFAULT_VALUE OFF
+  DESCRIPTION "Build gkfs_proxy which shares daemon connections and a stat cache among all clients of a node"
+)
+
+
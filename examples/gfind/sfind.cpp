@@ -61,6 +61,31 @@ extern "C" int gkfs_getsingleserverdir(const char *path,
                                        unsigned int count, int server)
     __attribute__((weak));
 
+/* Server-side filtered scan, see client/gkfs_functions.hpp */
+struct gkfs_scan_filter {
+  const char *name;
+  int name_regex;
+  uint64_t size_min;
+  uint64_t size_max;
+  int64_t ctime_min;
+  int64_t ctime_max;
+  mode_t type;
+  int recursive;
+};
+
+struct gkfs_scan_stats {
+  uint64_t scanned;
+  uint64_t matched;
+  uint64_t size_sum;
+};
+
+extern "C" int gkfs_scan(const char *path,
+                         const struct gkfs_scan_filter *filter, int server,
+                         int (*fn)(const char *path, mode_t mode, size_t size,
+                                   time_t ctime, void *arg),
+                         void *arg, struct gkfs_scan_stats *stats)
+    __attribute__((weak));
+
 /* PFIND OPTIONS EXTENDED We need to add the GekkoFS mount dir and the number of
  * servers */
 typedef struct {
@@ -348,6 +373,42 @@ void dirProcess(const string path, unsigned long long &checked,
   }
 }
 
+/* Server-side processing of the whole tree.
+ * Each server filters its local entries and only returns the number of matches
+ * and scanned entries. Returns false if a server does not support scans.
+ */
+bool scanProcess(unsigned long long &checked, unsigned long long &found,
+                 pfind_options_t *opt) {
+  struct gkfs_scan_filter filter = {};
+  filter.name = opt->name_pattern;
+  filter.name_regex = 1;
+  filter.size_min = 0;
+  filter.size_max = std::numeric_limits<uint64_t>::max();
+  if (opt->size != std::numeric_limits<uint64_t>::max()) {
+    filter.size_min = opt->size;
+    filter.size_max = opt->size;
+  }
+  filter.ctime_min = std::numeric_limits<int64_t>::min();
+  if (opt->timestamp_file)
+    filter.ctime_min = runtime.ctime_min;
+  filter.ctime_max = std::numeric_limits<int64_t>::max();
+  filter.type = S_IFREG;
+  filter.recursive = 1;
+
+  unsigned long long scanned = 0;
+  unsigned long long matched = 0;
+  for (auto server = 0; server < opt->num_servers; server++) {
+    struct gkfs_scan_stats stats = {};
+    if (gkfs_scan(opt->workdir, &filter, server, nullptr, nullptr, &stats))
+      return false;
+    scanned += stats.scanned;
+    matched += stats.matched;
+  }
+  checked += scanned;
+  found += matched;
+  return true;
+}
+
 int process(pfind_options_t *opt) {
   // Print off a hello world message
   unsigned long long found,checked;
@@ -369,6 +430,11 @@ int process(pfind_options_t *opt) {
     }
   }
 
+  if (gkfs_scan && scanProcess(checked, found, opt)) {
+    cout << "MATCHED " << found << "/" << checked << endl;
+    return 0;
+  }
+
   queue<string> dirs;
   string workdir = opt->workdir;
   workdir = workdir.substr(strlen(opt->mountdir), workdir.size());
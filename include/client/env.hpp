@@ -46,8 +46,15 @@ static constexpr auto LOG_SYSCALL_FILTER = ADD_PREFIX("LOG_SYSCALL_FILTER");
 
 static constexpr auto LOG_OUTPUT = ADD_PREFIX("LOG_OUTPUT");
 static constexpr auto LOG_OUTPUT_TRUNC = ADD_PREFIX("LOG_OUTPUT_TRUNC");
+static constexpr auto LOG_ASYNC = ADD_PREFIX("LOG_ASYNC");
 static constexpr auto CWD = ADD_PREFIX("CWD");
 static constexpr auto HOSTS_FILE = ADD_PREFIX("HOSTS_FILE");
+static constexpr auto PREFETCH_HOSTS = ADD_PREFIX("PREFETCH_HOSTS");
+static constexpr auto TRACE_OUTPUT = ADD_PREFIX("TRACE_OUTPUT");
+#ifndef GKFS_ENABLE_FORWARDING
+static constexpr auto PROXY_PID_FILE = ADD_PREFIX("PROXY_PID_FILE");
+static constexpr auto DATA_LOCALITY = ADD_PREFIX("DATA_LOCALITY");
+#endif
 #ifdef GKFS_ENABLE_FORWARDING
 static constexpr auto FORWARDING_MAP_FILE = ADD_PREFIX("FORWARDING_MAP_FILE");
 #endif
@@ -44,7 +44,8 @@ int
 gkfs_open(const std::string& path, mode_t mode, int flags);
 
 int
-gkfs_create(const std::string& path, mode_t mode);
+gkfs_create(const std::string& path, mode_t mode,
+            size_t* chunk_size = nullptr, int64_t* data_host = nullptr);
 
 int
 gkfs_remove(const std::string& path);
@@ -86,7 +87,8 @@ int
 gkfs_truncate(const std::string& path, off_t offset);
 
 int
-gkfs_truncate(const std::string& path, off_t old_size, off_t new_size);
+gkfs_truncate(const std::string& path, off_t old_size, off_t new_size,
+              size_t chunk_size, int64_t data_host);
 
 int
 gkfs_dup(int oldfd);
@@ -106,7 +108,7 @@ gkfs_readlink(const std::string& path, char* buf, int bufsize);
 
 ssize_t
 gkfs_pwrite(std::shared_ptr<gkfs::filemap::OpenFile> file, const char* buf,
-            size_t count, off64_t offset);
+            size_t count, off64_t offset, bool update_pos = false);
 
 ssize_t
 gkfs_pwrite_ws(int fd, const void* buf, size_t count, off64_t offset);
@@ -115,7 +117,8 @@ ssize_t
 gkfs_write(int fd, const void* buf, size_t count);
 
 ssize_t
-gkfs_pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset);
+gkfs_pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset,
+             bool update_pos = false);
 
 ssize_t
 gkfs_writev(int fd, const struct iovec* iov, int iovcnt);
@@ -136,6 +139,38 @@ gkfs_readv(int fd, const struct iovec* iov, int iovcnt);
 ssize_t
 gkfs_preadv(int fd, const struct iovec* iov, int iovcnt, off_t offset);
 
+void*
+gkfs_mmap(void* addr, size_t length, int prot, int flags, int fd,
+          off_t offset);
+
+int
+gkfs_msync(void* addr, size_t length, int flags);
+
+int
+gkfs_mprotect(void* addr, size_t length, int prot);
+
+int
+gkfs_munmap(void* addr, size_t length);
+
+void
+gkfs_mmap_replace(void* addr, size_t length);
+
+bool
+gkfs_is_mapped(void* addr, size_t length);
+
+ssize_t
+gkfs_copy_file_range(int fd_in, off64_t* off_in, int fd_out, off64_t* off_out,
+                     size_t len, unsigned int flags);
+
+ssize_t
+gkfs_sendfile(int out_fd, int in_fd, off64_t* offset, size_t count);
+
+int
+gkfs_fallocate(int fd, int mode, off_t offset, off_t len);
+
+int
+gkfs_fsync(int fd);
+
 int
 gkfs_opendir(const std::string& path);
 
@@ -159,4 +194,58 @@ gkfs_rename(const std::string& old_path, const std::string& new_path);
 extern "C" int
 gkfs_getsingleserverdir(const char* path, struct dirent_extended* dirp,
                         unsigned int count, int server);
+
+// Predicate of gkfs_scan(). Ranges are inclusive, a NULL name and a zero type
+// match all entries.
+struct gkfs_scan_filter {
+    const char* name; // glob or POSIX extended regex on an entry's name
+    int name_regex;   // if non-zero, name is a regex instead of a glob
+    uint64_t size_min;
+    uint64_t size_max;
+    int64_t ctime_min;
+    int64_t ctime_max;
+    mode_t type;   // file type, e.g., S_IFREG, or 0 for any
+    int recursive; // if non-zero, the whole subtree is scanned
+};
+
+// Aggregates of gkfs_scan()
+struct gkfs_scan_stats {
+    uint64_t scanned;  // number of entries scanned
+    uint64_t matched;  // number of entries matching the filter
+    uint64_t size_sum; // total size of matching entries
+};
+
+typedef int (*gkfs_scan_cb)(const char* path, mode_t mode, size_t size,
+                            time_t ctime, void* arg);
+
+// Server-side filtered namespace scan, exported for C usage
+extern "C" int
+gkfs_scan(const char* path, const struct gkfs_scan_filter* filter, int server,
+          gkfs_scan_cb fn, void* arg, struct gkfs_scan_stats* stats);
+
+// Recursive removal of a directory tree, exported for C usage
+extern "C" int
+gkfs_remove_tree(const char* path);
+
+// Per-file chunk size (layout), exported for C usage
+extern "C" int
+gkfs_set_chunk_size(const char* path, size_t chunk_size);
+
+extern "C" ssize_t
+gkfs_get_chunk_size(const char* path);
+
+// List I/O for non-contiguous file and memory segments, exported for C usage
+extern "C" ssize_t
+gkfs_write_list(int fd, int mem_count, const struct iovec* mem_list,
+                int file_count, const off64_t* file_offsets,
+                const size_t* file_lengths);
+
+extern "C" ssize_t
+gkfs_read_list(int fd, int mem_count, const struct iovec* mem_list,
+               int file_count, const off64_t* file_offsets,
+               const size_t* file_lengths);
+
+// On-demand dump of the client's trace spans, exported for C usage
+extern "C" int
+gkfs_trace_dump(const char* path);
 #endif // GEKKOFS_GKFS_FUNCTIONS_HPP
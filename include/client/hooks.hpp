@@ -199,6 +199,29 @@ hook_fsync(unsigned int fd);
 int
 hook_getxattr(const char* path, const char* name, void* value, size_t size);
 
+long
+hook_mmap(void* addr, size_t length, int prot, int flags, int fd,
+          off_t offset);
+
+int
+hook_mprotect(void* addr, size_t length, int prot);
+
+int
+hook_munmap(void* addr, size_t length);
+
+int
+hook_msync(void* addr, size_t length, int flags);
+
+long
+hook_copy_file_range(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                     size_t len, unsigned int flags);
+
+long
+hook_sendfile(int out_fd, int in_fd, loff_t* offset, size_t count);
+
+int
+hook_fallocate(int fd, int mode, off_t offset, off_t len);
+
 } // namespace gkfs::hook
 
 #endif
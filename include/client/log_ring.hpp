@@ -0,0 +1,207 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS' POSIX interface.
+
+  GekkoFS' POSIX interface is free software: you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public License as
+  published by the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  GekkoFS' POSIX interface is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with GekkoFS' POSIX interface.  If not, see
+  <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: LGPL-3.0-or-later
+*/
+
+#ifndef LIBGKFS_LOG_RING_HPP
+#define LIBGKFS_LOG_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include <sys/uio.h>
+
+namespace gkfs::log::detail {
+
+/**
+ * @brief Lock-free multi-producer, single-consumer ring buffer of log
+ * messages.
+ * @internal
+ * A producer reserves space for its record by advancing the head with a CAS,
+ * copies its message, and publishes the record by setting the state in the
+ * record's header. A record that does not fit before the end of the buffer is
+ * preceded by a padding record up to the end. If there is not enough free
+ * space, the message is dropped and counted instead of blocking the producer.
+ *
+ * The consumer collects published records in order and stops at the first
+ * record still being written. Consumed space is zeroed before it is released
+ * to the producers, so that the header of an unpublished record always reads
+ * as empty.
+ * @endinternal
+ */
+class log_ring {
+private:
+    struct header {
+        uint32_t state; //!< One of record_state, accessed atomically
+        uint32_t size;  //!< Message size without header and alignment
+    };
+
+    enum record_state : uint32_t { empty = 0, record = 1, padding = 2 };
+
+    std::unique_ptr<char[]> buf_;
+    const uint64_t capacity_;
+    const uint64_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0}; //!< Next byte to reserve
+    alignas(64) std::atomic<uint64_t> tail_{0}; //!< Next byte to consume
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+
+    static constexpr uint64_t
+    record_size(uint64_t size) {
+        // records are aligned to their header
+        return sizeof(header) +
+               ((size + sizeof(header) - 1) & ~(sizeof(header) - 1));
+    }
+
+    header*
+    header_at(uint64_t pos) const {
+        return reinterpret_cast<header*>(buf_.get() + (pos & mask_));
+    }
+
+    void
+    publish(uint64_t pos, record_state state, uint64_t size) {
+        auto* hdr = header_at(pos);
+        hdr->size = static_cast<uint32_t>(size);
+        std::atomic_ref<uint32_t>(hdr->state)
+                .store(state, std::memory_order_release);
+    }
+
+public:
+    /**
+     * @param capacity Size of the buffer in bytes, must be a power of two
+     */
+    explicit log_ring(uint64_t capacity)
+        : buf_(new char[capacity]()), capacity_(capacity),
+          mask_(capacity - 1) {
+        assert(capacity >= sizeof(header) && (capacity & mask_) == 0);
+    }
+
+    log_ring(const log_ring&) = delete;
+
+    log_ring&
+    operator=(const log_ring&) = delete;
+
+    /**
+     * @brief Appends a message. Never blocks.
+     * @param data Message
+     * @param size Message size
+     * @return false if the message was dropped because the buffer is full
+     */
+    bool
+    push(const char* data, size_t size) noexcept {
+        const auto need = record_size(size);
+        auto pos = head_.load(std::memory_order_relaxed);
+        uint64_t pad;
+        do {
+            auto tail = tail_.load(std::memory_order_acquire);
+            auto off = pos & mask_;
+            pad = off + need > capacity_ ? capacity_ - off : 0;
+            // a stale pos behind the tail fails the CAS below
+            if(pos + pad + need > tail + capacity_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while(!head_.compare_exchange_weak(pos, pos + pad + need,
+                                             std::memory_order_relaxed));
+        if(pad != 0)
+            publish(pos, padding, pad - sizeof(header));
+        pos += pad;
+        std::memcpy(buf_.get() + (pos & mask_) + sizeof(header), data, size);
+        publish(pos, record, size);
+        return true;
+    }
+
+    /**
+     * @brief Hands published messages in order to a writer and releases them.
+     * Must only be called by one thread at a time.
+     * @param iov Array of at least max entries to collect the messages in
+     * @param max Maximum number of messages to collect
+     * @param write Called with (iov, count) if any message was collected
+     * @return Number of messages handed to the writer
+     */
+    template <typename Writer>
+    size_t
+    drain(struct iovec* iov, size_t max, Writer&& write) {
+        const auto start = tail_.load(std::memory_order_relaxed);
+        const auto head = head_.load(std::memory_order_acquire);
+        auto pos = start;
+        size_t n = 0;
+        while(n < max && pos != head) {
+            auto* hdr = header_at(pos);
+            auto state = std::atomic_ref<uint32_t>(hdr->state)
+                                 .load(std::memory_order_acquire);
+            if(state == empty)
+                break;
+            if(state == record)
+                iov[n++] = {reinterpret_cast<char*>(hdr) + sizeof(header),
+                            hdr->size};
+            pos += record_size(hdr->size);
+        }
+        if(pos == start)
+            return 0;
+        if(n != 0)
+            write(iov, n);
+        // zero the consumed space, which may wrap around the end
+        auto off = start & mask_;
+        auto len = pos - start;
+        auto first = std::min(len, capacity_ - off);
+        std::memset(buf_.get() + off, 0, first);
+        std::memset(buf_.get(), 0, len - first);
+        tail_.store(pos, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Number of bytes reserved and not yet consumed.
+     */
+    uint64_t
+    used() const noexcept {
+        // the tail is loaded first as it never passes the head
+        auto tail = tail_.load(std::memory_order_acquire);
+        return head_.load(std::memory_order_relaxed) - tail;
+    }
+
+    uint64_t
+    capacity() const noexcept {
+        return capacity_;
+    }
+
+    /**
+     * @brief Number of messages dropped so far because the buffer was full.
+     */
+    uint64_t
+    dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace gkfs::log::detail
+
+#endif // LIBGKFS_LOG_RING_HPP
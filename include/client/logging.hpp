@@ -36,6 +36,7 @@
 #include <client/make_array.hpp>
 #include <client/syscalls.hpp>
 #include <optional>
+#include <memory>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 #include <date/tz.h>
@@ -149,6 +150,8 @@ struct logger;
 
 namespace detail {
 
+class async_writer;
+
 template <typename Buffer>
 static inline void
 log_buffer(std::FILE* fp, Buffer&& buffer) {
@@ -273,7 +276,8 @@ protected:
 
 struct logger {
 
-    logger(const std::string& opts, const std::string& path, bool trunc
+    logger(const std::string& opts, const std::string& path, bool trunc,
+           bool async
 #ifdef GKFS_DEBUG_BUILD
            ,
            const std::string& filter, int verbosity
@@ -282,6 +286,20 @@ struct logger {
 
     ~logger();
 
+    /**
+     * Write a formatted message to the log, either directly or, in
+     * asynchronous mode, through the background writer thread.
+     */
+    void
+    write(const char* data, std::size_t size);
+
+    /**
+     * Stop asynchronous logging, writing all buffered messages. Subsequent
+     * messages are written directly.
+     */
+    void
+    stop_async();
+
     template <typename... Args>
     inline void
     log(log_level level, const char* const func, const int lineno,
@@ -302,7 +320,7 @@ struct logger {
 
         fmt::format_to(buffer, std::forward<Args>(args)...);
         fmt::format_to(buffer, "\n");
-        detail::log_buffer(log_fd_, buffer);
+        write(buffer.data(), buffer.size());
     }
 
     inline int
@@ -319,17 +337,21 @@ struct logger {
             std::size_t size;
         };
 
-        // helper lambda to print an iterable of buffer_views
+        // helper lambda to print an iterable of buffer_views as one line
         const auto log_buffer_views = [this](const auto& buffers) {
+            // prefix and message are each at most max_buffer_size long
+            std::array<char, 2 * max_buffer_size + 1> line;
             std::size_t n = 0;
 
             for(const auto& bv : buffers) {
                 if(bv.addr != nullptr) {
-                    detail::log_buffer(log_fd_, bv.addr, bv.size);
-                    n += bv.size;
+                    const auto len = std::min(bv.size, line.size() - n);
+                    std::memcpy(line.data() + n, bv.addr, len);
+                    n += len;
                 }
             }
 
+            write(line.data(), n);
             return n;
         };
 
@@ -403,6 +425,7 @@ struct logger {
 
     int log_fd_;
     log_level log_mask_;
+    std::shared_ptr<detail::async_writer> async_writer_;
 
 #ifdef GKFS_DEBUG_BUILD
     std::bitset<512> filtered_syscalls_;
@@ -35,6 +35,7 @@
 #include <memory>
 #include <atomic>
 #include <array>
+#include <config.hpp>
 
 namespace gkfs::filemap {
 
@@ -50,6 +51,7 @@ enum class OpenFile_flags {
     wronly,
     rdwr,
     cloexec,
+    appended, // an append was written and its size may not be persisted yet
     flag_count // this is purely used as a size variable of this enum class
 };
 
@@ -62,6 +64,9 @@ protected:
     std::array<bool, static_cast<int>(OpenFile_flags::flag_count)> flags_ = {
             {false}};
     unsigned long pos_;
+    size_t chunk_size_{gkfs::config::rpc::chunksize};
+    // daemon storing all chunks of the file, -1 if placed by the distributor
+    int64_t data_host_{-1};
     std::mutex pos_mutex_;
     std::mutex flag_mutex_;
 
@@ -95,6 +100,18 @@ public:
 
     FileType
     type() const;
+
+    size_t
+    chunk_size() const;
+
+    void
+    chunk_size(size_t chunk_size);
+
+    int64_t
+    data_host() const;
+
+    void
+    data_host(int64_t data_host);
 };
 
 
@@ -104,9 +121,26 @@ private:
     std::map<int, std::shared_ptr<OpenFile>> files_;
     std::recursive_mutex files_mutex_;
 
+    /*
+     * exist() is called for every fd based syscall of the application,
+     * including those on sockets, pipes, and stdout. To answer it without
+     * taking files_mutex_, bit fd of fd_bitmap_ is set while an fd below
+     * fd_bitmap_size is in files_. files_ is only searched for higher fds if
+     * there are any. Both are updated under files_mutex_ with files_.
+     */
+    static constexpr int fd_bitmap_size = 65536;
+    std::array<std::atomic<uint64_t>, fd_bitmap_size / 64> fd_bitmap_{};
+    std::atomic<size_t> high_fds_{0};
+
     int
     safe_generate_fd_idx_();
 
+    void
+    insert_(int fd, std::shared_ptr<OpenFile> open_file);
+
+    void
+    erase_(int fd);
+
     /*
      * TODO: Setting our file descriptor index to a specific value is dangerous
      * because we might clash with the kernel. E.g., if we would passthrough and
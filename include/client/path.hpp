@@ -40,6 +40,9 @@ bool
 resolve(const std::string& path, std::string& resolved,
         bool resolve_last_link = true);
 
+void
+invalidate_resolve_cache();
+
 std::string
 get_sys_cwd();
 
@@ -38,7 +38,12 @@
 #include <string>
 #include <config.hpp>
 
+#include <atomic>
 #include <bitset>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 /* Forward declarations */
 namespace gkfs {
@@ -72,6 +77,53 @@ struct FsConfig {
 
 enum class RelativizeStatus { internal, external, fd_unknown, fd_not_a_dir };
 
+/**
+ * Daemon endpoints indexed by host id. An endpoint is looked up on first use
+ * and cached afterwards so that client start-up does not depend on the number
+ * of daemons. Lookups of all endpoints can optionally be prefetched by a
+ * background thread.
+ */
+class HostEndpoints {
+public:
+    using lookup_fn = std::function<hermes::endpoint(const std::string&)>;
+
+private:
+    std::vector<std::string> uris_;
+    lookup_fn lookup_;
+    mutable std::vector<std::optional<hermes::endpoint>> endpoints_;
+    mutable std::mutex endpoints_mutex_;
+    std::unique_ptr<std::thread> prefetch_thread_;
+    std::atomic<bool> stop_prefetch_{false};
+
+    static void
+    register_atfork();
+
+public:
+    HostEndpoints() = default;
+
+    ~HostEndpoints();
+
+    HostEndpoints(const HostEndpoints&) = delete;
+
+    HostEndpoints&
+    operator=(const HostEndpoints&) = delete;
+
+    void
+    assign(std::vector<std::string> uris, lookup_fn lookup);
+
+    void
+    prefetch(std::vector<uint64_t> host_ids);
+
+    void
+    clear();
+
+    hermes::endpoint
+    at(uint64_t host_id) const;
+
+    std::size_t
+    size() const;
+};
+
 /**
  * Singleton class of the client context with all relevant global data
  */
@@ -91,11 +143,17 @@ private:
     std::vector<std::string> mountdir_components_;
     std::string mountdir_;
 
-    std::vector<hermes::endpoint> hosts_;
+    HostEndpoints hosts_;
+    // optional per-daemon weights from the hosts file, indexed by host id
+    std::vector<double> host_weights_;
     uint64_t local_host_id_;
     uint64_t fwd_host_id_;
     std::string rpc_protocol_;
     bool auto_sm_{false};
+    // node-local proxy which serves metadata and data requests if used
+    std::optional<hermes::endpoint> proxy_host_;
+    // new files store their chunks on the daemon of this node if possible
+    bool data_locality_{false};
 
     bool interception_enabled_;
 
@@ -135,15 +193,21 @@ public:
     const std::string&
     cwd() const;
 
-    const std::vector<hermes::endpoint>&
+    const HostEndpoints&
     hosts() const;
 
-    void
-    hosts(const std::vector<hermes::endpoint>& addrs);
+    HostEndpoints&
+    hosts();
 
     void
     clear_hosts();
 
+    const std::vector<double>&
+    host_weights() const;
+
+    void
+    host_weights(const std::vector<double>& host_weights);
+
     uint64_t
     local_host_id() const;
 
@@ -168,6 +232,21 @@ public:
     void
     auto_sm(bool auto_sm);
 
+    bool
+    use_proxy() const;
+
+    const hermes::endpoint&
+    proxy_host() const;
+
+    void
+    proxy_host(const hermes::endpoint& host);
+
+    bool
+    data_locality() const;
+
+    void
+    data_locality(bool data_locality);
+
     RelativizeStatus
     relativize_fd_path(int dirfd, const char* raw_path,
                        std::string& relative_path, int flags = 0,
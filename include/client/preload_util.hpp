@@ -89,6 +89,17 @@ read_hosts_file();
 void
 connect_to_hosts(const std::vector<std::pair<std::string, std::string>>& hosts);
 
+#ifndef GKFS_ENABLE_FORWARDING
+std::string
+read_proxy_pid_file();
+
+void
+connect_to_proxy(const std::string& uri);
+
+int64_t
+data_host_for_create();
+#endif
+
 } // namespace gkfs::utils
 
 #endif // GEKKOFS_PRELOAD_UTIL_HPP
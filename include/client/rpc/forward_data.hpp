@@ -30,6 +30,8 @@
 #ifndef GEKKOFS_CLIENT_FORWARD_DATA_HPP
 #define GEKKOFS_CLIENT_FORWARD_DATA_HPP
 
+struct iovec;
+
 namespace gkfs::rpc {
 
 struct ChunkStat {
@@ -44,18 +46,56 @@ struct ChunkStat {
 std::pair<int, ssize_t>
 forward_write(const std::string& path, const void* buf, bool append_flag,
               off64_t in_offset, size_t write_size,
-              int64_t updated_metadentry_size);
+              int64_t updated_metadentry_size, size_t chunk_size,
+              int64_t data_host);
+
+std::pair<int, ssize_t>
+forward_writev(const std::string& path, const struct iovec* iov, int iovcnt,
+               bool append_flag, off64_t in_offset, size_t write_size,
+               int64_t updated_metadentry_size, size_t chunk_size,
+               int64_t data_host);
 
 std::pair<int, ssize_t>
 forward_read(const std::string& path, void* buf, off64_t offset,
-             size_t read_size);
+             size_t read_size, size_t chunk_size, int64_t data_host);
+
+std::pair<int, ssize_t>
+forward_readv(const std::string& path, const struct iovec* iov, int iovcnt,
+              off64_t offset, size_t read_size, size_t chunk_size,
+              int64_t data_host);
+
+std::pair<int, ssize_t>
+forward_write_list(const std::string& path, const struct iovec* mem_list,
+                   int mem_count, int file_count, const off64_t* file_offsets,
+                   const size_t* file_lengths, size_t chunk_size,
+                   int64_t data_host);
+
+std::pair<int, ssize_t>
+forward_read_list(const std::string& path, const struct iovec* mem_list,
+                  int mem_count, int file_count, const off64_t* file_offsets,
+                  const size_t* file_lengths, size_t chunk_size,
+                  int64_t data_host);
 
 int
-forward_truncate(const std::string& path, size_t current_size, size_t new_size);
+forward_truncate(const std::string& path, size_t current_size, size_t new_size,
+                 size_t chunk_size, int64_t data_host);
 
 std::pair<int, ChunkStat>
 forward_get_chunk_stat();
 
+std::pair<int, ChunkStat>
+forward_get_chunk_stat(uint64_t host);
+
+std::pair<int, ssize_t>
+forward_copy_data(const std::string& src_path, off64_t src_offset,
+                  const std::string& dst_path, off64_t dst_offset,
+                  size_t count, size_t src_chunk_size, size_t dst_chunk_size,
+                  int64_t src_data_host, int64_t dst_data_host);
+
+int
+forward_fallocate(const std::string& path, off64_t offset, size_t length,
+                  size_t chunk_size, int64_t data_host);
+
 } // namespace gkfs::rpc
 
 #endif // GEKKOFS_CLIENT_FORWARD_DATA_HPP
@@ -34,6 +34,9 @@
 #include <memory>
 #include <vector>
 /* Forward declaration */
+struct gkfs_scan_filter;
+struct gkfs_scan_stats;
+
 namespace gkfs {
 namespace filemap {
 class OpenDir;
@@ -50,11 +53,15 @@ class Metadata;
 namespace rpc {
 
 int
-forward_create(const std::string& path, mode_t mode);
+forward_create(const std::string& path, mode_t mode, size_t chunk_size,
+               int64_t data_host);
 
 int
 forward_stat(const std::string& path, std::string& attr);
 
+int
+forward_set_chunk_size(const std::string& path, size_t chunk_size);
+
 #ifdef HAS_RENAME
 int
 forward_rename(const std::string& oldpath, const std::string& newpath,
@@ -64,6 +71,9 @@ forward_rename(const std::string& oldpath, const std::string& newpath,
 int
 forward_remove(const std::string& path);
 
+int
+forward_remove_subtree(const std::string& path);
+
 int
 forward_decr_size(const std::string& path, size_t length);
 
@@ -85,6 +95,13 @@ forward_get_dirents(const std::string& path);
 std::pair<int, std::vector<std::tuple<const std::string, bool, size_t, time_t>>>
 forward_get_dirents_single(const std::string& path, int server);
 
+int
+forward_scan(
+        const std::string& path, const gkfs_scan_filter& filter, int server,
+        bool aggregate, gkfs_scan_stats& stats,
+        std::vector<std::tuple<const std::string, mode_t, size_t, time_t>>&
+                entries);
+
 #ifdef HAS_SYMLINKS
 
 int
@@ -285,8 +285,10 @@ struct create {
         hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path, uint32_t mode)
-            : m_path(path), m_mode(mode) {}
+        input(const std::string& path, uint32_t mode, uint64_t chunk_size,
+              int64_t data_host)
+            : m_path(path), m_mode(mode), m_chunk_size(chunk_size),
+              m_data_host(data_host) {}
 
         input(input&& rhs) = default;
 
@@ -308,16 +310,29 @@ struct create {
             return m_mode;
         }
 
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
         explicit input(const rpc_mk_node_in_t& other)
-            : m_path(other.path), m_mode(other.mode) {}
+            : m_path(other.path), m_mode(other.mode),
+              m_chunk_size(other.chunk_size), m_data_host(other.data_host) {}
 
         explicit operator rpc_mk_node_in_t() {
-            return {m_path.c_str(), m_mode};
+            return {m_path.c_str(), m_mode, m_chunk_size, m_data_host};
         }
 
     private:
         std::string m_path;
         uint32_t m_mode;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
     };
 
     class output {
@@ -554,10 +569,13 @@ struct remove_metadata {
         hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        output() : m_err(), m_size(), m_mode() {}
+        output()
+            : m_err(), m_size(), m_mode(), m_chunk_size(), m_data_host() {}
 
-        output(int32_t err, int64_t size, uint32_t mode)
-            : m_err(err), m_size(size), m_mode(mode) {}
+        output(int32_t err, int64_t size, uint32_t mode, uint64_t chunk_size,
+               int64_t data_host)
+            : m_err(err), m_size(size), m_mode(mode), m_chunk_size(chunk_size),
+              m_data_host(data_host) {}
 
         output(output&& rhs) = default;
 
@@ -573,6 +591,8 @@ struct remove_metadata {
             m_err = out.err;
             m_size = out.size;
             m_mode = out.mode;
+            m_chunk_size = out.chunk_size;
+            m_data_host = out.data_host;
         }
 
         int32_t
@@ -590,11 +610,23 @@ struct remove_metadata {
             return m_mode;
         };
 
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
 
     private:
         int32_t m_err;
         int64_t m_size;
         uint32_t m_mode;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
     };
 };
 
@@ -1103,8 +1135,9 @@ struct update_metadentry_size {
 
     public:
         input(const std::string& path, uint64_t size, int64_t offset,
-              bool append)
-            : m_path(path), m_size(size), m_offset(offset), m_append(append) {}
+              bool append, uint64_t trace_id)
+            : m_path(path), m_size(size), m_offset(offset), m_append(append),
+              m_trace_id(trace_id) {}
 
         input(input&& rhs) = default;
 
@@ -1136,12 +1169,17 @@ struct update_metadentry_size {
             return m_append;
         }
 
+        uint64_t
+        trace_id() const {
+            return m_trace_id;
+        }
+
         explicit input(const rpc_update_metadentry_size_in_t& other)
             : m_path(other.path), m_size(other.size), m_offset(other.offset),
-              m_append(other.append) {}
+              m_append(other.append), m_trace_id(other.trace_id) {}
 
         explicit operator rpc_update_metadentry_size_in_t() {
-            return {m_path.c_str(), m_size, m_offset, m_append};
+            return {m_path.c_str(), m_size, m_offset, m_append, m_trace_id};
         }
 
     private:
@@ -1149,6 +1187,7 @@ struct update_metadentry_size {
         uint64_t m_size;
         int64_t m_offset;
         bool m_append;
+        uint64_t m_trace_id;
     };
 
     class output {
@@ -1471,11 +1510,14 @@ struct write_data {
         input(const std::string& path, int64_t offset, uint64_t host_id,
               uint64_t host_size, uint64_t chunk_n, uint64_t chunk_start,
               uint64_t chunk_end, uint64_t total_chunk_size,
+              uint64_t chunk_size, int64_t data_host, uint64_t trace_id,
               const hermes::exposed_memory& buffers)
             : m_path(path), m_offset(offset), m_host_id(host_id),
               m_host_size(host_size), m_chunk_n(chunk_n),
               m_chunk_start(chunk_start), m_chunk_end(chunk_end),
-              m_total_chunk_size(total_chunk_size), m_buffers(buffers) {}
+              m_total_chunk_size(total_chunk_size), m_chunk_size(chunk_size),
+              m_data_host(data_host), m_trace_id(trace_id),
+              m_buffers(buffers) {}
 
         input(input&& rhs) = default;
 
@@ -1527,6 +1569,21 @@ struct write_data {
             return m_total_chunk_size;
         }
 
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
+        uint64_t
+        trace_id() const {
+            return m_trace_id;
+        }
+
         hermes::exposed_memory
         buffers() const {
             return m_buffers;
@@ -1538,12 +1595,14 @@ struct write_data {
               m_chunk_n(other.chunk_n), m_chunk_start(other.chunk_start),
               m_chunk_end(other.chunk_end),
               m_total_chunk_size(other.total_chunk_size),
-              m_buffers(other.bulk_handle) {}
+              m_chunk_size(other.chunk_size), m_data_host(other.data_host),
+              m_trace_id(other.trace_id), m_buffers(other.bulk_handle) {}
 
         explicit operator rpc_write_data_in_t() {
-            return {m_path.c_str(), m_offset,           m_host_id,
-                    m_host_size,    m_chunk_n,          m_chunk_start,
-                    m_chunk_end,    m_total_chunk_size, hg_bulk_t(m_buffers)};
+            return {m_path.c_str(), m_offset, m_host_id, m_host_size, m_chunk_n,
+                    m_chunk_start, m_chunk_end, m_total_chunk_size,
+                    m_chunk_size, m_data_host, m_trace_id,
+                    hg_bulk_t(m_buffers)};
         }
 
     private:
@@ -1555,6 +1614,9 @@ struct write_data {
         uint64_t m_chunk_start;
         uint64_t m_chunk_end;
         uint64_t m_total_chunk_size;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
+        uint64_t m_trace_id;
         hermes::exposed_memory m_buffers;
     };
 
@@ -1649,11 +1711,14 @@ struct read_data {
         input(const std::string& path, int64_t offset, uint64_t host_id,
               uint64_t host_size, uint64_t chunk_n, uint64_t chunk_start,
               uint64_t chunk_end, uint64_t total_chunk_size,
+              uint64_t chunk_size, int64_t data_host, uint64_t trace_id,
               const hermes::exposed_memory& buffers)
             : m_path(path), m_offset(offset), m_host_id(host_id),
               m_host_size(host_size), m_chunk_n(chunk_n),
               m_chunk_start(chunk_start), m_chunk_end(chunk_end),
-              m_total_chunk_size(total_chunk_size), m_buffers(buffers) {}
+              m_total_chunk_size(total_chunk_size), m_chunk_size(chunk_size),
+              m_data_host(data_host), m_trace_id(trace_id),
+              m_buffers(buffers) {}
 
         input(input&& rhs) = default;
 
@@ -1705,6 +1770,21 @@ struct read_data {
             return m_total_chunk_size;
         }
 
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
+        uint64_t
+        trace_id() const {
+            return m_trace_id;
+        }
+
         hermes::exposed_memory
         buffers() const {
             return m_buffers;
@@ -1716,12 +1796,14 @@ struct read_data {
               m_chunk_n(other.chunk_n), m_chunk_start(other.chunk_start),
               m_chunk_end(other.chunk_end),
               m_total_chunk_size(other.total_chunk_size),
-              m_buffers(other.bulk_handle) {}
+              m_chunk_size(other.chunk_size), m_data_host(other.data_host),
+              m_trace_id(other.trace_id), m_buffers(other.bulk_handle) {}
 
         explicit operator rpc_read_data_in_t() {
-            return {m_path.c_str(), m_offset,           m_host_id,
-                    m_host_size,    m_chunk_n,          m_chunk_start,
-                    m_chunk_end,    m_total_chunk_size, hg_bulk_t(m_buffers)};
+            return {m_path.c_str(), m_offset, m_host_id, m_host_size, m_chunk_n,
+                    m_chunk_start, m_chunk_end, m_total_chunk_size,
+                    m_chunk_size, m_data_host, m_trace_id,
+                    hg_bulk_t(m_buffers)};
         }
 
     private:
@@ -1733,6 +1815,9 @@ struct read_data {
         uint64_t m_chunk_start;
         uint64_t m_chunk_end;
         uint64_t m_total_chunk_size;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
+        uint64_t m_trace_id;
         hermes::exposed_memory m_buffers;
     };
 
@@ -1792,7 +1877,7 @@ struct trunc_data {
     using handle_type = hermes::rpc_handle<self_type>;
     using input_type = input;
     using output_type = output;
-    using mercury_input_type = rpc_trunc_in_t;
+    using mercury_input_type = rpc_trunc_data_in_t;
     using mercury_output_type = rpc_err_out_t;
 
     // RPC public identifier
@@ -1811,7 +1896,7 @@ struct trunc_data {
 
     // Mercury callback to serialize input arguments
     constexpr static const auto mercury_in_proc_cb =
-            HG_GEN_PROC_NAME(rpc_trunc_in_t);
+            HG_GEN_PROC_NAME(rpc_trunc_data_in_t);
 
     // Mercury callback to serialize output arguments
     constexpr static const auto mercury_out_proc_cb =
@@ -1824,8 +1909,8 @@ struct trunc_data {
         hermes::detail::post_to_mercury(ExecutionContext*);
 
     public:
-        input(const std::string& path, uint64_t length)
-            : m_path(path), m_length(length) {}
+        input(const std::string& path, uint64_t length, uint64_t chunk_size)
+            : m_path(path), m_length(length), m_chunk_size(chunk_size) {}
 
         input(input&& rhs) = default;
 
@@ -1847,19 +1932,27 @@ struct trunc_data {
             return m_length;
         }
 
-        explicit input(const rpc_trunc_in_t& other)
-            : m_path(other.path), m_length(other.length) {}
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
 
-        explicit operator rpc_trunc_in_t() {
+        explicit input(const rpc_trunc_data_in_t& other)
+            : m_path(other.path), m_length(other.length),
+              m_chunk_size(other.chunk_size) {}
+
+        explicit operator rpc_trunc_data_in_t() {
             return {
                     m_path.c_str(),
                     m_length,
+                    m_chunk_size,
             };
         }
 
     private:
         std::string m_path;
         uint64_t m_length;
+        uint64_t m_chunk_size;
     };
 
     class output {
@@ -2280,6 +2373,1151 @@ struct chunk_stat {
     };
 };
 
+//==============================================================================
+// definitions for copy_data
+struct copy_data {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = copy_data;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_copy_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 824442880;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::copy_data;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_copy_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& src_path, const std::string& dst_path,
+              int64_t src_offset, int64_t dst_offset, uint64_t count,
+              uint64_t host_id, uint64_t host_size, uint64_t src_chunk_size,
+              uint64_t dst_chunk_size, int64_t src_data_host,
+              int64_t dst_data_host)
+            : m_src_path(src_path), m_dst_path(dst_path),
+              m_src_offset(src_offset), m_dst_offset(dst_offset),
+              m_count(count), m_host_id(host_id), m_host_size(host_size),
+              m_src_chunk_size(src_chunk_size),
+              m_dst_chunk_size(dst_chunk_size), m_src_data_host(src_data_host),
+              m_dst_data_host(dst_data_host) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        src_path() const {
+            return m_src_path;
+        }
+
+        std::string
+        dst_path() const {
+            return m_dst_path;
+        }
+
+        int64_t
+        src_offset() const {
+            return m_src_offset;
+        }
+
+        int64_t
+        dst_offset() const {
+            return m_dst_offset;
+        }
+
+        uint64_t
+        count() const {
+            return m_count;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        src_chunk_size() const {
+            return m_src_chunk_size;
+        }
+
+        uint64_t
+        dst_chunk_size() const {
+            return m_dst_chunk_size;
+        }
+
+        int64_t
+        src_data_host() const {
+            return m_src_data_host;
+        }
+
+        int64_t
+        dst_data_host() const {
+            return m_dst_data_host;
+        }
+
+        explicit input(const rpc_copy_data_in_t& other)
+            : m_src_path(other.src_path), m_dst_path(other.dst_path),
+              m_src_offset(other.src_offset), m_dst_offset(other.dst_offset),
+              m_count(other.count), m_host_id(other.host_id),
+              m_host_size(other.host_size),
+              m_src_chunk_size(other.src_chunk_size),
+              m_dst_chunk_size(other.dst_chunk_size),
+              m_src_data_host(other.src_data_host),
+              m_dst_data_host(other.dst_data_host) {}
+
+        explicit operator rpc_copy_data_in_t() {
+            return {m_src_path.c_str(), m_dst_path.c_str(), m_src_offset,
+                    m_dst_offset, m_count, m_host_id, m_host_size,
+                    m_src_chunk_size, m_dst_chunk_size, m_src_data_host,
+                    m_dst_data_host};
+        }
+
+    private:
+        std::string m_src_path;
+        std::string m_dst_path;
+        int64_t m_src_offset;
+        int64_t m_dst_offset;
+        uint64_t m_count;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_src_chunk_size;
+        uint64_t m_dst_chunk_size;
+        int64_t m_src_data_host;
+        int64_t m_dst_data_host;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() : m_err(), m_io_size() {}
+
+        output(int32_t err, size_t io_size) : m_err(err), m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        size_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for fallocate
+struct fallocate {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = fallocate;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_fallocate_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 1682243584;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::fallocate;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_fallocate_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path, int64_t offset, uint64_t length,
+              uint64_t host_id, uint64_t host_size, uint64_t chunk_size,
+              int64_t data_host)
+            : m_path(path), m_offset(offset), m_length(length),
+              m_host_id(host_id), m_host_size(host_size),
+              m_chunk_size(chunk_size), m_data_host(data_host) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        int64_t
+        offset() const {
+            return m_offset;
+        }
+
+        uint64_t
+        length() const {
+            return m_length;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
+        explicit input(const rpc_fallocate_in_t& other)
+            : m_path(other.path), m_offset(other.offset),
+              m_length(other.length), m_host_id(other.host_id),
+              m_host_size(other.host_size), m_chunk_size(other.chunk_size),
+              m_data_host(other.data_host) {}
+
+        explicit operator rpc_fallocate_in_t() {
+            return {m_path.c_str(), m_offset, m_length, m_host_id, m_host_size,
+                    m_chunk_size, m_data_host};
+        }
+
+    private:
+        std::string m_path;
+        int64_t m_offset;
+        uint64_t m_length;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() : m_err() {}
+
+        output(int32_t err) : m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for write_data_list
+struct write_data_list {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = write_data_list;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_list_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2849636352;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::write_list;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_list_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path, uint64_t host_id, uint64_t host_size,
+              uint64_t extent_n, uint64_t table_offset, uint64_t total_size,
+              uint64_t chunk_size, int64_t data_host,
+              const hermes::exposed_memory& buffers)
+            : m_path(path), m_host_id(host_id), m_host_size(host_size),
+              m_extent_n(extent_n), m_table_offset(table_offset),
+              m_total_size(total_size), m_chunk_size(chunk_size),
+              m_data_host(data_host), m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        extent_n() const {
+            return m_extent_n;
+        }
+
+        uint64_t
+        table_offset() const {
+            return m_table_offset;
+        }
+
+        uint64_t
+        total_size() const {
+            return m_total_size;
+        }
+
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
+        }
+
+        explicit input(const rpc_list_data_in_t& other)
+            : m_path(other.path), m_host_id(other.host_id),
+              m_host_size(other.host_size), m_extent_n(other.extent_n),
+              m_table_offset(other.table_offset),
+              m_total_size(other.total_size), m_chunk_size(other.chunk_size),
+              m_data_host(other.data_host), m_buffers(other.bulk_handle) {}
+
+        explicit operator rpc_list_data_in_t() {
+            return {m_path.c_str(), m_host_id, m_host_size, m_extent_n,
+                    m_table_offset, m_total_size, m_chunk_size, m_data_host,
+                    hg_bulk_t(m_buffers)};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_extent_n;
+        uint64_t m_table_offset;
+        uint64_t m_total_size;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
+        hermes::exposed_memory m_buffers;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() : m_err(), m_io_size() {}
+
+        output(int32_t err, size_t io_size) : m_err(err), m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        size_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for read_data_list
+struct read_data_list {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = read_data_list;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_list_data_in_t;
+    using mercury_output_type = rpc_data_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 2289500160;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::read_list;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_list_data_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_data_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path, uint64_t host_id, uint64_t host_size,
+              uint64_t extent_n, uint64_t table_offset, uint64_t total_size,
+              uint64_t chunk_size, int64_t data_host,
+              const hermes::exposed_memory& buffers)
+            : m_path(path), m_host_id(host_id), m_host_size(host_size),
+              m_extent_n(extent_n), m_table_offset(table_offset),
+              m_total_size(total_size), m_chunk_size(chunk_size),
+              m_data_host(data_host), m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        host_id() const {
+            return m_host_id;
+        }
+
+        uint64_t
+        host_size() const {
+            return m_host_size;
+        }
+
+        uint64_t
+        extent_n() const {
+            return m_extent_n;
+        }
+
+        uint64_t
+        table_offset() const {
+            return m_table_offset;
+        }
+
+        uint64_t
+        total_size() const {
+            return m_total_size;
+        }
+
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        int64_t
+        data_host() const {
+            return m_data_host;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
+        }
+
+        explicit input(const rpc_list_data_in_t& other)
+            : m_path(other.path), m_host_id(other.host_id),
+              m_host_size(other.host_size), m_extent_n(other.extent_n),
+              m_table_offset(other.table_offset),
+              m_total_size(other.total_size), m_chunk_size(other.chunk_size),
+              m_data_host(other.data_host), m_buffers(other.bulk_handle) {}
+
+        explicit operator rpc_list_data_in_t() {
+            return {m_path.c_str(), m_host_id, m_host_size, m_extent_n,
+                    m_table_offset, m_total_size, m_chunk_size, m_data_host,
+                    hg_bulk_t(m_buffers)};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_host_id;
+        uint64_t m_host_size;
+        uint64_t m_extent_n;
+        uint64_t m_table_offset;
+        uint64_t m_total_size;
+        uint64_t m_chunk_size;
+        int64_t m_data_host;
+        hermes::exposed_memory m_buffers;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() : m_err(), m_io_size() {}
+
+        output(int32_t err, size_t io_size) : m_err(err), m_io_size(io_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_data_out_t& out) {
+            m_err = out.err;
+            m_io_size = out.io_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        size_t
+        io_size() const {
+            return m_io_size;
+        }
+
+    private:
+        int32_t m_err;
+        size_t m_io_size;
+    };
+};
+
+//==============================================================================
+// definitions for set_chunk_size
+struct set_chunk_size {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = set_chunk_size;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_chunk_size_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 3814719488;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::set_chunk_size;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_chunk_size_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path, uint64_t chunk_size)
+            : m_path(path), m_chunk_size(chunk_size) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        uint64_t
+        chunk_size() const {
+            return m_chunk_size;
+        }
+
+        explicit input(const rpc_chunk_size_in_t& other)
+            : m_path(other.path), m_chunk_size(other.chunk_size) {}
+
+        explicit operator rpc_chunk_size_in_t() {
+            return {m_path.c_str(), m_chunk_size};
+        }
+
+    private:
+        std::string m_path;
+        uint64_t m_chunk_size;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() : m_err() {}
+
+        output(int32_t err) : m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
+//==============================================================================
+// definitions for scan
+struct scan {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = scan;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_scan_in_t;
+    using mercury_output_type = rpc_scan_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 613744640;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::scan;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_scan_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_scan_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path, bool recursive,
+              const std::string& pattern, bool regex, uint64_t size_min,
+              uint64_t size_max, int64_t ctime_min, int64_t ctime_max,
+              uint32_t type, bool aggregate,
+              const hermes::exposed_memory& buffers)
+            : m_path(path), m_recursive(recursive), m_pattern(pattern),
+              m_regex(regex), m_size_min(size_min), m_size_max(size_max),
+              m_ctime_min(ctime_min), m_ctime_max(ctime_max), m_type(type),
+              m_aggregate(aggregate), m_buffers(buffers) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        bool
+        recursive() const {
+            return m_recursive;
+        }
+
+        std::string
+        pattern() const {
+            return m_pattern;
+        }
+
+        bool
+        regex() const {
+            return m_regex;
+        }
+
+        uint64_t
+        size_min() const {
+            return m_size_min;
+        }
+
+        uint64_t
+        size_max() const {
+            return m_size_max;
+        }
+
+        int64_t
+        ctime_min() const {
+            return m_ctime_min;
+        }
+
+        int64_t
+        ctime_max() const {
+            return m_ctime_max;
+        }
+
+        uint32_t
+        type() const {
+            return m_type;
+        }
+
+        bool
+        aggregate() const {
+            return m_aggregate;
+        }
+
+        hermes::exposed_memory
+        buffers() const {
+            return m_buffers;
+        }
+
+        explicit input(const rpc_scan_in_t& other)
+            : m_path(other.path), m_recursive(other.recursive),
+              m_pattern(other.pattern), m_regex(other.regex),
+              m_size_min(other.size_min), m_size_max(other.size_max),
+              m_ctime_min(other.ctime_min), m_ctime_max(other.ctime_max),
+              m_type(other.type), m_aggregate(other.aggregate),
+              m_buffers(other.bulk_handle) {}
+
+        explicit operator rpc_scan_in_t() {
+            return {m_path.c_str(), m_recursive, m_pattern.c_str(), m_regex,
+                    m_size_min, m_size_max, m_ctime_min, m_ctime_max, m_type,
+                    m_aggregate, hg_bulk_t(m_buffers)};
+        }
+
+    private:
+        std::string m_path;
+        bool m_recursive;
+        std::string m_pattern;
+        bool m_regex;
+        uint64_t m_size_min;
+        uint64_t m_size_max;
+        int64_t m_ctime_min;
+        int64_t m_ctime_max;
+        uint32_t m_type;
+        bool m_aggregate;
+        hermes::exposed_memory m_buffers;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output()
+            : m_err(), m_scanned(), m_matched(), m_size_sum(), m_bulk_size() {}
+
+        output(int32_t err, uint64_t scanned, uint64_t matched,
+               uint64_t size_sum, uint64_t bulk_size)
+            : m_err(err), m_scanned(scanned), m_matched(matched),
+              m_size_sum(size_sum), m_bulk_size(bulk_size) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_scan_out_t& out) {
+            m_err = out.err;
+            m_scanned = out.scanned;
+            m_matched = out.matched;
+            m_size_sum = out.size_sum;
+            m_bulk_size = out.bulk_size;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+        uint64_t
+        scanned() const {
+            return m_scanned;
+        }
+
+        uint64_t
+        matched() const {
+            return m_matched;
+        }
+
+        uint64_t
+        size_sum() const {
+            return m_size_sum;
+        }
+
+        uint64_t
+        bulk_size() const {
+            return m_bulk_size;
+        }
+
+    private:
+        int32_t m_err;
+        uint64_t m_scanned;
+        uint64_t m_matched;
+        uint64_t m_size_sum;
+        uint64_t m_bulk_size;
+    };
+};
+
+//==============================================================================
+// definitions for remove_subtree
+struct remove_subtree {
+
+    // forward declarations of public input/output types for this RPC
+    class input;
+
+    class output;
+
+    // traits used so that the engine knows what to do with the RPC
+    using self_type = remove_subtree;
+    using handle_type = hermes::rpc_handle<self_type>;
+    using input_type = input;
+    using output_type = output;
+    using mercury_input_type = rpc_path_only_in_t;
+    using mercury_output_type = rpc_err_out_t;
+
+    // RPC public identifier
+    // (N.B: we reuse the same IDs assigned by Margo so that the daemon
+    // understands Hermes RPCs)
+    constexpr static const uint64_t public_id = 845414400;
+
+    // RPC internal Mercury identifier
+    constexpr static const hg_id_t mercury_id = public_id;
+
+    // RPC name
+    constexpr static const auto name = gkfs::rpc::tag::remove_subtree;
+
+    // requires response?
+    constexpr static const auto requires_response = true;
+
+    // Mercury callback to serialize input arguments
+    constexpr static const auto mercury_in_proc_cb =
+            HG_GEN_PROC_NAME(rpc_path_only_in_t);
+
+    // Mercury callback to serialize output arguments
+    constexpr static const auto mercury_out_proc_cb =
+            HG_GEN_PROC_NAME(rpc_err_out_t);
+
+    class input {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        input(const std::string& path) : m_path(path) {}
+
+        input(input&& rhs) = default;
+
+        input(const input& other) = default;
+
+        input&
+        operator=(input&& rhs) = default;
+
+        input&
+        operator=(const input& other) = default;
+
+        std::string
+        path() const {
+            return m_path;
+        }
+
+        explicit input(const rpc_path_only_in_t& other)
+            : m_path(other.path) {}
+
+        explicit operator rpc_path_only_in_t() {
+            return {m_path.c_str()};
+        }
+
+    private:
+        std::string m_path;
+    };
+
+    class output {
+
+        template <typename ExecutionContext>
+        friend hg_return_t
+        hermes::detail::post_to_mercury(ExecutionContext*);
+
+    public:
+        output() : m_err() {}
+
+        output(int32_t err) : m_err(err) {}
+
+        output(output&& rhs) = default;
+
+        output(const output& other) = default;
+
+        output&
+        operator=(output&& rhs) = default;
+
+        output&
+        operator=(const output& other) = default;
+
+        explicit output(const rpc_err_out_t& out) {
+            m_err = out.err;
+        }
+
+        int32_t
+        err() const {
+            return m_err;
+        }
+
+    private:
+        int32_t m_err;
+    };
+};
+
 } // namespace gkfs::rpc
 
 
@@ -61,7 +61,8 @@ log2(uint64_t n) {
  * Check whether @n is aligned to a block boundary, i.e. if it is divisible by
  * @block_size.
  *
- * @note This function assumes that block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use a bit mask, all others a
+ * division.
  *
  * @param [in] n the number to check.
  * @param [in] block_size
@@ -69,16 +70,19 @@ log2(uint64_t n) {
  */
 constexpr bool
 is_aligned(const uint64_t n, const size_t block_size) {
-    using gkfs::utils::arithmetic::log2;
-    assert(is_power_of_2(block_size));
-    return !(n & ((1u << log2(block_size)) - 1));
+    // This check is automatically removed in release builds
+    assert(block_size > 0);
+    if(is_power_of_2(block_size))
+        return !(n & (block_size - 1u));
+    return n % block_size == 0;
 }
 
 /**
  * Given a file @offset and a @block_size, align the @offset to its
  * closest left-side block boundary.
  *
- * @note This function assumes that block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use a bit mask, all others a
+ * division.
  *
  * @param [in] offset the offset to align.
  * @param [in] block_size the block size used to compute boundaries.
@@ -87,8 +91,10 @@ is_aligned(const uint64_t n, const size_t block_size) {
 constexpr uint64_t
 align_left(const uint64_t offset, const size_t block_size) {
     // This check is automatically removed in release builds
-    assert(is_power_of_2(block_size));
-    return offset & ~(block_size - 1u);
+    assert(block_size > 0);
+    if(is_power_of_2(block_size))
+        return offset & ~(block_size - 1u);
+    return offset - offset % block_size;
 }
 
 
@@ -96,7 +102,8 @@ align_left(const uint64_t offset, const size_t block_size) {
  * Given a file @offset and a @block_size, align the @offset to its
  * closest right-side block boundary.
  *
- * @note This function assumes that block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use a bit mask, all others a
+ * division.
  *
  * @param [in] offset the offset to align.
  * @param [in] block_size the block size used to compute boundaries.
@@ -104,8 +111,6 @@ align_left(const uint64_t offset, const size_t block_size) {
  */
 constexpr uint64_t
 align_right(const uint64_t offset, const size_t block_size) {
-    // This check is automatically removed in release builds
-    assert(is_power_of_2(block_size));
     return align_left(offset, block_size) + block_size;
 }
 
@@ -114,7 +119,8 @@ align_right(const uint64_t offset, const size_t block_size) {
  * Return the overrun bytes that separate @offset from the closest left side
  * block boundary.
  *
- * @note This function assumes that block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use a bit mask, all others a
+ * division.
  *
  * @param [in] offset the offset for which the overrun distance should be
  * computed.
@@ -124,8 +130,10 @@ align_right(const uint64_t offset, const size_t block_size) {
 constexpr size_t
 block_overrun(const uint64_t offset, const size_t block_size) {
     // This check is automatically removed in release builds
-    assert(is_power_of_2(block_size));
-    return offset & (block_size - 1u);
+    assert(block_size > 0);
+    if(is_power_of_2(block_size))
+        return offset & (block_size - 1u);
+    return offset % block_size;
 }
 
 
@@ -133,7 +141,8 @@ block_overrun(const uint64_t offset, const size_t block_size) {
  * Return the underrun bytes that separate @offset from the closest right side
  * block boundary.
  *
- * @note This function assumes that block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use a bit mask, all others a
+ * division.
  *
  * @param [in] offset the offset for which the overrun distance should be
  * computed.
@@ -142,8 +151,6 @@ block_overrun(const uint64_t offset, const size_t block_size) {
  */
 constexpr size_t
 block_underrun(const uint64_t offset, const size_t block_size) {
-    // This check is automatically removed in release builds
-    assert(is_power_of_2(block_size));
     return align_right(offset, block_size) - offset;
 }
 
@@ -157,7 +164,8 @@ block_underrun(const uint64_t offset, const size_t block_size) {
  * index 1 to block [block_size, 2 * block_size - 1], and so on up to
  * a maximum index FILE_LENGTH / block_size.
  *
- * @note This function assumes that @block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use shifts and bit masks, all
+ * others a division.
  *
  * @param [in] offset the offset for which the block index should be computed.
  * @param [in] block_size the block_size that should be used to compute the
@@ -170,8 +178,10 @@ block_index(const uint64_t offset, const size_t block_size) {
     using gkfs::utils::arithmetic::log2;
 
     // This check is automatically removed in release builds
-    assert(is_power_of_2(block_size));
-    return align_left(offset, block_size) >> log2(block_size);
+    assert(block_size > 0);
+    if(is_power_of_2(block_size))
+        return offset >> log2(block_size);
+    return offset / block_size;
 }
 
 
@@ -179,7 +189,8 @@ block_index(const uint64_t offset, const size_t block_size) {
  * Compute the number of blocks involved in an operation affecting the
  * regions from [@offset, to @offset + @count).
  *
- * @note This function assumes that @block_size is a power of 2.
+ * @note Block sizes that are a power of 2 use shifts and bit masks, all
+ * others a division.
  * @note This function assumes that @offset + @count does not
  * overflow.
  *
@@ -195,7 +206,7 @@ block_count(const uint64_t offset, const size_t size, const size_t block_size) {
     using gkfs::utils::arithmetic::log2;
 
     // These checks are automatically removed in release builds
-    assert(is_power_of_2(block_size));
+    assert(block_size > 0);
 
 #if defined(__GNUC__) && !defined(__clang__)
     assert(!__builtin_add_overflow_p(offset, size, uint64_t{0}));
@@ -203,12 +214,10 @@ block_count(const uint64_t offset, const size_t size, const size_t block_size) {
     assert(offset + size > offset);
 #endif
 
-    const uint64_t first_block = align_left(offset, block_size);
-    const uint64_t final_block = align_left(offset + size, block_size);
     const size_t mask = -!!size; // this is either 0 or ~0
 
-    return (((final_block >> log2(block_size)) -
-             (first_block >> log2(block_size)) +
+    return ((block_index(offset + size, block_size) -
+             block_index(offset, block_size) +
              !is_aligned(offset + size, block_size))) &
            mask;
 }
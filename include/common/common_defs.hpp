@@ -29,12 +29,25 @@
 #ifndef GEKKOFS_COMMON_DEFS_HPP
 #define GEKKOFS_COMMON_DEFS_HPP
 
+#include <cstdint>
+
 // These constexpr set the RPC's identity and which handler the receiver end
 // should use
 namespace gkfs::rpc {
 
 using chnk_id_t = unsigned long;
 
+/**
+ * @brief Chunk extent of a list I/O request. The extents of a request are
+ * transferred as a table in front of the data in the client's exposed memory.
+ */
+struct chnk_extent {
+    uint64_t chnk_id;       //!< chunk id
+    uint64_t chnk_offset;   //!< offset within the chunk
+    uint64_t size;          //!< number of bytes
+    uint64_t origin_offset; //!< offset of the data in the exposed memory
+};
+
 namespace tag {
 
 constexpr auto fs_config = "rpc_srv_fs_config";
@@ -42,12 +55,15 @@ constexpr auto create = "rpc_srv_mk_node";
 constexpr auto stat = "rpc_srv_stat";
 constexpr auto remove_metadata = "rpc_srv_rm_metadata";
 constexpr auto remove_data = "rpc_srv_rm_data";
+constexpr auto remove_subtree = "rpc_srv_rm_subtree";
 constexpr auto decr_size = "rpc_srv_decr_size";
 constexpr auto update_metadentry = "rpc_srv_update_metadentry";
 constexpr auto get_metadentry_size = "rpc_srv_get_metadentry_size";
 constexpr auto update_metadentry_size = "rpc_srv_update_metadentry_size";
 constexpr auto get_dirents = "rpc_srv_get_dirents";
 constexpr auto get_dirents_extended = "rpc_srv_get_dirents_extended";
+constexpr auto set_chunk_size = "rpc_srv_set_chunk_size";
+constexpr auto scan = "rpc_srv_scan";
 #ifdef HAS_SYMLINKS
 constexpr auto mk_symlink = "rpc_srv_mk_symlink";
 #endif
@@ -55,6 +71,10 @@ constexpr auto write = "rpc_srv_write_data";
 constexpr auto read = "rpc_srv_read_data";
 constexpr auto truncate = "rpc_srv_trunc_data";
 constexpr auto get_chunk_stat = "rpc_srv_chunk_stat";
+constexpr auto copy_data = "rpc_srv_copy_data";
+constexpr auto fallocate = "rpc_srv_fallocate";
+constexpr auto write_list = "rpc_srv_write_data_list";
+constexpr auto read_list = "rpc_srv_read_data_list";
 } // namespace tag
 
 namespace protocol {
@@ -0,0 +1,64 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#ifndef GKFS_COMMON_HOSTS_FILE_HPP
+#define GKFS_COMMON_HOSTS_FILE_HPP
+
+#include <string>
+#include <vector>
+
+namespace gkfs::utils {
+
+/**
+ * @brief A single daemon entry of the hosts file.
+ */
+struct HostsFileEntry {
+    std::string hostname; //!< Hostname, including a possible #rootdir_suffix
+    std::string uri;      //!< Mercury URI address of the daemon
+    double weight;        //!< Weight for the weighted distributor
+};
+
+/**
+ * @brief Parses the hosts file written by the daemons. Each line holds a
+ * hostname, a URI and an optional positive weight which defaults to 1.
+ * @internal
+ * Entries are sorted by hostname (including a possible rootdir_suffix) and URI.
+ * A host id is the position of its daemon in this order. Clients, daemons and
+ * proxies must therefore all use this function so that host ids resolve to the
+ * same daemon everywhere and data hashes to the same place after a restart.
+ * @endinternal
+ * @param path Path to the hosts file
+ * @return Sorted entries, empty if the file has no entries
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+std::vector<HostsFileEntry>
+parse_hosts_file(const std::string& path);
+
+} // namespace gkfs::utils
+
+#endif // GKFS_COMMON_HOSTS_FILE_HPP
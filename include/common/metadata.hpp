@@ -51,6 +51,10 @@ private:
     nlink_t link_count_{}; // number of names for this inode (hardlinks)
     size_t size_{};     // size_ in bytes, might be computed instead of stored
     blkcnt_t blocks_{}; // allocated file system blocks_
+    // chunk size of a file. Directories pass it on to new entries
+    size_t chunk_size_{gkfs::config::rpc::chunksize};
+    // daemon holding all chunks of a file, -1 if placed by the distributor
+    int64_t data_host_{-1};
 #ifdef HAS_SYMLINKS
     std::string target_path_; // For links this is the path of the target file
 #ifdef HAS_RENAME
@@ -126,6 +130,18 @@ public:
     void
     blocks(blkcnt_t blocks_);
 
+    size_t
+    chunk_size() const;
+
+    void
+    chunk_size(size_t chunk_size_);
+
+    int64_t
+    data_host() const;
+
+    void
+    data_host(int64_t data_host_);
+
 #ifdef HAS_SYMLINKS
 
     std::string
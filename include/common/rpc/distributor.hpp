@@ -36,6 +36,10 @@
 #include <unordered_map>
 #include <fstream>
 #include <map>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 
 namespace gkfs::rpc {
 
@@ -60,6 +64,15 @@ public:
 
     virtual std::vector<host_t>
     locate_directory_metadata(const std::string& path) const = 0;
+
+    /**
+     * @brief Returns the owners of all chunks in [chnk_start, chnk_end]. The
+     * default calls locate_data() per chunk. Distributors that place chunks
+     * arithmetically override it to hash the path only once.
+     */
+    virtual std::vector<host_t>
+    locate_data_range(const std::string& path, chunkid_t chnk_start,
+                      chunkid_t chnk_end) const;
 };
 
 
@@ -93,6 +106,119 @@ public:
     locate_directory_metadata(const std::string& path) const override;
 };
 
+/**
+ * @brief Stripes the chunks of a file round-robin across stripe_count
+ * consecutive daemons, similar to Lustre's RAID0 layout. The first daemon is
+ * derived from a single hash of the path and also holds the file's metadata.
+ */
+class StripedDistributor : public Distributor {
+private:
+    host_t localhost_;
+    unsigned int hosts_size_{0};
+    unsigned int stripe_count_{0};
+    unsigned int max_stripe_count_;
+    std::vector<host_t> all_hosts_;
+    std::hash<std::string> str_hash;
+
+    void
+    hosts_size(unsigned int hosts_size);
+
+public:
+    explicit StripedDistributor(
+            unsigned int stripe_count = gkfs::config::rpc::stripe_count);
+
+    StripedDistributor(
+            host_t localhost, unsigned int hosts_size,
+            unsigned int stripe_count = gkfs::config::rpc::stripe_count);
+
+    host_t
+    localhost() const override;
+
+    unsigned int
+    stripe_count() const;
+
+    host_t
+    locate_data(const std::string& path,
+                const chunkid_t& chnk_id) const override;
+
+    host_t
+    locate_data(const std::string& path, const chunkid_t& chnk_id,
+                unsigned int host_size) override;
+
+    host_t
+    locate_file_metadata(const std::string& path) const override;
+
+    std::vector<host_t>
+    locate_directory_metadata(const std::string& path) const override;
+
+    std::vector<host_t>
+    locate_data_range(const std::string& path, chunkid_t chnk_start,
+                      chunkid_t chnk_end) const override;
+};
+
+/**
+ * @brief Places chunks by weighted rendezvous (highest random weight) hashing.
+ * Every daemon scores a chunk with weight / -ln(u), u being a uniform hash of
+ * the chunk and the daemon, and the highest score wins. Each daemon therefore
+ * receives a share of the chunks proportional to its weight, e.g., its
+ * capacity, and adding a daemon only moves the chunks that it wins. Metadata
+ * is placed by path hash as with the SimpleHashDistributor.
+ *
+ * Weights are given per host id. The daemon does not know the number of
+ * daemons at startup and fetches the weights through weights_loader once it
+ * learns it. Missing or mismatching weights fall back to uniform weights.
+ */
+class WeightedDistributor : public Distributor {
+public:
+    using weights_loader_t =
+            std::function<std::vector<double>(unsigned int hosts_size)>;
+
+private:
+    host_t localhost_;
+    std::atomic<unsigned int> hosts_size_{0};
+    std::vector<host_t> all_hosts_;
+    std::vector<double> weights_;
+    weights_loader_t weights_loader_;
+    std::mutex weights_mutex_;
+    std::hash<std::string> str_hash;
+
+    void
+    set_weights(unsigned int hosts_size, std::vector<double> weights);
+
+    host_t
+    locate(uint64_t chunk_key) const;
+
+public:
+    explicit WeightedDistributor(weights_loader_t weights_loader = {});
+
+    WeightedDistributor(host_t localhost, unsigned int hosts_size,
+                        std::vector<double> weights);
+
+    host_t
+    localhost() const override;
+
+    const std::vector<double>&
+    weights() const;
+
+    host_t
+    locate_data(const std::string& path,
+                const chunkid_t& chnk_id) const override;
+
+    host_t
+    locate_data(const std::string& path, const chunkid_t& chnk_id,
+                unsigned int host_size) override;
+
+    host_t
+    locate_file_metadata(const std::string& path) const override;
+
+    std::vector<host_t>
+    locate_directory_metadata(const std::string& path) const override;
+
+    std::vector<host_t>
+    locate_data_range(const std::string& path, chunkid_t chnk_start,
+                      chunkid_t chnk_end) const override;
+};
+
 class LocalOnlyDistributor : public Distributor {
 private:
     host_t localhost_;
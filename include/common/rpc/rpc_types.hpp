@@ -41,7 +41,8 @@ MERCURY_GEN_PROC(rpc_err_out_t, ((hg_int32_t) (err)))
 
 // Metadentry
 MERCURY_GEN_PROC(rpc_mk_node_in_t,
-                 ((hg_const_string_t) (path))((uint32_t) (mode)))
+                 ((hg_const_string_t) (path))((uint32_t) (mode))(
+                         (hg_uint64_t) (chunk_size))((hg_int64_t) (data_host)))
 
 MERCURY_GEN_PROC(rpc_path_only_in_t, ((hg_const_string_t) (path)))
 
@@ -52,7 +53,8 @@ MERCURY_GEN_PROC(rpc_rm_node_in_t, ((hg_const_string_t) (path)))
 
 MERCURY_GEN_PROC(
         rpc_rm_metadata_out_t,
-        ((hg_int32_t) (err))((hg_int64_t) (size))((hg_uint32_t) (mode)))
+        ((hg_int32_t) (err))((hg_int64_t) (size))((hg_uint32_t) (mode))(
+                (hg_uint64_t) (chunk_size))((hg_int64_t) (data_host)))
 
 MERCURY_GEN_PROC(rpc_trunc_in_t,
                  ((hg_const_string_t) (path))((hg_uint64_t) (length)))
@@ -70,7 +72,8 @@ MERCURY_GEN_PROC(
 
 MERCURY_GEN_PROC(rpc_update_metadentry_size_in_t,
                  ((hg_const_string_t) (path))((hg_uint64_t) (size))(
-                         (hg_int64_t) (offset))((hg_bool_t) (append)))
+                         (hg_int64_t) (offset))((hg_bool_t) (append))(
+                         (hg_uint64_t) (trace_id)))
 
 MERCURY_GEN_PROC(rpc_update_metadentry_size_out_t,
                  ((hg_int32_t) (err))((hg_int64_t) (ret_size)))
@@ -78,6 +81,9 @@ MERCURY_GEN_PROC(rpc_update_metadentry_size_out_t,
 MERCURY_GEN_PROC(rpc_get_metadentry_size_out_t,
                  ((hg_int32_t) (err))((hg_int64_t) (ret_size)))
 
+MERCURY_GEN_PROC(rpc_chunk_size_in_t,
+                 ((hg_const_string_t) (path))((hg_uint64_t) (chunk_size)))
+
 #ifdef HAS_SYMLINKS
 MERCURY_GEN_PROC(rpc_mk_symlink_in_t, ((hg_const_string_t) (path))((
                                               hg_const_string_t) (target_path)))
@@ -91,7 +97,8 @@ MERCURY_GEN_PROC(
                 (hg_uint64_t) (host_id))((hg_uint64_t) (host_size))(
                 (hg_uint64_t) (chunk_n))((hg_uint64_t) (chunk_start))(
                 (hg_uint64_t) (chunk_end))((hg_uint64_t) (total_chunk_size))(
-                (hg_bulk_t) (bulk_handle)))
+                (hg_uint64_t) (chunk_size))((hg_int64_t) (data_host))(
+                (hg_uint64_t) (trace_id))((hg_bulk_t) (bulk_handle)))
 
 MERCURY_GEN_PROC(rpc_data_out_t, ((int32_t) (err))((hg_size_t) (io_size)))
 
@@ -101,14 +108,56 @@ MERCURY_GEN_PROC(
                 (hg_uint64_t) (host_id))((hg_uint64_t) (host_size))(
                 (hg_uint64_t) (chunk_n))((hg_uint64_t) (chunk_start))(
                 (hg_uint64_t) (chunk_end))((hg_uint64_t) (total_chunk_size))(
+                (hg_uint64_t) (chunk_size))((hg_int64_t) (data_host))(
+                (hg_uint64_t) (trace_id))((hg_bulk_t) (bulk_handle)))
+
+MERCURY_GEN_PROC(rpc_trunc_data_in_t,
+                 ((hg_const_string_t) (path))((hg_uint64_t) (length))(
+                         (hg_uint64_t) (chunk_size)))
+
+MERCURY_GEN_PROC(
+        rpc_copy_data_in_t,
+        ((hg_const_string_t) (src_path))((hg_const_string_t) (dst_path))(
+                (int64_t) (src_offset))((int64_t) (dst_offset))(
+                (hg_uint64_t) (count))((hg_uint64_t) (host_id))(
+                (hg_uint64_t) (host_size))((hg_uint64_t) (src_chunk_size))(
+                (hg_uint64_t) (dst_chunk_size))((hg_int64_t) (src_data_host))(
+                (hg_int64_t) (dst_data_host)))
+
+MERCURY_GEN_PROC(
+        rpc_list_data_in_t,
+        ((hg_const_string_t) (path))((hg_uint64_t) (host_id))(
+                (hg_uint64_t) (host_size))((hg_uint64_t) (extent_n))(
+                (hg_uint64_t) (table_offset))((hg_uint64_t) (total_size))(
+                (hg_uint64_t) (chunk_size))((hg_int64_t) (data_host))(
                 (hg_bulk_t) (bulk_handle)))
 
+MERCURY_GEN_PROC(rpc_fallocate_in_t,
+                 ((hg_const_string_t) (path))((int64_t) (offset))(
+                         (hg_uint64_t) (length))((hg_uint64_t) (host_id))(
+                         (hg_uint64_t) (host_size))((hg_uint64_t) (chunk_size))(
+                         (hg_int64_t) (data_host)))
+
 MERCURY_GEN_PROC(rpc_get_dirents_in_t,
                  ((hg_const_string_t) (path))((hg_bulk_t) (bulk_handle)))
 
 MERCURY_GEN_PROC(rpc_get_dirents_out_t,
                  ((hg_int32_t) (err))((hg_size_t) (dirents_size)))
 
+MERCURY_GEN_PROC(
+        rpc_scan_in_t,
+        ((hg_const_string_t) (path))((hg_bool_t) (recursive))(
+                (hg_const_string_t) (pattern))((hg_bool_t) (regex))(
+                (hg_uint64_t) (size_min))((hg_uint64_t) (size_max))(
+                (hg_int64_t) (ctime_min))((hg_int64_t) (ctime_max))(
+                (hg_uint32_t) (type))((hg_bool_t) (aggregate))(
+                (hg_bulk_t) (bulk_handle)))
+
+MERCURY_GEN_PROC(rpc_scan_out_t,
+                 ((hg_int32_t) (err))((hg_uint64_t) (scanned))(
+                         (hg_uint64_t) (matched))((hg_uint64_t) (size_sum))(
+                         (hg_uint64_t) (bulk_size)))
+
 
 MERCURY_GEN_PROC(
         rpc_config_out_t,
@@ -94,24 +94,34 @@ public:
         iops_stats,
         iops_dirent,
         iops_remove,
+        iops_sched_io,
+        iops_sched_merge,
     }; ///< enum storing IOPS Stats
 
-    enum class SizeOp { write_size, read_size }; ///< enum storing Size Stats
+    enum class SizeOp {
+        write_size,
+        read_size,
+        sched_io_size
+    }; ///< enum storing Size Stats
 
 private:
     constexpr static const std::initializer_list<Stats::IopsOp> all_IopsOp = {
-            IopsOp::iops_create, IopsOp::iops_write,
-            IopsOp::iops_read,   IopsOp::iops_stats,
-            IopsOp::iops_dirent, IopsOp::iops_remove}; ///< Enum IOPS iterator
+            IopsOp::iops_create,   IopsOp::iops_write,
+            IopsOp::iops_read,     IopsOp::iops_stats,
+            IopsOp::iops_dirent,   IopsOp::iops_remove,
+            IopsOp::iops_sched_io,
+            IopsOp::iops_sched_merge}; ///< Enum IOPS iterator
 
     constexpr static const std::initializer_list<Stats::SizeOp> all_SizeOp = {
-            SizeOp::write_size, SizeOp::read_size}; ///< Enum SIZE iterator
+            SizeOp::write_size, SizeOp::read_size,
+            SizeOp::sched_io_size}; ///< Enum SIZE iterator
 
     const std::vector<std::string> IopsOp_s = {
-            "IOPS_CREATE", "IOPS_WRITE",   "IOPS_READ",
-            "IOPS_STATS",  "IOPS_DIRENTS", "IOPS_REMOVE"}; ///< Stats Labels
-    const std::vector<std::string> SizeOp_s = {"WRITE_SIZE",
-                                               "READ_SIZE"}; ///< Stats Labels
+            "IOPS_CREATE",   "IOPS_WRITE",   "IOPS_READ",
+            "IOPS_STATS",    "IOPS_DIRENTS", "IOPS_REMOVE",
+            "IOPS_SCHED_IO", "IOPS_SCHED_MERGE"}; ///< Stats Labels
+    const std::vector<std::string> SizeOp_s = {
+            "WRITE_SIZE", "READ_SIZE", "SCHED_IO_SIZE"}; ///< Stats Labels
 
     std::chrono::time_point<std::chrono::steady_clock>
             start; ///< When we started the server
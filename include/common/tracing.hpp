@@ -0,0 +1,177 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#ifndef GKFS_COMMON_TRACING_HPP
+#define GKFS_COMMON_TRACING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Per-request tracing across clients and daemons.
+ * @internal
+ * A request is identified by a trace id which the client attaches to the RPCs
+ * it sends. Both sides record timestamped spans of the request's stages into
+ * per-thread ring buffers, which are written as Chrome trace JSON, viewable
+ * with Perfetto or chrome://tracing, on demand or at shutdown. Only the most
+ * recent spans of each thread are kept.
+ *
+ * Tracing is disabled unless enable() is called. Disabled spans cost a load of
+ * a global flag.
+ * @endinternal
+ */
+namespace gkfs::tracing {
+
+namespace detail {
+extern std::atomic<bool> enabled;
+} // namespace detail
+
+/**
+ * @brief Enables tracing for this process.
+ * @param process_name Name of the process in the trace, e.g., "gkfs_daemon"
+ */
+void
+enable(const std::string& process_name);
+
+/**
+ * @brief Checks if tracing is enabled.
+ */
+inline bool
+enabled() noexcept {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the current time in nanoseconds since the epoch.
+ * @internal
+ * The realtime clock is used so that spans of different processes, and of
+ * different nodes up to their clock offset, can be put side by side.
+ * @endinternal
+ */
+uint64_t
+now_ns() noexcept;
+
+/**
+ * @brief Creates a trace id that is unique across processes with a high
+ * probability. 0 is never returned.
+ */
+uint64_t
+new_trace_id() noexcept;
+
+/**
+ * @brief Records a completed span into the calling thread's ring buffer.
+ * @param trace_id Trace id of the request, 0 if the request is untraced
+ * @param name Stage name, must be a string literal
+ * @param start_ns Start time as returned by now_ns()
+ * @param end_ns End time as returned by now_ns()
+ */
+void
+record(uint64_t trace_id, const char* name, uint64_t start_ns,
+       uint64_t end_ns) noexcept;
+
+/**
+ * @brief Writes all recorded spans as Chrome trace JSON.
+ * @param path Output file, overwritten if it exists
+ * @return 0 on success, errno otherwise
+ */
+int
+dump(const std::string& path);
+
+/**
+ * @brief The trace id of the request the calling thread is working on.
+ * @internal
+ * Used by clients, whose threads issue one request at a time, so that RPC
+ * layers need not pass the id around. Daemon handlers run as user-level
+ * threads which may share an OS thread and must pass the id explicitly.
+ * @endinternal
+ */
+uint64_t
+current_trace_id() noexcept;
+
+/**
+ * @brief Sets the calling thread's current trace id for its lifetime. A new
+ * trace id is created unless the thread is already part of a traced request,
+ * so that nested operations, e.g., pwritev() calling pwrite(), share one id.
+ */
+class TraceContext {
+private:
+    bool owner_{false};
+
+public:
+    TraceContext() noexcept;
+
+    ~TraceContext();
+
+    TraceContext(const TraceContext&) = delete;
+
+    TraceContext&
+    operator=(const TraceContext&) = delete;
+};
+
+/**
+ * @brief Records a span from its construction to its destruction if tracing is
+ * enabled and the trace id is not 0.
+ */
+class Span {
+private:
+    uint64_t trace_id_;
+    const char* name_;
+    uint64_t start_ns_{0};
+
+public:
+    /**
+     * @param name Stage name, must be a string literal
+     * @param trace_id Trace id of the request
+     */
+    Span(const char* name, uint64_t trace_id) noexcept
+        : trace_id_(trace_id), name_(name) {
+        if(trace_id_ != 0 && enabled())
+            start_ns_ = now_ns();
+    }
+
+    /**
+     * @param name Stage name, must be a string literal
+     */
+    explicit Span(const char* name) noexcept
+        : Span(name, enabled() ? current_trace_id() : 0) {}
+
+    ~Span() {
+        if(start_ns_ != 0)
+            record(trace_id_, name_, start_ns_, now_ns());
+    }
+
+    Span(const Span&) = delete;
+
+    Span&
+    operator=(const Span&) = delete;
+};
+
+} // namespace gkfs::tracing
+
+#endif // GKFS_COMMON_TRACING_HPP
@@ -34,6 +34,7 @@
 // environment prefixes (are concatenated in env module at compile time)
 #define CLIENT_ENV_PREFIX "LIBGKFS_"
 #define DAEMON_ENV_PREFIX "GKFS_DAEMON_"
+#define PROXY_ENV_PREFIX "GKFS_PROXY_"
 #define COMMON_ENV_PREFIX "GKFS_"
 
 namespace gkfs::config {
@@ -47,14 +48,37 @@ namespace io {
  * If buffer is not zeroed, sparse regions contain invalid data.
  */
 constexpr auto zero_buffer_before_read = false;
+/*
+ * Maximum number of bytes copied by a single copy_file_range() or sendfile()
+ * call. Matches the kernel's MAX_RW_COUNT so that the result fits the syscall
+ * return value. Callers loop over larger ranges.
+ */
+constexpr auto max_copy_size = 0x7ffff000;
 } // namespace io
 
+namespace path {
+/*
+ * Maximum number of directories outside of GekkoFS that a client process
+ * caches to skip the lstat per path component when resolving paths. 0
+ * disables the cache
+ */
+constexpr auto resolve_cache_size = 8192;
+} // namespace path
+
 namespace log {
 constexpr auto client_log_path = "/tmp/gkfs_client.log";
 constexpr auto daemon_log_path = "/tmp/gkfs_daemon.log";
+constexpr auto proxy_log_path = "/tmp/gkfs_proxy.log";
 
 constexpr auto client_log_level = "info,errors,critical,hermes";
 constexpr auto daemon_log_level = 4; // info
+constexpr auto proxy_log_level = 4;  // info
+
+// ring buffer size in bytes (power of two) of the client's asynchronous
+// logging. Messages are dropped while it is full
+constexpr auto client_async_buffer_size = 8 * 1024 * 1024;
+// maximum time (< 1s) messages wait in the buffer before they are written
+constexpr auto client_async_flush_interval_ms = 50;
 } // namespace log
 
 namespace metadata {
@@ -84,16 +108,82 @@ constexpr auto implicit_data_removal = true;
 // Check for existence of file metadata before create. This done on RocksDB
 // level
 constexpr auto create_exist_check = true;
+/*
+ * New files and directories inherit the chunk size of their parent directory.
+ * This requires the parent's metadata which is already fetched if
+ * CREATE_CHECK_PARENTS is enabled. Otherwise, an additional stat RPC is issued
+ * per create unless this is set to false, in which case the default chunk size
+ * is used.
+ */
+constexpr auto inherit_chunksize = true;
+/*
+ * O_APPEND offsets are reserved from an in-memory size counter on the metadata
+ * owner. The counter is merged into the KV store after this many reservations
+ * and additionally on stat, fsync/close, truncate, and daemon shutdown.
+ */
+constexpr auto append_flush_interval = 64;
+// Number of independently locked shards of the in-memory metadata backend
+constexpr auto memory_shards = 64;
+// name of the in-memory metadata backend's snapshot file within its directory
+constexpr auto memory_snapshot_file = "snapshot";
 } // namespace metadata
 namespace data {
 // directory name below rootdir where chunks are placed
 constexpr auto chunk_dir = "chunks";
+/*
+ * With LIBGKFS_DATA_LOCALITY, new files store all chunks on the daemon of the
+ * creating client's node as long as that daemon has at least this fraction of
+ * its chunk space free. Otherwise, the distributor places the chunks.
+ */
+constexpr auto locality_min_free_ratio = 0.1;
+// time in milliseconds for which the local daemon's free space is cached
+constexpr auto locality_stat_ttl = 1000;
+/*
+ * Maximum number of files for which a daemon keeps an in-memory index of their
+ * chunk files. Truncating an indexed file removes its chunks without scanning
+ * the chunk directory. Files beyond this limit fall back to a directory scan.
+ */
+constexpr auto chunk_index_max_files = 100000;
+/*
+ * Maximum number of chunk ids indexed per file and in total. A file exceeding
+ * either limit drops its chunk ids and falls back to a directory scan, which
+ * bounds the index memory to a few dozen MiB.
+ */
+constexpr auto chunk_index_max_file_chunks = 64 * 1024;
+constexpr auto chunk_index_max_chunks = 1024 * 1024;
 } // namespace data
 
 namespace rpc {
+// default chunk size of files whose parent directory does not set one
 constexpr auto chunksize = 524288; // in bytes (e.g., 524288 == 512KB)
+// bounds of per-file chunk sizes set via gkfs_set_chunk_size()
+constexpr auto min_chunksize = 4096;               // 4 KiB
+constexpr auto max_chunksize = 1024 * 1024 * 1024; // 1 GiB
+/*
+ * Bounds of the part of a list I/O request (gkfs_write_list(),
+ * gkfs_read_list()) sent to a single daemon. The daemon buffers its extent
+ * table and data, so larger requests are rejected with EINVAL.
+ */
+constexpr auto max_list_extents = 64 * 1024;
+constexpr auto max_list_size = 256 * 1024 * 1024; // 256 MiB
+/*
+ * Amount of source data a daemon buffers at a time while serving a server-side
+ * copy, but at least one chunk. The destination chunks of a batch are written
+ * and pushed to their owners concurrently.
+ */
+constexpr auto copy_batch_size = 64 * 1024 * 1024; // 64 MiB
+/*
+ * Number of daemons the chunks of a file are striped across if
+ * GKFS_USE_STRIPED_DISTRIBUTION is enabled. Clients, proxies, and daemons must
+ * agree on it. It is capped at the number of daemons.
+ */
+constexpr auto stripe_count = 4;
 // size of preallocated buffer to hold directory entries in rpc call
 constexpr auto dirents_buff_size = (8 * 1024 * 1024); // 8 mega
+// initial size of the buffer for a daemon's scan matches, grown on demand
+constexpr auto scan_buff_size = 64 * 1024;
+// number of scan requests sent to a daemon whose matches do not fit the buffer
+constexpr auto scan_attempts = 3;
 /*
  * Indicates the number of concurrent progress to drive I/O operations of chunk
  * files to and from local file systems The value is directly mapped to created
@@ -104,11 +194,61 @@ constexpr auto daemon_io_xstreams = 8;
 constexpr auto daemon_handler_xstreams = 4;
 } // namespace rpc
 
+/*
+ * In-tree I/O scheduler of the daemon, enabled with --io-scheduler. Clients
+ * share the disk by deficit round robin with the given quantum. Reads go
+ * before writes unless a write has been queued longer than the write deadline.
+ * Adjacent requests on a chunk are merged up to the maximum merge size.
+ */
+namespace scheduler {
+constexpr auto quantum = 1024 * 1024;            // in bytes per client turn
+constexpr auto write_deadline = 50;              // in milliseconds
+constexpr auto max_merge_size = 8 * 1024 * 1024; // in bytes
+// batches handed to the I/O execution streams at a time
+constexpr auto max_inflight = rpc::daemon_io_xstreams;
+} // namespace scheduler
+
+namespace proxy {
+// file in which the node-local proxy publishes its pid and RPC address
+constexpr auto pid_path = "/tmp/gkfs_proxy.pid";
+// Number of threads used for RPC handlers at the proxy
+constexpr auto handler_xstreams = 8;
+// time in milliseconds for which the proxy answers stat requests from its cache
+constexpr auto stat_cache_ttl = 1000;
+// maximum number of cached stat entries before expired entries are evicted
+constexpr auto stat_cache_size = 100000;
+// slots of modification counters that paths are hashed to. Stat results are
+// not cached if their slot changed while the stat was relayed
+constexpr auto stat_generation_slots = 4096;
+/*
+ * Size of the buffer through which the proxy relays a client's read or write.
+ * Larger requests are relayed in consecutive pieces that end on chunk
+ * boundaries, bounding the proxy's memory per request.
+ */
+constexpr auto relay_buffer_size = 16 * 1024 * 1024; // 16 MiB
+} // namespace proxy
+
 namespace rocksdb {
 // Write-ahead logging of rocksdb
 constexpr auto use_write_ahead_log = false;
+// Options profiles selectable in the daemon's RocksDB config file
+constexpr auto profile_default = "default";
+constexpr auto profile_create = "create-heavy";
+constexpr auto profile_stat = "stat-heavy";
+constexpr auto profile_readdir = "readdir-heavy";
+// Profile used if the config file does not set one
+constexpr auto profile = profile_default;
+// Encode keys as (parent, name) so that a directory listing only reads the
+// directory's direct children. Must not change for an existing metadata
+// directory. Can be overridden in the daemon's RocksDB config file
+constexpr auto use_parent_keys = false;
 } // namespace rocksdb
 
+namespace tracing {
+// spans kept per thread if tracing is enabled. Older spans are overwritten
+constexpr auto ring_size = 8192;
+} // namespace tracing
+
 namespace stats {
 constexpr auto max_stats = 1000000; ///< How many stats will be stored
 constexpr auto prometheus_gateway = "127.0.0.1:9091";
@@ -38,9 +38,14 @@
 #include <limits>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <system_error>
+#include <unordered_map>
 
 /* Forward declarations */
+struct iovec;
+
 namespace spdlog {
 class logger;
 }
@@ -71,7 +76,27 @@ private:
     std::shared_ptr<spdlog::logger> log_; //!< Class logger
 
     std::string root_path_; //!< Path to GekkoFS root directory
-    size_t chunksize_; //!< File system chunksize. TODO Why does that exist?
+    size_t chunksize_; //!< Default chunk size, used for statfs accounting
+    bool preallocate_; //!< Reserve full chunksize for new chunk files
+
+    /**
+     * @brief Chunk files of a GekkoFS file stored on this daemon. The set is
+     * only complete if this daemon instance created the file's chunk directory
+     * and the file stayed within the index limits. Otherwise, chunks may exist
+     * on disk that the index does not know of.
+     */
+    struct ChunkIndex {
+        bool complete;
+        std::set<gkfs::rpc::chnk_id_t> chunks;
+    };
+
+    mutable std::mutex chunk_index_mutex_; //!< Protects chunk_index_
+    /// Per-file chunk index, lets truncate avoid chunk directory scans
+    mutable std::unordered_map<std::string, ChunkIndex> chunk_index_;
+    /// Number of chunk ids in all chunk index entries
+    mutable size_t chunk_index_size_{0};
+    /// Incremented whenever chunk directories are removed
+    mutable uint64_t chunk_index_epoch_{0};
 
     /**
      * @brief Converts an internal gkfs path under the root dir to the absolute
@@ -109,14 +134,44 @@ private:
     void
     init_chunk_space(const std::string& file_path) const;
 
+    /**
+     * @brief Stores the path of a GekkoFS file with its new chunk directory.
+     * @param chunk_dir Absolute chunk directory path
+     * @param file_path Chunk file path, e.g., /foo/bar
+     */
+    void
+    tag_chunk_space(const std::string& chunk_dir,
+                    const std::string& file_path) const;
+
+    /**
+     * @brief Removes a file from the chunk index. chunk_index_mutex_ must be
+     * held.
+     * @param it Chunk index entry of the file
+     * @return Iterator following the removed entry
+     */
+    std::unordered_map<std::string, ChunkIndex>::iterator
+    drop_chunk_index(std::unordered_map<std::string, ChunkIndex>::iterator it)
+            const;
+
+    /**
+     * @brief Records a chunk file in the chunk index of its GekkoFS file.
+     * @param file_path Chunk file path, e.g., /foo/bar
+     * @param chunk_id Number of chunk id
+     */
+    void
+    index_chunk(const std::string& file_path,
+                gkfs::rpc::chnk_id_t chunk_id) const;
+
 public:
     /**
      * @brief Initializes the ChunkStorage object on daemon launch.
      * @param path Root directory where all data is placed on the local FS.
      * @param chunksize Used chunksize in this GekkoFS instance.
+     * @param preallocate Reserve the full chunksize when a chunk file is
+     * created to reduce fragmentation of the node-local file system.
      * @throws ChunkStorageException on launch failure
      */
-    ChunkStorage(std::string& path, size_t chunksize);
+    ChunkStorage(std::string& path, size_t chunksize, bool preallocate = false);
 
     /**
      * @brief Removes chunk directory with all its files which is a recursive
@@ -127,6 +182,17 @@ public:
     void
     destroy_chunk_space(const std::string& file_path) const;
 
+    /**
+     * @brief Returns all GekkoFS files below a directory, i.e., in its subtree,
+     * which have a chunk directory on this daemon and drops them from the chunk
+     * index. The files are then removed with destroy_chunk_space().
+     * @param dir Directory path, e.g., /foo
+     * @return File paths, e.g., /foo/bar
+     * @throws ChunkStorageException
+     */
+    std::vector<std::string>
+    detach_chunk_spaces(const std::string& dir) const;
+
     /**
      * @brief Writes a single chunk file and is usually called by an Argobots
      * tasklet.
@@ -135,12 +201,32 @@ public:
      * @param buf Buffer to write to chunk
      * @param size Amount of bytes to write to the chunk file
      * @param offset Offset where to write to the chunk file
+     * @param chunk_size Chunk size of the file, reserved on preallocation
      * @return The amount of bytes written
      * @throws ChunkStorageException with its error code
      */
     ssize_t
     write_chunk(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id,
-                const char* buf, size_t size, off64_t offset) const;
+                const char* buf, size_t size, off64_t offset,
+                size_t chunk_size) const;
+
+    /**
+     * @brief Writes a contiguous range of a single chunk file from multiple
+     * buffers with one vectored write. Used by the I/O scheduler for merged
+     * requests.
+     * @param file_path Chunk file path, e.g., /foo/bar
+     * @param chunk_id Number of chunk id
+     * @param iov Buffers to write to the chunk, in file order
+     * @param iovcnt Number of buffers
+     * @param offset Offset where to write to the chunk file
+     * @param chunk_size Chunk size of the file, reserved on preallocation
+     * @return The amount of bytes written
+     * @throws ChunkStorageException with its error code
+     */
+    ssize_t
+    writev_chunk(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id,
+                 const struct iovec* iov, int iovcnt, off64_t offset,
+                 size_t chunk_size) const;
 
     /**
      * @brief Reads a single chunk file and is usually called by an Argobots
@@ -157,6 +243,36 @@ public:
     read_chunk(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id,
                char* buf, size_t size, off64_t offset) const;
 
+    /**
+     * @brief Reads a contiguous range of a single chunk file into multiple
+     * buffers with one vectored read. Used by the I/O scheduler for merged
+     * requests.
+     * @param file_path Chunk file path, e.g., /foo/bar
+     * @param chunk_id Number of chunk id
+     * @param iov Buffers to read into, in file order
+     * @param iovcnt Number of buffers
+     * @param offset Offset where to read from the chunk file
+     * @return The amount of bytes read
+     * @throws ChunkStorageException with its error code
+     */
+    ssize_t
+    readv_chunk(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id,
+                const struct iovec* iov, int iovcnt, off64_t offset) const;
+
+    /**
+     * @brief Reserves backend storage for a range of a single chunk file,
+     * creating the chunk file if it does not exist. The chunk file size is not
+     * changed.
+     * @param file_path Chunk file path, e.g., /foo/bar
+     * @param chunk_id Number of chunk id
+     * @param offset Offset within the chunk file
+     * @param size Amount of bytes to reserve
+     * @throws ChunkStorageException with its error code
+     */
+    void
+    allocate_chunk(const std::string& file_path, gkfs::rpc::chnk_id_t chunk_id,
+                   off64_t offset, size_t size) const;
+
     /**
      * @brief Delete all chunks starting with chunk a chunk id.
      * @param file_path Chunk file path, e.g., /foo/bar
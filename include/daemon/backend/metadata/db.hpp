@@ -37,6 +37,7 @@
 #include <daemon/backend/exceptions.hpp>
 #include <tuple>
 #include <daemon/backend/metadata/metadata_backend.hpp>
+#include <daemon/backend/metadata/memory_backend.hpp>
 #ifdef GKFS_ENABLE_ROCKSDB
 #include <daemon/backend/metadata/rocksdb_backend.hpp>
 #endif
@@ -49,6 +50,7 @@ namespace gkfs::metadata {
 
 constexpr auto rocksdb_backend = "rocksdb";
 constexpr auto parallax_backend = "parallaxdb";
+constexpr auto memory_backend = "memorydb";
 
 
 class MetadataDB {
@@ -138,6 +140,17 @@ public:
     void
     decrease_size(const std::string& key, size_t size);
 
+    /**
+     * @brief Sets only the chunk size part of the metadata entry via a RocksDB
+     * Operand. The chunk size of a regular file which already has data is not
+     * changed, as its existing chunks would no longer be found.
+     * @param key KV store key
+     * @param chunk_size new chunk size for entry
+     * @throws DBException on failure, NotFoundException if entry doesn't exist
+     */
+    void
+    update_chunk_size(const std::string& key, size_t chunk_size);
+
     /**
      * @brief Return all file names and modes for the first-level entries of the
      * given directory.
@@ -160,6 +173,25 @@ public:
     [[nodiscard]] std::vector<std::tuple<std::string, bool, size_t, time_t>>
     get_dirents_extended(const std::string& dir) const;
 
+    /**
+     * @brief Calls a function for each entry below the given directory.
+     * @param dir directory path
+     * @param recursive true to visit all entries of the directory's subtree,
+     * false for its first-level entries only
+     * @param fn called with the absolute path and metadata of each entry
+     */
+    void
+    scan(const std::string& dir, bool recursive, const scan_fn& fn) const;
+
+    /**
+     * @brief Removes all entries below the given directory, i.e., its
+     * subtree. The directory's own entry is kept.
+     * @param dir directory path
+     * @throws DBException
+     */
+    void
+    remove_subtree(const std::string& dir);
+
     /**
      * @brief Iterate over complete database, note ONLY used for debugging and
      * is therefore unused.
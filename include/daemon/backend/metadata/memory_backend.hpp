@@ -0,0 +1,263 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#ifndef GEKKOFS_METADATA_MEMORYBACKEND_HPP
+#define GEKKOFS_METADATA_MEMORYBACKEND_HPP
+
+#include <memory>
+#include <spdlog/spdlog.h>
+#include <config.hpp>
+#include <daemon/backend/exceptions.hpp>
+#include <daemon/backend/metadata/metadata_backend.hpp>
+#include <common/metadata.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <tuple>
+
+namespace gkfs::metadata {
+
+/**
+ * @brief In-memory metadata backend for file system instances that live for a
+ * single job.
+ * @internal
+ * Entries are kept in ordered maps which are sharded by the entry's parent
+ * directory. Keys within a shard are encoded as (parent, name) so that all
+ * children of a directory are adjacent in one shard and a directory listing
+ * only visits them. Each shard is protected by its own reader-writer lock.
+ *
+ * Optionally, all entries are written to a snapshot file in the background
+ * at a fixed interval and on shutdown. An existing snapshot is loaded on
+ * startup.
+ * @endinternal
+ */
+class MemoryBackend : public MetadataBackend<MemoryBackend> {
+private:
+    struct shard {
+        mutable std::shared_mutex mutex;
+        std::map<std::string, std::string> entries;
+    };
+
+    std::array<shard, gkfs::config::metadata::memory_shards> shards_;
+
+    // snapshot file and background snapshot thread
+    std::string snapshot_path_;
+    std::chrono::seconds snapshot_interval_{0};
+    std::thread snapshot_thread_;
+    std::mutex snapshot_mutex_;
+    std::condition_variable snapshot_cv_;
+    bool shutdown_{false};
+
+    /**
+     * Encodes a path as a key of its parent's shard
+     * @param path absolute path without a trailing slash
+     * @return pair<shard, key>
+     */
+    std::pair<shard*, std::string>
+    locate(const std::string& path);
+
+    std::pair<const shard*, std::string>
+    locate(const std::string& path) const;
+
+    /**
+     * Returns all first-level entries of a directory
+     * @param dir directory path with a trailing slash
+     * @return vector of pair <name, metadata>
+     */
+    std::vector<std::pair<std::string, Metadata>>
+    list_directory(const std::string& dir) const;
+
+    /**
+     * Loads all entries from the snapshot file, if it exists
+     * @throws DBException if the snapshot file is corrupt
+     */
+    void
+    load_snapshot();
+
+    /**
+     * Writes all entries to the snapshot file
+     * @throws DBException if the snapshot cannot be written
+     */
+    void
+    write_snapshot() const;
+
+public:
+    /**
+     * Called when the daemon is started
+     * @param path directory for the snapshot file
+     * @param snapshot_interval interval of background snapshots in seconds.
+     * 0 disables snapshots
+     */
+    MemoryBackend(const std::string& path, unsigned int snapshot_interval);
+
+    virtual ~MemoryBackend();
+
+    /**
+     * Unused, as no KV store settings exist
+     */
+    void
+    optimize_database_impl();
+
+    /**
+     * Gets a value for a key
+     * @param key
+     * @return value
+     * @throws NotFoundException if entry doesn't exist
+     */
+    std::string
+    get_impl(const std::string& key) const;
+
+    /**
+     * Puts an entry. An existing entry is left unchanged as with the RocksDB
+     * backend's create merge operand
+     * @param key
+     * @param val
+     */
+    void
+    put_impl(const std::string& key, const std::string& val);
+
+    /**
+     * Puts an entry if it doesn't exist
+     * @param key
+     * @param val
+     * @throws ExistException if entry already exists
+     */
+    void
+    put_no_exist_impl(const std::string& key, const std::string& val);
+
+    /**
+     * Removes an entry
+     * @param key
+     * @throws NotFoundException if entry doesn't exist
+     */
+    void
+    remove_impl(const std::string& key);
+
+    /**
+     * checks for existence of an entry
+     * @param key
+     * @return true if exists
+     */
+    bool
+    exists_impl(const std::string& key);
+
+    /**
+     * Updates a metadentry atomically and also allows to change keys
+     * @param old_key
+     * @param new_key
+     * @param val
+     * @throws NotFoundException if entry doesn't exist
+     */
+    void
+    update_impl(const std::string& old_key, const std::string& new_key,
+                const std::string& val);
+
+    /**
+     * Updates the size on the metadata
+     * Operation. E.g., called before a write() call
+     * @param key
+     * @param size
+     * @param append
+     * @throws NotFoundException if entry doesn't exist
+     */
+    void
+    increase_size_impl(const std::string& key, size_t size, bool append);
+
+    /**
+     * Decreases the size on the metadata
+     * Operation E.g., called before a truncate() call
+     * @param key
+     * @param size
+     * @throws NotFoundException if entry doesn't exist
+     */
+    void
+    decrease_size_impl(const std::string& key, size_t size);
+
+    /**
+     * Sets the chunk size on the metadata unless the entry is a regular file
+     * which already has data
+     * @param key
+     * @param chunk_size
+     * @throws NotFoundException if entry doesn't exist
+     */
+    void
+    update_chunk_size_impl(const std::string& key, size_t chunk_size);
+
+    /**
+     * Return all the first-level entries of the directory @dir
+     *
+     * @return vector of pair <std::string name, bool is_dir>,
+     *         where name is the name of the entries and is_dir
+     *         is true in the case the entry is a directory.
+     */
+    std::vector<std::pair<std::string, bool>>
+    get_dirents_impl(const std::string& dir) const;
+
+    /**
+     * Return all the first-level entries of the directory @dir
+     *
+     * @return vector of pair <std::string name, bool is_dir - size - ctime>,
+     *         where name is the name of the entries and is_dir
+     *         is true in the case the entry is a directory.
+     */
+    std::vector<std::tuple<std::string, bool, size_t, time_t>>
+    get_dirents_extended_impl(const std::string& dir) const;
+
+    /**
+     * Calls a function for each entry below the directory @dir, i.e., its
+     * first-level entries or, if recursive, all entries of its subtree
+     * @param dir directory with a trailing slash
+     * @param recursive true to visit the whole subtree
+     * @param fn called with the absolute path and metadata of each entry
+     */
+    void
+    scan_impl(const std::string& dir, bool recursive, const scan_fn& fn) const;
+
+    /**
+     * Removes all entries below the directory @dir, i.e., its subtree
+     * @param dir directory with a trailing slash
+     */
+    void
+    remove_subtree_impl(const std::string& dir);
+
+    /**
+     * Code example for iterating all entries. This is for debug only as it is
+     * too expensive
+     */
+    void
+    iterate_all_impl() const;
+};
+
+} // namespace gkfs::metadata
+
+#endif // GEKKOFS_METADATA_MEMORYBACKEND_HPP
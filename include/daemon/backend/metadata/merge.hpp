@@ -40,7 +40,8 @@ namespace gkfs::metadata {
 enum class OperandID : char {
     increase_size = 'i',
     decrease_size = 'd',
-    create = 'c'
+    create = 'c',
+    chunk_size = 's'
 };
 
 class MergeOperand {
@@ -115,6 +116,21 @@ public:
     serialize_params() const override;
 };
 
+class ChunkSizeOperand : public MergeOperand {
+public:
+    size_t chunk_size;
+
+    explicit ChunkSizeOperand(size_t chunk_size);
+
+    explicit ChunkSizeOperand(const rdb::Slice& serialized_op);
+
+    OperandID
+    id() const override;
+
+    std::string
+    serialize_params() const override;
+};
+
 class MetadataMergeOperator : public rocksdb::MergeOperator {
 public:
     ~MetadataMergeOperator() override = default;
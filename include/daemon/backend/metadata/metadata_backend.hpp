@@ -32,10 +32,14 @@
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <daemon/backend/exceptions.hpp>
+#include <common/metadata.hpp>
+#include <functional>
 #include <tuple>
 
 namespace gkfs::metadata {
 
+/// called by scan() with the absolute path and metadata of each entry
+using scan_fn = std::function<void(const std::string&, const Metadata&)>;
 
 class AbstractMetadataBackend {
 public:
@@ -66,12 +70,21 @@ public:
     virtual void
     decrease_size(const std::string& key, size_t size) = 0;
 
+    virtual void
+    update_chunk_size(const std::string& key, size_t chunk_size) = 0;
+
     virtual std::vector<std::pair<std::string, bool>>
     get_dirents(const std::string& dir) const = 0;
 
     virtual std::vector<std::tuple<std::string, bool, size_t, time_t>>
     get_dirents_extended(const std::string& dir) const = 0;
 
+    virtual void
+    scan(const std::string& dir, bool recursive, const scan_fn& fn) const = 0;
+
+    virtual void
+    remove_subtree(const std::string& dir) = 0;
+
     virtual void
     iterate_all() const = 0;
 };
@@ -124,6 +137,11 @@ public:
         static_cast<T&>(*this).decrease_size_impl(key, size);
     }
 
+    void
+    update_chunk_size(const std::string& key, size_t chunk_size) {
+        static_cast<T&>(*this).update_chunk_size_impl(key, chunk_size);
+    }
+
     std::vector<std::pair<std::string, bool>>
     get_dirents(const std::string& dir) const {
         return static_cast<T const&>(*this).get_dirents_impl(dir);
@@ -134,6 +152,16 @@ public:
         return static_cast<T const&>(*this).get_dirents_extended_impl(dir);
     }
 
+    void
+    scan(const std::string& dir, bool recursive, const scan_fn& fn) const {
+        static_cast<T const&>(*this).scan_impl(dir, recursive, fn);
+    }
+
+    void
+    remove_subtree(const std::string& dir) {
+        static_cast<T&>(*this).remove_subtree_impl(dir);
+    }
+
     void
     iterate_all() const {
         static_cast<T const&>(*this).iterate_all_impl();
@@ -162,6 +162,16 @@ public:
     void
     decrease_size_impl(const std::string& key, size_t size);
 
+    /**
+     * Sets the chunk size on the metadata unless the entry is a regular file
+     * which already has data
+     * @param key
+     * @param chunk_size
+     * @throws DBException on failure
+     */
+    void
+    update_chunk_size_impl(const std::string& key, size_t chunk_size);
+
     /**
      * Return all the first-level entries of the directory @dir
      *
@@ -182,6 +192,24 @@ public:
     std::vector<std::tuple<std::string, bool, size_t, time_t>>
     get_dirents_extended_impl(const std::string& dir) const;
 
+    /**
+     * Calls a function for each entry below the directory @dir, i.e., its
+     * first-level entries or, if recursive, all entries of its subtree
+     * @param dir directory with a trailing slash
+     * @param recursive true to visit the whole subtree
+     * @param fn called with the absolute path and metadata of each entry
+     */
+    void
+    scan_impl(const std::string& dir, bool recursive, const scan_fn& fn) const;
+
+    /**
+     * Removes all entries below the directory @dir, i.e., its subtree
+     * @param dir directory with a trailing slash
+     * @throws DBException on failure
+     */
+    void
+    remove_subtree_impl(const std::string& dir);
+
     /**
      * Code example for iterating all entries in KV store. This is for debug
      * only as it is too expensive
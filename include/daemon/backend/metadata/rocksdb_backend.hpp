@@ -48,6 +48,16 @@ private:
     std::unique_ptr<rdb::DB> db_;
     rdb::Options options_;
     rdb::WriteOptions write_opts_;
+    // keys are encoded as (parent, name) instead of the full path
+    bool parent_keys_{false};
+
+    /**
+     * Encodes a path as a KV store key
+     * @param path absolute path without a trailing slash
+     * @return key
+     */
+    std::string
+    encode_key(const std::string& path) const;
 
 public:
     explicit RocksDBBackend(const std::string& path);
@@ -147,6 +157,16 @@ public:
     void
     decrease_size_impl(const std::string& key, size_t size);
 
+    /**
+     * Sets the chunk size on the metadata unless the entry is a regular file
+     * which already has data
+     * @param key
+     * @param chunk_size
+     * @throws DBException on failure
+     */
+    void
+    update_chunk_size_impl(const std::string& key, size_t chunk_size);
+
     /**
      * Return all the first-level entries of the directory @dir
      *
@@ -167,6 +187,24 @@ public:
     std::vector<std::tuple<std::string, bool, size_t, time_t>>
     get_dirents_extended_impl(const std::string& dir) const;
 
+    /**
+     * Calls a function for each entry below the directory @dir, i.e., its
+     * first-level entries or, if recursive, all entries of its subtree
+     * @param dir directory with a trailing slash
+     * @param recursive true to visit the whole subtree
+     * @param fn called with the absolute path and metadata of each entry
+     */
+    void
+    scan_impl(const std::string& dir, bool recursive, const scan_fn& fn) const;
+
+    /**
+     * Removes all entries below the directory @dir, i.e., its subtree
+     * @param dir directory with a trailing slash
+     * @throws DBException on failure
+     */
+    void
+    remove_subtree_impl(const std::string& dir);
+
     /**
      * Code example for iterating all entries in KV store. This is for debug
      * only as it is too expensive
@@ -44,6 +44,7 @@ class MetadataDB;
 
 namespace data {
 class ChunkStorage;
+class IoScheduler;
 }
 
 /* Forward declarations */
@@ -76,12 +77,22 @@ private:
     // Database
     std::shared_ptr<gkfs::metadata::MetadataDB> mdb_;
     std::string dbbackend_;
+    std::string dbconfig_{};
 
     // Parallax
     unsigned long long parallax_size_md_ = 8589934592ull;
 
+    // In-memory metadata snapshot interval in seconds (0 = no snapshots)
+    unsigned int memorydb_snapshot_interval_ = 0;
+
     // Storage backend
     std::shared_ptr<gkfs::data::ChunkStorage> storage_;
+    bool preallocate_chunks_ = false;
+    // weight for the weighted distributor (0 = chunk storage capacity in GiB)
+    double host_weight_ = 0.0;
+    // in-tree I/O scheduler, chunk I/O goes directly to the I/O pool if unset
+    bool use_io_scheduler_ = false;
+    std::shared_ptr<gkfs::data::IoScheduler> io_scheduler_;
 
     // configurable metadata
     bool atime_state_;
@@ -150,6 +161,12 @@ public:
     void
     dbbackend(const std::string& dbbackend_);
 
+    const std::string&
+    dbconfig() const;
+
+    void
+    dbconfig(const std::string& dbconfig);
+
     const std::shared_ptr<gkfs::metadata::MetadataDB>&
     mdb() const;
 
@@ -165,6 +182,24 @@ public:
     void
     storage(const std::shared_ptr<gkfs::data::ChunkStorage>& storage);
 
+    bool
+    preallocate_chunks() const;
+
+    void
+    preallocate_chunks(bool preallocate_chunks);
+
+    bool
+    use_io_scheduler() const;
+
+    void
+    use_io_scheduler(bool use_io_scheduler);
+
+    const std::shared_ptr<gkfs::data::IoScheduler>&
+    io_scheduler() const;
+
+    void
+    io_scheduler(const std::shared_ptr<gkfs::data::IoScheduler>& io_scheduler);
+
     const std::string&
     rpc_protocol() const;
 
@@ -225,6 +260,18 @@ public:
     void
     parallax_size_md(unsigned int size_md);
 
+    double
+    host_weight() const;
+
+    void
+    host_weight(double host_weight);
+
+    unsigned int
+    memorydb_snapshot_interval() const;
+
+    void
+    memorydb_snapshot_interval(unsigned int interval);
+
     const std::shared_ptr<gkfs::utils::Stats>&
     stats() const;
 
@@ -31,6 +31,8 @@
 
 #include <daemon/daemon.hpp>
 
+#include <mutex>
+
 namespace gkfs {
 
 /* Forward declarations */
@@ -56,6 +58,10 @@ private:
     std::string self_addr_str_;
     // Distributor
     std::shared_ptr<gkfs::rpc::Distributor> distributor_;
+    // Addresses of other daemons, resolved lazily on first use and indexed by
+    // host id
+    std::vector<hg_addr_t> peer_addrs_;
+    std::mutex peer_mutex_;
 
 public:
     static RPCData*
@@ -100,6 +106,22 @@ public:
 
     void
     distributor(const std::shared_ptr<gkfs::rpc::Distributor>& distributor);
+
+    /**
+     * @brief Returns the Mercury address of another daemon, looking it up in
+     * the shared hosts file on first use.
+     * @param host_id Host id as used by the distributor
+     * @return Mercury address or HG_ADDR_NULL if it cannot be resolved
+     */
+    hg_addr_t
+    peer_addr(uint64_t host_id);
+
+    /**
+     * @brief Frees all cached peer addresses. Must be called before margo is
+     * finalized.
+     */
+    void
+    release_peer_addrs();
 };
 
 } // namespace daemon
@@ -49,15 +49,21 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_decr_size)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_remove_metadata)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_remove_subtree)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_metadentry_size)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry_size)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_set_chunk_size)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_dirents)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_dirents_extended)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_scan)
 #ifdef HAS_SYMLINKS
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_mk_symlink)
@@ -72,8 +78,16 @@ DECLARE_MARGO_RPC_HANDLER(rpc_srv_read)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_write)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_read_list)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_write_list)
+
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_truncate)
 
 DECLARE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat)
 
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_copy_data)
+
+DECLARE_MARGO_RPC_HANDLER(rpc_srv_fallocate)
+
 #endif // GKFS_DAEMON_RPC_DEFS_HPP
@@ -111,6 +111,10 @@ public:
  * Therefore, a queue per chunk could be beneficial (this has not been tested
  * yet).
  *
+ * If the daemon's I/O scheduler is enabled, write and read requests are
+ * submitted to it instead of creating tasklets directly. The scheduler signals
+ * the same eventuals.
+ *
  * Note, at this time, CRTP is only required for `cancel_all_tasks()`.
  *
  * @endinternal
@@ -125,6 +129,9 @@ protected:
     std::vector<ABT_task> abt_tasks_; //!< Tasklets operating on the file
     std::vector<ABT_eventual>
             task_eventuals_; //!< Eventuals for tasklet callbacks
+    uint64_t client_{}; //!< Client issuing the operation, for fair sharing
+    bool scheduled_{false}; //!< Requests were submitted to the I/O scheduler
+    uint64_t trace_id_{};   //!< Trace id of the I/O request, 0 if untraced
 
 public:
     /**
@@ -153,7 +160,18 @@ public:
     }
 
     /**
-     * @brief Cancels all tasks in-flight and free resources.
+     * @brief Sets the trace id under which the spans of the operation's tasks
+     * are recorded.
+     * @param trace_id Trace id of the I/O request
+     */
+    void
+    trace_id(uint64_t trace_id) {
+        trace_id_ = trace_id;
+    }
+
+    /**
+     * @brief Cancels all tasks in-flight and free resources. Requests queued in
+     * the I/O scheduler cannot be canceled and are waited for.
      */
     void
     cancel_all_tasks() {
@@ -166,6 +184,8 @@ public:
         }
         for(auto& eventual : task_eventuals_) {
             if(eventual) {
+                if(scheduled_)
+                    ABT_eventual_wait(eventual, nullptr);
                 ABT_eventual_reset(eventual);
                 ABT_eventual_free(&eventual);
             }
@@ -189,6 +209,7 @@ private:
     struct chunk_truncate_args {
         const std::string* path; //!< Path to affected chunk directory
         size_t size; //!< GekkoFS file offset (_NOT_ chunk file) to truncate to
+        size_t chunk_size;     //!< Chunk size of the file
         ABT_eventual eventual; //!< Attached eventual
     };                         //!< Struct for a truncate operation
 
@@ -215,10 +236,11 @@ public:
      * @brief Truncate request called by RPC handler function and launches a
      * non-blocking tasklet.
      * @param size GekkoFS file offset (_NOT_ chunk file) to truncate to
+     * @param chunk_size Chunk size of the file
      * @throws ChunkMetaOpException
      */
     void
-    truncate(size_t size);
+    truncate(size_t size, size_t chunk_size);
     /**
      * @brief Wait for the truncate tasklet to finish.
      * @return Error code for success (0) or failure
@@ -241,11 +263,15 @@ private:
         const char* buf;              //!< Buffer for chunk
         gkfs::rpc::chnk_id_t chnk_id; //!< chunk id that is affected
         size_t size;                  //!< size to write for chunk
+        size_t chunk_size;            //!< Chunk size of the file
         off64_t off;                  //!< offset for individual chunk
         ABT_eventual eventual;        //!< Attached eventual
+        uint64_t trace_id;            //!< Trace id of the I/O request
+        uint64_t enqueue_ns;          //!< Tasklet creation time if traced
     };                                //!< Struct for an chunk write operation
 
     std::vector<struct chunk_write_args> task_args_; //!< tasklet input structs
+    size_t chunk_size_; //!< Chunk size of the file
     /**
      * @brief Exclusively used by the Argobots tasklet.
      * @param _arg Pointer to input struct of type <chunk_write_args>. Error
@@ -260,7 +286,8 @@ private:
     clear_task_args();
 
 public:
-    ChunkWriteOperation(const std::string& path, size_t n);
+    ChunkWriteOperation(const std::string& path, size_t n, size_t chunk_size,
+                        uint64_t client = 0);
 
     ~ChunkWriteOperation() = default;
 
@@ -302,6 +329,8 @@ private:
         size_t size;                  //!< size to read from chunk
         off64_t off;                  //!< offset for individual chunk
         ABT_eventual eventual;        //!< Attached eventual
+        uint64_t trace_id;            //!< Trace id of the I/O request
+        uint64_t enqueue_ns;          //!< Tasklet creation time if traced
     };                                //!< Struct for an chunk read operation
 
     std::vector<struct chunk_read_args> task_args_; //!< tasklet input structs
@@ -329,7 +358,7 @@ public:
         std::vector<uint64_t>* chunk_ids;    //!< all chunk ids in this read
     }; //!< Struct to push read data to the client
 
-    ChunkReadOperation(const std::string& path, size_t n);
+    ChunkReadOperation(const std::string& path, size_t n, uint64_t client = 0);
 
     ~ChunkReadOperation() = default;
 
@@ -355,6 +384,139 @@ public:
      */
     std::pair<int, size_t>
     wait_for_tasks_and_push_back(const bulk_args& args);
+
+    /**
+     * @brief Waits for all local I/O operations to finish for reads that stay
+     * within the daemon, e.g., the source chunks of a server-side copy.
+     * Missing chunk files are sparse regions and not an error.
+     * @return Pair for error code for success (0) or failure and read size
+     */
+    std::pair<int, size_t>
+    wait_for_tasks();
+};
+
+/**
+ * @brief Chunk operation class for removing the chunk directories of all files
+ * in a directory's subtree. The files are split among up to
+ * daemon_io_xstreams tasks which remove them in parallel.
+ */
+class ChunkRemoveSubtreeOperation
+    : public ChunkOperation<ChunkRemoveSubtreeOperation> {
+    friend class ChunkOperation<ChunkRemoveSubtreeOperation>;
+
+private:
+    struct chunk_remove_args {
+        const std::vector<std::string>* files; //!< Files of all tasks
+        size_t begin;          //!< First file removed by this task
+        size_t end;            //!< One past the last file of this task
+        ABT_eventual eventual; //!< Attached eventual
+    };                         //!< Struct for a chunk remove operation
+
+    std::vector<std::string> files_; //!< Files whose chunks are removed
+    std::vector<struct chunk_remove_args> task_args_; //!< tasklet input structs
+    /**
+     * @brief Exclusively used by the Argobots tasklet.
+     * @param _arg Pointer to input struct of type <chunk_remove_args>. Error
+     * code<int> is placed into eventual to signal its failure or success.
+     */
+    static void
+    remove_abt(void* _arg);
+    /**
+     * @brief Resets the task_arg_ struct.
+     */
+    void
+    clear_task_args();
+
+public:
+    /**
+     * @param path Directory whose subtree is removed
+     * @param files Files with chunk directories on this daemon, see
+     * ChunkStorage::detach_chunk_spaces()
+     */
+    ChunkRemoveSubtreeOperation(const std::string& path,
+                                std::vector<std::string> files);
+
+    ~ChunkRemoveSubtreeOperation() = default;
+
+    /**
+     * @brief Remove request called by RPC handler function and launches
+     * non-blocking tasklets.
+     * @throws ChunkMetaOpException
+     */
+    void
+    remove();
+
+    /**
+     * @brief Wait for all remove tasklets to finish.
+     * @return Error code for success (0) or failure
+     */
+    int
+    wait_for_tasks();
+};
+
+/**
+ * @brief Chunk operation class for fallocate operations, reserving backend
+ * storage for a byte range of a file. The chunks are split among up to
+ * daemon_io_xstreams tasks which allocate them in parallel.
+ */
+class ChunkAllocateOperation : public ChunkOperation<ChunkAllocateOperation> {
+    friend class ChunkOperation<ChunkAllocateOperation>;
+
+private:
+    struct chunk_allocate_args {
+        const ChunkAllocateOperation* op; //!< Operation owning the chunks
+        size_t begin;                     //!< First chunk of this task
+        size_t end;            //!< One past the last chunk of this task
+        ABT_eventual eventual; //!< Attached eventual
+    };                         //!< Struct for a chunk allocate operation
+
+    std::vector<gkfs::rpc::chnk_id_t> chnk_ids_; //!< Chunks on this daemon
+    uint64_t offset_;    //!< GekkoFS file offset of the range
+    uint64_t length_;    //!< Length of the range
+    size_t chunk_size_;  //!< Chunk size of the file
+    std::vector<struct chunk_allocate_args>
+            task_args_; //!< tasklet input structs
+    /**
+     * @brief Exclusively used by the Argobots tasklet.
+     * @param _arg Pointer to input struct of type <chunk_allocate_args>. Error
+     * code<int> is placed into eventual to signal its failure or success.
+     */
+    static void
+    allocate_abt(void* _arg);
+    /**
+     * @brief Resets the task_arg_ struct.
+     */
+    void
+    clear_task_args();
+
+public:
+    /**
+     * @param path Path to chunk directory
+     * @param chnk_ids Chunks of the range that are stored on this daemon
+     * @param offset GekkoFS file offset (_NOT_ chunk file) of the range
+     * @param length Length of the range
+     * @param chunk_size Chunk size of the file
+     */
+    ChunkAllocateOperation(const std::string& path,
+                           std::vector<gkfs::rpc::chnk_id_t> chnk_ids,
+                           uint64_t offset, uint64_t length, size_t chunk_size);
+
+    ~ChunkAllocateOperation() = default;
+
+    /**
+     * @brief Allocate request called by RPC handler function and launches
+     * non-blocking tasklets.
+     * @throws ChunkMetaOpException
+     */
+    void
+    allocate();
+
+    /**
+     * @brief Wait for all allocate tasklets to finish.
+     * @return Error code for success (0) or failure
+     */
+    int
+    wait_for_tasks();
 };
 
 } // namespace gkfs::data
@@ -31,6 +31,7 @@
 
 #include <daemon/daemon.hpp>
 #include <common/metadata.hpp>
+#include <daemon/backend/metadata/metadata_backend.hpp>
 
 namespace gkfs::metadata {
 
@@ -49,18 +50,33 @@ get_dirents(const std::string& dir);
 std::vector<std::tuple<std::string, bool, size_t, time_t>>
 get_dirents_extended(const std::string& dir);
 
+void
+scan(const std::string& dir, bool recursive, const scan_fn& fn);
+
 void
 create(const std::string& path, Metadata& md);
 
 void
 update(const std::string& path, Metadata& md);
 
-void
+size_t
 update_size(const std::string& path, size_t io_size, off_t offset, bool append);
 
+void
+decrease_size(const std::string& path, size_t length);
+
+void
+set_chunk_size(const std::string& path, size_t chunk_size);
+
+void
+flush_sizes();
+
 void
 remove(const std::string& path);
 
+void
+remove_subtree(const std::string& dir);
+
 } // namespace gkfs::metadata
 
 #endif // GEKKOFS_METADENTRY_HPP
@@ -0,0 +1,168 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief Request queue of the daemon's in-tree I/O scheduler. It decides which
+ * chunk I/O requests are issued next and is independent of Argobots.
+ */
+
+#ifndef GEKKOFS_DAEMON_IO_QUEUE_HPP
+#define GEKKOFS_DAEMON_IO_QUEUE_HPP
+
+#include <common/common_defs.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace gkfs::data {
+
+enum class IoOp { read, write };
+
+/**
+ * @brief A single chunk I/O request as issued by a chunk operation.
+ */
+struct IoRequest {
+    IoOp op;                       //!< Read or write
+    uint64_t client;               //!< Client the request is fair-shared by
+    const std::string* path;       //!< GekkoFS file path
+    gkfs::rpc::chnk_id_t chnk_id;  //!< Chunk id within the file
+    char* buf;                     //!< Buffer to read to or write from
+    size_t size;                   //!< Bytes to transfer
+    off64_t off;                   //!< Offset within the chunk file
+    size_t chunk_size;             //!< Chunk size of the file
+    void* completion;              //!< Opaque handle signaled on completion
+    //! Enqueue time, checked against the write deadline
+    std::chrono::steady_clock::time_point arrival;
+    uint64_t trace_id{}; //!< Trace id of the I/O request, 0 if untraced
+};
+
+/**
+ * @brief Queues chunk I/O requests per client and per file and hands them out
+ * in batches of merged requests.
+ *
+ * This class is not thread-safe.
+ * @internal
+ * Clients share the disk by deficit round robin: each turn a client is granted
+ * a quantum of bytes and is served until its deficit is spent. Within a
+ * client, its files are visited round robin. Reads are served before writes
+ * unless the oldest queued write of the client has waited longer than the
+ * write deadline, which prevents writes from starving under read load.
+ *
+ * A batch starts with the oldest request of the selected file queue and adds
+ * requests on the same chunk that continue it without a gap, up to the maximum
+ * merge size. Writes only merge with the requests directly behind them so that
+ * overlapping writes stay in order. Reads are not ordered among each other and
+ * merge with any adjacent read of the file.
+ * @endinternal
+ */
+class IoQueue {
+private:
+    struct FileQueue {
+        std::deque<IoRequest> reads;
+        std::deque<IoRequest> writes;
+    };
+
+    struct ClientQueue {
+        std::map<std::string, FileQueue> files; //!< Per-file queues
+        std::string last_file{};                //!< Round robin position
+        int64_t deficit{};                      //!< Bytes left in this turn
+    };
+
+    std::unordered_map<uint64_t, ClientQueue> clients_;
+    std::deque<uint64_t> active_; //!< Round robin order of queued clients
+    size_t size_{};               //!< Number of queued requests
+
+    size_t quantum_;
+    std::chrono::milliseconds write_deadline_;
+    size_t max_merge_size_;
+
+    /**
+     * @brief Selects the file queue a client is served from next.
+     * @param client Client queue
+     * @param now Current time to check write deadlines against
+     * @return File queue and whether its writes are served
+     */
+    std::pair<std::map<std::string, FileQueue>::iterator, bool>
+    select(ClientQueue& client,
+           std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Removes the next batch of merged requests from a queue.
+     * @param queue Read or write queue of a file
+     * @param is_write Whether queue holds writes
+     * @return Requests in file order
+     */
+    std::vector<IoRequest>
+    take(std::deque<IoRequest>& queue, bool is_write) const;
+
+public:
+    /**
+     * @brief Creates an empty queue.
+     * @param quantum Bytes a client may issue per round robin turn
+     * @param write_deadline Wait time after which writes go before reads
+     * @param max_merge_size Maximum bytes of a batch of merged requests
+     */
+    IoQueue(size_t quantum, std::chrono::milliseconds write_deadline,
+            size_t max_merge_size);
+
+    /**
+     * @brief Queues a request.
+     * @param req Request, its arrival time is used for the write deadline
+     */
+    void
+    push(IoRequest req);
+
+    /**
+     * @brief Removes the next batch of requests to issue.
+     * @param now Current time to check write deadlines against
+     * @return Requests on a contiguous range of one chunk, in file order. Empty
+     * if no request is queued.
+     */
+    std::vector<IoRequest>
+    pop(std::chrono::steady_clock::time_point now =
+                std::chrono::steady_clock::now());
+
+    /**
+     * @brief Number of queued requests.
+     */
+    [[nodiscard]] size_t
+    size() const;
+
+    [[nodiscard]] bool
+    empty() const;
+};
+
+} // namespace gkfs::data
+
+#endif // GEKKOFS_DAEMON_IO_QUEUE_HPP
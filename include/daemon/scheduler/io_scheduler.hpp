@@ -0,0 +1,109 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief In-tree I/O scheduler of the daemon which orders chunk I/O between
+ * the RPC handlers and the chunk storage.
+ */
+
+#ifndef GEKKOFS_DAEMON_IO_SCHEDULER_HPP
+#define GEKKOFS_DAEMON_IO_SCHEDULER_HPP
+
+#include <daemon/scheduler/io_queue.hpp>
+
+#include <mutex>
+#include <vector>
+
+extern "C" {
+#include <abt.h>
+}
+
+namespace gkfs::data {
+
+/**
+ * @brief Schedules chunk I/O requests onto the Argobots I/O pool.
+ * @internal
+ * Without the scheduler, each chunk request becomes a tasklet in the FIFO I/O
+ * pool right away. With it, chunk operations submit their requests to an
+ * IoQueue and at most max_inflight batches are handed to the I/O pool at a
+ * time, so that the queue, not the pool, decides the order. Each batch is one
+ * (vectored) read or write on a single chunk file. When a batch finishes, its
+ * tasklet signals the eventual of every request in it and dispatches the next
+ * batches.
+ *
+ * Requests whose batch cannot be started are completed with EIO.
+ * @endinternal
+ */
+class IoScheduler {
+private:
+    struct Batch {
+        IoScheduler* scheduler;
+        std::vector<IoRequest> requests;
+    };
+
+    IoQueue queue_;
+    std::mutex mutex_; //!< Protects queue_ and inflight_
+    unsigned int inflight_{};
+    unsigned int max_inflight_;
+    ABT_pool pool_;
+
+    /**
+     * @brief Hands batches to the I/O pool while below max_inflight.
+     * @param lock Held lock of mutex_, released while creating tasklets
+     */
+    void
+    dispatch(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @brief Exclusively used by the Argobots tasklet. Runs a batch against
+     * the chunk storage and signals its requests.
+     * @param _arg Pointer to a Batch, which is freed
+     */
+    static void
+    run_batch(void* _arg);
+
+public:
+    /**
+     * @brief Creates a scheduler issuing I/O to an Argobots pool.
+     * @param pool I/O pool driven by the daemon's I/O execution streams
+     * @param max_inflight Maximum number of batches in the pool
+     */
+    IoScheduler(ABT_pool pool, unsigned int max_inflight);
+
+    /**
+     * @brief Queues a chunk request. Its completion handle must be an
+     * ABT_eventual of size ssize_t which is set to the transferred bytes or the
+     * negative error code.
+     * @param req Chunk request, its arrival time is set here
+     */
+    void
+    submit(IoRequest req);
+};
+
+} // namespace gkfs::data
+
+#endif // GEKKOFS_DAEMON_IO_SCHEDULER_HPP
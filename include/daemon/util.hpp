@@ -32,6 +32,9 @@
 #ifndef GEKKOFS_DAEMON_UTIL_HPP
 #define GEKKOFS_DAEMON_UTIL_HPP
 
+#include <string>
+#include <vector>
+
 namespace gkfs::utils {
 /**
  * @brief Registers the daemon's RPC address to the shared hosts file.
@@ -45,6 +48,15 @@ populate_hosts_file();
  */
 void
 destroy_hosts_file();
+
+/**
+ * @brief Reads the RPC addresses of all daemons from the shared hosts file.
+ * @param weights[out] if given, the daemons' weights in the same order
+ * @return Addresses ordered by host id, i.e., in the order used by clients
+ * @throws std::runtime_error when the file cannot be read or is malformed
+ */
+std::vector<std::string>
+read_hosts_file(std::vector<double>* weights = nullptr);
 } // namespace gkfs::utils
 
 #endif // GEKKOFS_DAEMON_UTIL_HPP
@@ -0,0 +1,58 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief The main header file defining singletons and including needed headers
+ * in the node-local proxy.
+ */
+#ifndef GKFS_PROXY_PROXY_HPP
+#define GKFS_PROXY_PROXY_HPP
+
+// std libs
+#include <string>
+#include <spdlog/spdlog.h>
+
+#include <config.hpp>
+#include <common/common_defs.hpp>
+// margo
+extern "C" {
+#include <abt.h>
+#include <mercury.h>
+#include <margo.h>
+}
+
+#include <proxy/proxy_data.hpp>
+#include <common/rpc/distributor.hpp>
+
+#define PROXY_DATA                                                             \
+    (static_cast<gkfs::proxy::ProxyData*>(                                     \
+            gkfs::proxy::ProxyData::getInstance())) ///< PROXY_DATA macro to
+                                                    ///< access the ProxyData
+                                                    ///< singleton across the
+                                                    ///< proxy
+
+#endif // GKFS_PROXY_PROXY_HPP
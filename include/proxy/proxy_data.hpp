@@ -0,0 +1,246 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief Singleton holding the state of the node-local proxy.
+ */
+#ifndef GKFS_PROXY_PROXY_DATA_HPP
+#define GKFS_PROXY_PROXY_DATA_HPP
+
+#include <proxy/proxy.hpp>
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace gkfs {
+
+/* Forward declarations */
+namespace rpc {
+class Distributor;
+}
+
+namespace proxy {
+
+class ProxyData {
+
+private:
+    ProxyData() {}
+
+    // logger
+    std::shared_ptr<spdlog::logger> spdlogger_;
+
+    // Margo instance serving the clients and forwarding to the daemons
+    margo_instance_id server_rpc_mid_;
+    std::string rpc_protocol_;
+    std::string bind_addr_;
+    bool use_auto_sm_{true};
+    std::string self_addr_str_;
+    std::string hosts_file_;
+    std::string pid_file_;
+
+    // Daemon URIs and their addresses, resolved lazily on first use and
+    // indexed by host id
+    std::vector<std::string> host_uris_;
+    std::vector<double> host_weights_;
+    std::vector<hg_addr_t> host_addrs_;
+    std::mutex host_mutex_;
+
+    // Same distribution as the clients and daemons
+    std::shared_ptr<gkfs::rpc::Distributor> distributor_;
+
+    // Serialized metadata of recently stat'ed paths shared by all clients
+    struct stat_entry {
+        std::string metadata;
+        std::chrono::steady_clock::time_point expiry;
+    };
+    std::unordered_map<std::string, stat_entry> stat_cache_;
+    // Modification counters of the paths hashed to each slot. Protected by
+    // stat_cache_mutex_
+    std::array<uint64_t, gkfs::config::proxy::stat_generation_slots>
+            stat_generations_{};
+    std::mutex stat_cache_mutex_;
+    std::chrono::milliseconds stat_cache_ttl_{
+            gkfs::config::proxy::stat_cache_ttl};
+
+    uint64_t&
+    stat_generation_slot(const std::string& path);
+
+public:
+    static ProxyData*
+    getInstance() {
+        static ProxyData instance;
+        return &instance;
+    }
+
+    ProxyData(ProxyData const&) = delete;
+
+    void
+    operator=(ProxyData const&) = delete;
+
+    // Getter/Setter
+
+    const std::shared_ptr<spdlog::logger>&
+    log() const;
+
+    void
+    log(const std::shared_ptr<spdlog::logger>& log);
+
+    margo_instance*
+    server_rpc_mid();
+
+    void
+    server_rpc_mid(margo_instance* server_rpc_mid);
+
+    const std::string&
+    rpc_protocol() const;
+
+    void
+    rpc_protocol(const std::string& rpc_protocol);
+
+    bool
+    use_auto_sm() const;
+
+    void
+    use_auto_sm(bool use_auto_sm);
+
+    const std::string&
+    bind_addr() const;
+
+    void
+    bind_addr(const std::string& addr);
+
+    const std::string&
+    self_addr_str() const;
+
+    void
+    self_addr_str(const std::string& addr_str);
+
+    const std::string&
+    hosts_file() const;
+
+    void
+    hosts_file(const std::string& hosts_file);
+
+    const std::string&
+    pid_file() const;
+
+    void
+    pid_file(const std::string& pid_file);
+
+    const std::vector<std::string>&
+    host_uris() const;
+
+    void
+    host_uris(const std::vector<std::string>& host_uris);
+
+    const std::vector<double>&
+    host_weights() const;
+
+    void
+    host_weights(const std::vector<double>& host_weights);
+
+    const std::shared_ptr<gkfs::rpc::Distributor>&
+    distributor() const;
+
+    void
+    distributor(const std::shared_ptr<gkfs::rpc::Distributor>& distributor);
+
+    void
+    stat_cache_ttl(std::chrono::milliseconds ttl);
+
+    /**
+     * @brief Returns the Mercury address of a daemon, looking it up on first
+     * use.
+     * @param host_id Host id as used by the distributor
+     * @return Mercury address or HG_ADDR_NULL if it cannot be resolved
+     */
+    hg_addr_t
+    host_addr(uint64_t host_id);
+
+    /**
+     * @brief Frees all cached daemon addresses. Must be called before margo
+     * is finalized.
+     */
+    void
+    release_host_addrs();
+
+    /**
+     * @brief Returns the cached serialized metadata of a path if it has not
+     * expired.
+     * @param path
+     * @return serialized metadata or std::nullopt
+     */
+    std::optional<std::string>
+    cached_stat(const std::string& path);
+
+    /**
+     * @brief Returns the modification generation of a path. It must be taken
+     * before the path's metadata is requested from its daemon and passed to
+     * cache_stat().
+     * @param path
+     * @return generation
+     */
+    uint64_t
+    stat_generation(const std::string& path);
+
+    /**
+     * @brief Caches the serialized metadata of a path for the stat cache TTL.
+     * The metadata is dropped if the path may have been modified since the
+     * generation was taken, as it could be stale.
+     * @param path
+     * @param metadata
+     * @param generation Result of stat_generation() before the request
+     */
+    void
+    cache_stat(const std::string& path, const std::string& metadata,
+               uint64_t generation);
+
+    /**
+     * @brief Drops the cached metadata of a path, e.g., after it was modified.
+     * @param path
+     */
+    void
+    invalidate_stat(const std::string& path);
+
+    /**
+     * @brief Drops the cached metadata of a directory and all paths below it,
+     * e.g., after its subtree was removed.
+     * @param dir
+     */
+    void
+    invalidate_stat_subtree(const std::string& dir);
+};
+
+} // namespace proxy
+} // namespace gkfs
+
+#endif // GKFS_PROXY_PROXY_DATA_HPP
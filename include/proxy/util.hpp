@@ -0,0 +1,71 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief Helper functions of the node-local proxy.
+ */
+
+#ifndef GEKKOFS_PROXY_UTIL_HPP
+#define GEKKOFS_PROXY_UTIL_HPP
+
+#include <proxy/proxy.hpp>
+
+#include <string>
+#include <vector>
+
+namespace gkfs::proxy {
+
+std::vector<std::string>
+read_hosts_file(std::vector<double>* weights = nullptr);
+
+void
+write_pid_file();
+
+void
+remove_pid_file();
+
+/**
+ * @brief Forwards an RPC to a daemon and waits for its output.
+ * @internal
+ * The proxy registers its handlers under the daemon's RPC names, so the RPC id
+ * of the handled request is also used for the daemon. On success, the output
+ * must be freed with margo_free_output() and the returned handle destroyed.
+ * @endinternal
+ * @param name RPC name
+ * @param host_id target daemon
+ * @param in RPC input
+ * @param out RPC output
+ * @param handle returned daemon handle
+ * @return Mercury error code. HG_SUCCESS on success.
+ */
+hg_return_t
+forward_to_daemon(const char* name, uint64_t host_id, void* in, void* out,
+                  hg_handle_t& handle);
+
+} // namespace gkfs::proxy
+
+#endif // GEKKOFS_PROXY_UTIL_HPP
@@ -37,14 +37,25 @@
 #include <client/open_dir.hpp>
 
 #include <common/path_util.hpp>
+#include <common/tracing.hpp>
 
 extern "C" {
 #include <dirent.h> // used for file types in the getdents{,64}() functions
 #include <linux/kernel.h> // used for definition of alignment macros
 #include <sys/statfs.h>
 #include <sys/statvfs.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
 }
 
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string_view>
+
 using namespace std;
 
 /*
@@ -93,12 +104,16 @@ namespace {
  * Checks if metadata for parent directory exists (can be disabled with
  * CREATE_CHECK_PARENTS). errno may be set
  * @param path
+ * @param chunk_size if not null, receives the chunk size a new object in the
+ * parent directory inherits
  * @return 0 on success, -1 on failure
  */
 int
-check_parent_dir(const std::string& path) {
-#if CREATE_CHECK_PARENTS
+check_parent_dir(const std::string& path, size_t* chunk_size = nullptr) {
     auto p_comp = gkfs::path::dirname(path);
+    if(chunk_size)
+        *chunk_size = gkfs::config::rpc::chunksize;
+#if CREATE_CHECK_PARENTS
     auto md = gkfs::utils::get_metadata(p_comp);
     if(!md) {
         if(errno == ENOENT) {
@@ -114,9 +129,409 @@ check_parent_dir(const std::string& path) {
         errno = ENOTDIR;
         return -1;
     }
+    if(chunk_size && gkfs::config::metadata::inherit_chunksize)
+        *chunk_size = md->chunk_size();
+#else
+    if(chunk_size && gkfs::config::metadata::inherit_chunksize) {
+        // a missing parent is not an error without CREATE_CHECK_PARENTS
+        auto md = gkfs::utils::get_metadata(p_comp);
+        if(md && S_ISDIR(md->mode()))
+            *chunk_size = md->chunk_size();
+    }
 #endif // CREATE_CHECK_PARENTS
     return 0;
 }
+
+/*
+ * Bookkeeping for emulated memory mappings of GekkoFS files. A mapping is
+ * backed by anonymous memory that is populated from the daemons when it is
+ * established. MAP_SHARED mappings of files opened for writing are written back
+ * on msync() and munmap() while they are writable.
+ *
+ * Only dirty pages are written back. Without write-protect faults, a page is
+ * dirty if its hash differs from the hash taken when it became writable or was
+ * last written back. The protection of each mapping is tracked through
+ * mprotect(), so that pages without read access can be hashed.
+ */
+using PageHashes = std::vector<std::atomic<size_t>>;
+
+struct MmapEntry {
+    std::string path;
+    uintptr_t addr;
+    size_t length;
+    off64_t offset; // file offset that corresponds to addr
+    int prot;       // current protection of the memory
+    bool shared;
+    bool writeback; // shared mapping of a file opened for writing
+    // page hashes of mappings that were writable, indexed from `base`. Shared
+    // by the remaining parts of a partially unmapped mapping.
+    std::shared_ptr<PageHashes> hashes;
+    uintptr_t base;
+};
+
+std::map<uintptr_t, MmapEntry> mmap_entries;
+std::mutex mmap_mutex;
+// allows munmap()/msync() on non-GekkoFS memory to skip the lock
+std::atomic<size_t> mmap_count{0};
+
+size_t
+page_size() {
+    static const auto size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+size_t
+page_align_up(size_t length) {
+    return (length + page_size() - 1) & ~(page_size() - 1);
+}
+
+size_t
+page_hash(uintptr_t page) {
+    return std::hash<std::string_view>{}(
+            std::string_view(reinterpret_cast<const char*>(page), page_size()));
+}
+
+/**
+ * Runs `fn` while a mapping slice is readable. Read access is granted
+ * temporarily if the application removed it, e.g., with PROT_NONE.
+ * errno may be set
+ * @param slice
+ * @param fn
+ * @return result of fn, or -1 if read access could not be granted
+ */
+template <typename Fn>
+int
+with_read_access(const MmapEntry& slice, Fn&& fn) {
+    if(slice.prot & PROT_READ) {
+        return fn();
+    }
+    auto mem = reinterpret_cast<void*>(slice.addr);
+    if(::mprotect(mem, slice.length, slice.prot | PROT_READ) != 0) {
+        return -1;
+    }
+    auto ret = fn();
+    auto err = errno;
+    ::mprotect(mem, slice.length, slice.prot);
+    errno = err;
+    return ret;
+}
+
+/**
+ * Takes the page hashes of a mapping slice that becomes writable, indexed from
+ * the slice's address
+ * @param slice
+ * @return page hashes
+ */
+std::shared_ptr<PageHashes>
+mmap_hash_pages(const MmapEntry& slice) {
+    auto hashes = std::make_shared<PageHashes>(slice.length / page_size());
+    with_read_access(slice, [&] {
+        for(size_t idx = 0; idx < hashes->size(); idx++)
+            (*hashes)[idx].store(page_hash(slice.addr + idx * page_size()),
+                                 std::memory_order_relaxed);
+        return 0;
+    });
+    return hashes;
+}
+
+/**
+ * Splits the mapping containing `at` so that a mapping starts at `at`.
+ * mmap_mutex must be held.
+ * @param at page-aligned address
+ */
+void
+mmap_split(uintptr_t at) {
+    auto it = mmap_entries.upper_bound(at);
+    if(it == mmap_entries.begin()) {
+        return;
+    }
+    --it;
+    auto& entry = it->second;
+    if(entry.addr == at || entry.addr + entry.length <= at) {
+        return;
+    }
+    auto tail = entry;
+    tail.addr = at;
+    tail.length = entry.addr + entry.length - at;
+    tail.offset = static_cast<off64_t>(entry.offset + (at - entry.addr));
+    entry.length = at - entry.addr;
+    mmap_entries.emplace(at, std::move(tail));
+    mmap_count++;
+}
+
+/**
+ * Collects all (partial) mappings that overlap with [addr, addr + length).
+ * The returned entries are trimmed to the overlapping range. If `remove` is
+ * set, the overlapping parts are removed from the registry and the remaining
+ * parts of partially unmapped mappings are kept.
+ * @param addr
+ * @param length
+ * @param remove
+ * @return overlapping mapping slices
+ */
+std::vector<MmapEntry>
+mmap_collect(uintptr_t addr, size_t length, bool remove) {
+    std::vector<MmapEntry> slices{};
+    if(mmap_count.load() == 0) {
+        return slices;
+    }
+    auto end = addr + length;
+    std::lock_guard<std::mutex> lock(mmap_mutex);
+    auto it = mmap_entries.upper_bound(addr);
+    if(it != mmap_entries.begin()) {
+        --it;
+    }
+    while(it != mmap_entries.end() && it->first < end) {
+        auto entry = it->second;
+        auto entry_end = entry.addr + entry.length;
+        if(entry_end <= addr) {
+            ++it;
+            continue;
+        }
+        auto slice_start = std::max(entry.addr, addr);
+        auto slice_end = std::min(entry_end, end);
+        auto slice = entry;
+        slice.addr = slice_start;
+        slice.length = slice_end - slice_start;
+        slice.offset =
+                static_cast<off64_t>(entry.offset + (slice_start - entry.addr));
+        slices.push_back(std::move(slice));
+        if(!remove) {
+            ++it;
+            continue;
+        }
+        it = mmap_entries.erase(it);
+        mmap_count--;
+        // keep the parts of the mapping that are not unmapped
+        if(entry.addr < slice_start) {
+            auto head = entry;
+            head.length = slice_start - entry.addr;
+            mmap_entries.emplace(entry.addr, std::move(head));
+            mmap_count++;
+        }
+        if(slice_end < entry_end) {
+            auto tail = entry;
+            tail.addr = slice_end;
+            tail.length = entry_end - slice_end;
+            tail.offset = static_cast<off64_t>(entry.offset +
+                                               (slice_end - entry.addr));
+            mmap_entries.emplace(slice_end, std::move(tail));
+            mmap_count++;
+        }
+    }
+    return slices;
+}
+
+/**
+ * Writes the dirty pages of a mapping slice back to the file. Contiguous dirty
+ * pages are written with a single write. Only the part of the slice that lies
+ * within the current file size is written, following the semantics of the
+ * kernel which never extends a file through a mapping. A page's hash is taken
+ * before it is written, so changes made during the write-back are found by the
+ * next one. Slices that were never writable are skipped.
+ * errno may be set
+ * @param slice
+ * @return 0 on success, -1 on failure
+ */
+int
+mmap_writeback(const MmapEntry& slice) {
+    if(!slice.writeback || !slice.hashes) {
+        return 0;
+    }
+    auto md = gkfs::utils::get_metadata(slice.path);
+    if(!md) {
+        return -1;
+    }
+    auto file_size = static_cast<off64_t>(md->size());
+    if(slice.offset >= file_size) {
+        return 0;
+    }
+    auto count = std::min(static_cast<size_t>(file_size - slice.offset),
+                          slice.length);
+    auto file = std::make_shared<gkfs::filemap::OpenFile>(slice.path, O_RDWR);
+    file->chunk_size(md->chunk_size());
+    file->data_host(md->data_host());
+
+    auto& hashes = *slice.hashes;
+    const auto end = slice.addr + count;
+    std::vector<std::pair<size_t, size_t>> run_hashes{};
+    uintptr_t run_start = 0;
+    auto flush_run = [&](uintptr_t run_end) {
+        if(run_hashes.empty())
+            return 0;
+        auto run_offset = slice.offset + (run_start - slice.addr);
+        auto run_length = std::min(run_end, end) - run_start;
+        LOG(DEBUG, "{}() writing back '{}' bytes of '{}' at offset '{}'",
+            "mmap_writeback", run_length, slice.path, run_offset);
+        auto ret = gkfs::syscall::gkfs_pwrite(
+                file, reinterpret_cast<const char*>(run_start), run_length,
+                run_offset);
+        if(ret < 0)
+            return -1;
+        for(const auto& [idx, hash] : run_hashes)
+            hashes[idx].store(hash, std::memory_order_relaxed);
+        run_hashes.clear();
+        return 0;
+    };
+    return with_read_access(slice, [&] {
+        for(auto page = slice.addr; page < end; page += page_size()) {
+            auto idx = (page - slice.base) / page_size();
+            auto hash = page_hash(page);
+            if(hash == hashes[idx].load(std::memory_order_relaxed)) {
+                if(flush_run(page) != 0)
+                    return -1;
+                continue;
+            }
+            if(run_hashes.empty())
+                run_start = page;
+            run_hashes.emplace_back(idx, hash);
+        }
+        return flush_run(end);
+    });
+}
+
+/**
+ * Writes back and forgets all emulated mappings in a range. The memory itself
+ * is not released. Write-back errors are logged only, as the mappings are
+ * gone afterwards either way.
+ * @param addr
+ * @param length
+ */
+void
+mmap_release(uintptr_t addr, size_t length) {
+    auto slices = mmap_collect(addr, page_align_up(length), true);
+    for(const auto& slice : slices) {
+        if(mmap_writeback(slice) != 0) {
+            LOG(ERROR, "{}() failed to write back mapping of '{}': {}",
+                __func__, slice.path, strerror(errno));
+        }
+    }
+}
+
+/**
+ * Copies a range between two GekkoFS files on the daemons. File data is not
+ * transferred through the client.
+ * errno may be set
+ * @param in source file
+ * @param src_off offset in the source file
+ * @param out destination file
+ * @param dst_off offset in the destination file
+ * @param len number of bytes to copy
+ * @return copied size (0 at end of the source file) or -1 on error
+ */
+ssize_t
+gkfs_copy_range(const std::shared_ptr<gkfs::filemap::OpenFile>& in,
+                off64_t src_off,
+                const std::shared_ptr<gkfs::filemap::OpenFile>& out,
+                off64_t dst_off, size_t len) {
+    if(in->type() != gkfs::filemap::FileType::regular ||
+       out->type() != gkfs::filemap::FileType::regular) {
+        errno = EISDIR;
+        return -1;
+    }
+    if(in->get_flag(gkfs::filemap::OpenFile_flags::wronly) ||
+       !(out->get_flag(gkfs::filemap::OpenFile_flags::wronly) ||
+         out->get_flag(gkfs::filemap::OpenFile_flags::rdwr))) {
+        errno = EBADF;
+        return -1;
+    }
+    if(src_off < 0 || dst_off < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    auto md = gkfs::utils::get_metadata(in->path());
+    if(!md) {
+        return -1;
+    }
+    auto file_size = static_cast<off64_t>(md->size());
+    if(len == 0 || src_off >= file_size) {
+        return 0;
+    }
+    auto count = std::min(static_cast<size_t>(file_size - src_off), len);
+    // overlapping ranges within the same file are not supported by the kernel
+    // either
+    if(in->path() == out->path() &&
+       src_off < dst_off + static_cast<off64_t>(count) &&
+       dst_off < src_off + static_cast<off64_t>(count)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(
+            out->path(), count, dst_off, false);
+    auto err = ret_update_size.first;
+    if(err) {
+        LOG(ERROR, "update_metadentry_size() failed with err '{}'", err);
+        errno = err;
+        return -1;
+    }
+    auto ret_copy = gkfs::rpc::forward_copy_data(
+            in->path(), src_off, out->path(), dst_off, count, in->chunk_size(),
+            out->chunk_size(), in->data_host(), out->data_host());
+    err = ret_copy.first;
+    if(err) {
+        LOG(WARNING, "gkfs::rpc::forward_copy_data() failed with err '{}'",
+            err);
+        errno = err;
+        return -1;
+    }
+    return ret_copy.second;
+}
+
+
+/**
+ * Validates the segment lists of a list I/O request.
+ * errno may be set
+ * @return total size of the request or -1 if the lists are invalid
+ */
+ssize_t
+list_io_size(int mem_count, const struct iovec* mem_list, int file_count,
+             const off64_t* file_offsets, const size_t* file_lengths) {
+    if(mem_count < 0 || file_count < 0 ||
+       (mem_count > 0 && mem_list == nullptr) ||
+       (file_count > 0 && (!file_offsets || !file_lengths))) {
+        errno = EINVAL;
+        return -1;
+    }
+    size_t mem_size = 0;
+    for(int i = 0; i < mem_count; ++i) {
+        mem_size += mem_list[i].iov_len;
+    }
+    size_t file_size = 0;
+    for(int i = 0; i < file_count; ++i) {
+        if(file_offsets[i] < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        file_size += file_lengths[i];
+    }
+    // the memory segments are filled in file segment order
+    if(mem_size != file_size) {
+        errno = EINVAL;
+        return -1;
+    }
+    return static_cast<ssize_t>(file_size);
+}
+
+/**
+ * Returns the open GekkoFS file for a list I/O request.
+ * errno may be set
+ * @return file or nullptr on error
+ */
+std::shared_ptr<gkfs::filemap::OpenFile>
+list_io_file(int fd) {
+    auto file = CTX->file_map()->get(fd);
+    if(!file) {
+        errno = EBADF;
+        return nullptr;
+    }
+    if(file->type() != gkfs::filemap::FileType::regular) {
+        errno = EISDIR;
+        return nullptr;
+    }
+    return file;
+}
+
 } // namespace
 
 namespace gkfs::syscall {
@@ -138,12 +553,6 @@ gkfs_open(const std::string& path, mode_t mode, int flags) {
         return -1;
     }
 
-    if(flags & O_APPEND) {
-        LOG(ERROR, "`O_APPEND` flag is not supported");
-        errno = ENOTSUP;
-        return -1;
-    }
-
     // metadata object filled during create or stat
     gkfs::metadata::Metadata md{};
     if(flags & O_CREAT) {
@@ -154,7 +563,9 @@ gkfs_open(const std::string& path, mode_t mode, int flags) {
         }
         // no access check required here. If one is using our FS they have the
         // permissions.
-        auto err = gkfs_create(path, mode | S_IFREG);
+        size_t chunk_size{};
+        int64_t data_host{-1};
+        auto err = gkfs_create(path, mode | S_IFREG, &chunk_size, &data_host);
         if(err) {
             if(errno == EEXIST) {
                 // file exists, O_CREAT was set
@@ -187,8 +598,10 @@ gkfs_open(const std::string& path, mode_t mode, int flags) {
             }
         } else {
             // file was successfully created. Add to filemap
-            return CTX->file_map()->add(
-                    std::make_shared<gkfs::filemap::OpenFile>(path, flags));
+            auto file = std::make_shared<gkfs::filemap::OpenFile>(path, flags);
+            file->chunk_size(chunk_size);
+            file->data_host(data_host);
+            return CTX->file_map()->add(file);
         }
     } else {
         auto md_ = gkfs::utils::get_metadata(path);
@@ -240,14 +653,18 @@ gkfs_open(const std::string& path, mode_t mode, int flags) {
             assert(S_ISREG(md.mode()));
 
             if((flags & O_TRUNC) && ((flags & O_RDWR) || (flags & O_WRONLY))) {
-                if(gkfs_truncate(new_path, md.size(), 0)) {
+                if(gkfs_truncate(new_path, md.size(), 0, md.chunk_size(),
+                                 md.data_host())) {
                     LOG(ERROR, "Error truncating file");
                     return -1;
                 }
             }
 
-            return CTX->file_map()->add(
-                    std::make_shared<gkfs::filemap::OpenFile>(new_path, flags));
+            auto file =
+                    std::make_shared<gkfs::filemap::OpenFile>(new_path, flags);
+            file->chunk_size(md.chunk_size());
+            file->data_host(md.data_host());
+            return CTX->file_map()->add(file);
         }
     }
 #endif // HAS_RENAME
@@ -260,14 +677,17 @@ gkfs_open(const std::string& path, mode_t mode, int flags) {
     assert(S_ISREG(md.mode()));
 
     if((flags & O_TRUNC) && ((flags & O_RDWR) || (flags & O_WRONLY))) {
-        if(gkfs_truncate(path, md.size(), 0)) {
+        if(gkfs_truncate(path, md.size(), 0, md.chunk_size(),
+                         md.data_host())) {
             LOG(ERROR, "Error truncating file");
             return -1;
         }
     }
 
-    return CTX->file_map()->add(
-            std::make_shared<gkfs::filemap::OpenFile>(path, flags));
+    auto file = std::make_shared<gkfs::filemap::OpenFile>(path, flags);
+    file->chunk_size(md.chunk_size());
+    file->data_host(md.data_host());
+    return CTX->file_map()->add(file);
 }
 
 /**
@@ -275,10 +695,13 @@ gkfs_open(const std::string& path, mode_t mode, int flags) {
  * errno may be set
  * @param path
  * @param mode
+ * @param chunk_size if not null, receives the chunk size of the new object
+ * @param data_host if not null, receives the data host of the new object
  * @return 0 on success, -1 on failure
  */
 int
-gkfs_create(const std::string& path, mode_t mode) {
+gkfs_create(const std::string& path, mode_t mode, size_t* chunk_size,
+            int64_t* data_host) {
 
     // file type must be set
     switch(mode & S_IFMT) {
@@ -301,14 +724,27 @@ gkfs_create(const std::string& path, mode_t mode) {
             return -1;
     }
 
-    if(check_parent_dir(path)) {
+    // new objects inherit the chunk size of their parent directory
+    size_t new_chunk_size{};
+    if(check_parent_dir(path, &new_chunk_size)) {
         return -1;
     }
-    auto err = gkfs::rpc::forward_create(path, mode);
+    // regular files may keep their chunks on the daemon of this node
+    int64_t new_data_host = -1;
+#ifndef GKFS_ENABLE_FORWARDING
+    if(S_ISREG(mode))
+        new_data_host = gkfs::utils::data_host_for_create();
+#endif
+    auto err = gkfs::rpc::forward_create(path, mode, new_chunk_size,
+                                         new_data_host);
     if(err) {
         errno = err;
         return -1;
     }
+    if(chunk_size)
+        *chunk_size = new_chunk_size;
+    if(data_host)
+        *data_host = new_data_host;
     return 0;
 }
 
@@ -719,10 +1155,13 @@ gkfs_lseek(shared_ptr<gkfs::filemap::OpenFile> gkfs_fd, off_t offset,
  * @param path
  * @param old_size
  * @param new_size
+ * @param chunk_size chunk size of the file
+ * @param data_host data host of the file, -1 if none
  * @return 0 on success, -1 on failure
  */
 int
-gkfs_truncate(const std::string& path, off_t old_size, off_t new_size) {
+gkfs_truncate(const std::string& path, off_t old_size, off_t new_size,
+              size_t chunk_size, int64_t data_host) {
     assert(new_size >= 0);
     assert(new_size <= old_size);
 
@@ -736,7 +1175,8 @@ gkfs_truncate(const std::string& path, off_t old_size, off_t new_size) {
         return -1;
     }
 
-    err = gkfs::rpc::forward_truncate(path, old_size, new_size);
+    err = gkfs::rpc::forward_truncate(path, old_size, new_size, chunk_size,
+                                      data_host);
     if(err) {
         LOG(DEBUG, "Failed to truncate data");
         errno = err;
@@ -793,7 +1233,8 @@ gkfs_truncate(const std::string& path, off_t length) {
             errno = EINVAL;
             return -1;
         }
-        return gkfs_truncate(new_path, size, length);
+        return gkfs_truncate(new_path, size, length, md->chunk_size(),
+                             md->data_host());
     }
 #endif
 #endif
@@ -822,7 +1263,8 @@ gkfs_truncate(const std::string& path, off_t length) {
         CTX->file_map()->remove(output_fd);
         return 0;
     }
-    return gkfs_truncate(path, size, length);
+    return gkfs_truncate(path, size, length, md->chunk_size(),
+                         md->data_host());
 }
 
 /**
@@ -849,17 +1291,22 @@ gkfs_dup2(const int oldfd, const int newfd) {
 }
 
 /**
- * Wrapper function for all gkfs write operations
+ * Wrapper function for all gkfs write operations. With O_APPEND, the offset is
+ * ignored and the metadata daemon reserves the range at the end of the file.
  * errno may be set
  * @param file
  * @param buf
  * @param count
  * @param offset
+ * @param update_pos set the file position to the end of the written range
  * @return written size or -1 on error
  */
 ssize_t
 gkfs_pwrite(std::shared_ptr<gkfs::filemap::OpenFile> file, const char* buf,
-            size_t count, off64_t offset) {
+            size_t count, off64_t offset, bool update_pos) {
+    // root span of this request, its id is forwarded to the daemons
+    gkfs::tracing::TraceContext trace_ctx;
+    gkfs::tracing::Span span("client.pwrite");
     if(file->type() != gkfs::filemap::FileType::regular) {
         assert(file->type() == gkfs::filemap::FileType::directory);
         LOG(WARNING, "Cannot read from directory");
@@ -880,13 +1327,20 @@ gkfs_pwrite(std::shared_ptr<gkfs::filemap::OpenFile> file, const char* buf,
     auto updated_size = ret_update_size.second;
 
     auto ret_write = gkfs::rpc::forward_write(*path, buf, append_flag, offset,
-                                              count, updated_size);
+                                              count, updated_size,
+                                              file->chunk_size(),
+                                              file->data_host());
     err = ret_write.first;
     if(err) {
         LOG(WARNING, "gkfs::rpc::forward_write() failed with err '{}'", err);
         errno = err;
         return -1;
     }
+    if(append_flag)
+        file->set_flag(gkfs::filemap::OpenFile_flags::appended, true);
+    if(update_pos && ret_write.second > 0) {
+        file->pos(append_flag ? updated_size : offset + ret_write.second);
+    }
     return ret_write.second; // return written size
 }
 
@@ -916,18 +1370,9 @@ gkfs_pwrite_ws(int fd, const void* buf, size_t count, off64_t offset) {
 ssize_t
 gkfs_write(int fd, const void* buf, size_t count) {
     auto gkfs_fd = CTX->file_map()->get(fd);
-    auto pos = gkfs_fd->pos(); // retrieve the current offset
-    if(gkfs_fd->get_flag(gkfs::filemap::OpenFile_flags::append)) {
-        gkfs_lseek(gkfs_fd, 0, SEEK_END);
-        pos = gkfs_fd->pos(); // Pos should be updated with append
-    }
-    auto ret = gkfs_pwrite(gkfs_fd, reinterpret_cast<const char*>(buf), count,
-                           pos);
-    // Update offset in file descriptor in the file map
-    if(ret > 0) {
-        gkfs_fd->pos(pos + count);
-    }
-    return ret;
+    // appends are placed by the metadata daemon, no lseek(SEEK_END) required
+    return gkfs_pwrite(gkfs_fd, reinterpret_cast<const char*>(buf), count,
+                       gkfs_fd->pos(), true);
 }
 
 /**
@@ -937,37 +1382,59 @@ gkfs_write(int fd, const void* buf, size_t count) {
  * @param iov
  * @param iovcnt
  * @param offset
+ * @param update_pos set the file position to the end of the written range
  * @return written size or -1 on error
  */
 ssize_t
-gkfs_pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset) {
+gkfs_pwritev(int fd, const struct iovec* iov, int iovcnt, off_t offset,
+             bool update_pos) {
+    gkfs::tracing::TraceContext trace_ctx;
+    gkfs::tracing::Span span("client.pwritev");
 
     auto file = CTX->file_map()->get(fd);
-    auto pos = offset; // keep track of current position
-    ssize_t written = 0;
-    ssize_t ret;
+    if(file->type() != gkfs::filemap::FileType::regular) {
+        assert(file->type() == gkfs::filemap::FileType::directory);
+        LOG(WARNING, "Cannot write to directory");
+        errno = EISDIR;
+        return -1;
+    }
+    size_t count = 0;
     for(int i = 0; i < iovcnt; ++i) {
-        auto count = (iov + i)->iov_len;
-        if(count == 0) {
-            continue;
-        }
-        auto buf = (iov + i)->iov_base;
-        ret = gkfs_pwrite(file, reinterpret_cast<char*>(buf), count, pos);
-        if(ret == -1) {
-            break;
-        }
-        written += ret;
-        pos += ret;
+        count += iov[i].iov_len;
+    }
+    if(count == 0) {
+        return 0;
+    }
+    auto path = file->path();
+    auto append_flag = file->get_flag(gkfs::filemap::OpenFile_flags::append);
 
-        if(static_cast<size_t>(ret) < count) {
-            break;
-        }
+    // a single size update and one RPC per daemon for all segments
+    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(
+            path, count, offset, append_flag);
+    auto err = ret_update_size.first;
+    if(err) {
+        LOG(ERROR, "update_metadentry_size() failed with err '{}'", err);
+        errno = err;
+        return -1;
     }
+    auto updated_size = ret_update_size.second;
 
-    if(written == 0) {
+    auto ret_write = gkfs::rpc::forward_writev(path, iov, iovcnt, append_flag,
+                                               offset, count, updated_size,
+                                               file->chunk_size(),
+                                               file->data_host());
+    err = ret_write.first;
+    if(err) {
+        LOG(WARNING, "gkfs::rpc::forward_writev() failed with err '{}'", err);
+        errno = err;
         return -1;
     }
-    return written;
+    if(append_flag)
+        file->set_flag(gkfs::filemap::OpenFile_flags::appended, true);
+    if(update_pos && ret_write.second > 0) {
+        file->pos(append_flag ? updated_size : offset + ret_write.second);
+    }
+    return ret_write.second; // return written size
 }
 
 /**
@@ -982,14 +1449,7 @@ ssize_t
 gkfs_writev(int fd, const struct iovec* iov, int iovcnt) {
 
     auto gkfs_fd = CTX->file_map()->get(fd);
-    auto pos = gkfs_fd->pos(); // retrieve the current offset
-    auto ret = gkfs_pwritev(fd, iov, iovcnt, pos);
-    assert(ret != 0);
-    if(ret < 0) {
-        return -1;
-    }
-    gkfs_fd->pos(pos + ret);
-    return ret;
+    return gkfs_pwritev(fd, iov, iovcnt, gkfs_fd->pos(), true);
 }
 
 /**
@@ -1003,6 +1463,8 @@ gkfs_writev(int fd, const struct iovec* iov, int iovcnt) {
 ssize_t
 gkfs_pread(std::shared_ptr<gkfs::filemap::OpenFile> file, char* buf,
            size_t count, off64_t offset) {
+    gkfs::tracing::TraceContext trace_ctx;
+    gkfs::tracing::Span span("client.pread");
     if(file->type() != gkfs::filemap::FileType::regular) {
         assert(file->type() == gkfs::filemap::FileType::directory);
         LOG(WARNING, "Cannot read from directory");
@@ -1015,7 +1477,8 @@ gkfs_pread(std::shared_ptr<gkfs::filemap::OpenFile> file, char* buf,
     if constexpr(gkfs::config::io::zero_buffer_before_read) {
         memset(buf, 0, sizeof(char) * count);
     }
-    auto ret = gkfs::rpc::forward_read(file->path(), buf, offset, count);
+    auto ret = gkfs::rpc::forward_read(file->path(), buf, offset, count,
+                                       file->chunk_size(), file->data_host());
     auto err = ret.first;
     if(err) {
         LOG(WARNING, "gkfs::rpc::forward_read() failed with ret '{}'", err);
@@ -1057,33 +1520,39 @@ gkfs_read(int fd, void* buf, size_t count) {
  */
 ssize_t
 gkfs_preadv(int fd, const struct iovec* iov, int iovcnt, off_t offset) {
+    gkfs::tracing::TraceContext trace_ctx;
+    gkfs::tracing::Span span("client.preadv");
 
     auto file = CTX->file_map()->get(fd);
-    auto pos = offset; // keep track of current position
-    ssize_t read = 0;
-    ssize_t ret;
+    if(file->type() != gkfs::filemap::FileType::regular) {
+        assert(file->type() == gkfs::filemap::FileType::directory);
+        LOG(WARNING, "Cannot read from directory");
+        errno = EISDIR;
+        return -1;
+    }
+    size_t count = 0;
     for(int i = 0; i < iovcnt; ++i) {
-        auto count = (iov + i)->iov_len;
-        if(count == 0) {
-            continue;
-        }
-        auto buf = (iov + i)->iov_base;
-        ret = gkfs_pread(file, reinterpret_cast<char*>(buf), count, pos);
-        if(ret == -1) {
-            break;
-        }
-        read += ret;
-        pos += ret;
-
-        if(static_cast<size_t>(ret) < count) {
-            break;
+        // Zeroing buffer before read is only relevant for sparse files.
+        // Otherwise sparse regions contain invalid data.
+        if constexpr(gkfs::config::io::zero_buffer_before_read) {
+            memset(iov[i].iov_base, 0, iov[i].iov_len);
         }
+        count += iov[i].iov_len;
     }
-
-    if(read == 0) {
+    if(count == 0) {
+        return 0;
+    }
+    // one RPC per daemon for all segments
+    auto ret = gkfs::rpc::forward_readv(file->path(), iov, iovcnt, offset,
+                                        count, file->chunk_size(),
+                                        file->data_host());
+    auto err = ret.first;
+    if(err) {
+        LOG(WARNING, "gkfs::rpc::forward_readv() failed with ret '{}'", err);
+        errno = err;
         return -1;
     }
-    return read;
+    return ret.second; // return read size
 }
 
 /**
@@ -1100,11 +1569,9 @@ gkfs_readv(int fd, const struct iovec* iov, int iovcnt) {
     auto gkfs_fd = CTX->file_map()->get(fd);
     auto pos = gkfs_fd->pos(); // retrieve the current offset
     auto ret = gkfs_preadv(fd, iov, iovcnt, pos);
-    assert(ret != 0);
-    if(ret < 0) {
-        return -1;
+    if(ret > 0) {
+        gkfs_fd->pos(pos + ret);
     }
-    gkfs_fd->pos(pos + ret);
     return ret;
 }
 
@@ -1123,6 +1590,386 @@ gkfs_pread_ws(int fd, void* buf, size_t count, off64_t offset) {
     return gkfs_pread(gkfs_fd, reinterpret_cast<char*>(buf), count, offset);
 }
 
+/**
+ * gkfs wrapper for mmap() system calls
+ * The mapping is emulated with anonymous memory which is eagerly populated
+ * with the file content via forward_read(), i.e., mapping a file costs a read
+ * of the whole mapped range. Writable MAP_SHARED mappings additionally hash
+ * every page when they become writable and on each msync() and munmap(), which
+ * write back the changed pages. Changes made by other processes after the
+ * mapping was established are not visible.
+ * errno may be set
+ * @param addr
+ * @param length
+ * @param prot
+ * @param flags
+ * @param fd
+ * @param offset
+ * @return address of the mapping or MAP_FAILED on error
+ */
+void*
+gkfs_mmap(void* addr, size_t length, int prot, int flags, int fd,
+          off_t offset) {
+    auto file = CTX->file_map()->get(fd);
+    if(file->type() != gkfs::filemap::FileType::regular) {
+        errno = ENODEV;
+        return MAP_FAILED;
+    }
+    if(length == 0 || offset < 0 || (offset % ::sysconf(_SC_PAGESIZE)) != 0) {
+        errno = EINVAL;
+        return MAP_FAILED;
+    }
+    auto shared = (flags & MAP_SHARED) != 0;
+    auto writable = file->get_flag(gkfs::filemap::OpenFile_flags::rdwr);
+    // a mapping always requires read access to the file
+    if(file->get_flag(gkfs::filemap::OpenFile_flags::wronly) ||
+       (shared && (prot & PROT_WRITE) && !writable)) {
+        errno = EACCES;
+        return MAP_FAILED;
+    }
+    auto md = gkfs::utils::get_metadata(file->path());
+    if(!md) {
+        return MAP_FAILED;
+    }
+
+    // A fixed mapping replaces existing mappings in its range, whose changes
+    // must be written back before their memory is reused
+    if(flags & MAP_FIXED) {
+        mmap_release(reinterpret_cast<uintptr_t>(addr), length);
+    }
+
+    // The memory must be writable while it is populated. The requested
+    // protection is applied afterwards.
+    auto anon_flags = (flags & ~(MAP_SHARED | MAP_PRIVATE)) | MAP_PRIVATE |
+                      MAP_ANONYMOUS;
+    auto mem = ::mmap(addr, length, prot | PROT_READ | PROT_WRITE, anon_flags,
+                      -1, 0);
+    if(mem == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+
+    auto file_size = static_cast<off64_t>(md->size());
+    if(offset < file_size) {
+        auto count = std::min(static_cast<size_t>(file_size - offset), length);
+        auto ret = gkfs_pread(file, static_cast<char*>(mem), count, offset);
+        if(ret < 0) {
+            auto err = errno;
+            ::munmap(mem, length);
+            errno = err;
+            return MAP_FAILED;
+        }
+    }
+    if((prot & (PROT_READ | PROT_WRITE)) != (PROT_READ | PROT_WRITE) &&
+       ::mprotect(mem, length, prot) != 0) {
+        auto err = errno;
+        ::munmap(mem, length);
+        errno = err;
+        return MAP_FAILED;
+    }
+
+    auto mem_addr = reinterpret_cast<uintptr_t>(mem);
+    MmapEntry entry{file->path(),
+                    mem_addr,
+                    page_align_up(length),
+                    offset,
+                    prot,
+                    shared,
+                    shared && writable,
+                    nullptr,
+                    mem_addr};
+    // pages are hashed once the mapping is writable, see gkfs_mprotect()
+    if(entry.writeback && (prot & PROT_WRITE)) {
+        entry.hashes = mmap_hash_pages(entry);
+    }
+    // the kernel may place a new mapping where an emulated mapping was
+    // unmapped without notice, e.g., by mremap()
+    mmap_collect(mem_addr, entry.length, true);
+    {
+        std::lock_guard<std::mutex> lock(mmap_mutex);
+        mmap_entries.emplace(mem_addr, std::move(entry));
+        mmap_count++;
+    }
+    LOG(DEBUG, "{}() mapped '{}' bytes of '{}' at offset '{}' to '{}'",
+        __func__, length, file->path(), offset, fmt::ptr(mem));
+    return mem;
+}
+
+/**
+ * gkfs wrapper for msync() system calls
+ * Writes back all writable shared GekkoFS mappings in the given range.
+ * errno may be set
+ * @param addr
+ * @param length
+ * @param flags
+ * @return 0 on success, -1 on failure
+ */
+int
+gkfs_msync(void* addr, size_t length, int flags) {
+    auto slices = mmap_collect(reinterpret_cast<uintptr_t>(addr),
+                               page_align_up(length), false);
+    if(slices.empty()) {
+        errno = ENOMEM;
+        return -1;
+    }
+    for(const auto& slice : slices) {
+        if(mmap_writeback(slice) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * gkfs wrapper for mprotect() system calls on emulated mappings
+ * The new protection is recorded so that pages without read access can be
+ * written back. Shared mappings of files opened for writing start tracking
+ * their dirty pages once they become writable. As by the kernel, write access
+ * to shared mappings of files that are not open for writing is refused.
+ * errno may be set
+ * @param addr
+ * @param length
+ * @param prot
+ * @return 0 on success, -1 on failure
+ */
+int
+gkfs_mprotect(void* addr, size_t length, int prot) {
+    auto start = reinterpret_cast<uintptr_t>(addr);
+    auto end = start + page_align_up(length);
+    std::lock_guard<std::mutex> lock(mmap_mutex);
+    auto first = [&] {
+        auto it = mmap_entries.upper_bound(start);
+        if(it != mmap_entries.begin() &&
+           std::prev(it)->second.addr + std::prev(it)->second.length > start)
+            --it;
+        return it;
+    };
+    if(prot & PROT_WRITE) {
+        for(auto it = first(); it != mmap_entries.end() && it->first < end;
+            ++it) {
+            if(it->second.shared && !it->second.writeback) {
+                errno = EACCES;
+                return -1;
+            }
+        }
+    }
+    if(::mprotect(addr, length, prot) != 0) {
+        return -1;
+    }
+    mmap_split(start);
+    mmap_split(end);
+    for(auto it = first(); it != mmap_entries.end() && it->first < end; ++it) {
+        auto& entry = it->second;
+        entry.prot = prot;
+        if(entry.writeback && !entry.hashes && (prot & PROT_WRITE)) {
+            entry.hashes = mmap_hash_pages(entry);
+            entry.base = entry.addr;
+        }
+    }
+    return 0;
+}
+
+/**
+ * gkfs wrapper for munmap() system calls
+ * Writes back all writable shared GekkoFS mappings in the given range before
+ * the memory is released.
+ * errno may be set
+ * @param addr
+ * @param length
+ * @return 0 on success, -1 on failure
+ */
+int
+gkfs_munmap(void* addr, size_t length) {
+    mmap_release(reinterpret_cast<uintptr_t>(addr), length);
+    return ::munmap(addr, length);
+}
+
+/**
+ * Writes back and forgets the emulated mappings in a range that is about to be
+ * replaced by a fixed mapping which is not a GekkoFS mapping
+ * @param addr
+ * @param length
+ */
+void
+gkfs_mmap_replace(void* addr, size_t length) {
+    mmap_release(reinterpret_cast<uintptr_t>(addr), length);
+}
+
+/**
+ * Checks if the given memory range overlaps with an emulated mapping of a
+ * GekkoFS file
+ * @param addr
+ * @param length
+ * @return true if at least one mapping overlaps
+ */
+bool
+gkfs_is_mapped(void* addr, size_t length) {
+    return !mmap_collect(reinterpret_cast<uintptr_t>(addr),
+                         page_align_up(length), false)
+                    .empty();
+}
+
+/**
+ * gkfs wrapper for copy_file_range() system calls
+ * errno may be set
+ * @param fd_in
+ * @param off_in
+ * @param fd_out
+ * @param off_out
+ * @param len
+ * @param flags
+ * @return copied size or -1 on error
+ */
+ssize_t
+gkfs_copy_file_range(int fd_in, off64_t* off_in, int fd_out, off64_t* off_out,
+                     size_t len, unsigned int flags) {
+    if(flags != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    auto in = CTX->file_map()->get(fd_in);
+    auto out = CTX->file_map()->get(fd_out);
+    if(out->get_flag(gkfs::filemap::OpenFile_flags::append)) {
+        errno = EBADF;
+        return -1;
+    }
+    auto src_off = off_in ? *off_in : in->pos();
+    auto dst_off = off_out ? *off_out : out->pos();
+    // the kernel copies at most MAX_RW_COUNT bytes per call
+    len = std::min(len, static_cast<size_t>(gkfs::config::io::max_copy_size));
+    auto ret = gkfs_copy_range(in, src_off, out, dst_off, len);
+    if(ret > 0) {
+        if(off_in)
+            *off_in = src_off + ret;
+        else
+            in->pos(src_off + ret);
+        if(off_out)
+            *off_out = dst_off + ret;
+        else
+            out->pos(dst_off + ret);
+    }
+    return ret;
+}
+
+/**
+ * gkfs wrapper for sendfile() system calls if both file descriptors refer to
+ * GekkoFS files
+ * errno may be set
+ * @param out_fd
+ * @param in_fd
+ * @param offset
+ * @param count
+ * @return copied size or -1 on error
+ */
+ssize_t
+gkfs_sendfile(int out_fd, int in_fd, off64_t* offset, size_t count) {
+    auto in = CTX->file_map()->get(in_fd);
+    auto out = CTX->file_map()->get(out_fd);
+    if(out->get_flag(gkfs::filemap::OpenFile_flags::append)) {
+        gkfs_lseek(out, 0, SEEK_END);
+    }
+    auto src_off = offset ? *offset : in->pos();
+    auto dst_off = out->pos();
+    count = std::min(count,
+                     static_cast<size_t>(gkfs::config::io::max_copy_size));
+    auto ret = gkfs_copy_range(in, src_off, out, dst_off, count);
+    if(ret > 0) {
+        if(offset)
+            *offset = src_off + ret;
+        else
+            in->pos(src_off + ret);
+        out->pos(dst_off + ret);
+    }
+    return ret;
+}
+
+/**
+ * gkfs wrapper for fallocate() system calls. Only the default mode and
+ * FALLOC_FL_KEEP_SIZE are supported.
+ * errno may be set
+ * @param fd
+ * @param mode
+ * @param offset
+ * @param len
+ * @return 0 on success or -1 on error
+ */
+int
+gkfs_fallocate(int fd, int mode, off_t offset, off_t len) {
+    auto file = CTX->file_map()->get(fd);
+    if(offset < 0 || len <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if(mode & ~FALLOC_FL_KEEP_SIZE) {
+        LOG(WARNING, "{}() unsupported mode '{}'", __func__, mode);
+        errno = EOPNOTSUPP;
+        return -1;
+    }
+    if(file->type() != gkfs::filemap::FileType::regular) {
+        errno = ENODEV;
+        return -1;
+    }
+    if(!(file->get_flag(gkfs::filemap::OpenFile_flags::wronly) ||
+         file->get_flag(gkfs::filemap::OpenFile_flags::rdwr))) {
+        errno = EBADF;
+        return -1;
+    }
+    // the end of the range must be a valid file size
+    if(len > std::numeric_limits<off_t>::max() - offset) {
+        errno = EFBIG;
+        return -1;
+    }
+    if(!(mode & FALLOC_FL_KEEP_SIZE)) {
+        // reserve the file size first so that concurrent writers see it
+        auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(
+                file->path(), len, offset, false);
+        if(ret_update_size.first) {
+            LOG(ERROR, "update_metadentry_size() failed with err '{}'",
+                ret_update_size.first);
+            errno = ret_update_size.first;
+            return -1;
+        }
+    }
+    auto err = gkfs::rpc::forward_fallocate(file->path(), offset, len,
+                                            file->chunk_size(),
+                                            file->data_host());
+    if(err) {
+        LOG(WARNING, "gkfs::rpc::forward_fallocate() failed with err '{}'",
+            err);
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * gkfs wrapper for fsync() system calls. Data is written synchronously by the
+ * daemons. If appends were written through the file, the size reserved on the
+ * metadata daemon is persisted. Also called on close, so that the daemon can
+ * release its append counter.
+ * errno may be set
+ * @param fd
+ * @return 0 on success or -1 on error
+ */
+int
+gkfs_fsync(int fd) {
+    auto file = CTX->file_map()->get(fd);
+    if(!file || !file->get_flag(gkfs::filemap::OpenFile_flags::appended)) {
+        return 0;
+    }
+    file->set_flag(gkfs::filemap::OpenFile_flags::appended, false);
+    // a zero-sized update persists and releases the append counter
+    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(
+            file->path(), 0, 0, false);
+    if(ret_update_size.first) {
+        LOG(ERROR, "update_metadentry_size() failed with err '{}'",
+            ret_update_size.first);
+        file->set_flag(gkfs::filemap::OpenFile_flags::appended, true);
+        errno = ret_update_size.first;
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * wrapper function for opening directories
  * errno may be set
@@ -1480,3 +2327,226 @@ gkfs_getsingleserverdir(const char* path, struct dirent_extended* dirp,
     }
     return written;
 }
+
+/* Server-side filtered namespace scan. Each daemon scans its entries below path
+ * and returns only those matching the filter, or only their number and total
+ * size if fn is NULL. server selects a single daemon, -1 asks all daemons.
+ * Paths passed to fn are absolute paths within the mount directory. If fn
+ * returns non-zero, no further entries are passed to it.
+ */
+extern "C" int
+gkfs_scan(const char* path, const struct gkfs_scan_filter* filter, int server,
+          gkfs_scan_cb fn, void* arg, struct gkfs_scan_stats* stats) {
+
+    std::string rel_path{};
+    if(!CTX->relativize_path(path, rel_path)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    if(filter == nullptr) {
+        errno = EINVAL;
+        return -1;
+    }
+    struct gkfs_scan_stats sums {};
+    std::vector<std::tuple<const std::string, mode_t, size_t, time_t>> entries;
+    auto err = gkfs::rpc::forward_scan(rel_path, *filter, server,
+                                       fn == nullptr, sums, entries);
+    if(err) {
+        errno = err;
+        return -1;
+    }
+    if(stats != nullptr)
+        *stats = sums;
+    for(const auto& [entry_path, mode, size, ctime] : entries) {
+        auto mount_path = CTX->mountdir() + entry_path;
+        if(fn(mount_path.c_str(), mode, size, ctime, arg) != 0)
+            break;
+    }
+    return 0;
+}
+
+/* Recursive removal of a directory tree (rm -rf). Instead of walking the tree,
+ * all daemons remove the metadata and data chunks of the entries below path in
+ * parallel before the directory itself is removed. Other file types are
+ * removed like with unlink(). The root directory is emptied but kept.
+ */
+extern "C" int
+gkfs_remove_tree(const char* path) {
+
+    std::string rel_path{};
+    if(!CTX->relativize_path(path, rel_path, false)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    auto md = gkfs::utils::get_metadata(rel_path);
+    if(!md)
+        return -1;
+    if(!S_ISDIR(md->mode()))
+        return gkfs::syscall::gkfs_remove(rel_path);
+
+    auto err = gkfs::rpc::forward_remove_subtree(rel_path);
+    if(err == 0 && rel_path != "/")
+        err = gkfs::rpc::forward_remove(rel_path);
+    if(err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+/* Per-file layout extension. The chunk size of a directory or of an empty file
+ * can be changed, new files and directories inherit the chunk size of their
+ * parent directory. Paths are resolved like those of intercepted calls.
+ */
+extern "C" int
+gkfs_set_chunk_size(const char* path, size_t chunk_size) {
+
+    std::string rel_path{};
+    if(!CTX->relativize_path(path, rel_path)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    if(chunk_size < gkfs::config::rpc::min_chunksize ||
+       chunk_size > gkfs::config::rpc::max_chunksize) {
+        LOG(DEBUG, "Chunk size '{}' is out of range", chunk_size);
+        errno = EINVAL;
+        return -1;
+    }
+    auto err = gkfs::rpc::forward_set_chunk_size(rel_path, chunk_size);
+    if(err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
+
+extern "C" ssize_t
+gkfs_get_chunk_size(const char* path) {
+
+    std::string rel_path{};
+    if(!CTX->relativize_path(path, rel_path)) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    auto md = gkfs::utils::get_metadata(rel_path);
+    if(!md) {
+        return -1;
+    }
+    return static_cast<ssize_t>(md->chunk_size());
+}
+
+/* List I/O extension for non-contiguous accesses, e.g., strided patterns of
+ * MPI-IO or HDF5. The memory segments are filled or drained in the order of
+ * the file segments. Each daemon receives a single request per call.
+ */
+extern "C" ssize_t
+gkfs_write_list(int fd, int mem_count, const struct iovec* mem_list,
+                int file_count, const off64_t* file_offsets,
+                const size_t* file_lengths) {
+
+    auto file = list_io_file(fd);
+    if(!file) {
+        return -1;
+    }
+    if(!(file->get_flag(gkfs::filemap::OpenFile_flags::wronly) ||
+         file->get_flag(gkfs::filemap::OpenFile_flags::rdwr))) {
+        errno = EBADF;
+        return -1;
+    }
+    auto count = list_io_size(mem_count, mem_list, file_count, file_offsets,
+                              file_lengths);
+    if(count <= 0) {
+        return count;
+    }
+
+    // a single size update for the segment ending last
+    int last = 0;
+    off64_t last_end = 0;
+    for(int i = 0; i < file_count; ++i) {
+        auto end = file_offsets[i] + static_cast<off64_t>(file_lengths[i]);
+        if(file_lengths[i] > 0 && end > last_end) {
+            last = i;
+            last_end = end;
+        }
+    }
+    auto ret_update_size = gkfs::rpc::forward_update_metadentry_size(
+            file->path(), file_lengths[last], file_offsets[last], false);
+    auto err = ret_update_size.first;
+    if(err) {
+        LOG(ERROR, "update_metadentry_size() failed with err '{}'", err);
+        errno = err;
+        return -1;
+    }
+
+    auto ret = gkfs::rpc::forward_write_list(file->path(), mem_list, mem_count,
+                                             file_count, file_offsets,
+                                             file_lengths, file->chunk_size(),
+                                             file->data_host());
+    err = ret.first;
+    if(err) {
+        LOG(WARNING, "gkfs::rpc::forward_write_list() failed with err '{}'",
+            err);
+        errno = err;
+        return -1;
+    }
+    return ret.second;
+}
+
+extern "C" ssize_t
+gkfs_read_list(int fd, int mem_count, const struct iovec* mem_list,
+               int file_count, const off64_t* file_offsets,
+               const size_t* file_lengths) {
+
+    auto file = list_io_file(fd);
+    if(!file) {
+        return -1;
+    }
+    if(file->get_flag(gkfs::filemap::OpenFile_flags::wronly)) {
+        errno = EBADF;
+        return -1;
+    }
+    auto count = list_io_size(mem_count, mem_list, file_count, file_offsets,
+                              file_lengths);
+    if(count <= 0) {
+        return count;
+    }
+    // Zeroing buffer before read is only relevant for sparse files. Otherwise
+    // sparse regions contain invalid data.
+    if constexpr(gkfs::config::io::zero_buffer_before_read) {
+        for(int i = 0; i < mem_count; ++i) {
+            memset(mem_list[i].iov_base, 0, mem_list[i].iov_len);
+        }
+    }
+    auto ret = gkfs::rpc::forward_read_list(file->path(), mem_list, mem_count,
+                                            file_count, file_offsets,
+                                            file_lengths, file->chunk_size(),
+                                            file->data_host());
+    auto err = ret.first;
+    if(err) {
+        LOG(WARNING, "gkfs::rpc::forward_read_list() failed with err '{}'",
+            err);
+        errno = err;
+        return -1;
+    }
+    return ret.second;
+}
+
+/**
+ * Writes the spans recorded by this client so far as Chrome trace JSON. Spans
+ * are only recorded if LIBGKFS_TRACE_OUTPUT is set.
+ * @param path output file
+ * @return 0 on success, -1 on error with errno set
+ */
+extern "C" int
+gkfs_trace_dump(const char* path) {
+    if(!gkfs::tracing::enabled()) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    auto err = gkfs::tracing::dump(path);
+    if(err) {
+        errno = err;
+        return -1;
+    }
+    return 0;
+}
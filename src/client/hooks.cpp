@@ -38,11 +38,13 @@
 #include <common/path_util.hpp>
 
 #include <memory>
+#include <vector>
 
 extern "C" {
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
+#include <sys/mman.h>
 }
 
 namespace {
@@ -53,6 +55,84 @@ with_errno(int ret) {
     return (ret < 0) ? -errno : ret;
 }
 
+/**
+ * Drops the cached external directories after an entry outside of GekkoFS was
+ * successfully removed, renamed, or created as a symlink.
+ * @return ret
+ */
+inline long
+invalidate_resolve_cache_if_ok(long ret) {
+    if(ret == 0) {
+        gkfs::path::invalidate_resolve_cache();
+    }
+    return ret;
+}
+
+/**
+ * Emulates sendfile() between a GekkoFS file and a file outside of GekkoFS by
+ * moving the data through a bounce buffer in chunk size steps.
+ * @return copied size or negative errno on error
+ */
+long
+sendfile_bounce(int out_fd, int in_fd, off64_t* offset, size_t count) {
+    count = std::min(count,
+                     static_cast<size_t>(gkfs::config::io::max_copy_size));
+    const auto in_gkfs = CTX->file_map()->exist(in_fd);
+    const auto out_gkfs = CTX->file_map()->exist(out_fd);
+    std::vector<char> buf(
+            std::min(count, static_cast<size_t>(gkfs::config::rpc::chunksize)));
+    size_t total = 0;
+    while(total < count) {
+        auto n = std::min(buf.size(), count - total);
+        long nread;
+        if(in_gkfs) {
+            nread = offset ? gkfs::syscall::gkfs_pread_ws(in_fd, buf.data(), n,
+                                                          *offset + total)
+                           : gkfs::syscall::gkfs_read(in_fd, buf.data(), n);
+            nread = nread < 0 ? -errno : nread;
+        } else {
+            nread = offset ? syscall_no_intercept_wrapper(
+                                     SYS_pread64, in_fd, buf.data(), n,
+                                     *offset + total)
+                           : syscall_no_intercept_wrapper(SYS_read, in_fd,
+                                                          buf.data(), n);
+        }
+        if(nread <= 0) {
+            if(nread < 0 && total == 0)
+                return nread;
+            break;
+        }
+        long nwritten;
+        if(out_gkfs) {
+            nwritten = gkfs::syscall::gkfs_write(out_fd, buf.data(), nread);
+            nwritten = nwritten < 0 ? -errno : nwritten;
+        } else {
+            nwritten = syscall_no_intercept_wrapper(SYS_write, out_fd,
+                                                    buf.data(), nread);
+        }
+        auto consumed = std::max(nwritten, 0L);
+        if(!offset && consumed < nread) {
+            // give back what was read but not written
+            if(in_gkfs)
+                gkfs::syscall::gkfs_lseek(in_fd, consumed - nread, SEEK_CUR);
+            else
+                syscall_no_intercept_wrapper(SYS_lseek, in_fd,
+                                             consumed - nread, SEEK_CUR);
+        }
+        if(nwritten < 0) {
+            if(total == 0)
+                return nwritten;
+            break;
+        }
+        total += nwritten;
+        if(nwritten < nread)
+            break;
+    }
+    if(offset)
+        *offset += total;
+    return total;
+}
+
 } // namespace
 
 namespace gkfs::hook {
@@ -92,7 +172,11 @@ hook_close(int fd) {
     LOG(DEBUG, "{}() called with fd: {}", __func__, fd);
 
     if(CTX->file_map()->exist(fd)) {
-        // No call to the daemon is required
+        // Only files with appends require a call to the daemon
+        if(gkfs::syscall::gkfs_fsync(fd) < 0) {
+            LOG(WARNING, "{}() failed to persist size of fd {}", __func__,
+                fd);
+        }
         CTX->file_map()->remove(fd);
         return 0;
     }
@@ -343,12 +427,12 @@ hook_unlinkat(int dirfd, const char* cpath, int flags) {
     auto rstatus = CTX->relativize_fd_path(dirfd, cpath, resolved, false);
     switch(rstatus) {
         case gkfs::preload::RelativizeStatus::fd_unknown:
-            return syscall_no_intercept_wrapper(SYS_unlinkat, dirfd, cpath,
-                                                flags);
+            return invalidate_resolve_cache_if_ok(syscall_no_intercept_wrapper(
+                    SYS_unlinkat, dirfd, cpath, flags));
 
         case gkfs::preload::RelativizeStatus::external:
-            return syscall_no_intercept_wrapper(SYS_unlinkat, dirfd,
-                                                resolved.c_str(), flags);
+            return invalidate_resolve_cache_if_ok(syscall_no_intercept_wrapper(
+                    SYS_unlinkat, dirfd, resolved.c_str(), flags));
 
         case gkfs::preload::RelativizeStatus::fd_not_a_dir:
             return -ENOTDIR;
@@ -383,12 +467,12 @@ hook_symlinkat(const char* oldname, int newdfd, const char* newname) {
             CTX->relativize_fd_path(newdfd, newname, newname_resolved, false);
     switch(rstatus) {
         case gkfs::preload::RelativizeStatus::fd_unknown:
-            return syscall_no_intercept_wrapper(SYS_symlinkat, oldname, newdfd,
-                                                newname);
+            return invalidate_resolve_cache_if_ok(syscall_no_intercept_wrapper(
+                    SYS_symlinkat, oldname, newdfd, newname));
 
         case gkfs::preload::RelativizeStatus::external:
-            return syscall_no_intercept_wrapper(SYS_symlinkat, oldname, newdfd,
-                                                newname_resolved.c_str());
+            return invalidate_resolve_cache_if_ok(syscall_no_intercept_wrapper(
+                    SYS_symlinkat, oldname, newdfd, newname_resolved.c_str()));
 
         case gkfs::preload::RelativizeStatus::fd_not_a_dir:
             return -ENOTDIR;
@@ -929,8 +1013,8 @@ hook_renameat(int olddfd, const char* oldname, int newdfd, const char* newname,
             return -EINVAL;
     }
 
-    return syscall_no_intercept_wrapper(SYS_renameat2, olddfd, oldpath_pass,
-                                        newdfd, newpath_pass, flags);
+    return invalidate_resolve_cache_if_ok(syscall_no_intercept_wrapper(
+            SYS_renameat2, olddfd, oldpath_pass, newdfd, newpath_pass, flags));
 }
 
 int
@@ -965,8 +1049,7 @@ hook_fsync(unsigned int fd) {
     LOG(DEBUG, "{}() called with fd: {}", __func__, fd);
 
     if(CTX->file_map()->exist(fd)) {
-        errno = 0;
-        return 0;
+        return with_errno(gkfs::syscall::gkfs_fsync(fd));
     }
 
     return syscall_no_intercept_wrapper(SYS_fsync, fd);
@@ -985,4 +1068,121 @@ hook_getxattr(const char* path, const char* name, void* value, size_t size) {
     return syscall_no_intercept_wrapper(SYS_getxattr, path, name, value, size);
 }
 
+long
+hook_mmap(void* addr, size_t length, int prot, int flags, int fd,
+          off_t offset) {
+
+    LOG(DEBUG,
+        "{}() called with addr: {}, length: {}, prot: {}, flags: {}, "
+        "fd: {}, offset: {}",
+        __func__, fmt::ptr(addr), length, prot, flags, fd, offset);
+
+    if(fd >= 0 && !(flags & MAP_ANONYMOUS) && CTX->file_map()->exist(fd)) {
+        auto ret = gkfs::syscall::gkfs_mmap(addr, length, prot, flags, fd,
+                                            offset);
+        if(ret == MAP_FAILED) {
+            return -errno;
+        }
+        return reinterpret_cast<long>(ret);
+    }
+    if((flags & MAP_FIXED) && gkfs::syscall::gkfs_is_mapped(addr, length)) {
+        gkfs::syscall::gkfs_mmap_replace(addr, length);
+    }
+    return syscall_no_intercept_wrapper(SYS_mmap, addr, length, prot, flags,
+                                        fd, offset);
+}
+
+int
+hook_mprotect(void* addr, size_t length, int prot) {
+
+    LOG(DEBUG, "{}() called with addr: {}, length: {}, prot: {}", __func__,
+        fmt::ptr(addr), length, prot);
+
+    if(gkfs::syscall::gkfs_is_mapped(addr, length)) {
+        return with_errno(gkfs::syscall::gkfs_mprotect(addr, length, prot));
+    }
+    return syscall_no_intercept_wrapper(SYS_mprotect, addr, length, prot);
+}
+
+int
+hook_munmap(void* addr, size_t length) {
+
+    LOG(DEBUG, "{}() called with addr: {}, length: {}", __func__,
+        fmt::ptr(addr), length);
+
+    if(gkfs::syscall::gkfs_is_mapped(addr, length)) {
+        return with_errno(gkfs::syscall::gkfs_munmap(addr, length));
+    }
+    return syscall_no_intercept_wrapper(SYS_munmap, addr, length);
+}
+
+int
+hook_msync(void* addr, size_t length, int flags) {
+
+    LOG(DEBUG, "{}() called with addr: {}, length: {}, flags: {}", __func__,
+        fmt::ptr(addr), length, flags);
+
+    if(gkfs::syscall::gkfs_is_mapped(addr, length)) {
+        return with_errno(gkfs::syscall::gkfs_msync(addr, length, flags));
+    }
+    return syscall_no_intercept_wrapper(SYS_msync, addr, length, flags);
+}
+
+long
+hook_copy_file_range(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out,
+                     size_t len, unsigned int flags) {
+
+    LOG(DEBUG,
+        "{}() called with fd_in: {}, off_in: {}, fd_out: {}, off_out: {}, "
+        "len: {}, flags: {}",
+        __func__, fd_in, fmt::ptr(off_in), fd_out, fmt::ptr(off_out), len,
+        flags);
+
+    const auto in_gkfs = CTX->file_map()->exist(fd_in);
+    const auto out_gkfs = CTX->file_map()->exist(fd_out);
+    if(in_gkfs && out_gkfs) {
+        auto ret = gkfs::syscall::gkfs_copy_file_range(fd_in, off_in, fd_out,
+                                                       off_out, len, flags);
+        return (ret < 0) ? -errno : ret;
+    }
+    if(in_gkfs || out_gkfs) {
+        // copies across file systems are rejected as by the kernel since 5.19
+        return -EXDEV;
+    }
+    return syscall_no_intercept_wrapper(SYS_copy_file_range, fd_in, off_in,
+                                        fd_out, off_out, len, flags);
+}
+
+long
+hook_sendfile(int out_fd, int in_fd, loff_t* offset, size_t count) {
+
+    LOG(DEBUG, "{}() called with out_fd: {}, in_fd: {}, offset: {}, count: {}",
+        __func__, out_fd, in_fd, fmt::ptr(offset), count);
+
+    const auto in_gkfs = CTX->file_map()->exist(in_fd);
+    const auto out_gkfs = CTX->file_map()->exist(out_fd);
+    if(in_gkfs && out_gkfs) {
+        auto ret = gkfs::syscall::gkfs_sendfile(out_fd, in_fd, offset, count);
+        return (ret < 0) ? -errno : ret;
+    }
+    if(in_gkfs || out_gkfs) {
+        return sendfile_bounce(out_fd, in_fd, offset, count);
+    }
+    return syscall_no_intercept_wrapper(SYS_sendfile, out_fd, in_fd, offset,
+                                        count);
+}
+
+int
+hook_fallocate(int fd, int mode, off_t offset, off_t len) {
+
+    LOG(DEBUG, "{}() called with fd: {}, mode: {}, offset: {}, len: {}",
+        __func__, fd, mode, offset, len);
+
+    if(CTX->file_map()->exist(fd)) {
+        return with_errno(
+                gkfs::syscall::gkfs_fallocate(fd, mode, offset, len));
+    }
+    return syscall_no_intercept_wrapper(SYS_fallocate, fd, mode, offset, len);
+}
+
 } // namespace gkfs::hook
@@ -31,6 +31,7 @@
 #include <client/preload.hpp>
 #include <client/hooks.hpp>
 #include <client/logging.hpp>
+#include <client/open_file_map.hpp>
 
 #include <optional>
 #include <fmt/format.h>
@@ -64,6 +65,38 @@ get_current_syscall_info() {
     return saved_syscall_info;
 }
 
+/*
+ * is_foreign_fd_syscall -- fast path for fds not owned by GekkoFS
+ *
+ * Returns true for syscalls which only operate on the fd in arg0 if that fd is
+ * not a GekkoFS file, e.g., a socket, pipe, or stdout. These syscalls are
+ * forwarded to the kernel before any other work is done. OpenFileMap::exist()
+ * answers without taking a lock.
+ */
+inline bool
+is_foreign_fd_syscall(long syscall_number, long arg0) {
+    switch(syscall_number) {
+        case SYS_read:
+        case SYS_pread64:
+        case SYS_readv:
+        case SYS_preadv:
+        case SYS_write:
+        case SYS_pwrite64:
+        case SYS_writev:
+        case SYS_pwritev:
+        case SYS_lseek:
+        case SYS_fstat:
+        case SYS_ftruncate:
+        case SYS_fsync:
+        case SYS_getdents:
+        case SYS_getdents64:
+        case SYS_fstatfs:
+            return !CTX->file_map()->exist(static_cast<int>(arg0));
+        default:
+            return false;
+    }
+}
+
 
 /*
  * hook_internal -- interception hook for internal syscalls
@@ -763,6 +796,49 @@ hook(long syscall_number, long arg0, long arg1, long arg2, long arg3, long arg4,
                     reinterpret_cast<void*>(arg2), static_cast<size_t>(arg4));
             break;
 
+        case SYS_mmap:
+            *result = gkfs::hook::hook_mmap(
+                    reinterpret_cast<void*>(arg0), static_cast<size_t>(arg1),
+                    static_cast<int>(arg2), static_cast<int>(arg3),
+                    static_cast<int>(arg4), static_cast<off_t>(arg5));
+            break;
+
+        case SYS_mprotect:
+            *result = gkfs::hook::hook_mprotect(reinterpret_cast<void*>(arg0),
+                                                static_cast<size_t>(arg1),
+                                                static_cast<int>(arg2));
+            break;
+
+        case SYS_munmap:
+            *result = gkfs::hook::hook_munmap(reinterpret_cast<void*>(arg0),
+                                              static_cast<size_t>(arg1));
+            break;
+
+        case SYS_msync:
+            *result = gkfs::hook::hook_msync(reinterpret_cast<void*>(arg0),
+                                             static_cast<size_t>(arg1),
+                                             static_cast<int>(arg2));
+            break;
+
+        case SYS_copy_file_range:
+            *result = gkfs::hook::hook_copy_file_range(
+                    static_cast<int>(arg0), reinterpret_cast<loff_t*>(arg1),
+                    static_cast<int>(arg2), reinterpret_cast<loff_t*>(arg3),
+                    static_cast<size_t>(arg4), static_cast<unsigned int>(arg5));
+            break;
+
+        case SYS_sendfile:
+            *result = gkfs::hook::hook_sendfile(
+                    static_cast<int>(arg0), static_cast<int>(arg1),
+                    reinterpret_cast<loff_t*>(arg2), static_cast<size_t>(arg3));
+            break;
+
+        case SYS_fallocate:
+            *result = gkfs::hook::hook_fallocate(
+                    static_cast<int>(arg0), static_cast<int>(arg1),
+                    static_cast<off_t>(arg2), static_cast<off_t>(arg3));
+            break;
+
         default:
             // ignore any other syscalls, i.e.: pass them on to the kernel
             // (syscalls forwarded to the kernel that return are logged in
@@ -947,6 +1023,14 @@ hook_guard_wrapper(long syscall_number, long arg0, long arg1, long arg2,
                                             arg3, arg4, arg5);
 #endif
 
+    if(!reentrance_guard_flag &&
+       is_foreign_fd_syscall(syscall_number, arg0)) {
+        ::save_current_syscall_info(gkfs::syscall::from_external_code |
+                                    gkfs::syscall::to_kernel |
+                                    gkfs::syscall::not_executed);
+        return gkfs::syscall::forward_to_kernel;
+    }
+
     int was_hooked = 0;
 
     if(reentrance_guard_flag) {
@@ -28,13 +28,19 @@
 */
 
 #include <client/logging.hpp>
+#include <client/log_ring.hpp>
 #include <client/env.hpp>
 #include <client/make_array.hpp>
+#include <config.hpp>
+#include <mutex>
 #include <regex>
+#include <thread>
 
 extern "C" {
 #include <date/tz.h>
 #include <fmt/ostream.h>
+#include <linux/futex.h>
+#include <pthread.h>
 }
 
 #ifdef GKFS_ENABLE_LOGGING
@@ -280,7 +286,164 @@ process_log_filter(const std::string& log_filter) {
 
 #endif // GKFS_DEBUG_BUILD
 
-logger::logger(const std::string& opts, const std::string& path, bool trunc
+namespace detail {
+
+/**
+ * Writes log messages from a background thread so that the logging threads
+ * only copy them into a ring buffer. The thread drains the buffer with one
+ * writev() per batch whenever the flush interval passes or the buffer is
+ * half full. Messages that do not fit into the buffer are dropped and the
+ * number of dropped messages is written to the log.
+ *
+ * The thread only uses non-intercepted system calls so that its own activity
+ * does not show up in the syscall log.
+ */
+class async_writer {
+public:
+    async_writer(int fd, std::size_t capacity) : fd_(fd), ring_(capacity) {
+        thread_ = std::make_unique<std::thread>([this] { run(); });
+    }
+
+    ~async_writer() {
+        stop();
+    }
+
+    /**
+     * Buffer a message for the background thread
+     * @return false if the writer is stopped and the message must be
+     * written directly by the caller
+     */
+    bool
+    write(const char* data, std::size_t size) {
+        // announce the producer before checking active_ so that stop() either
+        // sees it and waits for its push, or this thread sees the writer
+        // stopped. Both accesses must be sequentially consistent.
+        producers_.fetch_add(1);
+        if(!active_.load()) {
+            producers_.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+        // a dropped message is counted, not written directly
+        ring_.push(data, size);
+        if(ring_.used() > ring_.capacity() / 2 &&
+           !wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+            wake();
+        }
+        producers_.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Stop the background thread after it wrote all buffered messages
+     */
+    void
+    stop() {
+        if(!active_.exchange(false)) {
+            return;
+        }
+        // producers that saw the writer active finish their push before the
+        // final drain of the background thread
+        while(producers_.load(std::memory_order_acquire) > 0) {
+            ::syscall_no_intercept(SYS_sched_yield);
+        }
+        running_.store(false, std::memory_order_release);
+        wake();
+        thread_->join();
+    }
+
+    /**
+     * Called in the child after fork(), where the background thread does not
+     * exist. Messages buffered by the parent are discarded.
+     */
+    void
+    abandon() {
+        active_ = false;
+        running_ = false;
+        // producers of the parent do not exist in the child
+        producers_ = 0;
+        // the thread handle refers to the parent's thread and is leaked
+        (void) thread_.release();
+    }
+
+private:
+    static constexpr std::size_t max_batch = 256;
+
+    int fd_;
+    log_ring ring_;
+    std::unique_ptr<std::thread> thread_;
+    std::atomic<bool> active_{true};
+    std::atomic<uint32_t> producers_{0}; // threads inside write()
+    std::atomic<bool> running_{true};
+    std::atomic<bool> wake_pending_{false};
+    std::atomic<uint32_t> wake_seq_{0}; // futex word
+    uint64_t dropped_reported_{0};
+
+    void
+    wake() {
+        wake_seq_.fetch_add(1, std::memory_order_release);
+        ::syscall_no_intercept(SYS_futex, &wake_seq_, FUTEX_WAKE_PRIVATE, 1,
+                               nullptr, nullptr, 0);
+    }
+
+    void
+    wait() {
+        const auto seq = wake_seq_.load(std::memory_order_acquire);
+        wake_pending_.store(false, std::memory_order_release);
+        if(!running_.load(std::memory_order_acquire) ||
+           ring_.used() > ring_.capacity() / 2) {
+            return;
+        }
+        struct ::timespec timeout {
+            0, gkfs::config::log::client_async_flush_interval_ms * 1000000L
+        };
+        ::syscall_no_intercept(SYS_futex, &wake_seq_, FUTEX_WAIT_PRIVATE, seq,
+                               &timeout, nullptr, 0);
+    }
+
+    std::size_t
+    drain() {
+        std::array<struct ::iovec, max_batch> iov;
+        return ring_.drain(iov.data(), iov.size(),
+                           [this](struct ::iovec* v, std::size_t n) {
+                               ::syscall_no_intercept(SYS_writev, fd_, v, n);
+                           });
+    }
+
+    void
+    report_dropped() {
+        const auto dropped = ring_.dropped();
+        if(dropped == dropped_reported_) {
+            return;
+        }
+        static_buffer buffer;
+        fmt::format_to(buffer,
+                       "[gkfs] {} log messages dropped, the asynchronous log "
+                       "buffer was full\n",
+                       dropped - dropped_reported_);
+        ::syscall_no_intercept(SYS_write, fd_, buffer.data(), buffer.size());
+        dropped_reported_ = dropped;
+    }
+
+    void
+    run() {
+        while(running_.load(std::memory_order_acquire)) {
+            const auto n = drain();
+            report_dropped();
+            if(n == 0) {
+                wait();
+            }
+        }
+        // write messages buffered until the writer was stopped
+        while(drain() > 0) {
+        }
+        report_dropped();
+    }
+};
+
+} // namespace detail
+
+logger::logger(const std::string& opts, const std::string& path, bool trunc,
+               bool async
 #ifdef GKFS_DEBUG_BUILD
                ,
                const std::string& filter, int verbosity
@@ -349,6 +512,22 @@ logger::logger(const std::string& opts, const std::string& path, bool trunc
         timezone_ = nullptr;
     }
 
+    if(async && log_mask_ != log::none) {
+        async_writer_ = std::make_shared<detail::async_writer>(
+                log_fd_, gkfs::config::log::client_async_buffer_size);
+
+        // the writer thread does not survive fork(), children log directly
+        static std::once_flag atfork_registered;
+        std::call_once(atfork_registered, [] {
+            ::pthread_atfork(nullptr, nullptr, [] {
+                const auto& lg = get_global_logger();
+                if(lg && lg->async_writer_) {
+                    lg->async_writer_->abandon();
+                }
+            });
+        });
+    }
+
 #ifdef GKFS_ENABLE_LOGGING
     const auto log_hermes_message =
             [](const std::string& msg, hermes::log::level l, int severity,
@@ -427,9 +606,25 @@ logger::logger(const std::string& opts, const std::string& path, bool trunc
 }
 
 logger::~logger() {
+    stop_async();
     log_fd_ = ::syscall_no_intercept(SYS_close, log_fd_);
 }
 
+void
+logger::write(const char* data, std::size_t size) {
+    if(async_writer_ && async_writer_->write(data, size)) {
+        return;
+    }
+    detail::log_buffer(log_fd_, data, size);
+}
+
+void
+logger::stop_async() {
+    if(async_writer_) {
+        async_writer_->stop();
+    }
+}
+
 void
 logger::log_syscall(syscall::info info, const long syscall_number,
                     const long args[6], std::optional<long> result) {
@@ -489,7 +684,7 @@ print_syscall:
 
     fmt::format_to(buffer, "\n");
 
-    ::syscall_no_intercept(SYS_write, log_fd_, buffer.data(), buffer.size());
+    write(buffer.data(), buffer.size());
 }
 
 } // namespace gkfs::log
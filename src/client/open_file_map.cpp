@@ -101,6 +101,26 @@ OpenFile::type() const {
     return type_;
 }
 
+size_t
+OpenFile::chunk_size() const {
+    return chunk_size_;
+}
+
+void
+OpenFile::chunk_size(size_t chunk_size) {
+    OpenFile::chunk_size_ = chunk_size;
+}
+
+int64_t
+OpenFile::data_host() const {
+    return data_host_;
+}
+
+void
+OpenFile::data_host(int64_t data_host) {
+    OpenFile::data_host_ = data_host;
+}
+
 // OpenFileMap starts here
 
 shared_ptr<OpenFile>
@@ -125,11 +145,53 @@ OpenFileMap::get_dir(int dirfd) {
 
 bool
 OpenFileMap::exist(const int fd) {
+    if(fd < 0) {
+        return false;
+    }
+    if(fd < fd_bitmap_size) {
+        auto word = fd_bitmap_[fd / 64].load(memory_order_acquire);
+        return (word >> (fd % 64)) & 1;
+    }
+    if(high_fds_.load(memory_order_acquire) == 0) {
+        return false;
+    }
     lock_guard<recursive_mutex> lock(files_mutex_);
     auto f = files_.find(fd);
     return !(f == files_.end());
 }
 
+/**
+ * Adds fd to files_ and the lock-free lookup structures used by exist().
+ * files_mutex_ must be held.
+ */
+void
+OpenFileMap::insert_(int fd, std::shared_ptr<OpenFile> open_file) {
+    if(!files_.insert(make_pair(fd, open_file)).second) {
+        return;
+    }
+    if(fd >= 0 && fd < fd_bitmap_size) {
+        fd_bitmap_[fd / 64].fetch_or(uint64_t{1} << (fd % 64),
+                                     memory_order_release);
+    } else {
+        high_fds_.fetch_add(1, memory_order_release);
+    }
+}
+
+/**
+ * Removes fd from files_ and the lookup structures used by exist(). fd must be
+ * in files_ and files_mutex_ must be held.
+ */
+void
+OpenFileMap::erase_(int fd) {
+    files_.erase(fd);
+    if(fd >= 0 && fd < fd_bitmap_size) {
+        fd_bitmap_[fd / 64].fetch_and(~(uint64_t{1} << (fd % 64)),
+                                      memory_order_release);
+    } else {
+        high_fds_.fetch_sub(1, memory_order_release);
+    }
+}
+
 int
 OpenFileMap::safe_generate_fd_idx_() {
     auto fd = generate_fd_idx();
@@ -156,7 +218,7 @@ int
 OpenFileMap::add(std::shared_ptr<OpenFile> open_file) {
     auto fd = safe_generate_fd_idx_();
     lock_guard<recursive_mutex> lock(files_mutex_);
-    files_.insert(make_pair(fd, open_file));
+    insert_(fd, open_file);
     return fd;
 }
 
@@ -167,7 +229,7 @@ OpenFileMap::remove(const int fd) {
     if(f == files_.end()) {
         return false;
     }
-    files_.erase(fd);
+    erase_(fd);
     if(fd_validation_needed && files_.empty()) {
         fd_validation_needed = false;
         LOG(DEBUG, "fd_validation flag reset");
@@ -184,7 +246,7 @@ OpenFileMap::dup(const int oldfd) {
         return -1;
     }
     auto newfd = safe_generate_fd_idx_();
-    files_.insert(make_pair(newfd, open_file));
+    insert_(newfd, open_file);
     return newfd;
 }
 
@@ -206,7 +268,7 @@ OpenFileMap::dup2(const int oldfd, const int newfd) {
     // by os streams that we do not overwrite
     if(get_fd_idx() < newfd && newfd != 0 && newfd != 1 && newfd != 2)
         fd_validation_needed = true;
-    files_.insert(make_pair(newfd, open_file));
+    insert_(newfd, open_file);
     return newfd;
 }
 
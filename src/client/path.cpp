@@ -38,6 +38,9 @@
 #include <string>
 #include <cassert>
 #include <climits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_set>
 
 extern "C" {
 #include <sys/stat.h>
@@ -50,6 +53,69 @@ namespace gkfs::path {
 
 static const string excluded_paths[2] = {"sys/", "proc/"};
 
+namespace {
+
+/**
+ * @internal
+ * External directories which lstat() reported as directories, i.e., not as
+ * symlinks. resolve() skips the lstat() of these path prefixes, so that a path
+ * below known directories, e.g., within the mountdir, costs hash lookups
+ * instead of one syscall per component. Only the removal or renaming of a
+ * directory can turn a cached entry stale, after which
+ * invalidate_resolve_cache() drops all entries. The generation counter keeps a
+ * lookup that raced with such a change from inserting its outdated result.
+ * Changes made by other processes are not noticed.
+ * @endinternal
+ */
+class DirectoryCache {
+private:
+    shared_mutex mtx_;
+    uint64_t generation_{0};
+    unordered_set<string> dirs_;
+
+public:
+    uint64_t
+    generation() {
+        shared_lock<shared_mutex> lock(mtx_);
+        return generation_;
+    }
+
+    bool
+    contains(const string& dir) {
+        if(gkfs::config::path::resolve_cache_size == 0) {
+            return false;
+        }
+        shared_lock<shared_mutex> lock(mtx_);
+        return dirs_.find(dir) != dirs_.end();
+    }
+
+    void
+    insert(const string& dir, uint64_t generation) {
+        if(gkfs::config::path::resolve_cache_size == 0) {
+            return;
+        }
+        unique_lock<shared_mutex> lock(mtx_);
+        if(generation != generation_) {
+            return;
+        }
+        if(dirs_.size() >= gkfs::config::path::resolve_cache_size) {
+            dirs_.clear();
+        }
+        dirs_.insert(dir);
+    }
+
+    void
+    clear() {
+        unique_lock<shared_mutex> lock(mtx_);
+        ++generation_;
+        dirs_.clear();
+    }
+};
+
+DirectoryCache dir_cache;
+
+} // namespace
+
 /** Match components in path
  *
  * Returns the number of consecutive components at start of `path`
@@ -106,6 +172,8 @@ match_components(const string& path, unsigned int& path_components,
  *
  * returns true if the resolved path fall inside GekkoFS namespace,
  * and false otherwise.
+ *
+ * External directories are cached, see invalidate_resolve_cache().
  */
 bool
 resolve(const string& path, string& resolved, bool resolve_last_link) {
@@ -124,6 +192,7 @@ resolve(const string& path, string& resolved, bool resolve_last_link) {
     }
 
     struct stat st {};
+    const auto cache_generation = dir_cache.generation();
     const ::vector<string>& mnt_components = CTX->mountdir_components();
     unsigned int matched_components =
             0; // matched number of component in mountdir
@@ -192,6 +261,10 @@ resolve(const string& path, string& resolved, bool resolve_last_link) {
                             mnt_components.at(matched_components)) == 0) {
                 ++matched_components;
             }
+            if(dir_cache.contains(resolved)) {
+                ++resolved_components;
+                continue;
+            }
             if(lstat(resolved.c_str(), &st) < 0) {
 
                 LOG(DEBUG, "path \"{}\" does not exist", resolved);
@@ -225,6 +298,9 @@ resolve(const string& path, string& resolved, bool resolve_last_link) {
                 resolved.append(path, end, string::npos);
                 return false;
             }
+            if(S_ISDIR(st.st_mode)) {
+                dir_cache.insert(resolved, cache_generation);
+            }
         } else {
             // Inside GekkoFS
             ++matched_components;
@@ -245,6 +321,16 @@ resolve(const string& path, string& resolved, bool resolve_last_link) {
     return false;
 }
 
+/** Drop all cached external directories
+ *
+ * Must be called after the process removed or renamed an entry outside of
+ * GekkoFS, as a cached directory may have been replaced by a symlink.
+ */
+void
+invalidate_resolve_cache() {
+    dir_cache.clear();
+}
+
 string
 get_sys_cwd() {
     char temp[path::max_length];
@@ -36,6 +36,8 @@
 
 #include <common/rpc/distributor.hpp>
 #include <common/common_defs.hpp>
+#include <common/env_util.hpp>
+#include <common/tracing.hpp>
 
 #include <fstream>
 
@@ -48,6 +50,9 @@ std::unique_ptr<hermes::async_engine> ld_network_service; // extern variable
 
 namespace {
 
+// spans are written to <trace_output>.<pid> at shutdown if not empty
+string trace_output;
+
 #ifdef GKFS_ENABLE_FORWARDING
 pthread_t mapper;
 bool forwarding_running;
@@ -192,6 +197,10 @@ init_environment() {
                        "Failed to load hosts addresses: "s + e.what());
     }
 
+#ifndef GKFS_ENABLE_FORWARDING
+    auto proxy_uri = gkfs::utils::read_proxy_pid_file();
+#endif
+
     // initialize Hermes interface to Mercury
     LOG(INFO, "Initializing RPC subsystem...");
 
@@ -205,6 +214,10 @@ init_environment() {
         exit_error_msg(EXIT_FAILURE,
                        "Failed to connect to hosts: "s + e.what());
     }
+#ifndef GKFS_ENABLE_FORWARDING
+    if(!proxy_uri.empty())
+        gkfs::utils::connect_to_proxy(proxy_uri);
+#endif
 
     /* Setup distributor */
 #ifdef GKFS_ENABLE_FORWARDING
@@ -225,6 +238,12 @@ init_environment() {
 #ifdef GKFS_USE_GUIDED_DISTRIBUTION
     auto distributor = std::make_shared<gkfs::rpc::GuidedDistributor>(
             CTX->local_host_id(), CTX->hosts().size());
+#elif defined(GKFS_USE_STRIPED_DISTRIBUTION)
+    auto distributor = std::make_shared<gkfs::rpc::StripedDistributor>(
+            CTX->local_host_id(), CTX->hosts().size());
+#elif defined(GKFS_USE_WEIGHTED_DISTRIBUTION)
+    auto distributor = std::make_shared<gkfs::rpc::WeightedDistributor>(
+            CTX->local_host_id(), CTX->hosts().size(), CTX->host_weights());
 #else
     auto distributor = std::make_shared<gkfs::rpc::SimpleHashDistributor>(
             CTX->local_host_id(), CTX->hosts().size());
@@ -279,6 +298,13 @@ init_preload() {
 
     LOG(DEBUG, "Current working directory: '{}'", CTX->cwd());
     gkfs::preload::init_environment();
+
+    trace_output = gkfs::env::get_var(gkfs::env::TRACE_OUTPUT);
+    if(!trace_output.empty()) {
+        gkfs::tracing::enable(fmt::format("gkfs_client {} (pid {})",
+                                          CTX->get_hostname(), getpid()));
+        LOG(INFO, "Tracing enabled. Output: '{}.{}'", trace_output, getpid());
+    }
 #if NO_INTERCEPT == 0
     CTX->enable_interception();
 #endif
@@ -314,5 +340,18 @@ destroy_preload() {
 #endif
     LOG(DEBUG, "Syscall interception stopped");
 
+    if(!trace_output.empty()) {
+        auto trace_path = fmt::format("{}.{}", trace_output, getpid());
+        auto err = gkfs::tracing::dump(trace_path);
+        if(err)
+            LOG(ERROR, "Failed to write trace to '{}': {}", trace_path,
+                ::strerror(err));
+    }
+
     LOG(INFO, "All subsystems shut down. Client shutdown complete.");
+
+    // write all buffered log messages, later messages are written directly
+    if(const auto& logger = gkfs::log::get_global_logger()) {
+        logger->stop_async();
+    }
 }
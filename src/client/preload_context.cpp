@@ -28,6 +28,7 @@
 */
 
 #include <client/preload_context.hpp>
+#include <client/preload.hpp>
 #include <client/env.hpp>
 #include <client/logging.hpp>
 #include <client/open_file_map.hpp>
@@ -44,6 +45,7 @@
 
 extern "C" {
 #include <libsyscall_intercept_hook_point.h>
+#include <pthread.h>
 #include <syscall.h>
 }
 
@@ -51,6 +53,123 @@ namespace gkfs {
 
 namespace preload {
 
+HostEndpoints::~HostEndpoints() {
+    clear();
+}
+
+/**
+ * Sets the daemon URIs indexed by host id. No lookup is done here.
+ * @param uris
+ * @param lookup function resolving a URI into an endpoint
+ */
+void
+HostEndpoints::assign(std::vector<std::string> uris, lookup_fn lookup) {
+    clear();
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    endpoints_.resize(uris.size());
+    uris_ = std::move(uris);
+    lookup_ = std::move(lookup);
+}
+
+/**
+ * Looks up the given hosts in a background thread. Failed lookups are ignored
+ * and retried on first use.
+ * @param host_ids lookup order
+ */
+void
+HostEndpoints::prefetch(std::vector<uint64_t> host_ids) {
+    if(prefetch_thread_)
+        return;
+    register_atfork();
+    stop_prefetch_ = false;
+    prefetch_thread_ = std::make_unique<std::thread>(
+            [this, ids = std::move(host_ids)]() {
+                for(const auto id : ids) {
+                    if(stop_prefetch_)
+                        return;
+                    try {
+                        at(id);
+                    } catch(const std::exception& e) {
+                        LOG(WARNING,
+                            "Failed to prefetch endpoint of host '{}': {}", id,
+                            e.what());
+                    }
+                }
+            });
+}
+
+/**
+ * @internal
+ * A forked child only has the forking thread. The endpoint lock is held across
+ * fork() so that the child does not inherit it locked by the prefetch thread.
+ * The child drops the handle of the parent's prefetch thread without joining
+ * it and does not prefetch.
+ * @endinternal
+ */
+void
+HostEndpoints::register_atfork() {
+    static std::once_flag registered;
+    std::call_once(registered, [] {
+        ::pthread_atfork(
+                [] { CTX->hosts().endpoints_mutex_.lock(); },
+                [] { CTX->hosts().endpoints_mutex_.unlock(); },
+                [] {
+                    auto& hosts = CTX->hosts();
+                    hosts.endpoints_mutex_.unlock();
+                    hosts.stop_prefetch_ = true;
+                    // the handle refers to the parent's thread and is leaked
+                    (void) hosts.prefetch_thread_.release();
+                });
+    });
+}
+
+/**
+ * Stops prefetching and releases all endpoints. Must be called before the
+ * RPC subsystem is shut down.
+ */
+void
+HostEndpoints::clear() {
+    stop_prefetch_ = true;
+    if(prefetch_thread_) {
+        prefetch_thread_->join();
+        prefetch_thread_.reset();
+    }
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    endpoints_.clear();
+    uris_.clear();
+}
+
+/**
+ * Returns the endpoint of a host and looks it up on first use. The lookup is
+ * done without holding the lock, so concurrent first uses of different hosts
+ * do not serialize.
+ * @param host_id
+ * @return hermes endpoint
+ * @throws std::out_of_range if the host id is invalid
+ * @throws std::runtime_error if the lookup failed
+ */
+hermes::endpoint
+HostEndpoints::at(uint64_t host_id) const {
+    {
+        std::lock_guard<std::mutex> lock(endpoints_mutex_);
+        const auto& endp = endpoints_.at(host_id);
+        if(endp)
+            return *endp;
+    }
+    auto endp = lookup_(uris_.at(host_id));
+    LOG(DEBUG, "Found peer: {}", endp.to_string());
+    std::lock_guard<std::mutex> lock(endpoints_mutex_);
+    auto& cached = endpoints_.at(host_id);
+    if(!cached)
+        cached = std::move(endp);
+    return *cached;
+}
+
+std::size_t
+HostEndpoints::size() const {
+    return uris_.size();
+}
+
 decltype(PreloadContext::MIN_INTERNAL_FD) constexpr PreloadContext::
         MIN_INTERNAL_FD;
 decltype(PreloadContext::MAX_USER_FDS) constexpr PreloadContext::MAX_USER_FDS;
@@ -92,7 +211,11 @@ PreloadContext::init_logging() {
 
     const bool log_trunc = (!trunc_val.empty() && trunc_val[0] != '0');
 
-    gkfs::log::create_global_logger(log_opts, log_output, log_trunc
+    const std::string async_val = gkfs::env::get_var(gkfs::env::LOG_ASYNC);
+
+    const bool log_async = (!async_val.empty() && async_val[0] != '0');
+
+    gkfs::log::create_global_logger(log_opts, log_output, log_trunc, log_async
 #ifdef GKFS_DEBUG_BUILD
                                     ,
                                     log_filter, log_verbosity
@@ -128,14 +251,14 @@ PreloadContext::cwd() const {
     return cwd_;
 }
 
-const std::vector<hermes::endpoint>&
+const HostEndpoints&
 PreloadContext::hosts() const {
     return hosts_;
 }
 
-void
-PreloadContext::hosts(const std::vector<hermes::endpoint>& endpoints) {
-    hosts_ = endpoints;
+HostEndpoints&
+PreloadContext::hosts() {
+    return hosts_;
 }
 
 void
@@ -143,6 +266,16 @@ PreloadContext::clear_hosts() {
     hosts_.clear();
 }
 
+const std::vector<double>&
+PreloadContext::host_weights() const {
+    return host_weights_;
+}
+
+void
+PreloadContext::host_weights(const std::vector<double>& host_weights) {
+    host_weights_ = host_weights;
+}
+
 uint64_t
 PreloadContext::local_host_id() const {
     return local_host_id_;
@@ -183,6 +316,36 @@ PreloadContext::auto_sm(bool auto_sm) {
     PreloadContext::auto_sm_ = auto_sm;
 }
 
+bool
+PreloadContext::use_proxy() const {
+    return proxy_host_.has_value();
+}
+
+const hermes::endpoint&
+PreloadContext::proxy_host() const {
+    return *proxy_host_;
+}
+
+/**
+ * Sets the node-local proxy endpoint. From then on, all requests supported by
+ * the proxy are sent to it instead of the daemons.
+ * @param host proxy endpoint
+ */
+void
+PreloadContext::proxy_host(const hermes::endpoint& host) {
+    proxy_host_ = host;
+}
+
+bool
+PreloadContext::data_locality() const {
+    return data_locality_;
+}
+
+void
+PreloadContext::data_locality(bool data_locality) {
+    PreloadContext::data_locality_ = data_locality;
+}
+
 RelativizeStatus
 PreloadContext::relativize_fd_path(int dirfd, const char* raw_path,
                                    std::string& relative_path, int flags,
@@ -31,10 +31,12 @@
 #include <client/env.hpp>
 #include <client/logging.hpp>
 #include <client/rpc/forward_metadata.hpp>
+#include <client/rpc/forward_data.hpp>
 
 #include <common/rpc/distributor.hpp>
 #include <common/rpc/rpc_util.hpp>
 #include <common/env_util.hpp>
+#include <common/hosts_file.hpp>
 #include <common/common_defs.hpp>
 
 #include <hermes.hpp>
@@ -44,6 +46,8 @@
 #include <regex>
 #include <csignal>
 #include <random>
+#include <mutex>
+#include <chrono>
 
 extern "C" {
 #include <sys/sysmacros.h>
@@ -134,48 +138,31 @@ extract_protocol(const string& uri) {
 
 /**
  * Reads the daemon generator hosts file by a given path, returning hosts and
- * URI addresses
+ * URI addresses. The optional third column holds the daemon's weight for the
+ * weighted distributor and defaults to 1.
  * @param path to hosts file
+ * @param weights[out] daemon weights in the order of the returned hosts
  * @return vector<pair<hosts, URI>>
  * @throws std::runtime_error
  */
 vector<pair<string, string>>
-load_hostfile(const std::string& path) {
+load_hostfile(const std::string& path, vector<double>& weights) {
 
     LOG(DEBUG, "Loading hosts file: \"{}\"", path);
 
-    ifstream lf(path);
-    if(!lf) {
-        throw runtime_error(fmt::format("Failed to open hosts file '{}': {}",
-                                        path, strerror(errno)));
-    }
-    vector<pair<string, string>> hosts;
-    const regex line_re("^(\\S+)\\s+(\\S+)$",
-                        regex::ECMAScript | regex::optimize);
-    string line;
-    string host;
-    string uri;
-    std::smatch match;
-    while(getline(lf, line)) {
-        if(!regex_match(line, match, line_re)) {
-
-            LOG(ERROR, "Unrecognized line format: [path: '{}', line: '{}']",
-                path, line);
-
-            throw runtime_error(
-                    fmt::format("unrecognized line format: '{}'", line));
-        }
-        host = match[1];
-        uri = match[2];
-        hosts.emplace_back(host, uri);
-    }
-    if(hosts.empty()) {
+    auto entries = gkfs::utils::parse_hosts_file(path);
+    if(entries.empty()) {
         throw runtime_error(
                 "Hosts file found but no suitable addresses could be extracted");
     }
-    extract_protocol(hosts[0].second);
-    // sort hosts so that data always hashes to the same place during restart
-    std::sort(hosts.begin(), hosts.end());
+    extract_protocol(entries[0].uri);
+    vector<pair<string, string>> hosts;
+    hosts.reserve(entries.size());
+    weights.clear();
+    for(auto& e : entries) {
+        hosts.emplace_back(std::move(e.hostname), std::move(e.uri));
+        weights.push_back(e.weight);
+    }
     // remove rootdir suffix from host after sorting as no longer required
     for(auto& h : hosts) {
         auto idx = h.first.rfind("#");
@@ -240,7 +227,7 @@ metadata_to_stat(const std::string& path, const gkfs::metadata::Metadata& md,
     attr.st_uid = CTX->fs_conf()->uid;
     attr.st_gid = CTX->fs_conf()->gid;
     attr.st_rdev = 0;
-    attr.st_blksize = gkfs::config::rpc::chunksize;
+    attr.st_blksize = md.chunk_size();
     attr.st_blocks = 0;
 
     memset(&attr.st_atim, 0, sizeof(timespec));
@@ -358,8 +345,9 @@ read_hosts_file() {
                                   gkfs::config::hostfile_path);
 
     vector<pair<string, string>> hosts;
+    vector<double> weights;
     try {
-        hosts = load_hostfile(hostfile);
+        hosts = load_hostfile(hostfile, weights);
     } catch(const exception& e) {
         auto emsg = fmt::format("Failed to load hosts file: {}", e.what());
         throw runtime_error(emsg);
@@ -370,49 +358,33 @@ read_hosts_file() {
     }
 
     LOG(INFO, "Hosts pool size: {}", hosts.size());
+    CTX->host_weights(weights);
     return hosts;
 }
 
 /**
- * Connects to daemons and lookup Mercury URI addresses via Hermes
+ * Registers the daemons' Mercury URI addresses. Endpoints are looked up via
+ * Hermes on the first RPC to a host and cached afterwards. If
+ * LIBGKFS_PREFETCH_HOSTS is set, all endpoints are additionally looked up in a
+ * background thread.
  * @param hosts vector<pair<hostname, Mercury URI address>>
- * @throws std::runtime_error through lookup_endpoint()
  */
 void
 connect_to_hosts(const vector<pair<string, string>>& hosts) {
     auto local_hostname = gkfs::rpc::get_my_hostname(true);
     bool local_host_found = false;
 
-    std::vector<hermes::endpoint> addrs;
-    addrs.resize(hosts.size());
-
-    vector<uint64_t> host_ids(hosts.size());
-    // populate vector with [0, ..., host_size - 1]
-    ::iota(::begin(host_ids), ::end(host_ids), 0);
-    /*
-     * Shuffle hosts to balance addr lookups to all hosts
-     * Too many concurrent lookups send to same host
-     * could overwhelm the server,
-     * returning error when addr lookup
-     */
-    ::random_device rd; // obtain a random number from hardware
-    ::mt19937 g(rd());  // seed the random generator
-    ::shuffle(host_ids.begin(), host_ids.end(), g); // Shuffle hosts vector
-    // lookup addresses and put abstract server addresses into rpc_addresses
-
-    for(const auto& id : host_ids) {
+    vector<string> uris;
+    uris.reserve(hosts.size());
+    for(uint64_t id = 0; id < hosts.size(); ++id) {
         const auto& hostname = hosts.at(id).first;
-        const auto& uri = hosts.at(id).second;
-
-        addrs[id] = lookup_endpoint(uri);
+        uris.emplace_back(hosts.at(id).second);
 
         if(!local_host_found && hostname == local_hostname) {
             LOG(DEBUG, "Found local host: {}", hostname);
             CTX->local_host_id(id);
             local_host_found = true;
         }
-
-        LOG(DEBUG, "Found peer: {}", addrs[id].to_string());
     }
 
     if(!local_host_found) {
@@ -420,7 +392,130 @@ connect_to_hosts(const vector<pair<string, string>>& hosts) {
         CTX->local_host_id(0);
     }
 
-    CTX->hosts(addrs);
+#ifndef GKFS_ENABLE_FORWARDING
+    // data locality requires a daemon on this node
+    if(gkfs::env::get_var(gkfs::env::DATA_LOCALITY, "0") != "0") {
+        if(local_host_found) {
+            LOG(INFO, "Data locality enabled. Storing new files on host '{}'",
+                CTX->local_host_id());
+            CTX->data_locality(true);
+        } else {
+            LOG(WARNING, "No daemon on this node. Data locality is disabled");
+        }
+    }
+#endif
+
+    CTX->hosts().assign(std::move(uris), [](const string& uri) {
+        return lookup_endpoint(uri);
+    });
+
+    if(gkfs::env::get_var(gkfs::env::PREFETCH_HOSTS, "0") != "0") {
+        vector<uint64_t> host_ids(hosts.size());
+        // populate vector with [0, ..., host_size - 1]
+        ::iota(::begin(host_ids), ::end(host_ids), 0);
+        /*
+         * Shuffle hosts to balance addr lookups to all hosts
+         * Too many concurrent lookups send to same host
+         * could overwhelm the server,
+         * returning error when addr lookup
+         */
+        ::random_device rd; // obtain a random number from hardware
+        ::mt19937 g(rd());  // seed the random generator
+        ::shuffle(host_ids.begin(), host_ids.end(), g); // Shuffle hosts vector
+        CTX->hosts().prefetch(std::move(host_ids));
+    }
+}
+
+#ifndef GKFS_ENABLE_FORWARDING
+/**
+ * Reads the address of the node-local proxy from the pid file given in
+ * LIBGKFS_PROXY_PID_FILE. Using the proxy is optional: If the variable is not
+ * set, the file cannot be read, or the proxy process no longer exists, the
+ * client talks to the daemons directly. Must be called before the RPC
+ * subsystem is initialized as it may enable shared memory.
+ * @return proxy Mercury URI address or an empty string if no proxy is used
+ */
+string
+read_proxy_pid_file() {
+    auto pid_file = gkfs::env::get_var(gkfs::env::PROXY_PID_FILE);
+    if(pid_file.empty())
+        return {};
+
+    ifstream ifs(pid_file);
+    pid_t pid{};
+    string uri{};
+    if(!(ifs >> pid >> uri)) {
+        LOG(WARNING, "Failed to read proxy pid file '{}'. Not using the proxy",
+            pid_file);
+        return {};
+    }
+    if(::kill(pid, 0) != 0 && errno == ESRCH) {
+        LOG(WARNING, "Proxy with pid '{}' is not running. Not using the proxy",
+            pid);
+        return {};
+    }
+    // the proxy is reached via shared memory if it was started with auto_sm
+    if(uri.find(gkfs::rpc::protocol::na_sm) != string::npos &&
+       CTX->rpc_protocol() != gkfs::rpc::protocol::na_sm)
+        CTX->auto_sm(true);
+    LOG(INFO, "Using node-local proxy '{}' (pid '{}')", uri, pid);
+    return uri;
+}
+
+/**
+ * Looks up the node-local proxy which from then on serves all requests it
+ * supports. On failure, the client continues to talk to the daemons directly.
+ * @param uri proxy Mercury URI address
+ */
+void
+connect_to_proxy(const string& uri) {
+    try {
+        CTX->proxy_host(lookup_endpoint(uri));
+    } catch(const exception& e) {
+        LOG(WARNING, "Failed to connect to proxy: {}. Not using the proxy",
+            e.what());
+    }
 }
 
+/**
+ * Determines the daemon that stores all chunks of a new file. With
+ * LIBGKFS_DATA_LOCALITY, this is the daemon on the client's node unless its
+ * free chunk space has fallen below config::data::locality_min_free_ratio. In
+ * that case, new files spill to the distributor's placement. The local
+ * daemon's free space is queried via chunk stat and cached for
+ * config::data::locality_stat_ttl milliseconds.
+ * @return host id of the local daemon, -1 if the distributor places the chunks
+ */
+int64_t
+data_host_for_create() {
+    if(!CTX->data_locality())
+        return -1;
+
+    static mutex stat_mutex;
+    static chrono::steady_clock::time_point last_stat{};
+    static bool local_has_space = false;
+
+    lock_guard<mutex> lock(stat_mutex);
+    auto now = chrono::steady_clock::now();
+    if(last_stat == chrono::steady_clock::time_point{} ||
+       now - last_stat >
+               chrono::milliseconds(gkfs::config::data::locality_stat_ttl)) {
+        auto [err, stat] =
+                gkfs::rpc::forward_get_chunk_stat(CTX->local_host_id());
+        // on error, chunks are placed by the distributor
+        local_has_space =
+                err == 0 && stat.chunk_total > 0 &&
+                static_cast<double>(stat.chunk_free) >=
+                        gkfs::config::data::locality_min_free_ratio *
+                                static_cast<double>(stat.chunk_total);
+        if(!local_has_space) {
+            LOG(DEBUG, "Local host '{}' is low on space. Spilling new files",
+                CTX->local_host_id());
+        }
+        last_stat = now;
+    }
+    return local_has_space ? static_cast<int64_t>(CTX->local_host_id()) : -1;
+}
+#endif
+
 } // namespace gkfs::utils
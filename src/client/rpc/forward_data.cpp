@@ -34,11 +34,210 @@
 
 #include <common/rpc/distributor.hpp>
 #include <common/arithmetic/arithmetic.hpp>
+#include <common/tracing.hpp>
 
 #include <unordered_set>
+#include <unordered_map>
+
+extern "C" {
+#include <sys/uio.h>
+}
 
 using namespace std;
 
+namespace {
+
+/**
+ * Returns the daemon storing a chunk of a file.
+ * @param path
+ * @param chnk_id
+ * @param data_host daemon holding all chunks of the file, -1 if the chunks are
+ * placed by the distributor
+ * @return host id of the chunk's owner
+ */
+gkfs::rpc::host_t
+locate_chunk(const string& path, uint64_t chnk_id, int64_t data_host) {
+    if(data_host >= 0)
+        return static_cast<gkfs::rpc::host_t>(data_host);
+    return CTX->distributor()->locate_data(path, chnk_id);
+}
+
+/**
+ * Returns the daemons storing a range of chunks of a file.
+ * @param path
+ * @param chnk_start
+ * @param chnk_end
+ * @param data_host daemon holding all chunks of the file, -1 if the chunks are
+ * placed by the distributor
+ * @return host id of each chunk's owner, starting with chnk_start
+ */
+std::vector<gkfs::rpc::host_t>
+locate_chunks(const string& path, uint64_t chnk_start, uint64_t chnk_end,
+              int64_t data_host) {
+    if(data_host >= 0)
+        return std::vector<gkfs::rpc::host_t>(
+                chnk_end - chnk_start + 1,
+                static_cast<gkfs::rpc::host_t>(data_host));
+    return CTX->distributor()->locate_data_range(path, chnk_start, chnk_end);
+}
+
+/**
+ * Sends one list I/O RPC to each daemon that owns a chunk of the given file
+ * segments. The file segments are split into chunk extents which are grouped
+ * per daemon. All extents are placed as a table in front of the memory
+ * segments in one exposed memory region. Each daemon reads its part of the
+ * table and then transfers the data of its extents.
+ * @tparam RpcType write_data_list or read_data_list
+ * @param path
+ * @param mem_list memory segments
+ * @param mem_count
+ * @param file_count
+ * @param file_offsets offsets of the file segments
+ * @param file_lengths lengths of the file segments
+ * @param chunk_size chunk size of the file
+ * @param data_host data host of the file, -1 if none
+ * @param mode access mode of the exposed memory
+ * @return pair<error code, transferred size>
+ */
+template <typename RpcType>
+pair<int, ssize_t>
+forward_list(const string& path, const struct iovec* mem_list, int mem_count,
+             int file_count, const off64_t* file_offsets,
+             const size_t* file_lengths, size_t chunk_size, int64_t data_host,
+             hermes::access_mode mode) {
+
+    // import pow2-optimized arithmetic functions
+    using namespace gkfs::utils::arithmetic;
+    using gkfs::rpc::chnk_extent;
+
+    // Split file segments into chunk extents and group them per target.
+    // origin_offset is relative to the data for now.
+    std::map<uint64_t, std::vector<chnk_extent>> target_extents{};
+    std::vector<uint64_t> targets{};
+    uint64_t data_offset = 0;
+    for(int i = 0; i < file_count; ++i) {
+        auto offset = static_cast<uint64_t>(file_offsets[i]);
+        auto left = static_cast<uint64_t>(file_lengths[i]);
+        while(left > 0) {
+            auto chnk_id = block_index(offset, chunk_size);
+            auto chnk_offset = block_overrun(offset, chunk_size);
+            auto size = std::min<uint64_t>(left, chunk_size - chnk_offset);
+            auto target = locate_chunk(path, chnk_id, data_host);
+            if(target_extents.count(target) == 0) {
+                targets.push_back(target);
+            }
+            target_extents[target].push_back(
+                    chnk_extent{chnk_id, chnk_offset, size, data_offset});
+            offset += size;
+            left -= size;
+            data_offset += size;
+        }
+    }
+
+    // extent table in front of the data, grouped by target
+    std::vector<chnk_extent> table{};
+    std::vector<uint64_t> table_offsets{};
+    std::vector<uint64_t> target_sizes{};
+    for(const auto& target : targets) {
+        table_offsets.push_back(table.size() * sizeof(chnk_extent));
+        uint64_t target_size = 0;
+        for(const auto& extent : target_extents[target]) {
+            table.push_back(extent);
+            target_size += extent.size;
+        }
+        // daemons reject larger requests
+        auto extent_n = target_extents[target].size();
+        if(extent_n > gkfs::config::rpc::max_list_extents ||
+           target_size > gkfs::config::rpc::max_list_size) {
+            LOG(ERROR, "List I/O request for host {} exceeds limits", target);
+            return make_pair(EINVAL, 0);
+        }
+        target_sizes.push_back(target_size);
+    }
+    auto table_size = table.size() * sizeof(chnk_extent);
+    for(auto& extent : table) {
+        extent.origin_offset += table_size;
+    }
+
+    std::vector<hermes::mutable_buffer> bufseq{
+            hermes::mutable_buffer{table.data(), table_size},
+    };
+    for(int i = 0; i < mem_count; ++i) {
+        if(mem_list[i].iov_len > 0)
+            bufseq.emplace_back(mem_list[i].iov_base, mem_list[i].iov_len);
+    }
+
+    // expose user buffers so that they can serve as RDMA data sources or
+    // targets (these are automatically "unexposed" when the destructor is
+    // called)
+    hermes::exposed_memory local_buffers;
+
+    try {
+        local_buffers = ld_network_service->expose(bufseq, mode);
+    } catch(const std::exception& ex) {
+        LOG(ERROR, "Failed to expose buffers for RMA");
+        return make_pair(EBUSY, 0);
+    }
+
+    std::vector<hermes::rpc_handle<RpcType>> handles;
+
+    for(std::size_t idx = 0; idx < targets.size(); idx++) {
+        auto target = targets[idx];
+        try {
+            LOG(DEBUG, "host: {}, path: \"{}\", extents: {}, size: {}",
+                target, path, target_extents[target].size(),
+                target_sizes[idx]);
+
+            typename RpcType::input in(
+                    path, target, CTX->hosts().size(),
+                    target_extents[target].size(), table_offsets[idx],
+                    target_sizes[idx], chunk_size, data_host, local_buffers);
+
+            handles.emplace_back(ld_network_service->post<RpcType>(
+                    CTX->hosts().at(target), in));
+
+        } catch(const std::exception& ex) {
+            LOG(ERROR,
+                "Unable to send non-blocking rpc for path \"{}\" "
+                "[peer: {}]",
+                path, target);
+            return make_pair(EBUSY, 0);
+        }
+    }
+
+    // Wait for RPC responses and then get response and add it to out_size.
+    // All potential outputs are served to free resources regardless of
+    // errors, although an errorcode is set.
+    auto err = 0;
+    ssize_t out_size = 0;
+    std::size_t idx = 0;
+
+    for(const auto& h : handles) {
+        try {
+            auto out = h.get().at(0);
+
+            if(out.err() != 0) {
+                LOG(ERROR, "Daemon reported error: {}", out.err());
+                err = out.err();
+            }
+
+            out_size += static_cast<size_t>(out.io_size());
+
+        } catch(const std::exception& ex) {
+            LOG(ERROR, "Failed to get rpc output for path \"{}\" [peer: {}]",
+                path, targets[idx]);
+            err = EIO;
+        }
+        idx++;
+    }
+    if(err)
+        return make_pair(err, 0);
+    else
+        return make_pair(0, out_size);
+}
+
+} // namespace
+
 namespace gkfs::rpc {
 
 /*
@@ -57,12 +256,40 @@ namespace gkfs::rpc {
  * @param in_offset
  * @param write_size
  * @param updated_metadentry_size
+ * @param chunk_size
+ * @param data_host
  * @return pair<error code, written size>
  */
 pair<int, ssize_t>
 forward_write(const string& path, const void* buf, const bool append_flag,
               const off64_t in_offset, const size_t write_size,
-              const int64_t updated_metadentry_size) {
+              const int64_t updated_metadentry_size, const size_t chunk_size,
+              const int64_t data_host) {
+    iovec iov{const_cast<void*>(buf), write_size};
+    return forward_writev(path, &iov, 1, append_flag, in_offset, write_size,
+                          updated_metadentry_size, chunk_size, data_host);
+}
+
+/**
+ * Send an RPC request to write from multiple buffers to a contiguous file
+ * range. All buffers are exposed as one multi-segment memory region so that
+ * each daemon is contacted only once.
+ * @param path
+ * @param iov
+ * @param iovcnt
+ * @param append_flag
+ * @param in_offset
+ * @param write_size sum of all buffer lengths
+ * @param updated_metadentry_size
+ * @param chunk_size
+ * @param data_host daemon holding all chunks of the file, -1 if none
+ * @return pair<error code, written size>
+ */
+pair<int, ssize_t>
+forward_writev(const string& path, const struct iovec* iov, int iovcnt,
+               const bool append_flag, const off64_t in_offset,
+               const size_t write_size, const int64_t updated_metadentry_size,
+               const size_t chunk_size, const int64_t data_host) {
 
     // import pow2-optimized arithmetic functions
     using namespace gkfs::utils::arithmetic;
@@ -71,16 +298,17 @@ forward_write(const string& path, const void* buf, const bool append_flag,
 
     // Calculate chunkid boundaries and numbers so that daemons know in
     // which interval to look for chunks
+    // appends use the range reserved by the metadata daemon which ends at
+    // the updated size
     off64_t offset =
-            append_flag ? in_offset : (updated_metadentry_size - write_size);
+            append_flag ? (updated_metadentry_size - write_size) : in_offset;
 
-    auto chnk_start = block_index(offset, gkfs::config::rpc::chunksize);
-    auto chnk_end = block_index((offset + write_size) - 1,
-                                gkfs::config::rpc::chunksize);
+    auto chnk_start = block_index(offset, chunk_size);
+    auto chnk_end = block_index((offset + write_size) - 1, chunk_size);
 
-    // Collect all chunk ids within count that have the same destination so
-    // that those are send in one rpc bulk transfer
-    std::map<uint64_t, std::vector<uint64_t>> target_chnks{};
+    // Count the chunks within count that have the same destination so that
+    // those are send in one rpc bulk transfer
+    std::unordered_map<uint64_t, uint64_t> target_chnks{};
     // contains the target ids, used to access the target_chnks map.
     // First idx is chunk with potential offset
     std::vector<uint64_t> targets{};
@@ -89,15 +317,18 @@ forward_write(const string& path, const void* buf, const bool append_flag,
     uint64_t chnk_start_target = 0;
     uint64_t chnk_end_target = 0;
 
+    // the node-local proxy receives all chunks in a single request and
+    // distributes them to the daemons
+    std::vector<gkfs::rpc::host_t> owners{};
+    if(!CTX->use_proxy()) {
+        owners = locate_chunks(path, chnk_start, chnk_end, data_host);
+    }
+
     for(uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-        auto target = CTX->distributor()->locate_data(path, chnk_id);
+        uint64_t target = CTX->use_proxy() ? 0 : owners[chnk_id - chnk_start];
 
-        if(target_chnks.count(target) == 0) {
-            target_chnks.insert(
-                    std::make_pair(target, std::vector<uint64_t>{chnk_id}));
+        if(target_chnks[target]++ == 0) {
             targets.push_back(target);
-        } else {
-            target_chnks[target].push_back(chnk_id);
         }
 
         // set first and last chnk targets
@@ -111,15 +342,18 @@ forward_write(const string& path, const void* buf, const bool append_flag,
     }
 
     // some helper variables for async RPC
-    std::vector<hermes::mutable_buffer> bufseq{
-            hermes::mutable_buffer{const_cast<void*>(buf), write_size},
-    };
+    std::vector<hermes::mutable_buffer> bufseq{};
+    for(int i = 0; i < iovcnt; ++i) {
+        if(iov[i].iov_len > 0)
+            bufseq.emplace_back(iov[i].iov_base, iov[i].iov_len);
+    }
 
     // expose user buffers so that they can serve as RDMA data sources
     // (these are automatically "unexposed" when the destructor is called)
     hermes::exposed_memory local_buffers;
 
     try {
+        gkfs::tracing::Span expose_span("client.expose_buffers");
         local_buffers = ld_network_service->expose(
                 bufseq, hermes::access_mode::read_only);
 
@@ -128,6 +362,8 @@ forward_write(const string& path, const void* buf, const bool append_flag,
         return make_pair(EBUSY, 0);
     }
 
+    // covers issuing all RPCs and waiting for their responses
+    gkfs::tracing::Span rpc_span("client.write_rpc");
     std::vector<hermes::rpc_handle<gkfs::rpc::write_data>> handles;
 
     // Issue non-blocking RPC requests and wait for the result later
@@ -138,25 +374,22 @@ forward_write(const string& path, const void* buf, const bool append_flag,
     for(const auto& target : targets) {
 
         // total chunk_size for target
-        auto total_chunk_size =
-                target_chnks[target].size() * gkfs::config::rpc::chunksize;
+        auto total_chunk_size = target_chnks[target] * chunk_size;
 
         // receiver of first chunk must subtract the offset from first chunk
         if(target == chnk_start_target) {
-            total_chunk_size -=
-                    block_overrun(offset, gkfs::config::rpc::chunksize);
+            total_chunk_size -= block_overrun(offset, chunk_size);
         }
 
         // receiver of last chunk must subtract
         if(target == chnk_end_target &&
-           !is_aligned(offset + write_size, gkfs::config::rpc::chunksize)) {
-            total_chunk_size -= block_underrun(offset + write_size,
-                                               gkfs::config::rpc::chunksize);
+           !is_aligned(offset + write_size, chunk_size)) {
+            total_chunk_size -= block_underrun(offset + write_size, chunk_size);
         }
 
-        auto endp = CTX->hosts().at(target);
-
         try {
+            auto endp = CTX->use_proxy() ? CTX->proxy_host()
+                                         : CTX->hosts().at(target);
 
             LOG(DEBUG, "Sending RPC ...");
 
@@ -164,16 +397,17 @@ forward_write(const string& path, const void* buf, const bool append_flag,
                     path,
                     // first offset in targets is the chunk with
                     // a potential offset
-                    block_overrun(offset, gkfs::config::rpc::chunksize), target,
+                    block_overrun(offset, chunk_size), target,
                     CTX->hosts().size(),
                     // number of chunks handled by that destination
-                    target_chnks[target].size(),
+                    target_chnks[target],
                     // chunk start id of this write
                     chnk_start,
                     // chunk end id of this write
                     chnk_end,
                     // total size to write
-                    total_chunk_size, local_buffers);
+                    total_chunk_size, chunk_size, data_host,
+                    gkfs::tracing::current_trace_id(), local_buffers);
 
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
             // we can retry for RPC_TRIES (see old commits with margo)
@@ -241,24 +475,48 @@ forward_write(const string& path, const void* buf, const bool append_flag,
  * @param buf
  * @param offset
  * @param read_size
+ * @param chunk_size
+ * @param data_host
  * @return pair<error code, read size>
  */
 pair<int, ssize_t>
 forward_read(const string& path, void* buf, const off64_t offset,
-             const size_t read_size) {
+             const size_t read_size, const size_t chunk_size,
+             const int64_t data_host) {
+    iovec iov{buf, read_size};
+    return forward_readv(path, &iov, 1, offset, read_size, chunk_size,
+                         data_host);
+}
+
+/**
+ * Send an RPC request to read a contiguous file range to multiple buffers.
+ * All buffers are exposed as one multi-segment memory region so that each
+ * daemon is contacted only once.
+ * @param path
+ * @param iov
+ * @param iovcnt
+ * @param offset
+ * @param read_size sum of all buffer lengths
+ * @param chunk_size
+ * @param data_host daemon holding all chunks of the file, -1 if none
+ * @return pair<error code, read size>
+ */
+pair<int, ssize_t>
+forward_readv(const string& path, const struct iovec* iov, int iovcnt,
+              const off64_t offset, const size_t read_size,
+              const size_t chunk_size, const int64_t data_host) {
 
     // import pow2-optimized arithmetic functions
     using namespace gkfs::utils::arithmetic;
 
     // Calculate chunkid boundaries and numbers so that daemons know in which
     // interval to look for chunks
-    auto chnk_start = block_index(offset, gkfs::config::rpc::chunksize);
-    auto chnk_end =
-            block_index((offset + read_size - 1), gkfs::config::rpc::chunksize);
+    auto chnk_start = block_index(offset, chunk_size);
+    auto chnk_end = block_index((offset + read_size - 1), chunk_size);
 
-    // Collect all chunk ids within count that have the same destination so
-    // that those are send in one rpc bulk transfer
-    std::map<uint64_t, std::vector<uint64_t>> target_chnks{};
+    // Count the chunks within count that have the same destination so that
+    // those are send in one rpc bulk transfer
+    std::unordered_map<uint64_t, uint64_t> target_chnks{};
     // contains the recipient ids, used to access the target_chnks map.
     // First idx is chunk with potential offset
     std::vector<uint64_t> targets{};
@@ -266,15 +524,18 @@ forward_read(const string& path, void* buf, const off64_t offset,
     uint64_t chnk_start_target = 0;
     uint64_t chnk_end_target = 0;
 
+    // the node-local proxy receives all chunks in a single request and
+    // distributes them to the daemons
+    std::vector<gkfs::rpc::host_t> owners{};
+    if(!CTX->use_proxy()) {
+        owners = locate_chunks(path, chnk_start, chnk_end, data_host);
+    }
+
     for(uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
-        auto target = CTX->distributor()->locate_data(path, chnk_id);
+        uint64_t target = CTX->use_proxy() ? 0 : owners[chnk_id - chnk_start];
 
-        if(target_chnks.count(target) == 0) {
-            target_chnks.insert(
-                    std::make_pair(target, std::vector<uint64_t>{chnk_id}));
+        if(target_chnks[target]++ == 0) {
             targets.push_back(target);
-        } else {
-            target_chnks[target].push_back(chnk_id);
         }
 
         // set first and last chnk targets
@@ -288,15 +549,18 @@ forward_read(const string& path, void* buf, const off64_t offset,
     }
 
     // some helper variables for async RPCs
-    std::vector<hermes::mutable_buffer> bufseq{
-            hermes::mutable_buffer{buf, read_size},
-    };
+    std::vector<hermes::mutable_buffer> bufseq{};
+    for(int i = 0; i < iovcnt; ++i) {
+        if(iov[i].iov_len > 0)
+            bufseq.emplace_back(iov[i].iov_base, iov[i].iov_len);
+    }
 
     // expose user buffers so that they can serve as RDMA data targets
     // (these are automatically "unexposed" when the destructor is called)
     hermes::exposed_memory local_buffers;
 
     try {
+        gkfs::tracing::Span expose_span("client.expose_buffers");
         local_buffers = ld_network_service->expose(
                 bufseq, hermes::access_mode::write_only);
 
@@ -305,6 +569,8 @@ forward_read(const string& path, void* buf, const off64_t offset,
         return make_pair(EBUSY, 0);
     }
 
+    // covers issuing all RPCs and waiting for their responses
+    gkfs::tracing::Span rpc_span("client.read_rpc");
     std::vector<hermes::rpc_handle<gkfs::rpc::read_data>> handles;
 
     // Issue non-blocking RPC requests and wait for the result later
@@ -315,25 +581,22 @@ forward_read(const string& path, void* buf, const off64_t offset,
     for(const auto& target : targets) {
 
         // total chunk_size for target
-        auto total_chunk_size =
-                target_chnks[target].size() * gkfs::config::rpc::chunksize;
+        auto total_chunk_size = target_chnks[target] * chunk_size;
 
         // receiver of first chunk must subtract the offset from first chunk
         if(target == chnk_start_target) {
-            total_chunk_size -=
-                    block_overrun(offset, gkfs::config::rpc::chunksize);
+            total_chunk_size -= block_overrun(offset, chunk_size);
         }
 
         // receiver of last chunk must subtract
         if(target == chnk_end_target &&
-           !is_aligned(offset + read_size, gkfs::config::rpc::chunksize)) {
-            total_chunk_size -= block_underrun(offset + read_size,
-                                               gkfs::config::rpc::chunksize);
+           !is_aligned(offset + read_size, chunk_size)) {
+            total_chunk_size -= block_underrun(offset + read_size, chunk_size);
         }
 
-        auto endp = CTX->hosts().at(target);
-
         try {
+            auto endp = CTX->use_proxy() ? CTX->proxy_host()
+                                         : CTX->hosts().at(target);
 
             LOG(DEBUG, "Sending RPC ...");
 
@@ -341,16 +604,17 @@ forward_read(const string& path, void* buf, const off64_t offset,
                     path,
                     // first offset in targets is the chunk with
                     // a potential offset
-                    block_overrun(offset, gkfs::config::rpc::chunksize), target,
+                    block_overrun(offset, chunk_size), target,
                     CTX->hosts().size(),
                     // number of chunks handled by that destination
-                    target_chnks[target].size(),
+                    target_chnks[target],
                     // chunk start id of this write
                     chnk_start,
                     // chunk end id of this write
                     chnk_end,
                     // total size to write
-                    total_chunk_size, local_buffers);
+                    total_chunk_size, chunk_size, data_host,
+                    gkfs::tracing::current_trace_id(), local_buffers);
 
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
             // we can retry for RPC_TRIES (see old commits with margo)
@@ -417,16 +681,65 @@ forward_read(const string& path, void* buf, const off64_t offset,
         return make_pair(0, out_size);
 }
 
+/**
+ * Send RPC requests to write non-contiguous file segments from non-contiguous
+ * memory segments. Each daemon is contacted once for all its chunk extents.
+ * @param path
+ * @param mem_list
+ * @param mem_count
+ * @param file_count
+ * @param file_offsets
+ * @param file_lengths
+ * @param chunk_size
+ * @param data_host
+ * @return pair<error code, written size>
+ */
+pair<int, ssize_t>
+forward_write_list(const std::string& path, const struct iovec* mem_list,
+                   int mem_count, int file_count, const off64_t* file_offsets,
+                   const size_t* file_lengths, const size_t chunk_size,
+                   const int64_t data_host) {
+    return forward_list<gkfs::rpc::write_data_list>(
+            path, mem_list, mem_count, file_count, file_offsets, file_lengths,
+            chunk_size, data_host, hermes::access_mode::read_only);
+}
+
+/**
+ * Send RPC requests to read non-contiguous file segments to non-contiguous
+ * memory segments. Each daemon is contacted once for all its chunk extents.
+ * @param path
+ * @param mem_list
+ * @param mem_count
+ * @param file_count
+ * @param file_offsets
+ * @param file_lengths
+ * @param chunk_size
+ * @param data_host
+ * @return pair<error code, read size>
+ */
+pair<int, ssize_t>
+forward_read_list(const std::string& path, const struct iovec* mem_list,
+                  int mem_count, int file_count, const off64_t* file_offsets,
+                  const size_t* file_lengths, const size_t chunk_size,
+                  const int64_t data_host) {
+    // the daemons pull the extent table and push the data
+    return forward_list<gkfs::rpc::read_data_list>(
+            path, mem_list, mem_count, file_count, file_offsets, file_lengths,
+            chunk_size, data_host, hermes::access_mode::read_write);
+}
+
 /**
  * Send an RPC request to truncate a file to given new size
  * @param path
  * @param current_size
  * @param new_size
+ * @param chunk_size
+ * @param data_host
  * @return error code
  */
 int
 forward_truncate(const std::string& path, size_t current_size,
-                 size_t new_size) {
+                 size_t new_size, size_t chunk_size, int64_t data_host) {
 
     // import pow2-optimized arithmetic functions
     using namespace gkfs::utils::arithmetic;
@@ -434,16 +747,22 @@ forward_truncate(const std::string& path, size_t current_size,
     assert(current_size > new_size);
 
     // Find out which data servers need to delete data chunks in order to
-    // contact only them
-    const unsigned int chunk_start =
-            block_index(new_size, gkfs::config::rpc::chunksize);
-    const unsigned int chunk_end = block_index(current_size - new_size - 1,
-                                               gkfs::config::rpc::chunksize);
-
-    std::unordered_set<unsigned int> hosts;
-    for(unsigned int chunk_id = chunk_start; chunk_id <= chunk_end;
-        ++chunk_id) {
-        hosts.insert(CTX->distributor()->locate_data(path, chunk_id));
+    // contact only them. The work is bounded by the number of daemons: if the
+    // removed chunk range is at least as large, all daemons are contacted.
+    const uint64_t chunk_start = block_index(new_size, chunk_size);
+    const uint64_t chunk_end = block_index(current_size - 1, chunk_size);
+    const auto hosts_size = CTX->hosts().size();
+
+    std::unordered_set<gkfs::rpc::host_t> hosts;
+    if(data_host >= 0) {
+        hosts.insert(static_cast<gkfs::rpc::host_t>(data_host));
+    } else if(chunk_end - chunk_start + 1 >= hosts_size) {
+        for(gkfs::rpc::host_t host = 0; host < hosts_size; ++host)
+            hosts.insert(host);
+    } else {
+        auto owners = CTX->distributor()->locate_data_range(path, chunk_start,
+                                                            chunk_end);
+        hosts.insert(owners.begin(), owners.end());
     }
 
     std::vector<hermes::rpc_handle<gkfs::rpc::trunc_data>> handles;
@@ -452,12 +771,11 @@ forward_truncate(const std::string& path, size_t current_size,
 
     for(const auto& host : hosts) {
 
-        auto endp = CTX->hosts().at(host);
-
         try {
+            auto endp = CTX->hosts().at(host);
             LOG(DEBUG, "Sending RPC ...");
 
-            gkfs::rpc::trunc_data::input in(path, new_size);
+            gkfs::rpc::trunc_data::input in(path, new_size, chunk_size);
 
             // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
             // we can retry for RPC_TRIES (see old commits with margo)
@@ -495,6 +813,166 @@ forward_truncate(const std::string& path, size_t current_size,
     return err ? err : 0;
 }
 
+/**
+ * Send an RPC request to copy a byte range of one file to another without
+ * moving the data through the client. Each daemon that stores a source chunk
+ * of the range reads its local chunks and writes them to the destination chunk
+ * owners, either locally or by pushing them to the corresponding daemon.
+ * The destination file size must be updated by the caller.
+ * @param src_path
+ * @param src_offset
+ * @param dst_path
+ * @param dst_offset
+ * @param count
+ * @param src_chunk_size
+ * @param dst_chunk_size
+ * @param src_data_host
+ * @param dst_data_host
+ * @return pair<error code, copied size>
+ */
+pair<int, ssize_t>
+forward_copy_data(const std::string& src_path, off64_t src_offset,
+                  const std::string& dst_path, off64_t dst_offset,
+                  size_t count, size_t src_chunk_size, size_t dst_chunk_size,
+                  int64_t src_data_host, int64_t dst_data_host) {
+
+    // import pow2-optimized arithmetic functions
+    using namespace gkfs::utils::arithmetic;
+
+    auto chnk_start = block_index(src_offset, src_chunk_size);
+    auto chnk_end = block_index((src_offset + count - 1), src_chunk_size);
+
+    // only daemons that hold source chunks need to be contacted
+    std::unordered_set<uint64_t> targets{};
+    for(uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+        targets.insert(locate_chunk(src_path, chnk_id, src_data_host));
+        if(targets.size() == CTX->hosts().size()) {
+            break;
+        }
+    }
+
+    std::vector<hermes::rpc_handle<gkfs::rpc::copy_data>> handles;
+
+    auto err = 0;
+
+    for(const auto& target : targets) {
+        try {
+            LOG(DEBUG, "Sending RPC to host: {}", target);
+
+            gkfs::rpc::copy_data::input in(
+                    src_path, dst_path, src_offset, dst_offset, count, target,
+                    CTX->hosts().size(), src_chunk_size, dst_chunk_size,
+                    src_data_host, dst_data_host);
+
+            // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that
+            // we can retry for RPC_TRIES (see old commits with margo)
+            // TODO(amiranda): hermes will eventually provide a post(endpoint)
+            // returning one result and a broadcast(endpoint_set) returning a
+            // result_set. When that happens we can remove the .at(0) :/
+            handles.emplace_back(
+                    ld_network_service->post<gkfs::rpc::copy_data>(
+                            CTX->hosts().at(target), in));
+
+        } catch(const std::exception& ex) {
+            LOG(ERROR, "Failed to send request to host: {}", target);
+            err = EBUSY;
+            break; // We need to gather all responses so we can't return here
+        }
+    }
+
+    // Wait for RPC responses and then get response
+    size_t out_size = 0;
+    for(const auto& h : handles) {
+        try {
+            // XXX We might need a timeout here to not wait forever for an
+            // output that never comes?
+            auto out = h.get().at(0);
+
+            if(out.err() != 0) {
+                LOG(ERROR, "Daemon reported error: {}", out.err());
+                err = out.err();
+            }
+            out_size += static_cast<size_t>(out.io_size());
+        } catch(const std::exception& ex) {
+            LOG(ERROR, "Failed to get rpc output for path \"{}\"", src_path);
+            err = EIO;
+        }
+    }
+    if(err)
+        return make_pair(err, 0);
+    else
+        return make_pair(0, out_size);
+}
+
+/**
+ * Send an RPC request to reserve backend storage for a byte range of a file.
+ * All daemons owning a chunk in the range preallocate their chunk files in
+ * parallel. The file size is not changed.
+ * @param path
+ * @param offset
+ * @param length
+ * @param chunk_size
+ * @param data_host
+ * @return error code
+ */
+int
+forward_fallocate(const std::string& path, off64_t offset, size_t length,
+                  size_t chunk_size, int64_t data_host) {
+
+    // import pow2-optimized arithmetic functions
+    using namespace gkfs::utils::arithmetic;
+
+    auto chnk_start = block_index(offset, chunk_size);
+    auto chnk_end = block_index((offset + length - 1), chunk_size);
+
+    std::unordered_set<uint64_t> targets{};
+    for(uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+        targets.insert(locate_chunk(path, chnk_id, data_host));
+        if(targets.size() == CTX->hosts().size()) {
+            break;
+        }
+    }
+
+    std::vector<hermes::rpc_handle<gkfs::rpc::fallocate>> handles;
+
+    auto err = 0;
+
+    for(const auto& target : targets) {
+        try {
+            LOG(DEBUG, "Sending RPC to host: {}", target);
+
+            gkfs::rpc::fallocate::input in(path, offset, length, target,
+                                           CTX->hosts().size(), chunk_size,
+                                           data_host);
+
+            handles.emplace_back(
+                    ld_network_service->post<gkfs::rpc::fallocate>(
+                            CTX->hosts().at(target), in));
+
+        } catch(const std::exception& ex) {
+            LOG(ERROR, "Failed to send request to host: {}", target);
+            err = EBUSY;
+            break; // We need to gather all responses so we can't return here
+        }
+    }
+
+    // Wait for RPC responses and then get response
+    for(const auto& h : handles) {
+        try {
+            auto out = h.get().at(0);
+
+            if(out.err() != 0) {
+                LOG(ERROR, "Daemon reported error: {}", out.err());
+                err = out.err();
+            }
+        } catch(const std::exception& ex) {
+            LOG(ERROR, "Failed to get rpc output for path \"{}\"", path);
+            err = EIO;
+        }
+    }
+    return err;
+}
+
 /**
  * Send an RPC request to chunk stat all hosts
  * @return pair<error code, rpc::ChunkStat>
@@ -506,8 +984,9 @@ forward_get_chunk_stat() {
 
     auto err = 0;
 
-    for(const auto& endp : CTX->hosts()) {
+    for(std::size_t host_id = 0; host_id < CTX->hosts().size(); host_id++) {
         try {
+            auto endp = CTX->hosts().at(host_id);
             LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
 
             gkfs::rpc::chunk_stat::input in(0);
@@ -523,7 +1002,7 @@ forward_get_chunk_stat() {
         } catch(const std::exception& ex) {
             // TODO(amiranda): we should cancel all previously posted requests
             // here, unfortunately, Hermes does not support it yet :/
-            LOG(ERROR, "Failed to send request to host: {}", endp.to_string());
+            LOG(ERROR, "Failed to send request to host: {}", host_id);
             err = EBUSY;
             break; // We need to gather all responses so we can't return here
         }
@@ -546,8 +1025,8 @@ forward_get_chunk_stat() {
             if(out.err()) {
                 err = out.err();
                 LOG(ERROR,
-                    "Host '{}' reported err code '{}' during stat chunk.",
-                    CTX->hosts().at(i).to_string(), err);
+                    "Host '{}' reported err code '{}' during stat chunk.", i,
+                    err);
                 // we don't break here to ensure all responses are processed
                 continue;
             }
@@ -565,4 +1044,35 @@ forward_get_chunk_stat() {
         return make_pair(0, ChunkStat{chunk_size, chunk_total, chunk_free});
 }
 
+/**
+ * Send an RPC request to chunk stat a single host
+ * @param host host id of the daemon
+ * @return pair<error code, rpc::ChunkStat>
+ */
+pair<int, ChunkStat>
+forward_get_chunk_stat(uint64_t host) {
+
+    try {
+        LOG(DEBUG, "Sending RPC to host: {}", host);
+
+        gkfs::rpc::chunk_stat::input in(0);
+
+        auto out = ld_network_service
+                           ->post<gkfs::rpc::chunk_stat>(CTX->hosts().at(host),
+                                                         in)
+                           .get()
+                           .at(0);
+        if(out.err()) {
+            LOG(ERROR, "Host '{}' reported err code '{}' during stat chunk.",
+                host, out.err());
+            return make_pair(out.err(), ChunkStat{});
+        }
+        return make_pair(0, ChunkStat{out.chunk_size(), out.chunk_total(),
+                                      out.chunk_free()});
+    } catch(const std::exception& ex) {
+        LOG(ERROR, "Failed to get RPC output from host: {}", host);
+        return make_pair(EBUSY, ChunkStat{});
+    }
+}
+
 } // namespace gkfs::rpc
@@ -42,10 +42,10 @@ namespace gkfs::rpc {
 bool
 forward_get_fs_config() {
 
-    auto endp = CTX->hosts().at(CTX->local_host_id());
     gkfs::rpc::fs_config::output out;
 
     try {
+        auto endp = CTX->hosts().at(CTX->local_host_id());
         LOG(DEBUG, "Retrieving file system configurations from daemon");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
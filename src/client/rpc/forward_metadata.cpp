@@ -28,6 +28,7 @@
 */
 
 #include <client/rpc/forward_metadata.hpp>
+#include <client/gkfs_functions.hpp>
 #include <client/preload.hpp>
 #include <client/logging.hpp>
 #include <client/preload_util.hpp>
@@ -37,9 +38,30 @@
 #include <common/rpc/rpc_util.hpp>
 #include <common/rpc/distributor.hpp>
 #include <common/rpc/rpc_types.hpp>
+#include <common/tracing.hpp>
+
+#include <numeric>
 
 using namespace std;
 
+namespace {
+
+/**
+ * Returns the endpoint to which a file metadata request for a path is sent.
+ * This is the node-local proxy if it is used, otherwise the responsible daemon.
+ * @param path
+ * @return hermes endpoint
+ * @throws std::runtime_error if the daemon's endpoint cannot be looked up
+ */
+hermes::endpoint
+metadata_endpoint(const std::string& path) {
+    if(CTX->use_proxy())
+        return CTX->proxy_host();
+    return CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+}
+
+} // namespace
+
 namespace gkfs::rpc {
 
 /*
@@ -51,21 +73,26 @@ namespace gkfs::rpc {
  * Send an RPC for a create request
  * @param path
  * @param mode
+ * @param chunk_size chunk size of the new file
+ * @param data_host daemon storing all chunks of the new file, -1 if the chunks
+ * are placed by the distributor
  * @return error code
  */
 int
-forward_create(const std::string& path, const mode_t mode) {
-
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+forward_create(const std::string& path, const mode_t mode,
+               const size_t chunk_size, const int64_t data_host) {
 
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
         // TODO(amiranda): hermes will eventually provide a post(endpoint)
         // returning one result and a broadcast(endpoint_set) returning a
         // result_set. When that happens we can remove the .at(0) :/
-        auto out = ld_network_service->post<gkfs::rpc::create>(endp, path, mode)
+        auto out = ld_network_service
+                           ->post<gkfs::rpc::create>(endp, path, mode,
+                                                     chunk_size, data_host)
                            .get()
                            .at(0);
         LOG(DEBUG, "Got response success: {}", out.err());
@@ -86,9 +113,8 @@ forward_create(const std::string& path, const mode_t mode) {
 int
 forward_stat(const std::string& path, string& attr) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
@@ -111,6 +137,33 @@ forward_stat(const std::string& path, string& attr) {
     return 0;
 }
 
+/**
+ * Send an RPC to change the chunk size of a file or directory. The daemon
+ * rejects the request for regular files that already contain data.
+ * @param path
+ * @param chunk_size
+ * @return error code
+ */
+int
+forward_set_chunk_size(const std::string& path, const size_t chunk_size) {
+
+    try {
+        auto endp = metadata_endpoint(path);
+        LOG(DEBUG, "Sending RPC ...");
+        auto out = ld_network_service
+                           ->post<gkfs::rpc::set_chunk_size>(endp, path,
+                                                             chunk_size)
+                           .get()
+                           .at(0);
+        LOG(DEBUG, "Got response success: {}", out.err());
+
+        return out.err() ? out.err() : 0;
+    } catch(const std::exception& ex) {
+        LOG(ERROR, "while getting rpc output");
+        return EBUSY;
+    }
+}
+
 /**
  * Send an RPC for a remove request. This removes metadata and all data chunks
  * possible distributed across many daemons. Optimizations are in place for
@@ -126,15 +179,18 @@ forward_stat(const std::string& path, string& attr) {
 int
 forward_remove(const std::string& path) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
     int64_t size = 0;
     uint32_t mode = 0;
+    uint64_t chunk_size = gkfs::config::rpc::chunksize;
+    int64_t data_host = -1;
 
     /*
      * Send one RPC to metadata destination and remove metadata while retrieving
-     * size and mode to determine if data needs to removed too
+     * size, mode, chunk size, and data host to determine if and where data
+     * needs to removed too
      */
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
@@ -152,6 +208,8 @@ forward_remove(const std::string& path) {
             return out.err();
         size = out.size();
         mode = out.mode();
+        chunk_size = out.chunk_size();
+        data_host = out.data_host();
     } catch(const std::exception& ex) {
         LOG(ERROR, "while getting rpc output");
         return EBUSY;
@@ -164,14 +222,14 @@ forward_remove(const std::string& path) {
 
     std::vector<hermes::rpc_handle<gkfs::rpc::remove_data>> handles;
 
-    // Small files
-    if(static_cast<std::size_t>(size / gkfs::config::rpc::chunksize) <
-       CTX->hosts().size()) {
+    // Small files and files whose chunks are all stored on one daemon
+    if(data_host >= 0 ||
+       static_cast<std::size_t>(size / chunk_size) < CTX->hosts().size()) {
         const auto metadata_host_id =
                 CTX->distributor()->locate_file_metadata(path);
-        const auto endp_metadata = CTX->hosts().at(metadata_host_id);
 
         try {
+            const auto endp_metadata = CTX->hosts().at(metadata_host_id);
             LOG(DEBUG, "Sending RPC to host: {}", endp_metadata.to_string());
             gkfs::rpc::remove_data::input in(path);
             handles.emplace_back(
@@ -179,11 +237,14 @@ forward_remove(const std::string& path) {
                             endp_metadata, in));
 
             uint64_t chnk_start = 0;
-            uint64_t chnk_end = size / gkfs::config::rpc::chunksize;
+            uint64_t chnk_end = data_host >= 0 ? 0 : size / chunk_size;
 
             for(uint64_t chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
                 const auto chnk_host_id =
-                        CTX->distributor()->locate_data(path, chnk_id);
+                        data_host >= 0
+                                ? static_cast<gkfs::rpc::host_t>(data_host)
+                                : CTX->distributor()->locate_data(path,
+                                                                  chnk_id);
                 if constexpr(gkfs::config::metadata::implicit_data_removal) {
                     /*
                      * If the chnk host matches the metadata host the remove
@@ -207,8 +268,10 @@ forward_remove(const std::string& path) {
             return EBUSY;
         }
     } else { // "Big" files
-        for(const auto& endp : CTX->hosts()) {
+        for(std::size_t host_id = 0; host_id < CTX->hosts().size();
+            host_id++) {
             try {
+                auto endp = CTX->hosts().at(host_id);
                 LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
 
                 gkfs::rpc::remove_data::input in(path);
@@ -230,7 +293,7 @@ forward_remove(const std::string& path) {
                 // :/
                 LOG(ERROR,
                     "Failed to forward non-blocking rpc request to host: {}",
-                    endp.to_string());
+                    host_id);
                 return EBUSY;
             }
         }
@@ -255,6 +318,53 @@ forward_remove(const std::string& path) {
     return err;
 }
 
+/**
+ * Send an RPC request to all daemons to remove the subtree of a directory,
+ * i.e., the metadata and data of all entries below it. The directory itself is
+ * not removed. With a proxy, a single request is sent to the proxy which
+ * forwards it to all daemons and drops the subtree from its stat cache.
+ * @param path
+ * @return error code
+ */
+int
+forward_remove_subtree(const std::string& path) {
+
+    std::vector<hermes::rpc_handle<gkfs::rpc::remove_subtree>> handles;
+    auto err = 0;
+    auto host_size = CTX->use_proxy() ? 1 : CTX->hosts().size();
+    for(std::size_t host_id = 0; host_id < host_size; host_id++) {
+        try {
+            // endpoints are looked up lazily, which may fail as well
+            auto endp = CTX->use_proxy() ? CTX->proxy_host()
+                                         : CTX->hosts().at(host_id);
+            LOG(DEBUG, "Sending RPC to host: {}", endp.to_string());
+            gkfs::rpc::remove_subtree::input in(path);
+            handles.emplace_back(
+                    ld_network_service->post<gkfs::rpc::remove_subtree>(endp,
+                                                                        in));
+        } catch(const std::exception& ex) {
+            LOG(ERROR,
+                "Failed to forward non-blocking rpc request to host: {}",
+                host_id);
+            err = EBUSY;
+        }
+    }
+    // wait for RPC responses
+    for(const auto& h : handles) {
+        try {
+            auto out = h.get().at(0);
+            if(out.err() != 0) {
+                LOG(ERROR, "received error response: {}", out.err());
+                err = out.err();
+            }
+        } catch(const std::exception& ex) {
+            LOG(ERROR, "while getting rpc output");
+            err = EBUSY;
+        }
+    }
+    return err;
+}
+
 /**
  * Send an RPC for a decrement file size request. This is for example used
  * during a truncate() call.
@@ -265,9 +375,8 @@ forward_remove(const std::string& path) {
 int
 forward_decr_size(const std::string& path, size_t length) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
@@ -302,9 +411,8 @@ forward_update_metadentry(
         const string& path, const gkfs::metadata::Metadata& md,
         const gkfs::metadata::MetadentryUpdateFlags& md_flags) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
@@ -358,8 +466,16 @@ int
 forward_rename(const string& oldpath, const string& newpath,
                const gkfs::metadata::Metadata& md) {
 
-    auto endp =
-            CTX->hosts().at(CTX->distributor()->locate_file_metadata(oldpath));
+    // endpoints are looked up on first use, which may fail
+    std::optional<hermes::endpoint> endp;
+    std::optional<hermes::endpoint> endp2;
+    try {
+        endp = metadata_endpoint(oldpath);
+        endp2 = metadata_endpoint(newpath);
+    } catch(const std::exception& ex) {
+        LOG(ERROR, "Failed to look up endpoint: {}", ex.what());
+        return EBUSY;
+    }
 
     try {
         LOG(DEBUG, "Sending RPC ...");
@@ -370,7 +486,7 @@ forward_rename(const string& oldpath, const string& newpath,
         // result_set. When that happens we can remove the .at(0) :/
         auto out = ld_network_service
                            ->post<gkfs::rpc::update_metadentry>(
-                                   endp, oldpath, (md.link_count()),
+                                   *endp, oldpath, (md.link_count()),
                                    /* mode */ 0,
                                    /* uid */ 0,
                                    /* gid */ 0, md.size(),
@@ -405,9 +521,6 @@ forward_rename(const string& oldpath, const string& newpath,
     // TODO(amiranda): hermes will eventually provide a post(endpoint)
     // returning one result and a broadcast(endpoint_set) returning a
     // result_set. When that happens we can remove the .at(0) :/
-    auto endp2 =
-            CTX->hosts().at(CTX->distributor()->locate_file_metadata(newpath));
-
     try {
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
@@ -417,7 +530,9 @@ forward_rename(const string& oldpath, const string& newpath,
         // result_set. When that happens we can remove the .at(0) :/
 
         auto out = ld_network_service
-                           ->post<gkfs::rpc::create>(endp2, newpath, md2.mode())
+                           ->post<gkfs::rpc::create>(
+                                   *endp2, newpath, md2.mode(),
+                                   md2.chunk_size(), md2.data_host())
                            .get()
                            .at(0);
         LOG(DEBUG, "Got response success: {}", out.err());
@@ -438,7 +553,7 @@ forward_rename(const string& oldpath, const string& newpath,
         // Update new file with target link = oldpath
         auto out =
                 ld_network_service
-                        ->post<gkfs::rpc::mk_symlink>(endp2, newpath, oldpath)
+                        ->post<gkfs::rpc::mk_symlink>(*endp2, newpath, oldpath)
                         .get()
                         .at(0);
 
@@ -459,10 +574,11 @@ forward_rename(const string& oldpath, const string& newpath,
         // TODO(amiranda): hermes will eventually provide a post(endpoint)
         // returning one result and a broadcast(endpoint_set) returning a
         // result_set. When that happens we can remove the .at(0) :/
-        auto out = ld_network_service
-                           ->post<gkfs::rpc::mk_symlink>(endp, oldpath, newpath)
-                           .get()
-                           .at(0);
+        auto out =
+                ld_network_service
+                        ->post<gkfs::rpc::mk_symlink>(*endp, oldpath, newpath)
+                        .get()
+                        .at(0);
 
         LOG(DEBUG, "Got response success: {}", out.err());
 
@@ -489,8 +605,9 @@ pair<int, off64_t>
 forward_update_metadentry_size(const string& path, const size_t size,
                                const off64_t offset, const bool append_flag) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
+    gkfs::tracing::Span span("client.update_size_rpc");
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
@@ -500,7 +617,8 @@ forward_update_metadentry_size(const string& path, const size_t size,
         auto out = ld_network_service
                            ->post<gkfs::rpc::update_metadentry_size>(
                                    endp, path, size, offset,
-                                   bool_to_merc_bool(append_flag))
+                                   bool_to_merc_bool(append_flag),
+                                   gkfs::tracing::current_trace_id())
                            .get()
                            .at(0);
 
@@ -525,9 +643,8 @@ forward_update_metadentry_size(const string& path, const size_t size,
 pair<int, off64_t>
 forward_get_metadentry_size(const std::string& path) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
@@ -601,11 +718,10 @@ forward_get_dirents(const string& path) {
     for(std::size_t i = 0; i < targets.size(); ++i) {
 
         // Setup rpc input parameters for each host
-        auto endp = CTX->hosts().at(targets[i]);
-
         gkfs::rpc::get_dirents::input in(path, exposed_buffers[i]);
 
         try {
+            auto endp = CTX->hosts().at(targets[i]);
             LOG(DEBUG, "{}() Sending RPC to host: '{}'", __func__, targets[i]);
             handles.emplace_back(
                     ld_network_service->post<gkfs::rpc::get_dirents>(endp, in));
@@ -741,11 +857,10 @@ forward_get_dirents_single(const string& path, int server) {
     // send RPCs
     std::vector<hermes::rpc_handle<gkfs::rpc::get_dirents_extended>> handles;
 
-    auto endp = CTX->hosts().at(targets[i]);
-
     gkfs::rpc::get_dirents_extended::input in(path, exposed_buffers[0]);
 
     try {
+        auto endp = CTX->hosts().at(targets[i]);
         LOG(DEBUG, "{}() Sending RPC to host: '{}'", __func__, targets[i]);
         handles.emplace_back(
                 ld_network_service->post<gkfs::rpc::get_dirents_extended>(endp,
@@ -819,6 +934,141 @@ forward_get_dirents_single(const string& path, int server) {
     return make_pair(err, output);
 }
 
+/**
+ * Send an RPC request to find all entries below a directory which match a
+ * filter to the daemons holding the directory's entries.
+ * @param path
+ * @param filter
+ * @param server daemon to ask or -1 for all daemons
+ * @param aggregate if true, only the aggregates are returned
+ * @param stats sums of the aggregates of all daemons
+ * @param entries matches of all daemons with path-mode-size and ctime
+ * @return error code
+ * Daemons are asked in parallel, each with a buffer of scan_buff_size for its
+ * matches. A daemon whose matches do not fit its buffer is asked again with a
+ * buffer of the size it requires. As its matches may change in between, a daemon is only
+ * asked scan_attempts times.
+ */
+int
+forward_scan(
+        const string& path, const gkfs_scan_filter& filter, int server,
+        bool aggregate, gkfs_scan_stats& stats,
+        vector<tuple<const std::string, mode_t, size_t, time_t>>& entries) {
+
+    LOG(DEBUG, "{}() enter for path '{}' server '{}' aggregate '{}'", __func__,
+        path, server, aggregate);
+
+    auto targets = CTX->distributor()->locate_directory_metadata(path);
+    if(server >= 0) {
+        if(static_cast<size_t>(server) >= targets.size())
+            return EINVAL;
+        targets = {targets[server]};
+    }
+
+    // daemons only push matches if requested. Still, each needs an exposed
+    // buffer.
+    const size_t per_host_buff_size =
+            aggregate ? sizeof(uint64_t) : gkfs::config::rpc::scan_buff_size;
+    vector<unique_ptr<char[]>> buffers(targets.size());
+    vector<size_t> buffer_sizes(targets.size(), per_host_buff_size);
+    vector<size_t> pending(targets.size());
+    std::iota(pending.begin(), pending.end(), 0);
+    const string pattern = filter.name ? filter.name : "";
+
+    auto err = 0;
+    for(auto attempt = 0;
+        attempt < gkfs::config::rpc::scan_attempts && !pending.empty();
+        attempt++) {
+        // expose local buffers for RMA from servers and send RPCs
+        std::vector<hermes::exposed_memory> exposed_buffers;
+        exposed_buffers.reserve(pending.size());
+        std::vector<hermes::rpc_handle<gkfs::rpc::scan>> handles;
+        vector<size_t> sent;
+        for(auto i : pending) {
+            // On C++14 make_unique function also zeroes the newly allocated
+            // buffer which is not needed here
+            buffers[i] = std::unique_ptr<char[]>(new char[buffer_sizes[i]]);
+            try {
+                exposed_buffers.emplace_back(ld_network_service->expose(
+                        std::vector<hermes::mutable_buffer>{
+                                hermes::mutable_buffer{buffers[i].get(),
+                                                       buffer_sizes[i]}},
+                        hermes::access_mode::write_only));
+                gkfs::rpc::scan::input in(
+                        path, filter.recursive != 0, pattern,
+                        filter.name_regex != 0, filter.size_min,
+                        filter.size_max, filter.ctime_min, filter.ctime_max,
+                        filter.type, aggregate, exposed_buffers.back());
+                handles.emplace_back(
+                        ld_network_service->post<gkfs::rpc::scan>(
+                                CTX->hosts().at(targets[i]), in));
+                sent.push_back(i);
+            } catch(const std::exception& ex) {
+                LOG(ERROR,
+                    "{}() Unable to send non-blocking scan() on {} [peer: {}] err '{}'",
+                    __func__, path, targets[i], ex.what());
+                err = EBUSY;
+            }
+        }
+
+        // wait for RPC responses and deserialize matches
+        vector<size_t> retry;
+        for(size_t h = 0; h < handles.size(); h++) {
+            auto i = sent[h];
+            try {
+                auto out = handles[h].get().at(0);
+                if(out.err() == ENOBUFS) {
+                    LOG(DEBUG,
+                        "{}() Matches of host '{}' require buffer size '{}'",
+                        __func__, targets[i], out.bulk_size());
+                    buffer_sizes[i] = out.bulk_size();
+                    retry.push_back(i);
+                    continue;
+                }
+                if(out.err() != 0) {
+                    LOG(ERROR,
+                        "{}() Failed to scan on host '{}'. Error '{}', path '{}'",
+                        __func__, targets[i], strerror(out.err()), path);
+                    err = out.err();
+                    continue;
+                }
+                stats.scanned += out.scanned();
+                stats.matched += out.matched();
+                stats.size_sum += out.size_sum();
+                if(aggregate || out.matched() == 0)
+                    continue;
+                auto n = out.matched();
+                auto out_buff_ptr = buffers[i].get();
+                auto mode_ptr = reinterpret_cast<mode_t*>(out_buff_ptr);
+                auto size_ptr = reinterpret_cast<size_t*>(
+                        out_buff_ptr + n * sizeof(mode_t));
+                auto ctime_ptr = reinterpret_cast<time_t*>(
+                        out_buff_ptr + n * (sizeof(mode_t) + sizeof(size_t)));
+                auto names_ptr =
+                        out_buff_ptr + n * (sizeof(mode_t) + sizeof(size_t) +
+                                            sizeof(time_t));
+                for(uint64_t j = 0; j < n; j++) {
+                    auto name = std::string(names_ptr);
+                    // number of characters in entry + \0 terminator
+                    names_ptr += name.size() + 1;
+                    entries.emplace_back(std::forward_as_tuple(
+                            std::move(name), *mode_ptr++, *size_ptr++,
+                            *ctime_ptr++));
+                }
+            } catch(const std::exception& ex) {
+                LOG(ERROR,
+                    "{}() Failed to get rpc output.. [path: {}, target host: {}] err '{}'",
+                    __func__, path, targets[i], ex.what());
+                err = EBUSY;
+            }
+        }
+        pending = std::move(retry);
+    }
+    if(!pending.empty() && err == 0)
+        err = ENOBUFS;
+    return err;
+}
+
 
 #ifdef HAS_SYMLINKS
 
@@ -831,9 +1081,8 @@ forward_get_dirents_single(const string& path, int server) {
 int
 forward_mk_symlink(const std::string& path, const std::string& target_path) {
 
-    auto endp = CTX->hosts().at(CTX->distributor()->locate_file_metadata(path));
-
     try {
+        auto endp = metadata_endpoint(path);
         LOG(DEBUG, "Sending RPC ...");
         // TODO(amiranda): add a post() with RPC_TIMEOUT to hermes so that we
         // can retry for RPC_TRIES (see old commits with margo)
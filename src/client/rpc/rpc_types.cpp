@@ -43,15 +43,22 @@ hermes::detail::register_user_request_types() {
     (void) registered_requests().add<gkfs::rpc::update_metadentry>();
     (void) registered_requests().add<gkfs::rpc::get_metadentry_size>();
     (void) registered_requests().add<gkfs::rpc::update_metadentry_size>();
+    (void) registered_requests().add<gkfs::rpc::set_chunk_size>();
 
 #ifdef HAS_SYMLINKS
     (void) registered_requests().add<gkfs::rpc::mk_symlink>();
 #endif // HAS_SYMLINKS
     (void) registered_requests().add<gkfs::rpc::remove_data>();
+    (void) registered_requests().add<gkfs::rpc::remove_subtree>();
     (void) registered_requests().add<gkfs::rpc::write_data>();
     (void) registered_requests().add<gkfs::rpc::read_data>();
     (void) registered_requests().add<gkfs::rpc::trunc_data>();
     (void) registered_requests().add<gkfs::rpc::get_dirents>();
     (void) registered_requests().add<gkfs::rpc::chunk_stat>();
     (void) registered_requests().add<gkfs::rpc::get_dirents_extended>();
+    (void) registered_requests().add<gkfs::rpc::scan>();
+    (void) registered_requests().add<gkfs::rpc::copy_data>();
+    (void) registered_requests().add<gkfs::rpc::fallocate>();
+    (void) registered_requests().add<gkfs::rpc::write_data_list>();
+    (void) registered_requests().add<gkfs::rpc::read_data_list>();
 }
@@ -0,0 +1,76 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <common/hosts_file.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <regex>
+#include <stdexcept>
+#include <tuple>
+
+using namespace std;
+
+namespace gkfs::utils {
+
+vector<HostsFileEntry>
+parse_hosts_file(const string& path) {
+    ifstream lf(path);
+    if(!lf) {
+        throw runtime_error(fmt::format("Failed to open hosts file '{}': {}",
+                                        path, strerror(errno)));
+    }
+    vector<HostsFileEntry> entries;
+    const regex line_re("^(\\S+)\\s+(\\S+)(?:\\s+(\\d*\\.?\\d+))?$",
+                        regex::ECMAScript | regex::optimize);
+    string line;
+    smatch match;
+    while(getline(lf, line)) {
+        if(!regex_match(line, match, line_re)) {
+            throw runtime_error(
+                    fmt::format("unrecognized line format: '{}'", line));
+        }
+        auto weight = match[3].matched ? stod(match[3]) : 1.0;
+        if(weight <= 0.0) {
+            throw runtime_error(fmt::format("invalid host weight: '{}'", line));
+        }
+        entries.push_back({match[1], match[2], weight});
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const HostsFileEntry& a, const HostsFileEntry& b) {
+                  return tie(a.hostname, a.uri, a.weight) <
+                         tie(b.hostname, b.uri, b.weight);
+              });
+    return entries;
+}
+
+} // namespace gkfs::utils
@@ -45,7 +45,7 @@ static const char MSP = '|'; // metadata separator
 
 Metadata::Metadata(const mode_t mode)
     : atime_(), mtime_(), ctime_(), mode_(mode), link_count_(0), size_(0),
-      blocks_(0) {
+      blocks_(0), chunk_size_(gkfs::config::rpc::chunksize), data_host_(-1) {
     assert(S_ISDIR(mode_) || S_ISREG(mode_));
 }
 
@@ -53,7 +53,8 @@ Metadata::Metadata(const mode_t mode)
 
 Metadata::Metadata(const mode_t mode, const std::string& target_path)
     : atime_(), mtime_(), ctime_(), mode_(mode), link_count_(0), size_(0),
-      blocks_(0), target_path_(target_path) {
+      blocks_(0), chunk_size_(gkfs::config::rpc::chunksize), data_host_(-1),
+      target_path_(target_path) {
     assert(S_ISLNK(mode_) || S_ISDIR(mode_) || S_ISREG(mode_));
     // target_path should be there only if this is a link
     assert(target_path_.empty() || S_ISLNK(mode_));
@@ -80,6 +81,16 @@ Metadata::Metadata(const std::string& binary_str) {
     assert(read > 0);
     ptr += read;
 
+    assert(*ptr == MSP);
+    chunk_size_ = std::stoul(++ptr, &read);
+    assert(read > 0);
+    ptr += read;
+
+    assert(*ptr == MSP);
+    data_host_ = std::stol(++ptr, &read);
+    assert(read > 0);
+    ptr += read;
+
     // The order is important. don't change.
     if constexpr(gkfs::config::metadata::use_atime) {
         assert(*ptr == MSP);
@@ -145,6 +156,10 @@ Metadata::serialize() const {
     s += fmt::format_int(mode_).c_str(); // add mandatory mode
     s += MSP;
     s += fmt::format_int(size_).c_str(); // add mandatory size
+    s += MSP;
+    s += fmt::format_int(chunk_size_).c_str(); // add mandatory chunk size
+    s += MSP;
+    s += fmt::format_int(data_host_).c_str(); // add mandatory data host
     if constexpr(gkfs::config::metadata::use_atime) {
         s += MSP;
         s += fmt::format_int(atime_).c_str();
@@ -271,6 +286,26 @@ Metadata::blocks(blkcnt_t blocks) {
     Metadata::blocks_ = blocks;
 }
 
+size_t
+Metadata::chunk_size() const {
+    return chunk_size_;
+}
+
+void
+Metadata::chunk_size(size_t chunk_size) {
+    Metadata::chunk_size_ = chunk_size;
+}
+
+int64_t
+Metadata::data_host() const {
+    return data_host_;
+}
+
+void
+Metadata::data_host(int64_t data_host) {
+    Metadata::data_host_ = data_host;
+}
+
 #ifdef HAS_SYMLINKS
 
 std::string
@@ -28,12 +28,26 @@
 
 #include <common/rpc/distributor.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 
 namespace gkfs {
 
 namespace rpc {
 
+::vector<host_t>
+Distributor::locate_data_range(const string& path, chunkid_t chnk_start,
+                               chunkid_t chnk_end) const {
+    ::vector<host_t> owners{};
+    owners.reserve(chnk_end - chnk_start + 1);
+    for(auto chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+        owners.push_back(locate_data(path, chnk_id));
+    }
+    return owners;
+}
+
 SimpleHashDistributor::SimpleHashDistributor(host_t localhost,
                                              unsigned int hosts_size)
     : localhost_(localhost), hosts_size_(hosts_size), all_hosts_(hosts_size) {
@@ -75,6 +89,197 @@ SimpleHashDistributor::locate_directory_metadata(const string& path) const {
     return all_hosts_;
 }
 
+StripedDistributor::StripedDistributor(unsigned int stripe_count)
+    : localhost_(0), max_stripe_count_(stripe_count) {}
+
+StripedDistributor::StripedDistributor(host_t localhost,
+                                       unsigned int hosts_size,
+                                       unsigned int stripe_count)
+    : localhost_(localhost), max_stripe_count_(stripe_count) {
+    this->hosts_size(hosts_size);
+}
+
+void
+StripedDistributor::hosts_size(unsigned int hosts_size) {
+    hosts_size_ = hosts_size;
+    stripe_count_ = ::min(::max(max_stripe_count_, 1u), hosts_size);
+    all_hosts_ = ::vector<host_t>(hosts_size);
+    ::iota(all_hosts_.begin(), all_hosts_.end(), 0);
+}
+
+host_t
+StripedDistributor::localhost() const {
+    return localhost_;
+}
+
+unsigned int
+StripedDistributor::stripe_count() const {
+    return stripe_count_;
+}
+
+host_t
+StripedDistributor::locate_data(const string& path,
+                                const chunkid_t& chnk_id) const {
+    auto start = str_hash(path) % hosts_size_;
+    return (start + chnk_id % stripe_count_) % hosts_size_;
+}
+
+host_t
+StripedDistributor::locate_data(const string& path, const chunkid_t& chnk_id,
+                                unsigned int hosts_size) {
+    if(hosts_size_ != hosts_size) {
+        this->hosts_size(hosts_size);
+    }
+    return locate_data(path, chnk_id);
+}
+
+host_t
+StripedDistributor::locate_file_metadata(const string& path) const {
+    return str_hash(path) % hosts_size_;
+}
+
+::vector<host_t>
+StripedDistributor::locate_directory_metadata(const string& path) const {
+    return all_hosts_;
+}
+
+::vector<host_t>
+StripedDistributor::locate_data_range(const string& path, chunkid_t chnk_start,
+                                      chunkid_t chnk_end) const {
+    ::vector<host_t> owners{};
+    owners.reserve(chnk_end - chnk_start + 1);
+    auto start = str_hash(path) % hosts_size_;
+    // position of the first chunk within the stripe, advanced without division
+    auto stripe_idx = chnk_start % stripe_count_;
+    for(auto chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+        auto owner = start + stripe_idx;
+        owners.push_back(owner < hosts_size_ ? owner : owner - hosts_size_);
+        if(++stripe_idx == stripe_count_) {
+            stripe_idx = 0;
+        }
+    }
+    return owners;
+}
+
+namespace {
+
+/**
+ * @internal
+ * splitmix64 finalizer. Spreads consecutive chunk ids and host ids over the
+ * whole 64 bit range, which std::hash does not do for integers.
+ * @endinternal
+ */
+uint64_t
+mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t
+chunk_key(size_t path_hash, chunkid_t chnk_id) {
+    return mix64(path_hash ^ mix64(chnk_id));
+}
+
+} // namespace
+
+WeightedDistributor::WeightedDistributor(weights_loader_t weights_loader)
+    : localhost_(0), weights_loader_(std::move(weights_loader)) {}
+
+WeightedDistributor::WeightedDistributor(host_t localhost,
+                                         unsigned int hosts_size,
+                                         ::vector<double> weights)
+    : localhost_(localhost) {
+    set_weights(hosts_size, std::move(weights));
+}
+
+void
+WeightedDistributor::set_weights(unsigned int hosts_size,
+                                 ::vector<double> weights) {
+    auto valid = weights.size() == hosts_size &&
+                 ::all_of(weights.begin(), weights.end(),
+                          [](double w) { return w > 0; });
+    if(!valid) {
+        weights.assign(hosts_size, 1.0);
+    }
+    weights_ = std::move(weights);
+    all_hosts_ = ::vector<host_t>(hosts_size);
+    ::iota(all_hosts_.begin(), all_hosts_.end(), 0);
+    // published last so that concurrent lookups never see a partial update
+    hosts_size_.store(hosts_size, std::memory_order_release);
+}
+
+host_t
+WeightedDistributor::locate(uint64_t key) const {
+    host_t owner = 0;
+    auto max_score = -1.0;
+    for(host_t host = 0; host < weights_.size(); host++) {
+        auto h = mix64(key ^ mix64(host));
+        // uniform in (0, 1), neither end included
+        auto u = (static_cast<double>(h >> 11) + 0.5) * 0x1.0p-53;
+        auto score = weights_[host] / -::log(u);
+        if(score > max_score) {
+            max_score = score;
+            owner = host;
+        }
+    }
+    return owner;
+}
+
+host_t
+WeightedDistributor::localhost() const {
+    return localhost_;
+}
+
+const ::vector<double>&
+WeightedDistributor::weights() const {
+    return weights_;
+}
+
+host_t
+WeightedDistributor::locate_data(const string& path,
+                                 const chunkid_t& chnk_id) const {
+    return locate(chunk_key(str_hash(path), chnk_id));
+}
+
+host_t
+WeightedDistributor::locate_data(const string& path, const chunkid_t& chnk_id,
+                                 unsigned int hosts_size) {
+    if(hosts_size_.load(std::memory_order_acquire) != hosts_size) {
+        std::lock_guard<std::mutex> lock(weights_mutex_);
+        if(hosts_size_.load(std::memory_order_relaxed) != hosts_size) {
+            set_weights(hosts_size, weights_loader_
+                                            ? weights_loader_(hosts_size)
+                                            : ::vector<double>{});
+        }
+    }
+    return locate_data(path, chnk_id);
+}
+
+host_t
+WeightedDistributor::locate_file_metadata(const string& path) const {
+    return str_hash(path) % hosts_size_.load(std::memory_order_relaxed);
+}
+
+::vector<host_t>
+WeightedDistributor::locate_directory_metadata(const string& path) const {
+    return all_hosts_;
+}
+
+::vector<host_t>
+WeightedDistributor::locate_data_range(const string& path,
+                                       chunkid_t chnk_start,
+                                       chunkid_t chnk_end) const {
+    ::vector<host_t> owners{};
+    owners.reserve(chnk_end - chnk_start + 1);
+    auto path_hash = str_hash(path);
+    for(auto chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+        owners.push_back(locate(chunk_key(path_hash, chnk_id)));
+    }
+    return owners;
+}
+
 LocalOnlyDistributor::LocalOnlyDistributor(host_t localhost)
     : localhost_(localhost) {}
 
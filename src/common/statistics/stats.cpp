@@ -209,6 +209,8 @@ Stats::add_value_size(enum SizeOp iop, unsigned long long value) {
         add_value_iops(IopsOp::iops_read);
     else if(iop == SizeOp::write_size)
         add_value_iops(IopsOp::iops_write);
+    else if(iop == SizeOp::sched_io_size)
+        add_value_iops(IopsOp::iops_sched_io);
 }
 
 /**
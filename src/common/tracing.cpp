@@ -0,0 +1,260 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <common/tracing.hpp>
+#include <config.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+extern "C" {
+#include <sys/syscall.h>
+#include <unistd.h>
+}
+
+using namespace std;
+
+namespace gkfs::tracing {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+} // namespace detail
+
+namespace {
+
+struct SpanRecord {
+    uint64_t trace_id;
+    const char* name;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint32_t tid;
+};
+
+/*
+ * Ring buffer of the most recent spans of a thread. Only its owning thread
+ * writes to it. A dump copies the slots up to the published head without
+ * locking and drops those that the owner may have overwritten meanwhile.
+ */
+class SpanRing {
+private:
+    vector<SpanRecord> slots_;
+    atomic<uint64_t> head_{0};
+
+public:
+    bool in_use{true}; // guarded by the registry mutex
+
+    SpanRing() : slots_(gkfs::config::tracing::ring_size) {}
+
+    void
+    push(const SpanRecord& span) noexcept {
+        auto head = head_.load(memory_order_relaxed);
+        slots_[head % slots_.size()] = span;
+        head_.store(head + 1, memory_order_release);
+    }
+
+    void
+    snapshot(vector<SpanRecord>& out) const {
+        auto head = head_.load(memory_order_acquire);
+        auto first = head > slots_.size() ? head - slots_.size() : 0;
+        auto offset = out.size();
+        for(auto i = first; i < head; i++)
+            out.push_back(slots_[i % slots_.size()]);
+        // slots written while copying are torn, drop them
+        auto new_head = head_.load(memory_order_acquire);
+        if(new_head - first > slots_.size()) {
+            auto torn = min<uint64_t>(new_head - first - slots_.size(),
+                                      head - first);
+            out.erase(out.begin() + offset, out.begin() + offset + torn);
+        }
+    }
+};
+
+struct Registry {
+    mutex mtx;
+    vector<shared_ptr<SpanRing>> rings;
+    string process_name;
+    uint64_t id_prefix{0};
+};
+
+Registry&
+registry() {
+    static Registry reg;
+    return reg;
+}
+
+atomic<uint64_t> id_counter{1};
+
+/*
+ * Holds the calling thread's ring and returns it to the registry when the
+ * thread exits, so that the number of rings is bounded by the number of
+ * concurrent threads. The spans of a returned ring are kept until its next
+ * owner overwrites them.
+ */
+struct RingHolder {
+    shared_ptr<SpanRing> ring{};
+    uint32_t tid{0};
+
+    RingHolder() = default;
+
+    RingHolder(const RingHolder&) = delete;
+
+    RingHolder&
+    operator=(const RingHolder&) = delete;
+
+    ~RingHolder() {
+        if(ring) {
+            lock_guard<mutex> lock(registry().mtx);
+            ring->in_use = false;
+        }
+    }
+
+    SpanRing&
+    get() {
+        if(!ring) {
+            tid = static_cast<uint32_t>(::syscall(SYS_gettid));
+            auto& reg = registry();
+            lock_guard<mutex> lock(reg.mtx);
+            for(auto& r : reg.rings) {
+                if(!r->in_use) {
+                    r->in_use = true;
+                    ring = r;
+                    break;
+                }
+            }
+            if(!ring) {
+                ring = make_shared<SpanRing>();
+                reg.rings.push_back(ring);
+            }
+        }
+        return *ring;
+    }
+};
+
+thread_local RingHolder local_ring;
+thread_local uint64_t current_id{0};
+
+} // namespace
+
+void
+enable(const std::string& process_name) {
+    auto& reg = registry();
+    {
+        lock_guard<mutex> lock(reg.mtx);
+        reg.process_name = process_name;
+        // the upper half of a trace id tells processes apart
+        auto seed = hash<string>{}(
+                fmt::format("{}:{}:{}", process_name, ::getpid(), now_ns()));
+        reg.id_prefix = (seed & 0xffffffffULL) | 1;
+    }
+    detail::enabled.store(true, memory_order_release);
+}
+
+uint64_t
+now_ns() noexcept {
+    return static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(
+                    chrono::system_clock::now().time_since_epoch())
+                    .count());
+}
+
+uint64_t
+new_trace_id() noexcept {
+    auto n = id_counter.fetch_add(1, memory_order_relaxed);
+    return (registry().id_prefix << 32) | (n & 0xffffffffULL);
+}
+
+void
+record(uint64_t trace_id, const char* name, uint64_t start_ns,
+       uint64_t end_ns) noexcept {
+    if(!enabled())
+        return;
+    try {
+        auto& ring = local_ring.get();
+        ring.push({trace_id, name, start_ns, end_ns, local_ring.tid});
+    } catch(...) {
+        // tracing must never fail a request
+    }
+}
+
+int
+dump(const std::string& path) {
+    vector<SpanRecord> spans{};
+    string process_name{};
+    {
+        auto& reg = registry();
+        lock_guard<mutex> lock(reg.mtx);
+        process_name = reg.process_name;
+        for(const auto& r : reg.rings)
+            r->snapshot(spans);
+    }
+    ofstream out(path, ios::trunc);
+    if(!out)
+        return errno ? errno : EIO;
+    auto pid = ::getpid();
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n"
+        << fmt::format(
+                   R"({{"name": "process_name", "ph": "M", "pid": {}, "args": {{"name": "{}"}}}})",
+                   pid, process_name);
+    for(const auto& s : spans) {
+        auto dur = s.end_ns > s.start_ns ? s.end_ns - s.start_ns : 0;
+        out << fmt::format(
+                ",\n{{\"name\": \"{}\", \"cat\": \"gkfs\", \"ph\": \"X\", "
+                "\"ts\": {}.{:03}, \"dur\": {}.{:03}, \"pid\": {}, "
+                "\"tid\": {}, \"args\": {{\"trace_id\": \"{:#018x}\"}}}}",
+                s.name, s.start_ns / 1000, s.start_ns % 1000, dur / 1000,
+                dur % 1000, pid, s.tid, s.trace_id);
+    }
+    out << "\n]}\n";
+    out.close();
+    return out ? 0 : EIO;
+}
+
+uint64_t
+current_trace_id() noexcept {
+    return current_id;
+}
+
+TraceContext::TraceContext() noexcept {
+    if(current_id == 0 && enabled()) {
+        current_id = new_trace_id();
+        owner_ = true;
+    }
+}
+
+TraceContext::~TraceContext() {
+    if(owner_)
+        current_id = 0;
+}
+
+} // namespace gkfs::tracing
@@ -34,8 +34,13 @@
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/backend/data/file_handle.hpp>
 #include <common/path_util.hpp>
+#include <config.hpp>
 
+#include <algorithm>
 #include <cerrno>
+#include <climits>
+#include <cstring>
+#include <vector>
 
 #include <filesystem>
 #include <spdlog/spdlog.h>
@@ -43,6 +48,8 @@
 extern "C" {
 #include <sys/statfs.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/xattr.h>
 #include <fcntl.h>
 }
 
@@ -51,6 +58,32 @@ using namespace std;
 
 namespace gkfs::data {
 
+namespace {
+
+/// Extended attribute of a chunk directory holding its file's path
+constexpr auto path_xattr = "user.gkfs.path";
+
+/**
+ * @brief Skips n transferred bytes in a buffer list after a partial vectored
+ * I/O call.
+ * @param bufs Buffer list, modified in place
+ * @param first Index of the first buffer with bytes left, updated
+ * @param n Number of bytes transferred
+ */
+void
+advance_iov(vector<struct iovec>& bufs, size_t& first, size_t n) {
+    while(n > 0 && first < bufs.size()) {
+        auto step = std::min(n, bufs[first].iov_len);
+        bufs[first].iov_base = static_cast<char*>(bufs[first].iov_base) + step;
+        bufs[first].iov_len -= step;
+        n -= step;
+        if(bufs[first].iov_len == 0)
+            first++;
+    }
+}
+
+} // namespace
+
 // private functions
 
 string
@@ -84,9 +117,34 @@ ChunkStorage::get_chunk_path(const string& file_path,
     return fmt::format("{}/{}", get_chunks_dir(file_path), chunk_id);
 }
 
+/**
+ * @internal
+ * The chunk directory of a file known to the chunk index exists already, so
+ * mkdir is skipped. Otherwise, the directory is created without holding the
+ * index lock. If this daemon instance created it, the file's index is complete.
+ * If it existed before, e.g., from a previous daemon run on the same rootdir,
+ * chunks may be on disk that the index does not know of and truncate must fall
+ * back to scanning the directory. Once the index is full, new files are not
+ * indexed.
+ *
+ * Concurrent writers of a new file all add the file's entry before writing a
+ * chunk and an existing entry is never replaced. A writer that found the
+ * directory existing therefore either leaves the entry incomplete or finds the
+ * complete entry of the creator, which then indexes its chunks. If chunk
+ * directories were removed meanwhile, the directory may be gone and the file is
+ * not indexed.
+ * @endinternal
+ */
 void
 ChunkStorage::init_chunk_space(const string& file_path) const {
     auto chunk_dir = absolute(get_chunks_dir(file_path));
+    uint64_t epoch;
+    {
+        lock_guard<mutex> lock(chunk_index_mutex_);
+        if(chunk_index_.count(file_path) != 0)
+            return;
+        epoch = chunk_index_epoch_;
+    }
     auto err = mkdir(chunk_dir.c_str(), 0750);
     if(err == -1 && errno != EEXIST) {
         auto err_str = fmt::format(
@@ -94,12 +152,71 @@ ChunkStorage::init_chunk_space(const string& file_path) const {
                 __func__, file_path, errno);
         throw ChunkStorageException(errno, err_str);
     }
+    if(err == 0)
+        tag_chunk_space(chunk_dir, file_path);
+    lock_guard<mutex> lock(chunk_index_mutex_);
+    if(epoch == chunk_index_epoch_ &&
+       chunk_index_.size() < gkfs::config::data::chunk_index_max_files)
+        chunk_index_.emplace(file_path, ChunkIndex{err == 0, {}});
+}
+
+/**
+ * @internal
+ * The encoding of chunk directory names is ambiguous: /foo/bar and /foo:bar
+ * share the directory foo:bar. The file's path is therefore stored with the
+ * directory, e.g., for subtree removal. Failing to store it is not an error,
+ * the path is then decoded from the directory's name.
+ * @endinternal
+ */
+void
+ChunkStorage::tag_chunk_space(const string& chunk_dir,
+                              const string& file_path) const {
+    if(setxattr(chunk_dir.c_str(), path_xattr, file_path.c_str(),
+                file_path.size(), 0) != 0)
+        log_->debug("{}() Failed to store path of chunk directory '{}': {}",
+                    __func__, chunk_dir, strerror(errno));
+}
+
+unordered_map<string, ChunkStorage::ChunkIndex>::iterator
+ChunkStorage::drop_chunk_index(
+        unordered_map<string, ChunkIndex>::iterator it) const {
+    chunk_index_size_ -= it->second.chunks.size();
+    return chunk_index_.erase(it);
+}
+
+/**
+ * @internal
+ * A file exceeding the per-file or total limit of indexed chunks is marked
+ * incomplete and its chunk ids are released. Its entry is kept, so that mkdir
+ * is still skipped for its chunk directory.
+ * @endinternal
+ */
+void
+ChunkStorage::index_chunk(const string& file_path,
+                          gkfs::rpc::chnk_id_t chunk_id) const {
+    lock_guard<mutex> lock(chunk_index_mutex_);
+    auto it = chunk_index_.find(file_path);
+    if(it == chunk_index_.end() || !it->second.complete)
+        return;
+    auto& index = it->second;
+    if(!index.chunks.insert(chunk_id).second)
+        return;
+    chunk_index_size_++;
+    if(index.chunks.size() > gkfs::config::data::chunk_index_max_file_chunks ||
+       chunk_index_size_ > gkfs::config::data::chunk_index_max_chunks) {
+        log_->debug("{}() Chunk index limit reached, no longer indexing '{}'",
+                    __func__, file_path);
+        chunk_index_size_ -= index.chunks.size();
+        index.complete = false;
+        std::set<gkfs::rpc::chnk_id_t>{}.swap(index.chunks);
+    }
 }
 
 // public functions
 
-ChunkStorage::ChunkStorage(string& path, const size_t chunksize)
-    : root_path_(path), chunksize_(chunksize) {
+ChunkStorage::ChunkStorage(string& path, const size_t chunksize,
+                           const bool preallocate)
+    : root_path_(path), chunksize_(chunksize), preallocate_(preallocate) {
     /* Get logger instance and set it for data module and chunk storage */
     GKFS_DATA_MOD->log(spdlog::get(GKFS_DATA_MOD->LOGGER_NAME));
     assert(GKFS_DATA_MOD->log());
@@ -115,11 +232,21 @@ ChunkStorage::ChunkStorage(string& path, const size_t chunksize)
     }
     log_->debug("{}() Chunk storage initialized with path: '{}'", __func__,
                 root_path_);
+    if(preallocate_)
+        log_->info("{}() Chunk files are preallocated to '{}' bytes", __func__,
+                   chunksize_);
 }
 
 void
 ChunkStorage::destroy_chunk_space(const string& file_path) const {
     auto chunk_dir = absolute(get_chunks_dir(file_path));
+    {
+        lock_guard<mutex> lock(chunk_index_mutex_);
+        auto it = chunk_index_.find(file_path);
+        if(it != chunk_index_.end())
+            drop_chunk_index(it);
+        chunk_index_epoch_++;
+    }
     try {
         // Note: remove_all does not throw an error when path doesn't exist.
         auto n = fs::remove_all(chunk_dir);
@@ -135,37 +262,130 @@ ChunkStorage::destroy_chunk_space(const string& file_path) const {
 
 /**
  * @internal
- * Refer to
- * https://www.gnu.org/software/libc/manual/html_node/I_002fO-Primitives.html
- * for pwrite behavior.
+ * Chunk directories are named after their file's path with '/' replaced by ':',
+ * so the files of a subtree share the directory's name prefix. Siblings whose
+ * names start with the directory's name and ':' share it as well, e.g.,
+ * /foo:bar for /foo. Each candidate's path is therefore read from the path
+ * stored with its directory and checked against the subtree. Directories
+ * without a stored path, e.g., on file systems without extended attributes,
+ * fall back to the decoded name. Index entries are dropped by the path prefix.
  * @endinternal
  */
+vector<string>
+ChunkStorage::detach_chunk_spaces(const string& dir) const {
+    auto path_prefix = dir;
+    if(path_prefix.back() != '/')
+        path_prefix.push_back('/');
+    // the root "/" is the empty prefix
+    auto name_prefix = get_chunks_dir(path_prefix);
+    {
+        lock_guard<mutex> lock(chunk_index_mutex_);
+        for(auto it = chunk_index_.begin(); it != chunk_index_.end();) {
+            if(it->first.compare(0, path_prefix.size(), path_prefix) == 0)
+                it = drop_chunk_index(it);
+            else
+                ++it;
+        }
+        chunk_index_epoch_++;
+    }
+    vector<string> files;
+    std::error_code ec;
+    fs::directory_iterator chunk_dir(root_path_, ec);
+    if(ec) {
+        throw ChunkStorageException(
+                ec.value(),
+                fmt::format("{}() Failed to open directory '{}': {}",
+                            __func__, root_path_, ec.message()));
+    }
+    vector<char> buf(PATH_MAX);
+    for(const auto& entry : chunk_dir) {
+        auto name = entry.path().filename().string();
+        if(name.compare(0, name_prefix.size(), name_prefix) != 0)
+            continue;
+        auto len = getxattr(entry.path().c_str(), path_xattr, buf.data(),
+                            buf.size());
+        if(len < 0) {
+            ::replace(name.begin(), name.end(), ':', '/');
+            files.push_back("/" + name);
+            continue;
+        }
+        string path(buf.data(), len);
+        if(path.compare(0, path_prefix.size(), path_prefix) != 0) {
+            log_->trace("{}() Skipping '{}' of file '{}' outside of '{}'",
+                        __func__, name, path, dir);
+            continue;
+        }
+        files.push_back(std::move(path));
+    }
+    return files;
+}
+
 ssize_t
 ChunkStorage::write_chunk(const string& file_path,
                           gkfs::rpc::chnk_id_t chunk_id, const char* buf,
-                          size_t size, off64_t offset) const {
+                          size_t size, off64_t offset,
+                          size_t chunk_size) const {
+    struct iovec iov {
+        const_cast<char*>(buf), size
+    };
+    return writev_chunk(file_path, chunk_id, &iov, 1, offset, chunk_size);
+}
 
-    assert((offset + size) <= chunksize_);
+/**
+ * @internal
+ * Refer to
+ * https://www.gnu.org/software/libc/manual/html_node/I_002fO-Primitives.html
+ * for pwrite behavior. Partial writes advance the buffer list and are retried.
+ * @endinternal
+ */
+ssize_t
+ChunkStorage::writev_chunk(const string& file_path,
+                           gkfs::rpc::chnk_id_t chunk_id,
+                           const struct iovec* iov, int iovcnt, off64_t offset,
+                           size_t chunk_size) const {
+
+    vector<struct iovec> bufs(iov, iov + iovcnt);
+    size_t size = 0;
+    for(const auto& b : bufs)
+        size += b.iov_len;
+    assert((offset + size) <= chunk_size);
     // may throw ChunkStorageException on failure
     init_chunk_space(file_path);
 
     auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
 
-    FileHandle fh(open(chunk_path.c_str(), O_WRONLY | O_CREAT, 0640),
-                  chunk_path);
+    // With preallocation, a newly created chunk file reserves the file's full
+    // chunk size at once instead of growing with each write. The file size is
+    // kept.
+    auto fd = preallocate_ ? open(chunk_path.c_str(),
+                                  O_WRONLY | O_CREAT | O_EXCL, 0640)
+                           : -1;
+    auto created = fd != -1;
+    if(!created)
+        fd = open(chunk_path.c_str(), O_WRONLY | O_CREAT, 0640);
+    FileHandle fh(fd, chunk_path);
     if(!fh.valid()) {
         auto err_str = fmt::format(
                 "{}() Failed to open chunk file for write. File: '{}', Error: '{}'",
                 __func__, chunk_path, ::strerror(errno));
         throw ChunkStorageException(errno, err_str);
     }
+    index_chunk(file_path, chunk_id);
+    if(created &&
+       ::fallocate(fh.native(), FALLOC_FL_KEEP_SIZE, 0, chunk_size) != 0) {
+        // preallocation is an optimization only
+        log_->debug("{}() Failed to preallocate chunk file '{}': '{}'",
+                    __func__, chunk_path, ::strerror(errno));
+    }
 
     size_t wrote_total{};
     ssize_t wrote{};
+    size_t first{};
 
-    do {
-        wrote = pwrite(fh.native(), buf + wrote_total, size - wrote_total,
-                       offset + wrote_total);
+    while(wrote_total != size) {
+        wrote = pwritev(fh.native(), bufs.data() + first,
+                        static_cast<int>(bufs.size() - first),
+                        offset + wrote_total);
 
         if(wrote < 0) {
             // retry if a signal or anything else has interrupted the read
@@ -178,23 +398,40 @@ ChunkStorage::write_chunk(const string& file_path,
             throw ChunkStorageException(errno, err_str);
         }
         wrote_total += wrote;
-    } while(wrote_total != size);
+        advance_iov(bufs, first, wrote);
+    }
 
     // file is closed via the file handle's destructor.
     return wrote_total;
 }
 
+ssize_t
+ChunkStorage::read_chunk(const string& file_path, gkfs::rpc::chnk_id_t chunk_id,
+                         char* buf, size_t size, off64_t offset) const {
+    struct iovec iov {
+        buf, size
+    };
+    return readv_chunk(file_path, chunk_id, &iov, 1, offset);
+}
+
 /**
  * @internal
  * Refer to
  * https://www.gnu.org/software/libc/manual/html_node/I_002fO-Primitives.html
- * for pread behavior
+ * for pread behavior. Partial reads advance the buffer list and are retried
+ * until end-of-file.
  * @endinternal
  */
 ssize_t
-ChunkStorage::read_chunk(const string& file_path, gkfs::rpc::chnk_id_t chunk_id,
-                         char* buf, size_t size, off64_t offset) const {
-    assert((offset + size) <= chunksize_);
+ChunkStorage::readv_chunk(const string& file_path,
+                          gkfs::rpc::chnk_id_t chunk_id,
+                          const struct iovec* iov, int iovcnt,
+                          off64_t offset) const {
+    vector<struct iovec> bufs(iov, iov + iovcnt);
+    size_t size = 0;
+    for(const auto& b : bufs)
+        size += b.iov_len;
+    assert((offset + size) <= gkfs::config::rpc::max_chunksize);
     auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
 
     FileHandle fh(open(chunk_path.c_str(), O_RDONLY), chunk_path);
@@ -206,10 +443,12 @@ ChunkStorage::read_chunk(const string& file_path, gkfs::rpc::chnk_id_t chunk_id,
     }
     size_t read_total = 0;
     ssize_t read = 0;
+    size_t first{};
 
-    do {
-        read = pread64(fh.native(), buf + read_total, size - read_total,
-                       offset + read_total);
+    while(read_total != size) {
+        read = preadv64(fh.native(), bufs.data() + first,
+                        static_cast<int>(bufs.size() - first),
+                        offset + read_total);
         if(read == 0) {
             /*
              * A value of zero indicates end-of-file (except if the value of the
@@ -240,12 +479,39 @@ ChunkStorage::read_chunk(const string& file_path, gkfs::rpc::chnk_id_t chunk_id,
 #endif
         assert(read > 0);
         read_total += read;
-    } while(read_total != size);
+        advance_iov(bufs, first, read);
+    }
 
     // file is closed via the file handle's destructor.
     return read_total;
 }
 
+void
+ChunkStorage::allocate_chunk(const string& file_path,
+                             gkfs::rpc::chnk_id_t chunk_id, off64_t offset,
+                             size_t size) const {
+    assert((offset + size) <= gkfs::config::rpc::max_chunksize);
+    // may throw ChunkStorageException on failure
+    init_chunk_space(file_path);
+
+    auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
+    FileHandle fh(open(chunk_path.c_str(), O_WRONLY | O_CREAT, 0640),
+                  chunk_path);
+    if(!fh.valid()) {
+        auto err_str = fmt::format(
+                "{}() Failed to open chunk file for allocation. File: '{}', Error: '{}'",
+                __func__, chunk_path, ::strerror(errno));
+        throw ChunkStorageException(errno, err_str);
+    }
+    index_chunk(file_path, chunk_id);
+    if(::fallocate(fh.native(), FALLOC_FL_KEEP_SIZE, offset, size) != 0) {
+        auto err_str = fmt::format(
+                "{}() Failed to allocate chunk file. File: '{}', size: '{}', offset: '{}', Error: '{}'",
+                __func__, chunk_path, size, offset, ::strerror(errno));
+        throw ChunkStorageException(errno, err_str);
+    }
+}
+
 /**
  * @internal
  * Note eventual consistency here: While chunks are removed, there is no lock
@@ -253,6 +519,9 @@ ChunkStorage::read_chunk(const string& file_path, gkfs::rpc::chnk_id_t chunk_id,
  * is the application's responsibility to stop modifying the file while truncate
  * is executed.
  *
+ * If the file's chunk index is complete, only the indexed chunk files from
+ * chunk_start onwards are removed. Otherwise, the chunk directory is scanned.
+ *
  * If an error is encountered when removing a chunk file, the function will
  * still remove all files and report the error afterwards with
  * ChunkStorageException.
@@ -263,20 +532,51 @@ ChunkStorage::trim_chunk_space(const string& file_path,
                                gkfs::rpc::chnk_id_t chunk_start) {
 
     auto chunk_dir = absolute(get_chunks_dir(file_path));
-    const fs::directory_iterator end;
     auto err_flag = false;
-    for(fs::directory_iterator chunk_file(chunk_dir); chunk_file != end;
-        ++chunk_file) {
-        auto chunk_path = chunk_file->path();
-        auto chunk_id = std::stoul(chunk_path.filename().c_str());
-        if(chunk_id >= chunk_start) {
-            auto err = unlink(chunk_path.c_str());
-            if(err == -1 && errno != ENOENT) {
-                err_flag = true;
-                log_->warn(
-                        "{}() Failed to remove chunk file. File: '{}', Error: '{}'",
-                        __func__, chunk_path.native(), ::strerror(errno));
-            }
+    auto remove_chunk = [&](const string& chunk_path) {
+        auto err = unlink(chunk_path.c_str());
+        if(err == -1 && errno != ENOENT) {
+            err_flag = true;
+            log_->warn(
+                    "{}() Failed to remove chunk file. File: '{}', Error: '{}'",
+                    __func__, chunk_path, ::strerror(errno));
+        }
+    };
+    std::vector<gkfs::rpc::chnk_id_t> indexed_chunks{};
+    auto indexed = false;
+    {
+        lock_guard<mutex> lock(chunk_index_mutex_);
+        auto it = chunk_index_.find(file_path);
+        if(it != chunk_index_.end() && it->second.complete) {
+            auto& chunks = it->second.chunks;
+            auto first = chunks.lower_bound(chunk_start);
+            indexed_chunks.assign(first, chunks.end());
+            chunks.erase(first, chunks.end());
+            chunk_index_size_ -= indexed_chunks.size();
+            indexed = true;
+        }
+    }
+    if(indexed) {
+        for(auto chunk_id : indexed_chunks)
+            remove_chunk(absolute(get_chunk_path(file_path, chunk_id)));
+    } else {
+        // a daemon that never stored a chunk of the file has nothing to trim
+        std::error_code ec{};
+        fs::directory_iterator chunk_file(chunk_dir, ec);
+        if(ec == std::errc::no_such_file_or_directory)
+            return;
+        if(ec)
+            throw ChunkStorageException(
+                    ec.value(),
+                    fmt::format(
+                            "{}() Failed to open chunk directory '{}': '{}'",
+                            __func__, chunk_dir, ec.message()));
+        const fs::directory_iterator end;
+        for(; chunk_file != end; ++chunk_file) {
+            auto chunk_path = chunk_file->path();
+            auto chunk_id = std::stoul(chunk_path.filename().c_str());
+            if(chunk_id >= chunk_start)
+                remove_chunk(chunk_path.native());
         }
     }
     if(err_flag)
@@ -292,7 +592,7 @@ ChunkStorage::truncate_chunk_file(const string& file_path,
                                   gkfs::rpc::chnk_id_t chunk_id, off_t length) {
     auto chunk_path = absolute(get_chunk_path(file_path, chunk_id));
     assert(length > 0 &&
-           static_cast<gkfs::rpc::chnk_id_t>(length) <= chunksize_);
+           static_cast<size_t>(length) <= gkfs::config::rpc::max_chunksize);
     auto ret = truncate(chunk_path.c_str(), length);
     if(ret == -1) {
         auto err_str = fmt::format(
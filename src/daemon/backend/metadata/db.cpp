@@ -26,6 +26,7 @@
   SPDX-License-Identifier: GPL-3.0-or-later
 */
 
+#include <daemon/daemon.hpp>
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/metadata/merge.hpp>
 #include <daemon/backend/exceptions.hpp>
@@ -46,7 +47,7 @@ namespace gkfs::metadata {
 /**
  * Factory to create DB instances
  * @param path where KV store data is stored
- * @param id parallax or rocksdb (default) backend
+ * @param id parallax, memorydb, or rocksdb (default) backend
  */
 struct MetadataDBFactory {
     static std::unique_ptr<AbstractMetadataBackend>
@@ -69,6 +70,14 @@ struct MetadataDBFactory {
                                             metadata_path);
             return std::make_unique<RocksDBBackend>(metadata_path);
 #endif
+        } else if(id == gkfs::metadata::memory_backend) {
+            auto metadata_path =
+                    fmt::format("{}/{}", path, gkfs::metadata::memory_backend);
+            GKFS_METADATA_MOD->log()->trace(
+                    "Using in-memory metadata with snapshot directory '{}'",
+                    metadata_path);
+            return std::make_unique<MemoryBackend>(
+                    metadata_path, GKFS_DATA->memorydb_snapshot_interval());
         }
         GKFS_METADATA_MOD->log()->error("No valid metadata backend selected");
         exit(EXIT_FAILURE);
@@ -169,6 +178,17 @@ MetadataDB::decrease_size(const std::string& key, size_t size) {
     backend_->decrease_size(key, size);
 }
 
+/**
+ * @internal
+ * E.g., called by set_chunk_size()
+ * @endinternal
+ */
+void
+MetadataDB::update_chunk_size(const std::string& key, size_t chunk_size) {
+
+    backend_->update_chunk_size(key, chunk_size);
+}
+
 std::vector<std::pair<std::string, bool>>
 MetadataDB::get_dirents(const std::string& dir) const {
     auto root_path = dir;
@@ -195,6 +215,33 @@ MetadataDB::get_dirents_extended(const std::string& dir) const {
     return backend_->get_dirents_extended(root_path);
 }
 
+void
+MetadataDB::scan(const std::string& dir, bool recursive,
+                 const scan_fn& fn) const {
+    auto root_path = dir;
+    assert(gkfs::path::is_absolute(root_path));
+    // add trailing slash if missing
+    if(!gkfs::path::has_trailing_slash(root_path) && root_path.size() != 1) {
+        // add trailing slash only if missing and is not the root_folder "/"
+        root_path.push_back('/');
+    }
+
+    backend_->scan(root_path, recursive, fn);
+}
+
+void
+MetadataDB::remove_subtree(const std::string& dir) {
+    auto root_path = dir;
+    assert(gkfs::path::is_absolute(root_path));
+    // add trailing slash if missing
+    if(!gkfs::path::has_trailing_slash(root_path) && root_path.size() != 1) {
+        // add trailing slash only if missing and is not the root_folder "/"
+        root_path.push_back('/');
+    }
+
+    backend_->remove_subtree(root_path);
+}
+
 
 /**
  * @internal
@@ -0,0 +1,530 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <daemon/backend/metadata/db.hpp>
+#include <daemon/backend/exceptions.hpp>
+#include <daemon/backend/metadata/metadata_module.hpp>
+
+#include <common/metadata.hpp>
+#include <daemon/backend/metadata/memory_backend.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+extern "C" {
+#include <sys/stat.h>
+}
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/**
+ * @brief Returns the key ranges holding the subtree of a directory.
+ * @internal
+ * The directory's children share the prefix (directory, '\0') and all deeper
+ * entries the prefix (directory, '/'). For the root "/", the former is the
+ * root's own key which is excluded.
+ * @endinternal
+ * @param dir directory path with a trailing slash
+ * @return [begin, end) key ranges
+ */
+std::vector<std::pair<std::string, std::string>>
+subtree_ranges(const std::string& dir) {
+    std::vector<std::pair<std::string, std::string>> ranges;
+    for(auto prefix : {dir.substr(0, dir.size() - 1) + '\0', dir}) {
+        auto end = prefix;
+        end.back()++;
+        if(prefix.size() == 1 && prefix[0] == '\0')
+            prefix.push_back('\0');
+        ranges.emplace_back(std::move(prefix), std::move(end));
+    }
+    return ranges;
+}
+
+} // namespace
+
+namespace gkfs::metadata {
+
+/**
+ * Called when the daemon is started. Loads an existing snapshot and starts the
+ * background snapshot thread if snapshots are enabled.
+ * @param path directory for the snapshot file
+ * @param snapshot_interval interval of background snapshots in seconds. 0
+ * disables snapshots
+ * @throws DBException if an existing snapshot cannot be loaded
+ */
+MemoryBackend::MemoryBackend(const std::string& path,
+                             unsigned int snapshot_interval)
+    : snapshot_interval_(snapshot_interval) {
+    if(snapshot_interval == 0)
+        return;
+    fs::create_directories(path);
+    snapshot_path_ = fmt::format("{}/{}", path,
+                                 gkfs::config::metadata::memory_snapshot_file);
+    load_snapshot();
+    snapshot_thread_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(snapshot_mutex_);
+        while(!snapshot_cv_.wait_for(lock, snapshot_interval_,
+                                     [this] { return shutdown_; })) {
+            try {
+                write_snapshot();
+            } catch(const std::exception& e) {
+                GKFS_METADATA_MOD->log()->error("{}() {}", __func__, e.what());
+            }
+        }
+    });
+}
+
+/**
+ * Stops the background snapshot thread and writes a final snapshot
+ */
+MemoryBackend::~MemoryBackend() {
+    if(!snapshot_thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        shutdown_ = true;
+    }
+    snapshot_cv_.notify_all();
+    snapshot_thread_.join();
+    try {
+        write_snapshot();
+    } catch(const std::exception& e) {
+        GKFS_METADATA_MOD->log()->error("{}() {}", __func__, e.what());
+    }
+}
+
+std::pair<MemoryBackend::shard*, std::string>
+MemoryBackend::locate(const std::string& path) {
+    auto [s, key] = std::as_const(*this).locate(path);
+    return {const_cast<shard*>(s), std::move(key)};
+}
+
+/**
+ * @internal
+ * The path "/a/b/c" is stored as "/a/b" + '\0' + "c" and the root "/" as '\0'
+ * in the shard of its parent "/a/b".
+ * @endinternal
+ */
+std::pair<const MemoryBackend::shard*, std::string>
+MemoryBackend::locate(const std::string& path) const {
+    auto sep = path.rfind('/');
+    std::string key;
+    key.reserve(path.size() + 1);
+    key.append(path, 0, sep);
+    auto idx = std::hash<std::string>{}(key) % shards_.size();
+    key.push_back('\0');
+    key.append(path, sep + 1, std::string::npos);
+    return {&shards_[idx], std::move(key)};
+}
+
+/**
+ * @internal
+ * The snapshot holds all entries as pairs of length-prefixed keys and values.
+ * @endinternal
+ */
+void
+MemoryBackend::load_snapshot() {
+    std::ifstream ifs(snapshot_path_, std::ios::binary);
+    if(!ifs)
+        return;
+    auto read_str = [&ifs](std::string& str) {
+        uint32_t len{};
+        if(!ifs.read(reinterpret_cast<char*>(&len), sizeof(len)))
+            return false;
+        str.resize(len);
+        return static_cast<bool>(ifs.read(str.data(), len));
+    };
+    size_t count = 0;
+    std::string key;
+    std::string val;
+    while(read_str(key)) {
+        if(!read_str(val)) {
+            throw DBException(fmt::format("Corrupt metadata snapshot '{}'",
+                                          snapshot_path_));
+        }
+        auto parent = key.substr(0, key.find('\0'));
+        auto& s = shards_[std::hash<std::string>{}(parent) % shards_.size()];
+        s.entries.emplace(key, val);
+        count++;
+    }
+    GKFS_METADATA_MOD->log()->info("{}() Loaded {} entries from snapshot '{}'",
+                                   __func__, count, snapshot_path_);
+}
+
+/**
+ * @internal
+ * Shards are copied one at a time under a shared lock so that requests are
+ * only blocked while a shard is copied. The snapshot is written to a temporary
+ * file first which replaces the previous snapshot once complete.
+ * @endinternal
+ */
+void
+MemoryBackend::write_snapshot() const {
+    auto tmp_path = snapshot_path_ + ".tmp";
+    std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+    auto write_str = [&ofs](const std::string& str) {
+        auto len = static_cast<uint32_t>(str.size());
+        ofs.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        ofs.write(str.data(), len);
+    };
+    size_t count = 0;
+    for(const auto& s : shards_) {
+        std::map<std::string, std::string> entries;
+        {
+            std::shared_lock<std::shared_mutex> lock(s.mutex);
+            entries = s.entries;
+        }
+        for(const auto& [key, val] : entries) {
+            write_str(key);
+            write_str(val);
+        }
+        count += entries.size();
+    }
+    ofs.close();
+    if(!ofs) {
+        throw DBException(fmt::format("Failed to write metadata snapshot '{}'",
+                                      tmp_path));
+    }
+    fs::rename(tmp_path, snapshot_path_);
+    GKFS_METADATA_MOD->log()->debug("{}() Wrote {} entries to snapshot '{}'",
+                                    __func__, count, snapshot_path_);
+}
+
+/**
+ * @internal
+ * All children of a directory are adjacent in the shard of the directory and
+ * share the prefix (directory, '\0'). Only these entries are visited.
+ * @endinternal
+ */
+std::vector<std::pair<std::string, Metadata>>
+MemoryBackend::list_directory(const std::string& dir) const {
+    // the root directory "/" is the empty parent
+    auto prefix = dir.substr(0, dir.size() - 1);
+    const auto& s =
+            shards_[std::hash<std::string>{}(prefix) % shards_.size()];
+    prefix.push_back('\0');
+
+    std::vector<std::pair<std::string, Metadata>> entries;
+    std::shared_lock<std::shared_mutex> lock(s.mutex);
+    for(auto it = s.entries.lower_bound(prefix);
+        it != s.entries.end() &&
+        it->first.compare(0, prefix.size(), prefix) == 0;
+        ++it) {
+        if(it->first.size() == prefix.size()) {
+            // we skip this path cause it is exactly the root_path
+            continue;
+        }
+        Metadata md(it->second);
+#ifdef HAS_RENAME
+        // Remove entries with negative blocks (rename)
+        if(md.blocks() == -1) {
+            continue;
+        }
+#endif // HAS_RENAME
+        entries.emplace_back(it->first.substr(prefix.size()), std::move(md));
+    }
+    return entries;
+}
+
+/**
+ * Gets a value for a key
+ * @param key
+ * @return value
+ * @throws NotFoundException if entry doesn't exist
+ */
+std::string
+MemoryBackend::get_impl(const std::string& key) const {
+    auto [s, k] = locate(key);
+    std::shared_lock<std::shared_mutex> lock(s->mutex);
+    auto it = s->entries.find(k);
+    if(it == s->entries.end())
+        throw NotFoundException(key);
+    return it->second;
+}
+
+/**
+ * Puts an entry. An existing entry is left unchanged as with the RocksDB
+ * backend's create merge operand
+ * @param key
+ * @param val
+ */
+void
+MemoryBackend::put_impl(const std::string& key, const std::string& val) {
+    auto [s, k] = locate(key);
+    std::unique_lock<std::shared_mutex> lock(s->mutex);
+    s->entries.try_emplace(std::move(k), val);
+}
+
+/**
+ * Puts an entry if it doesn't exist
+ * @param key
+ * @param val
+ * @throws ExistException if entry already exists
+ */
+void
+MemoryBackend::put_no_exist_impl(const std::string& key,
+                                 const std::string& val) {
+    auto [s, k] = locate(key);
+    std::unique_lock<std::shared_mutex> lock(s->mutex);
+    if(!s->entries.try_emplace(std::move(k), val).second)
+        throw ExistsException(key);
+}
+
+/**
+ * Removes an entry
+ * @param key
+ * @throws NotFoundException if entry doesn't exist
+ */
+void
+MemoryBackend::remove_impl(const std::string& key) {
+    auto [s, k] = locate(key);
+    std::unique_lock<std::shared_mutex> lock(s->mutex);
+    if(s->entries.erase(k) == 0)
+        throw NotFoundException(key);
+}
+
+/**
+ * checks for existence of an entry
+ * @param key
+ * @return true if exists
+ */
+bool
+MemoryBackend::exists_impl(const std::string& key) {
+    auto [s, k] = locate(key);
+    std::shared_lock<std::shared_mutex> lock(s->mutex);
+    return s->entries.count(k) != 0;
+}
+
+/**
+ * Updates a metadentry atomically and also allows to change keys
+ * @param old_key
+ * @param new_key
+ * @param val
+ * @throws NotFoundException if entry doesn't exist
+ */
+void
+MemoryBackend::update_impl(const std::string& old_key,
+                           const std::string& new_key,
+                           const std::string& val) {
+    auto [old_s, old_k] = locate(old_key);
+    auto [new_s, new_k] = locate(new_key);
+    if(old_s == new_s) {
+        std::unique_lock<std::shared_mutex> lock(old_s->mutex);
+        if(old_s->entries.erase(old_k) == 0)
+            throw NotFoundException(old_key);
+        old_s->entries[new_k] = val;
+        return;
+    }
+    std::scoped_lock lock(old_s->mutex, new_s->mutex);
+    if(old_s->entries.erase(old_k) == 0)
+        throw NotFoundException(old_key);
+    new_s->entries[new_k] = val;
+}
+
+/**
+ * Updates the size on the metadata
+ * Operation. E.g., called before a write() call
+ * @param key
+ * @param size
+ * @param append
+ * @throws NotFoundException if entry doesn't exist
+ */
+void
+MemoryBackend::increase_size_impl(const std::string& key, size_t size,
+                                  bool append) {
+    auto [s, k] = locate(key);
+    std::unique_lock<std::shared_mutex> lock(s->mutex);
+    auto it = s->entries.find(k);
+    if(it == s->entries.end())
+        throw NotFoundException(key);
+    Metadata md(it->second);
+    if(append)
+        md.size(md.size() + size);
+    else
+        md.size(std::max(md.size(), size));
+    it->second = md.serialize();
+}
+
+/**
+ * Decreases the size on the metadata
+ * Operation E.g., called before a truncate() call
+ * @param key
+ * @param size
+ * @throws NotFoundException if entry doesn't exist
+ */
+void
+MemoryBackend::decrease_size_impl(const std::string& key, size_t size) {
+    auto [s, k] = locate(key);
+    std::unique_lock<std::shared_mutex> lock(s->mutex);
+    auto it = s->entries.find(k);
+    if(it == s->entries.end())
+        throw NotFoundException(key);
+    Metadata md(it->second);
+    md.size(size);
+    it->second = md.serialize();
+}
+
+/**
+ * Sets the chunk size on the metadata unless the entry is a regular file
+ * which already has data
+ * @param key
+ * @param chunk_size
+ * @throws NotFoundException if entry doesn't exist
+ */
+void
+MemoryBackend::update_chunk_size_impl(const std::string& key,
+                                      size_t chunk_size) {
+    auto [s, k] = locate(key);
+    std::unique_lock<std::shared_mutex> lock(s->mutex);
+    auto it = s->entries.find(k);
+    if(it == s->entries.end())
+        throw NotFoundException(key);
+    Metadata md(it->second);
+    if(S_ISREG(md.mode()) && md.size() > 0)
+        return;
+    md.chunk_size(chunk_size);
+    it->second = md.serialize();
+}
+
+/**
+ * Return all the first-level entries of the directory @dir
+ *
+ * @return vector of pair <std::string name, bool is_dir>,
+ *         where name is the name of the entries and is_dir
+ *         is true in the case the entry is a directory.
+ */
+std::vector<std::pair<std::string, bool>>
+MemoryBackend::get_dirents_impl(const std::string& dir) const {
+    std::vector<std::pair<std::string, bool>> entries;
+    for(const auto& [name, md] : list_directory(dir)) {
+        entries.emplace_back(name, S_ISDIR(md.mode()));
+    }
+    return entries;
+}
+
+/**
+ * Return all the first-level entries of the directory @dir
+ *
+ * @return vector of pair <std::string name, bool is_dir - size - ctime>,
+ *         where name is the name of the entries and is_dir
+ *         is true in the case the entry is a directory.
+ */
+std::vector<std::tuple<std::string, bool, size_t, time_t>>
+MemoryBackend::get_dirents_extended_impl(const std::string& dir) const {
+    std::vector<std::tuple<std::string, bool, size_t, time_t>> entries;
+    for(const auto& [name, md] : list_directory(dir)) {
+        entries.emplace_back(std::forward_as_tuple(name, S_ISDIR(md.mode()),
+                                                   md.size(), md.ctime()));
+    }
+    return entries;
+}
+/**
+ * Calls a function for each entry below the directory @dir, i.e., its
+ * first-level entries or, if recursive, all entries of its subtree
+ * @internal
+ * A subtree is spread over all shards and consists of the same key ranges in
+ * each. @fn is called while holding a shard's shared lock and must not access
+ * the backend.
+ * @endinternal
+ * @param dir directory with a trailing slash
+ * @param recursive true to visit the whole subtree
+ * @param fn called with the absolute path and metadata of each entry
+ */
+void
+MemoryBackend::scan_impl(const std::string& dir, bool recursive,
+                         const scan_fn& fn) const {
+    if(!recursive) {
+        for(const auto& [name, md] : list_directory(dir)) {
+            fn(dir + name, md);
+        }
+        return;
+    }
+    auto ranges = subtree_ranges(dir);
+    for(const auto& s : shards_) {
+        std::shared_lock<std::shared_mutex> lock(s.mutex);
+        for(const auto& [begin, end] : ranges) {
+            for(auto it = s.entries.lower_bound(begin);
+                it != s.entries.end() && it->first < end; ++it) {
+                auto path = it->first;
+                std::replace(path.begin(), path.end(), '\0', '/');
+                Metadata md(it->second);
+#ifdef HAS_RENAME
+                // Remove entries with negative blocks (rename)
+                if(md.blocks() == -1) {
+                    continue;
+                }
+#endif // HAS_RENAME
+                fn(path, md);
+            }
+        }
+    }
+}
+
+/**
+ * Removes all entries below the directory @dir, i.e., its subtree
+ * @param dir directory with a trailing slash
+ */
+void
+MemoryBackend::remove_subtree_impl(const std::string& dir) {
+    auto ranges = subtree_ranges(dir);
+    for(auto& s : shards_) {
+        std::unique_lock<std::shared_mutex> lock(s.mutex);
+        for(const auto& [begin, end] : ranges) {
+            s.entries.erase(s.entries.lower_bound(begin),
+                            s.entries.lower_bound(end));
+        }
+    }
+}
+
+/**
+ * Code example for iterating all entries. This is for debug only as it is too
+ * expensive
+ */
+void
+MemoryBackend::iterate_all_impl() const {
+    for(const auto& s : shards_) {
+        std::shared_lock<std::shared_mutex> lock(s.mutex);
+        for(const auto& [key, val] : s.entries) {
+            auto path = key;
+            std::replace(path.begin(), path.end(), '\0', '/');
+            std::cout << path << std::endl;
+        }
+    }
+}
+
+/**
+ * Unused, as no KV store settings exist
+ */
+void
+MemoryBackend::optimize_database_impl() {}
+
+} // namespace gkfs::metadata
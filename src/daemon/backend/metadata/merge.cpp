@@ -132,6 +132,27 @@ CreateOperand::serialize_params() const {
 }
 
 
+ChunkSizeOperand::ChunkSizeOperand(const size_t chunk_size)
+    : chunk_size(chunk_size) {}
+
+ChunkSizeOperand::ChunkSizeOperand(const rdb::Slice& serialized_op) {
+    size_t read = 0;
+    chunk_size = ::stoul(serialized_op.ToString(), &read);
+    // check that we consumed all the input string
+    assert(read == serialized_op.size());
+}
+
+OperandID
+ChunkSizeOperand::id() const {
+    return OperandID::chunk_size;
+}
+
+string
+ChunkSizeOperand::serialize_params() const {
+    return ::to_string(chunk_size);
+}
+
+
 bool
 MetadataMergeOperator::FullMergeV2(const MergeOperationInput& merge_in,
                                    MergeOperationOutput* merge_out) const {
@@ -176,6 +197,12 @@ MetadataMergeOperator::FullMergeV2(const MergeOperationInput& merge_in,
             auto op = DecreaseSizeOperand(parameters);
             assert(op.size < fsize); // we assume no concurrency here
             fsize = op.size;
+        } else if(operand_id == OperandID::chunk_size) {
+            auto op = ChunkSizeOperand(parameters);
+            // existing chunks would no longer be found, e.g., if a write
+            // raced with the chunk size change
+            if(!S_ISREG(md.mode()) || fsize == 0)
+                md.chunk_size(op.chunk_size);
         } else if(operand_id == OperandID::create) {
             continue;
         } else {
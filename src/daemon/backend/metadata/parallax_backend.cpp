@@ -363,6 +363,27 @@ ParallaxBackend::decrease_size_impl(const std::string& key, size_t size) {
     update(key, key, md.serialize());
 }
 
+/**
+ * Sets the chunk size on the metadata unless the entry is a regular file
+ * which already has data
+ * @param key
+ * @param chunk_size
+ * @throws DBException on failure
+ */
+void
+ParallaxBackend::update_chunk_size_impl(const std::string& key,
+                                        size_t chunk_size) {
+    lock_guard<recursive_mutex> lock_guard(parallax_mutex_);
+
+    auto value = get(key);
+    // Decompress string
+    Metadata md(value);
+    if(S_ISREG(md.mode()) && md.size() > 0)
+        return;
+    md.chunk_size(chunk_size);
+    update(key, key, md.serialize());
+}
+
 /**
  * Return all the first-level entries of the directory @dir
  *
@@ -520,7 +541,99 @@ ParallaxBackend::get_dirents_extended_impl(const std::string& dir) const {
 
     return entries;
 }
+/**
+ * Calls a function for each entry below the directory @dir, i.e., its
+ * first-level entries or, if recursive, all entries of its subtree
+ * @param dir directory with a trailing slash
+ * @param recursive true to visit the whole subtree
+ * @param fn called with the absolute path and metadata of each entry
+ */
+void
+ParallaxBackend::scan_impl(const std::string& dir, bool recursive,
+                           const scan_fn& fn) const {
+    struct par_key K;
 
+    str2par(dir, K);
+    const char* error = NULL;
+    par_scanner S = par_init_scanner(par_db_, &K, PAR_GREATER_OR_EQUAL, &error);
+    if(error) {
+        throw_status_excpt(fmt::format("Failed to scan_impl: err {}", *error));
+    }
+
+    while(par_is_valid(S)) {
+        struct par_key K2 = par_get_key(S);
+        struct par_value value = par_get_value(S);
+
+        std::string k(K2.data, K2.size);
+
+        if(k.size() < dir.size() || k.compare(0, dir.size(), dir) != 0) {
+            break;
+        }
+
+        // skip the directory itself and, if not recursive, stuff deeper then
+        // one level depth
+        if(k.size() == dir.size() ||
+           (!recursive &&
+            k.find_first_of('/', dir.size()) != std::string::npos)) {
+            if(par_get_next(S) && !par_is_valid(S))
+                break;
+            continue;
+        }
+
+        Metadata md(std::string(value.val_buffer, value.val_size));
+#ifdef HAS_RENAME
+        // Remove entries with negative blocks (rename)
+        if(md.blocks() == -1) {
+            if(par_get_next(S) && !par_is_valid(S))
+                break;
+            continue;
+        }
+#endif // HAS_RENAME
+        fn(k, md);
+
+        if(par_get_next(S) && !par_is_valid(S))
+            break;
+    }
+    // If we don't close the scanner we cannot delete keys
+    par_close_scanner(S);
+}
+
+/**
+ * Removes all entries below the directory @dir, i.e., its subtree
+ * @param dir directory with a trailing slash
+ * @throws DBException on failure
+ */
+void
+ParallaxBackend::remove_subtree_impl(const std::string& dir) {
+    struct par_key K;
+
+    str2par(dir, K);
+    const char* error = NULL;
+    par_scanner S = par_init_scanner(par_db_, &K, PAR_GREATER_OR_EQUAL, &error);
+    if(error) {
+        throw_status_excpt(
+                fmt::format("Failed to remove_subtree_impl: err {}", *error));
+    }
+
+    std::vector<std::string> keys;
+    while(par_is_valid(S)) {
+        struct par_key K2 = par_get_key(S);
+        std::string k(K2.data, K2.size);
+        if(k.size() < dir.size() || k.compare(0, dir.size(), dir) != 0) {
+            break;
+        }
+        if(k.size() > dir.size())
+            keys.push_back(std::move(k));
+        if(par_get_next(S) && !par_is_valid(S))
+            break;
+    }
+    // If we don't close the scanner we cannot delete keys
+    par_close_scanner(S);
+
+    for(const auto& key : keys) {
+        remove_impl(key);
+    }
+}
 
 /**
  * Code example for iterating all entries in KV store. This is for debug only as
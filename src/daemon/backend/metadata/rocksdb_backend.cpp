@@ -31,19 +31,330 @@
 #include <daemon/backend/exceptions.hpp>
 #include <daemon/backend/metadata/metadata_module.hpp>
 
+#include <daemon/daemon.hpp>
+
 #include <common/metadata.hpp>
 #include <common/path_util.hpp>
 #include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
 #include <daemon/backend/metadata/rocksdb_backend.hpp>
+#include <rocksdb/cache.h>
+#include <rocksdb/convenience.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/memtablerep.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/table.h>
 extern "C" {
 #include <sys/stat.h>
 }
 
+namespace {
+
+/**
+ * @brief Prefix extractor mapping a metadata key to its parent directory.
+ * @internal
+ * Keys are absolute paths. The prefix is the path up to and including the
+ * last slash so that all entries of a directory share one prefix. Prefix bloom
+ * filters in memtables and SST files can then skip data that holds no entry
+ * of a directory.
+ * @endinternal
+ */
+class ParentDirTransform : public rdb::SliceTransform {
+public:
+    const char*
+    Name() const override {
+        return "gkfs.ParentDirTransform";
+    }
+
+    rdb::Slice
+    Transform(const rdb::Slice& key) const override {
+        auto len = key.size();
+        while(len > 0 && key[len - 1] != '/')
+            len--;
+        return {key.data(), len};
+    }
+
+    bool
+    InDomain(const rdb::Slice& key) const override {
+        return key.size() > 0 && key[0] == '/';
+    }
+};
+
+/**
+ * @brief Prefix extractor for keys encoded as (parent, name).
+ * @internal
+ * The prefix is the parent path including the separating null character, so
+ * that all direct children of a directory, and only those, share one prefix.
+ * @endinternal
+ */
+class ParentKeyTransform : public rdb::SliceTransform {
+public:
+    const char*
+    Name() const override {
+        return "gkfs.ParentKeyTransform";
+    }
+
+    rdb::Slice
+    Transform(const rdb::Slice& key) const override {
+        std::string_view sv(key.data(), key.size());
+        return {key.data(), sv.find('\0') + 1};
+    }
+
+    bool
+    InDomain(const rdb::Slice& key) const override {
+        return std::string_view(key.data(), key.size()).find('\0') !=
+               std::string_view::npos;
+    }
+};
+
+/**
+ * @brief Reads the daemon's RocksDB configuration file.
+ * @internal
+ * Each line holds a `key = value` pair. Empty lines and text after a `#` are
+ * ignored.
+ * @endinternal
+ * @param config_file path to the configuration file
+ * @return map of keys to values
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+std::unordered_map<std::string, std::string>
+read_config_file(const std::string& config_file) {
+    std::ifstream ifs(config_file);
+    if(!ifs) {
+        throw std::runtime_error(fmt::format(
+                "Failed to open RocksDB config file '{}'", config_file));
+    }
+    auto trim = [](const std::string& str) {
+        auto begin = str.find_first_not_of(" \t");
+        if(begin == std::string::npos)
+            return std::string{};
+        auto end = str.find_last_not_of(" \t");
+        return str.substr(begin, end - begin + 1);
+    };
+    std::unordered_map<std::string, std::string> entries{};
+    std::string line;
+    while(std::getline(ifs, line)) {
+        line = trim(line.substr(0, line.find('#')));
+        if(line.empty())
+            continue;
+        auto sep = line.find('=');
+        if(sep == std::string::npos) {
+            throw std::runtime_error(fmt::format(
+                    "Malformed line in RocksDB config file '{}': '{}'",
+                    config_file, line));
+        }
+        entries[trim(line.substr(0, sep))] = trim(line.substr(sep + 1));
+    }
+    return entries;
+}
+
+/**
+ * @brief Applies an options profile tailored to a metadata workload.
+ * @internal
+ * All profiles but `default` use a parent directory prefix extractor with
+ * prefix and whole key bloom filters in memtables and SST files, and a
+ * dedicated block cache for data, index, and filter blocks.
+ *
+ * - create-heavy: large write buffers which delay flushes and level-0
+ *   compactions. Memtables stay skiplists: readdir and subtree scans with path
+ *   keys seek in total order, which a hash skiplist memtable serves only by
+ *   sorting its whole contents on each seek. Skiplists also allow concurrent
+ *   memtable writes.
+ * - stat-heavy: a large block cache and hash indexes within data blocks for
+ *   point lookups.
+ * - readdir-heavy: larger data blocks and dynamic level sizes for directory
+ *   scans.
+ * @endinternal
+ * @param options RocksDB options to tune
+ * @param profile profile name
+ * @param parent_keys true if keys are encoded as (parent, name)
+ * @throws std::runtime_error for an unknown profile
+ */
+void
+apply_profile(rdb::Options& options, const std::string& profile,
+              bool parent_keys) {
+    constexpr size_t mib = 1024 * 1024;
+    if(profile == gkfs::config::rocksdb::profile_default)
+        return;
+    if(profile != gkfs::config::rocksdb::profile_create &&
+       profile != gkfs::config::rocksdb::profile_stat &&
+       profile != gkfs::config::rocksdb::profile_readdir) {
+        throw std::runtime_error(
+                fmt::format("Unknown RocksDB profile '{}'", profile));
+    }
+
+    if(parent_keys)
+        options.prefix_extractor = std::make_shared<ParentKeyTransform>();
+    else
+        options.prefix_extractor = std::make_shared<ParentDirTransform>();
+    options.memtable_prefix_bloom_size_ratio = 0.1;
+    options.memtable_whole_key_filtering = true;
+
+    rdb::BlockBasedTableOptions table_options{};
+    table_options.filter_policy.reset(rdb::NewBloomFilterPolicy(10, false));
+    table_options.whole_key_filtering = true;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+
+    if(profile == gkfs::config::rocksdb::profile_create) {
+        options.write_buffer_size = 128 * mib;
+        options.max_write_buffer_number = 6;
+        options.min_write_buffer_number_to_merge = 2;
+        options.level0_file_num_compaction_trigger = 8;
+        options.level0_slowdown_writes_trigger = 32;
+        options.level0_stop_writes_trigger = 64;
+        table_options.block_cache = rdb::NewLRUCache(64 * mib);
+    } else if(profile == gkfs::config::rocksdb::profile_stat) {
+        table_options.block_cache = rdb::NewLRUCache(512 * mib);
+        table_options.data_block_index_type =
+                rdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+        table_options.data_block_hash_table_util_ratio = 0.75;
+    } else {
+        table_options.block_cache = rdb::NewLRUCache(256 * mib);
+        table_options.block_size = 16 * 1024;
+        options.level_compaction_dynamic_level_bytes = true;
+    }
+    options.table_factory.reset(rdb::NewBlockBasedTableFactory(table_options));
+}
+
+/**
+ * @brief Calls a function for each first-level entry of a directory.
+ * @internal
+ * With keys encoded as (parent, name), all children of a directory are
+ * adjacent and share one prefix, so only they are read.
+ *
+ * With path keys, entries of subdirectories are not scanned either. The first
+ * key found within a subdirectory's subtree triggers a seek past the whole
+ * subtree. Iteration must be in total order as a directory's entries and their
+ * subtrees do not share one prefix.
+ * @endinternal
+ * @param db RocksDB instance
+ * @param root_path directory path with a trailing slash
+ * @param parent_keys true if keys are encoded as (parent, name)
+ * @param fn called with the entry's name and value
+ */
+template <typename Fn>
+void
+scan_directory(rdb::DB& db, const std::string& root_path, bool parent_keys,
+               Fn&& fn) {
+    // the directory's key prefix. Keys of the root directory "/" are prefixed
+    // with the null character only.
+    auto prefix = root_path;
+    if(parent_keys) {
+        prefix.back() = '\0';
+        if(root_path.size() == 1)
+            prefix = std::string(1, '\0');
+    }
+    // all keys of the directory are smaller than the prefix with its last
+    // character replaced by the next character
+    auto upper_bound = prefix;
+    upper_bound.back()++;
+    rdb::Slice upper_bound_slice(upper_bound);
+    rdb::ReadOptions ropts;
+    ropts.total_order_seek = !parent_keys;
+    ropts.iterate_upper_bound = &upper_bound_slice;
+    std::unique_ptr<rdb::Iterator> it(db.NewIterator(ropts));
+
+    it->Seek(prefix);
+    while(it->Valid()) {
+        auto key = it->key();
+        if(key.size() == prefix.size()) {
+            // we skip this path cause it is exactly the root_path
+            it->Next();
+            continue;
+        }
+        std::string_view name(key.data() + prefix.size(),
+                              key.size() - prefix.size());
+        auto slash = parent_keys ? std::string_view::npos : name.find('/');
+        if(slash != std::string_view::npos) {
+            // skip stuff deeper then one level depth with a single seek
+            std::string next(key.data(), prefix.size() + slash);
+            next.push_back('/' + 1);
+            it->Seek(next);
+            continue;
+        }
+        fn(std::string(name), it->value());
+        it->Next();
+    }
+    assert(it->status().ok());
+}
+
+/**
+ * @brief Returns the key ranges holding the subtree of a directory.
+ * @internal
+ * With path keys, the subtree shares the directory's prefix. With keys encoded
+ * as (parent, name), the directory's children share the prefix (directory,
+ * '\0') and all deeper entries the prefix (directory, '/'), i.e., the subtree
+ * consists of two ranges. The root's own key is such a prefix and excluded.
+ * @endinternal
+ * @param root_path directory path with a trailing slash
+ * @param parent_keys true if keys are encoded as (parent, name)
+ * @return [begin, end) key ranges
+ */
+std::vector<std::pair<std::string, std::string>>
+subtree_ranges(const std::string& root_path, bool parent_keys) {
+    const auto root_key = parent_keys ? std::string(1, '\0') : "/";
+    std::vector<std::string> prefixes;
+    if(parent_keys) {
+        prefixes.push_back(root_path);
+        prefixes.back().back() = '\0';
+    }
+    prefixes.push_back(root_path);
+
+    std::vector<std::pair<std::string, std::string>> ranges;
+    for(auto& prefix : prefixes) {
+        // all keys with the prefix are smaller than the prefix with its last
+        // character replaced by the next character
+        auto end = prefix;
+        end.back()++;
+        if(prefix == root_key)
+            prefix.push_back('\0');
+        ranges.emplace_back(std::move(prefix), std::move(end));
+    }
+    return ranges;
+}
+
+/**
+ * @brief Calls a function for each entry in the subtree of a directory.
+ * @param db RocksDB instance
+ * @param root_path directory path with a trailing slash
+ * @param parent_keys true if keys are encoded as (parent, name)
+ * @param fn called with the entry's key and value
+ */
+template <typename Fn>
+void
+scan_subtree(rdb::DB& db, const std::string& root_path, bool parent_keys,
+             Fn&& fn) {
+    for(const auto& [begin, end] : subtree_ranges(root_path, parent_keys)) {
+        rdb::Slice upper_bound_slice(end);
+        rdb::ReadOptions ropts;
+        ropts.total_order_seek = true;
+        ropts.iterate_upper_bound = &upper_bound_slice;
+        std::unique_ptr<rdb::Iterator> it(db.NewIterator(ropts));
+        for(it->Seek(begin); it->Valid(); it->Next()) {
+            fn(it->key(), it->value());
+        }
+        assert(it->status().ok());
+    }
+}
+
+} // namespace
+
 namespace gkfs::metadata {
 
 /**
  * Called when the daemon is started: Connects to the KV store
+ * @internal
+ * Options are taken from the profile and options set in the daemon's RocksDB
+ * configuration file (`--dbconfig`), if given. Besides `profile`,
+ * `use_write_ahead_log`, and `use_parent_keys`, all keys are RocksDB option
+ * names which override the profile's options.
+ * @endinternal
  * @param path where KV store data is stored
+ * @throws std::runtime_error if the configuration is invalid or the DB cannot
+ * be opened
  */
 RocksDBBackend::RocksDBBackend(const std::string& path) {
 
@@ -54,13 +365,62 @@ RocksDBBackend::RocksDBBackend(const std::string& path) {
     options_.create_if_missing = true;
     options_.merge_operator.reset(new MetadataMergeOperator);
     optimize_database_impl();
-    write_opts_.disableWAL = !(gkfs::config::rocksdb::use_write_ahead_log);
+
+    std::unordered_map<std::string, std::string> config{};
+    if(!GKFS_DATA->dbconfig().empty())
+        config = read_config_file(GKFS_DATA->dbconfig());
+    std::string profile = gkfs::config::rocksdb::profile;
+    if(auto it = config.find("profile"); it != config.end()) {
+        profile = it->second;
+        config.erase(it);
+    }
+    auto use_wal = gkfs::config::rocksdb::use_write_ahead_log;
+    parent_keys_ = gkfs::config::rocksdb::use_parent_keys;
+    if(auto it = config.find("use_write_ahead_log"); it != config.end()) {
+        use_wal = it->second == "true" || it->second == "1" ||
+                  it->second == "on";
+        config.erase(it);
+    }
+    if(auto it = config.find("use_parent_keys"); it != config.end()) {
+        parent_keys_ = it->second == "true" || it->second == "1" ||
+                       it->second == "on";
+        config.erase(it);
+    }
+    apply_profile(options_, profile, parent_keys_);
+    if(!config.empty()) {
+        rdb::ConfigOptions config_options{};
+        rdb::Options tuned_options{};
+        auto s = rdb::GetOptionsFromMap(config_options, options_, config,
+                                        &tuned_options);
+        if(!s.ok()) {
+            throw std::runtime_error("Invalid RocksDB option in config file: " +
+                                     s.ToString());
+        }
+        options_ = tuned_options;
+    }
+    GKFS_METADATA_MOD->log()->info(
+            "{}() Using RocksDB profile '{}' with {} option(s) from config file, write-ahead log '{}', parent keys '{}'",
+            __func__, profile, config.size(), use_wal, parent_keys_);
+    write_opts_.disableWAL = !use_wal;
     rdb::DB* rdb_ptr = nullptr;
     auto s = rocksdb::DB::Open(options_, path, &rdb_ptr);
     if(!s.ok()) {
         throw std::runtime_error("Failed to open RocksDB: " + s.ToString());
     }
     this->db_.reset(rdb_ptr);
+
+    // keys of both schemas must not be mixed within one DB
+    std::unique_ptr<rdb::Iterator> it(db_->NewIterator(rdb::ReadOptions()));
+    it->SeekToFirst();
+    if(it->Valid() &&
+       (std::string_view(it->key().data(), it->key().size()).find('\0') !=
+        std::string_view::npos) != parent_keys_) {
+        it.reset();
+        db_.reset();
+        throw std::runtime_error(
+                "RocksDB was created with a different key schema. Set "
+                "'use_parent_keys' as when the metadata directory was created");
+    }
 }
 
 
@@ -68,6 +428,25 @@ RocksDBBackend::~RocksDBBackend() {
     this->db_.reset();
 }
 
+/**
+ * Encodes a path as a KV store key. With parent keys, the path "/a/b/c" is
+ * stored as "/a/b" + '\0' + "c" and the root "/" as '\0'.
+ * @param path absolute path without a trailing slash
+ * @return key
+ */
+std::string
+RocksDBBackend::encode_key(const std::string& path) const {
+    if(!parent_keys_)
+        return path;
+    auto sep = path.rfind('/');
+    std::string key;
+    key.reserve(path.size() + 1);
+    key.append(path, 0, sep);
+    key.push_back('\0');
+    key.append(path, sep + 1, std::string::npos);
+    return key;
+}
+
 /**
  * Exception wrapper on Status object. Throws NotFoundException if
  * s.IsNotFound(), general DBException otherwise
@@ -96,7 +475,7 @@ std::string
 RocksDBBackend::get_impl(const std::string& key) const {
     std::string val;
 
-    auto s = db_->Get(rdb::ReadOptions(), key, &val);
+    auto s = db_->Get(rdb::ReadOptions(), encode_key(key), &val);
     if(!s.ok()) {
         throw_status_excpt(s);
     }
@@ -114,7 +493,7 @@ void
 RocksDBBackend::put_impl(const std::string& key, const std::string& val) {
 
     auto cop = CreateOperand(val);
-    auto s = db_->Merge(write_opts_, key, cop.serialize());
+    auto s = db_->Merge(write_opts_, encode_key(key), cop.serialize());
     if(!s.ok()) {
         throw_status_excpt(s);
     }
@@ -144,7 +523,7 @@ RocksDBBackend::put_no_exist_impl(const std::string& key,
 void
 RocksDBBackend::remove_impl(const std::string& key) {
 
-    auto s = db_->Delete(write_opts_, key);
+    auto s = db_->Delete(write_opts_, encode_key(key));
     if(!s.ok()) {
         throw_status_excpt(s);
     }
@@ -161,7 +540,7 @@ RocksDBBackend::exists_impl(const std::string& key) {
 
     std::string val;
 
-    auto s = db_->Get(rdb::ReadOptions(), key, &val);
+    auto s = db_->Get(rdb::ReadOptions(), encode_key(key), &val);
     if(!s.ok()) {
         if(s.IsNotFound()) {
             return false;
@@ -186,8 +565,8 @@ RocksDBBackend::update_impl(const std::string& old_key,
 
     // TODO use rdb::Put() method
     rdb::WriteBatch batch;
-    batch.Delete(old_key);
-    batch.Put(new_key, val);
+    batch.Delete(encode_key(old_key));
+    batch.Put(encode_key(new_key), val);
     auto s = db_->Write(write_opts_, &batch);
     if(!s.ok()) {
         throw_status_excpt(s);
@@ -207,7 +586,7 @@ RocksDBBackend::increase_size_impl(const std::string& key, size_t size,
                                    bool append) {
 
     auto uop = IncreaseSizeOperand(size, append);
-    auto s = db_->Merge(write_opts_, key, uop.serialize());
+    auto s = db_->Merge(write_opts_, encode_key(key), uop.serialize());
     if(!s.ok()) {
         throw_status_excpt(s);
     }
@@ -224,7 +603,25 @@ void
 RocksDBBackend::decrease_size_impl(const std::string& key, size_t size) {
 
     auto uop = DecreaseSizeOperand(size);
-    auto s = db_->Merge(write_opts_, key, uop.serialize());
+    auto s = db_->Merge(write_opts_, encode_key(key), uop.serialize());
+    if(!s.ok()) {
+        throw_status_excpt(s);
+    }
+}
+
+/**
+ * Sets the chunk size on the metadata. The merge operator drops the operand if
+ * the entry is a regular file which has data at the time it is applied.
+ * @param key
+ * @param chunk_size
+ * @throws DBException on failure
+ */
+void
+RocksDBBackend::update_chunk_size_impl(const std::string& key,
+                                       size_t chunk_size) {
+
+    auto uop = ChunkSizeOperand(chunk_size);
+    auto s = db_->Merge(write_opts_, encode_key(key), uop.serialize());
     if(!s.ok()) {
         throw_status_excpt(s);
     }
@@ -239,43 +636,23 @@ RocksDBBackend::decrease_size_impl(const std::string& key, size_t size) {
  */
 std::vector<std::pair<std::string, bool>>
 RocksDBBackend::get_dirents_impl(const std::string& dir) const {
-    auto root_path = dir;
-    rocksdb::ReadOptions ropts;
-    auto it = db_->NewIterator(ropts);
-
     std::vector<std::pair<std::string, bool>> entries;
-    for(it->Seek(root_path); it->Valid() && it->key().starts_with(root_path);
-        it->Next()) {
-
-        if(it->key().size() == root_path.size()) {
-            // we skip this path cause it is exactly the root_path
-            continue;
-        }
-
-        /***** Get File name *****/
-        auto name = it->key().ToString();
-        if(name.find_first_of('/', root_path.size()) != std::string::npos) {
-            // skip stuff deeper then one level depth
-            continue;
-        }
-        // remove prefix
-        name = name.substr(root_path.size());
-
+    auto add_entry = [&entries](std::string&& name, const rdb::Slice& value) {
         // relative path of directory entries must not be empty
         assert(!name.empty());
 
-        Metadata md(it->value().ToString());
+        Metadata md(value.ToString());
 #ifdef HAS_RENAME
         // Remove entries with negative blocks (rename)
         if(md.blocks() == -1) {
-            continue;
+            return;
         }
 #endif // HAS_RENAME
         auto is_dir = S_ISDIR(md.mode());
 
         entries.emplace_back(std::move(name), is_dir);
-    }
-    assert(it->status().ok());
+    };
+    scan_directory(*db_, dir, parent_keys_, add_entry);
     return entries;
 }
 
@@ -288,48 +665,81 @@ RocksDBBackend::get_dirents_impl(const std::string& dir) const {
  */
 std::vector<std::tuple<std::string, bool, size_t, time_t>>
 RocksDBBackend::get_dirents_extended_impl(const std::string& dir) const {
-    auto root_path = dir;
-    rocksdb::ReadOptions ropts;
-    auto it = db_->NewIterator(ropts);
-
     std::vector<std::tuple<std::string, bool, size_t, time_t>> entries;
-
-    for(it->Seek(root_path); it->Valid() && it->key().starts_with(root_path);
-        it->Next()) {
-
-        if(it->key().size() == root_path.size()) {
-            // we skip this path cause it is exactly the root_path
-            continue;
-        }
-
-        /***** Get File name *****/
-        auto name = it->key().ToString();
-        if(name.find_first_of('/', root_path.size()) != std::string::npos) {
-            // skip stuff deeper then one level depth
-            continue;
-        }
-        // remove prefix
-        name = name.substr(root_path.size());
-
+    auto add_entry = [&entries](std::string&& name, const rdb::Slice& value) {
         // relative path of directory entries must not be empty
         assert(!name.empty());
 
-        Metadata md(it->value().ToString());
+        Metadata md(value.ToString());
 #ifdef HAS_RENAME
         // Remove entries with negative blocks (rename)
         if(md.blocks() == -1) {
-            continue;
+            return;
         }
 #endif // HAS_RENAME
         auto is_dir = S_ISDIR(md.mode());
 
         entries.emplace_back(std::forward_as_tuple(std::move(name), is_dir,
                                                    md.size(), md.ctime()));
-    }
-    assert(it->status().ok());
+    };
+    scan_directory(*db_, dir, parent_keys_, add_entry);
     return entries;
 }
 
+/**
+ * Calls a function for each entry below the directory @dir, i.e., its
+ * first-level entries or, if recursive, all entries of its subtree
+ * @param dir directory with a trailing slash
+ * @param recursive true to visit the whole subtree
+ * @param fn called with the absolute path and metadata of each entry
+ */
+void
+RocksDBBackend::scan_impl(const std::string& dir, bool recursive,
+                          const scan_fn& fn) const {
+    auto visit = [&fn](const std::string& path, const rdb::Slice& value) {
+        Metadata md(value.ToString());
+#ifdef HAS_RENAME
+        // Remove entries with negative blocks (rename)
+        if(md.blocks() == -1) {
+            return;
+        }
+#endif // HAS_RENAME
+        fn(path, md);
+    };
+    if(!recursive) {
+        scan_directory(*db_, dir, parent_keys_,
+                       [&](std::string&& name, const rdb::Slice& value) {
+                           visit(dir + name, value);
+                       });
+        return;
+    }
+    scan_subtree(*db_, dir, parent_keys_,
+                 [&](const rdb::Slice& key, const rdb::Slice& value) {
+                     auto path = key.ToString();
+                     if(parent_keys_)
+                         std::replace(path.begin(), path.end(), '\0', '/');
+                     visit(path, value);
+                 });
+}
+
+/**
+ * Removes all entries below the directory @dir, i.e., its subtree, with one
+ * range deletion per key range in a single atomic batch
+ * @param dir directory with a trailing slash
+ * @throws DBException on failure
+ */
+void
+RocksDBBackend::remove_subtree_impl(const std::string& dir) {
+    rdb::WriteBatch batch;
+    for(const auto& [begin, end] : subtree_ranges(dir, parent_keys_)) {
+        auto s = batch.DeleteRange(begin, end);
+        if(!s.ok())
+            throw_status_excpt(s);
+    }
+    auto s = db_->Write(write_opts_, &batch);
+    if(!s.ok())
+        throw_status_excpt(s);
+}
 
 /**
  * Code example for iterating all entries in KV store. This is for debug only as
@@ -340,10 +750,14 @@ RocksDBBackend::iterate_all_impl() const {
     std::string key;
     std::string val;
     // Do RangeScan on parent inode
-    auto iter = db_->NewIterator(rdb::ReadOptions());
+    rdb::ReadOptions ropts;
+    ropts.total_order_seek = true;
+    std::unique_ptr<rdb::Iterator> iter(db_->NewIterator(ropts));
     for(iter->SeekToFirst(); iter->Valid(); iter->Next()) {
         key = iter->key().ToString();
         val = iter->value().ToString();
+        if(parent_keys_)
+            std::replace(key.begin(), key.end(), '\0', '/');
         std::cout << key << std::endl;
     }
 }
@@ -70,6 +70,37 @@ FsData::storage(const std::shared_ptr<gkfs::data::ChunkStorage>& storage) {
     storage_ = storage;
 }
 
+bool
+FsData::preallocate_chunks() const {
+    return preallocate_chunks_;
+}
+
+void
+FsData::preallocate_chunks(bool preallocate_chunks) {
+    preallocate_chunks_ = preallocate_chunks;
+}
+
+bool
+FsData::use_io_scheduler() const {
+    return use_io_scheduler_;
+}
+
+void
+FsData::use_io_scheduler(bool use_io_scheduler) {
+    use_io_scheduler_ = use_io_scheduler;
+}
+
+const std::shared_ptr<gkfs::data::IoScheduler>&
+FsData::io_scheduler() const {
+    return io_scheduler_;
+}
+
+void
+FsData::io_scheduler(
+        const std::shared_ptr<gkfs::data::IoScheduler>& io_scheduler) {
+    io_scheduler_ = io_scheduler;
+}
+
 const std::string&
 FsData::rootdir() const {
     return rootdir_;
@@ -120,6 +151,16 @@ FsData::dbbackend(const std::string& dbbackend) {
     FsData::dbbackend_ = dbbackend;
 }
 
+const std::string&
+FsData::dbconfig() const {
+    return dbconfig_;
+}
+
+void
+FsData::dbconfig(const std::string& dbconfig) {
+    FsData::dbconfig_ = dbconfig;
+}
+
 const std::string&
 FsData::rpc_protocol() const {
     return rpc_protocol_;
@@ -221,6 +262,26 @@ FsData::parallax_size_md(unsigned int size_md) {
             size_md * 1024ull * 1024ull * 1024ull);
 }
 
+double
+FsData::host_weight() const {
+    return host_weight_;
+}
+
+void
+FsData::host_weight(double host_weight) {
+    FsData::host_weight_ = host_weight;
+}
+
+unsigned int
+FsData::memorydb_snapshot_interval() const {
+    return memorydb_snapshot_interval_;
+}
+
+void
+FsData::memorydb_snapshot_interval(unsigned int interval) {
+    FsData::memorydb_snapshot_interval_ = interval;
+}
+
 const std::shared_ptr<gkfs::utils::Stats>&
 FsData::stats() const {
     return stats_;
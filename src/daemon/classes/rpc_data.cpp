@@ -27,6 +27,7 @@
 */
 
 #include <daemon/classes/rpc_data.hpp>
+#include <daemon/util.hpp>
 
 using namespace std;
 
@@ -87,6 +88,57 @@ RPCData::distributor(
     distributor_ = distributor;
 }
 
+hg_addr_t
+RPCData::peer_addr(uint64_t host_id) {
+    {
+        lock_guard<mutex> lock(peer_mutex_);
+        if(host_id < peer_addrs_.size() && peer_addrs_[host_id] != HG_ADDR_NULL)
+            return peer_addrs_[host_id];
+    }
+    // The hosts file is complete once the clients have started. It is read
+    // without holding the lock as the lookup may yield to other ULTs.
+    vector<string> uris;
+    try {
+        uris = gkfs::utils::read_hosts_file();
+    } catch(const exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() {}", __func__, e.what());
+        return HG_ADDR_NULL;
+    }
+    if(host_id >= uris.size()) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() host id '{}' not in hosts file with '{}' entries",
+                __func__, host_id, uris.size());
+        return HG_ADDR_NULL;
+    }
+    hg_addr_t addr = HG_ADDR_NULL;
+    auto ret = margo_addr_lookup(server_rpc_mid_, uris[host_id].c_str(), &addr);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to lookup address '{}'",
+                                      __func__, uris[host_id]);
+        return HG_ADDR_NULL;
+    }
+    lock_guard<mutex> lock(peer_mutex_);
+    if(peer_addrs_.size() < uris.size())
+        peer_addrs_.resize(uris.size(), HG_ADDR_NULL);
+    if(peer_addrs_[host_id] != HG_ADDR_NULL) {
+        // another ULT was faster
+        margo_addr_free(server_rpc_mid_, addr);
+        return peer_addrs_[host_id];
+    }
+    peer_addrs_[host_id] = addr;
+    return addr;
+}
+
+void
+RPCData::release_peer_addrs() {
+    lock_guard<mutex> lock(peer_mutex_);
+    for(auto& addr : peer_addrs_) {
+        if(addr != HG_ADDR_NULL)
+            margo_addr_free(server_rpc_mid_, addr);
+    }
+    peer_addrs_.clear();
+}
+
 
 } // namespace daemon
 } // namespace gkfs
@@ -40,12 +40,14 @@
 #include <common/rpc/rpc_types.hpp>
 #include <common/rpc/rpc_util.hpp>
 #include <common/statistics/stats.hpp>
+#include <common/tracing.hpp>
 
 #include <daemon/env.hpp>
 #include <daemon/handler/rpc_defs.hpp>
 #include <daemon/ops/metadentry.hpp>
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/scheduler/io_scheduler.hpp>
 #include <daemon/util.hpp>
 #include <CLI/CLI.hpp>
 
@@ -58,19 +60,18 @@
 #include <iostream>
 #include <fstream>
 #include <csignal>
-#include <condition_variable>
 
 extern "C" {
 #include <unistd.h>
 #include <cstdlib>
+#include <pthread.h>
 }
 
 using namespace std;
 namespace fs = std::filesystem;
 
-static condition_variable shutdown_please; // handler for shutdown signaling
-static mutex mtx; // mutex to wait on shutdown conditional variable
 static bool keep_rootdir = true;
+static string trace_output; // trace spans are written here if not empty
 
 struct cli_options {
     string mountdir;
@@ -81,9 +82,13 @@ struct cli_options {
     string hosts_file;
     string rpc_protocol;
     string dbbackend;
+    string dbconfig;
     string parallax_size;
+    unsigned int memorydb_snapshot;
+    double weight;
     string stats_file;
     string prometheus_gateway;
+    string trace_output;
 };
 
 /**
@@ -147,6 +152,8 @@ register_server_rpcs(margo_instance_id mid) {
                    rpc_rm_metadata_out_t, rpc_srv_remove_metadata);
     MARGO_REGISTER(mid, gkfs::rpc::tag::remove_data, rpc_rm_node_in_t,
                    rpc_err_out_t, rpc_srv_remove_data);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::remove_subtree, rpc_path_only_in_t,
+                   rpc_err_out_t, rpc_srv_remove_subtree);
     MARGO_REGISTER(mid, gkfs::rpc::tag::update_metadentry,
                    rpc_update_metadentry_in_t, rpc_err_out_t,
                    rpc_srv_update_metadentry);
@@ -156,11 +163,15 @@ register_server_rpcs(margo_instance_id mid) {
                    rpc_update_metadentry_size_in_t,
                    rpc_update_metadentry_size_out_t,
                    rpc_srv_update_metadentry_size);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::set_chunk_size, rpc_chunk_size_in_t,
+                   rpc_err_out_t, rpc_srv_set_chunk_size);
     MARGO_REGISTER(mid, gkfs::rpc::tag::get_dirents, rpc_get_dirents_in_t,
                    rpc_get_dirents_out_t, rpc_srv_get_dirents);
     MARGO_REGISTER(mid, gkfs::rpc::tag::get_dirents_extended,
                    rpc_get_dirents_in_t, rpc_get_dirents_out_t,
                    rpc_srv_get_dirents_extended);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::scan, rpc_scan_in_t, rpc_scan_out_t,
+                   rpc_srv_scan);
 #ifdef HAS_SYMLINKS
     MARGO_REGISTER(mid, gkfs::rpc::tag::mk_symlink, rpc_mk_symlink_in_t,
                    rpc_err_out_t, rpc_srv_mk_symlink);
@@ -169,10 +180,18 @@ register_server_rpcs(margo_instance_id mid) {
                    rpc_data_out_t, rpc_srv_write);
     MARGO_REGISTER(mid, gkfs::rpc::tag::read, rpc_read_data_in_t,
                    rpc_data_out_t, rpc_srv_read);
-    MARGO_REGISTER(mid, gkfs::rpc::tag::truncate, rpc_trunc_in_t, rpc_err_out_t,
-                   rpc_srv_truncate);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::write_list, rpc_list_data_in_t,
+                   rpc_data_out_t, rpc_srv_write_list);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::read_list, rpc_list_data_in_t,
+                   rpc_data_out_t, rpc_srv_read_list);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::truncate, rpc_trunc_data_in_t,
+                   rpc_err_out_t, rpc_srv_truncate);
     MARGO_REGISTER(mid, gkfs::rpc::tag::get_chunk_stat, rpc_chunk_stat_in_t,
                    rpc_chunk_stat_out_t, rpc_srv_get_chunk_stat);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::copy_data, rpc_copy_data_in_t,
+                   rpc_data_out_t, rpc_srv_copy_data);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::fallocate, rpc_fallocate_in_t,
+                   rpc_err_out_t, rpc_srv_fallocate);
 }
 
 /**
@@ -265,6 +284,22 @@ init_environment() {
     try {
 #ifdef GKFS_USE_GUIDED_DISTRIBUTION
         auto distributor = std::make_shared<gkfs::rpc::GuidedDistributor>();
+#elif defined(GKFS_USE_STRIPED_DISTRIBUTION)
+        auto distributor = std::make_shared<gkfs::rpc::StripedDistributor>();
+#elif defined(GKFS_USE_WEIGHTED_DISTRIBUTION)
+        // the hosts file is complete only once the first data RPC arrives
+        auto distributor = std::make_shared<gkfs::rpc::WeightedDistributor>(
+                [](unsigned int hosts_size) {
+                    vector<double> weights{};
+                    try {
+                        gkfs::utils::read_hosts_file(&weights);
+                    } catch(const std::exception& e) {
+                        GKFS_DATA->spdlogger()->warn(
+                                "Failed to read host weights, using uniform weights: {}",
+                                e.what());
+                    }
+                    return weights;
+                });
 #else
         auto distributor = std::make_shared<gkfs::rpc::SimpleHashDistributor>();
 #endif
@@ -308,7 +343,8 @@ init_environment() {
     fs::create_directories(chunk_storage_path);
     try {
         GKFS_DATA->storage(std::make_shared<gkfs::data::ChunkStorage>(
-                chunk_storage_path, gkfs::config::rpc::chunksize));
+                chunk_storage_path, gkfs::config::rpc::chunksize,
+                GKFS_DATA->preallocate_chunks()));
     } catch(const std::exception& e) {
         GKFS_DATA->spdlogger()->error(
                 "{}() Failed to initialize storage backend: {}", __func__,
@@ -338,6 +374,13 @@ init_environment() {
         throw;
     }
 
+    if(GKFS_DATA->use_io_scheduler()) {
+        GKFS_DATA->spdlogger()->debug("{}() Initializing I/O scheduler",
+                                      __func__);
+        GKFS_DATA->io_scheduler(std::make_shared<gkfs::data::IoScheduler>(
+                RPC_DATA->io_pool(), gkfs::config::scheduler::max_inflight));
+    }
+
     // TODO set metadata configurations. these have to go into a user
     // configurable file that is parsed here
     GKFS_DATA->atime_state(gkfs::config::metadata::use_atime);
@@ -413,11 +456,21 @@ destroy_enviroment() {
     }
 
     if(RPC_DATA->server_rpc_mid() != nullptr) {
+        RPC_DATA->release_peer_addrs();
         GKFS_DATA->spdlogger()->debug("{}() Finalizing margo RPC server",
                                       __func__);
         margo_finalize(RPC_DATA->server_rpc_mid());
     }
 
+    if(GKFS_DATA->mdb() != nullptr) {
+        try {
+            gkfs::metadata::flush_sizes();
+        } catch(const std::exception& e) {
+            GKFS_DATA->spdlogger()->error(
+                    "{}() Failed to persist append sizes: '{}'", __func__,
+                    e.what());
+        }
+    }
     GKFS_DATA->spdlogger()->info("{}() Closing metadata DB", __func__);
     GKFS_DATA->close_mdb();
 
@@ -433,17 +486,17 @@ destroy_enviroment() {
 }
 
 /**
- * @brief Handler for daemon shutdown signal handling.
- * @internal
- * Notifies the waiting thread in main() to wake up.
- * @endinternal
- * @param dummy unused but required by signal() called in main()
+ * @brief Writes all trace spans recorded so far to the --trace-output file.
  */
 void
-shutdown_handler(int dummy) {
-    GKFS_DATA->spdlogger()->info("{}() Received signal: '{}'", __func__,
-                                 strsignal(dummy));
-    shutdown_please.notify_all();
+dump_trace() {
+    auto err = gkfs::tracing::dump(trace_output);
+    if(err)
+        GKFS_DATA->spdlogger()->error("{}() Failed to write trace to '{}': {}",
+                                      __func__, trace_output, strerror(err));
+    else
+        GKFS_DATA->spdlogger()->info("{}() Trace written to '{}'", __func__,
+                                     trace_output);
 }
 
 /**
@@ -624,7 +677,8 @@ parse_input(const cli_options& opts, const CLI::App& desc) {
 
     if(desc.count("--dbbackend")) {
         if(opts.dbbackend == gkfs::metadata::rocksdb_backend ||
-           opts.dbbackend == gkfs::metadata::parallax_backend) {
+           opts.dbbackend == gkfs::metadata::parallax_backend ||
+           opts.dbbackend == gkfs::metadata::memory_backend) {
 #ifndef GKFS_ENABLE_PARALLAX
             if(opts.dbbackend == gkfs::metadata::parallax_backend) {
                 throw runtime_error(fmt::format(
@@ -651,10 +705,43 @@ parse_input(const cli_options& opts, const CLI::App& desc) {
     } else
         GKFS_DATA->dbbackend(gkfs::metadata::rocksdb_backend);
 
+    if(desc.count("--memorydb-snapshot")) { // interval in seconds
+        GKFS_DATA->memorydb_snapshot_interval(opts.memorydb_snapshot);
+    }
+
+    if(desc.count("--dbconfig")) {
+        if(!fs::exists(opts.dbconfig)) {
+            throw runtime_error(fmt::format("dbconfig file '{}' does not exist",
+                                            opts.dbconfig));
+        }
+        GKFS_DATA->dbconfig(opts.dbconfig);
+        GKFS_DATA->spdlogger()->info("{}() RocksDB config file: '{}'",
+                                     __func__, opts.dbconfig);
+    }
+
     if(desc.count("--parallaxsize")) { // Size in GB
         GKFS_DATA->parallax_size_md(stoi(opts.parallax_size));
     }
 
+    if(desc.count("--weight")) {
+        if(opts.weight <= 0.0) {
+            throw runtime_error(fmt::format(
+                    "weight '{}' must be greater than 0", opts.weight));
+        }
+        GKFS_DATA->host_weight(opts.weight);
+    }
+
+    if(desc.count("--preallocate-chunks")) {
+        GKFS_DATA->preallocate_chunks(true);
+        GKFS_DATA->spdlogger()->info("{}() Chunk file preallocation enabled",
+                                     __func__);
+    }
+
+    if(desc.count("--io-scheduler")) {
+        GKFS_DATA->use_io_scheduler(true);
+        GKFS_DATA->spdlogger()->info("{}() I/O scheduler enabled", __func__);
+    }
+
     /*
      * Statistics collection arguments
      */
@@ -693,6 +780,14 @@ parse_input(const cli_options& opts, const CLI::App& desc) {
     }
 #endif
 
+    if(desc.count("--trace-output")) {
+        trace_output = opts.trace_output;
+        gkfs::tracing::enable(fmt::format("gkfs_daemon (pid {})", getpid()));
+        GKFS_DATA->spdlogger()->info(
+                "{}() Tracing enabled. Trace is written to '{}'", __func__,
+                trace_output);
+    }
+
     if(desc.count("--output-stats")) {
         auto stats_file = opts.stats_file;
         GKFS_DATA->stats_file(stats_file);
@@ -714,12 +809,14 @@ parse_input(const cli_options& opts, const CLI::App& desc) {
 /**
  * @brief The initial function called when launching the daemon.
  * @internal
- * Launches all subroutines and waits on a conditional variable to shut it down.
- * Daemon will react to the following signals:
+ * Launches all subroutines and waits in sigwait() for a signal to shut it
+ * down. The signals are blocked before any other thread is started so that
+ * they are only delivered to main(), which handles them outside of a signal
+ * handler. Daemon will react to the following signals:
  *
  * SIGINT - Interrupt from keyboard (ctrl-c)
  * SIGTERM - Termination signal (kill <daemon_pid>
- * SIGKILL - Kill signal (kill -9 <daemon_pid>
+ * SIGUSR1 - Writes the trace spans if --trace-output is set
  * @endinternal
  * @param argc number of command line arguments
  * @param argv list of the command line arguments
@@ -770,12 +867,32 @@ main(int argc, const char* argv[]) {
                 "Cleans Rootdir >after< the deamon finishes");
     desc.add_option(
                 "--dbbackend,-d", opts.dbbackend,
-                "Metadata database backend to use. Available: {rocksdb, parallaxdb}\n"
+                "Metadata database backend to use. Available: {rocksdb, parallaxdb, memorydb}\n"
                 "RocksDB is default if not set. Parallax support is experimental.\n"
+                "memorydb keeps all metadata in memory for the lifetime of the daemon.\n"
                 "Note, parallaxdb creates a file called rocksdbx with 8GB created in metadir.");
+    desc.add_option("--memorydb-snapshot", opts.memorydb_snapshot,
+                    "memorydb - interval in seconds in which metadata is written "
+                    "to a snapshot in metadir, which is loaded on startup (default 0, disabled)");
+    desc.add_option(
+                "--dbconfig", opts.dbconfig,
+                "Path to a RocksDB config file with 'key = value' lines. 'profile' selects an options profile:\n"
+                "{default, create-heavy, stat-heavy, readdir-heavy}. Other keys are RocksDB option names.");
     desc.add_option("--parallaxsize", opts.parallax_size,
                     "parallaxdb - metadata file size in GB (default 8GB), "
                     "used only with new files");
+    desc.add_option(
+                "--weight", opts.weight,
+                "Share of the data placed on this daemon relative to the others, used by the weighted distributor.\n"
+                "Defaults to the capacity of the chunk storage in GiB.");
+    desc.add_flag(
+                "--preallocate-chunks",
+                "Reserves the full chunk size on the node-local file system when a chunk file is created "
+                "to reduce fragmentation under concurrent writers. (Default off)");
+    desc.add_flag(
+                "--io-scheduler",
+                "Schedules chunk I/O with per-file queues, merging of adjacent requests, read priority with "
+                "write deadlines, and fair sharing among clients. (Default off)");
     desc.add_flag(
                 "--enable-collection",
                 "Enables collection of general statistics. "
@@ -797,6 +914,11 @@ main(int argc, const char* argv[]) {
                 "Defines the prometheus gateway <ip:port> (Default 127.0.0.1:9091).");
     #endif
 
+    desc.add_option(
+                "--trace-output", opts.trace_output,
+                "Records timestamped spans of each traced client request and writes them as Chrome trace JSON "
+                "to the specified file at shutdown and on SIGUSR1.");
+
     desc.add_flag("--version", "Print version and exit.");
     // clang-format on
     try {
@@ -837,8 +959,16 @@ main(int argc, const char* argv[]) {
 
     /*
      * Initialize environment and start daemon. Wait until signaled to cancel
-     * before shutting down
+     * before shutting down. All threads inherit the blocked signal mask.
      */
+    sigset_t sigs;
+    sigemptyset(&sigs);
+    sigaddset(&sigs, SIGINT);
+    sigaddset(&sigs, SIGTERM);
+    if(!trace_output.empty())
+        sigaddset(&sigs, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &sigs, nullptr);
+
     try {
         GKFS_DATA->spdlogger()->info("{}() Initializing environment", __func__);
         init_environment();
@@ -851,15 +981,22 @@ main(int argc, const char* argv[]) {
         return EXIT_FAILURE;
     }
 
-    signal(SIGINT, shutdown_handler);
-    signal(SIGTERM, shutdown_handler);
-    signal(SIGKILL, shutdown_handler);
-
-    unique_lock<mutex> lk(mtx);
-    // Wait for shutdown signal to initiate shutdown protocols
-    shutdown_please.wait(lk);
+    // Wait for shutdown signal to initiate shutdown protocols. A trace dump
+    // request does not shut down the daemon
+    int sig = 0;
+    while(true) {
+        if(sigwait(&sigs, &sig) != 0)
+            continue;
+        if(sig != SIGUSR1)
+            break;
+        dump_trace();
+    }
+    GKFS_DATA->spdlogger()->info("{}() Received signal: '{}'", __func__,
+                                 strsignal(sig));
     GKFS_DATA->spdlogger()->info("{}() Shutting down...", __func__);
     destroy_enviroment();
+    if(!trace_output.empty())
+        dump_trace();
     GKFS_DATA->spdlogger()->info("{}() Complete. Exiting...", __func__);
     return EXIT_SUCCESS;
 }
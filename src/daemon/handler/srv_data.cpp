@@ -43,6 +43,10 @@
 #include <common/rpc/distributor.hpp>
 #include <common/arithmetic/arithmetic.hpp>
 #include <common/statistics/stats.hpp>
+#include <common/tracing.hpp>
+
+#include <functional>
+#include <string_view>
 
 #ifdef GKFS_ENABLE_AGIOS
 #include <daemon/scheduler/agios.hpp>
@@ -56,6 +60,58 @@ using namespace std;
 
 namespace {
 
+/**
+ * @brief Returns the daemon storing a chunk of a file.
+ * @param path File path
+ * @param chnk_id Chunk id
+ * @param data_host Daemon holding all chunks of the file, -1 if the chunks are
+ * placed by the distributor
+ * @param host_size Number of daemons
+ * @return Host id of the chunk's owner
+ */
+uint64_t
+chunk_owner(const string& path, gkfs::rpc::chnk_id_t chnk_id,
+            int64_t data_host, uint64_t host_size) {
+    if(data_host >= 0)
+        return static_cast<uint64_t>(data_host);
+    return RPC_DATA->distributor()->locate_data(path, chnk_id, host_size);
+}
+
+/**
+ * @brief Checks that the data host of a file, if any, is a daemon id, so that
+ * chunk_owner() only returns daemon ids.
+ * @param data_host Daemon holding all chunks of the file, -1 if the chunks are
+ * placed by the distributor
+ * @param host_size Number of daemons
+ * @return true if valid
+ */
+bool
+valid_data_host(int64_t data_host, uint64_t host_size) {
+    if(data_host < 0 || static_cast<uint64_t>(data_host) < host_size)
+        return true;
+    GKFS_DATA->spdlogger()->error("{}() Invalid data host '{}' of '{}' hosts",
+                                  __func__, data_host, host_size);
+    return false;
+}
+
+/**
+ * @brief Identifies the client of a request for fair sharing in the I/O
+ * scheduler.
+ * @param mid Margo instance id
+ * @param addr Address of the client
+ * @return Hash of the client address, 0 if the I/O scheduler is disabled
+ */
+uint64_t
+client_id(margo_instance_id mid, hg_addr_t addr) {
+    if(!GKFS_DATA->io_scheduler())
+        return 0;
+    char addr_str[256];
+    hg_size_t addr_size = sizeof(addr_str);
+    if(margo_addr_to_string(mid, addr_str, &addr_size, addr) != HG_SUCCESS)
+        return 0;
+    return std::hash<std::string_view>{}(std::string_view(addr_str));
+}
+
 /**
  * @brief Serves a write request transferring the chunks associated with this
  * daemon and store them on the node-local FS.
@@ -110,10 +166,22 @@ rpc_srv_write(hg_handle_t handle) {
     auto hgi = margo_get_info(handle);
     auto mid = margo_hg_info_get_instance(hgi);
     auto bulk_size = margo_bulk_get_size(in.bulk_handle);
+    gkfs::tracing::Span span("daemon.write", in.trace_id);
     GKFS_DATA->spdlogger()->debug(
             "{}() path: '{}' chunk_start '{}' chunk_end '{}' chunk_n '{}' total_chunk_size '{}' bulk_size: '{}' offset: '{}'",
             __func__, in.path, in.chunk_start, in.chunk_end, in.chunk_n,
             in.total_chunk_size, bulk_size, in.offset);
+    if(in.chunk_size == 0 ||
+       in.chunk_size > gkfs::config::rpc::max_chunksize) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid chunk size '{}'", __func__,
+                                      in.chunk_size);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    if(!valid_data_host(in.data_host, in.host_size)) {
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
 
 
 #ifdef GKFS_ENABLE_AGIOS
@@ -201,22 +269,24 @@ rpc_srv_write(hg_handle_t handle) {
      * consider the following cases:
      * 1. Very first chunk has offset or not and is serviced by this node
      * 2. If offset, will still be only 1 chunk written (small IO): (offset +
-     * bulk_size <= CHUNKSIZE) ? bulk_size
+     * bulk_size <= chunk_size) ? bulk_size
      * 3. If no offset, will only be 1 chunk written (small IO): (bulk_size <=
-     * CHUNKSIZE) ? bulk_size
-     * 4. Chunks between start and end chunk have size of the CHUNKSIZE
-     * 5. Last chunk (if multiple chunks are written): Don't write CHUNKSIZE but
-     * chnk_size_left for this destination Last chunk can also happen if only
-     * one chunk is written. This is covered by 2 and 3.
+     * chunk_size) ? bulk_size
+     * 4. Chunks between start and end chunk have size of the file's chunk_size
+     * 5. Last chunk (if multiple chunks are written): Don't write chunk_size
+     * but chnk_size_left for this destination Last chunk can also happen if
+     * only one chunk is written. This is covered by 2 and 3.
      */
     // temporary variables
-    auto transfer_size = (bulk_size <= gkfs::config::rpc::chunksize)
-                                 ? bulk_size
-                                 : gkfs::config::rpc::chunksize;
+    auto transfer_size =
+            (bulk_size <= in.chunk_size) ? bulk_size : in.chunk_size;
     uint64_t origin_offset;
     uint64_t local_offset;
     // object for asynchronous disk IO
-    gkfs::data::ChunkWriteOperation chunk_op{in.path, in.chunk_n};
+    gkfs::data::ChunkWriteOperation chunk_op{in.path, in.chunk_n,
+                                             in.chunk_size,
+                                             client_id(mid, hgi->addr)};
+    chunk_op.trace_id(in.trace_id);
 
     /*
      * 3. Calculate chunk sizes that correspond to this host, transfer data, and
@@ -229,8 +299,8 @@ rpc_srv_write(hg_handle_t handle) {
         chnk_id_file++) {
         // Continue if chunk does not hash to this host
 #ifndef GKFS_ENABLE_FORWARDING
-        if(RPC_DATA->distributor()->locate_data(in.path, chnk_id_file,
-                                                host_size) != host_id) {
+        if(chunk_owner(in.path, chnk_id_file, in.data_host, host_size) !=
+           host_id) {
             GKFS_DATA->spdlogger()->trace(
                     "{}() chunkid '{}' ignored as it does not match to this host with id '{}'. chnk_id_curr '{}'",
                     __func__, chnk_id_file, host_id, chnk_id_curr);
@@ -250,11 +320,12 @@ rpc_srv_write(hg_handle_t handle) {
             // if only 1 destination and 1 chunk (small write) the transfer_size
             // == bulk_size
             size_t offset_transfer_size = 0;
-            if(in.offset + bulk_size <= gkfs::config::rpc::chunksize)
+            if(in.offset + bulk_size <= in.chunk_size)
                 offset_transfer_size = bulk_size;
             else
-                offset_transfer_size = static_cast<size_t>(
-                        gkfs::config::rpc::chunksize - in.offset);
+                offset_transfer_size =
+                        static_cast<size_t>(in.chunk_size - in.offset);
+            gkfs::tracing::Span pull_span("daemon.bulk_pull", in.trace_id);
             ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr,
                                       in.bulk_handle, 0, bulk_handle, 0,
                                       offset_transfer_size);
@@ -276,12 +347,11 @@ rpc_srv_write(hg_handle_t handle) {
             // origin offset of a chunk is dependent on a given offset in a
             // write operation
             if(in.offset > 0)
-                origin_offset = (gkfs::config::rpc::chunksize - in.offset) +
+                origin_offset = (in.chunk_size - in.offset) +
                                 ((chnk_id_file - in.chunk_start) - 1) *
-                                        gkfs::config::rpc::chunksize;
+                                        in.chunk_size;
             else
-                origin_offset = (chnk_id_file - in.chunk_start) *
-                                gkfs::config::rpc::chunksize;
+                origin_offset = (chnk_id_file - in.chunk_start) * in.chunk_size;
             // last chunk might have different transfer_size
             if(chnk_id_curr == in.chunk_n - 1)
                 transfer_size = chnk_size_left_host;
@@ -291,6 +361,7 @@ rpc_srv_write(hg_handle_t handle) {
                     in.total_chunk_size, chnk_size_left_host, origin_offset,
                     local_offset, transfer_size);
             // RDMA the data to here
+            gkfs::tracing::Span pull_span("daemon.bulk_pull", in.trace_id);
             ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr,
                                       in.bulk_handle, origin_offset,
                                       bulk_handle, local_offset, transfer_size);
@@ -412,11 +483,23 @@ rpc_srv_read(hg_handle_t handle) {
     auto hgi = margo_get_info(handle);
     auto mid = margo_hg_info_get_instance(hgi);
     auto bulk_size = margo_bulk_get_size(in.bulk_handle);
+    gkfs::tracing::Span span("daemon.read", in.trace_id);
 
     GKFS_DATA->spdlogger()->debug(
             "{}() path: '{}' chunk_start '{}' chunk_end '{}' chunk_n '{}' total_chunk_size '{}' bulk_size: '{}' offset: '{}'",
             __func__, in.path, in.chunk_start, in.chunk_end, in.chunk_n,
             in.total_chunk_size, bulk_size, in.offset);
+    if(in.chunk_size == 0 ||
+       in.chunk_size > gkfs::config::rpc::max_chunksize) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid chunk size '{}'", __func__,
+                                      in.chunk_size);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    if(!valid_data_host(in.data_host, in.host_size)) {
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
 
 #ifdef GKFS_ENABLE_AGIOS
     int* data;
@@ -504,11 +587,12 @@ rpc_srv_read(hg_handle_t handle) {
     // temporary traveling pointer
     auto chnk_ptr = static_cast<char*>(bulk_buf);
     // temporary variables
-    auto transfer_size = (bulk_size <= gkfs::config::rpc::chunksize)
-                                 ? bulk_size
-                                 : gkfs::config::rpc::chunksize;
+    auto transfer_size =
+            (bulk_size <= in.chunk_size) ? bulk_size : in.chunk_size;
     // object for asynchronous disk IO
-    gkfs::data::ChunkReadOperation chunk_read_op{in.path, in.chunk_n};
+    gkfs::data::ChunkReadOperation chunk_read_op{in.path, in.chunk_n,
+                                                 client_id(mid, hgi->addr)};
+    chunk_read_op.trace_id(in.trace_id);
     /*
      * 3. Calculate chunk sizes that correspond to this host and start tasks to
      * read from disk
@@ -520,8 +604,8 @@ rpc_srv_read(hg_handle_t handle) {
         chnk_id_file++) {
         // Continue if chunk does not hash to this host
 #ifndef GKFS_ENABLE_FORWARDING
-        if(RPC_DATA->distributor()->locate_data(in.path, chnk_id_file,
-                                                host_size) != host_id) {
+        if(chunk_owner(in.path, chnk_id_file, in.data_host, host_size) !=
+           host_id) {
             GKFS_DATA->spdlogger()->trace(
                     "{}() chunkid '{}' ignored as it does not match to this host with id '{}'. chnk_id_curr '{}'",
                     __func__, chnk_id_file, host_id, chnk_id_curr);
@@ -540,11 +624,11 @@ rpc_srv_read(hg_handle_t handle) {
             // if only 1 destination and 1 chunk (small read) the transfer_size
             // == bulk_size
             size_t offset_transfer_size = 0;
-            if(in.offset + bulk_size <= gkfs::config::rpc::chunksize)
+            if(in.offset + bulk_size <= in.chunk_size)
                 offset_transfer_size = bulk_size;
             else
-                offset_transfer_size = static_cast<size_t>(
-                        gkfs::config::rpc::chunksize - in.offset);
+                offset_transfer_size =
+                        static_cast<size_t>(in.chunk_size - in.offset);
             // Setting later transfer offsets
             local_offsets[chnk_id_curr] = 0;
             origin_offsets[chnk_id_curr] = 0;
@@ -560,12 +644,11 @@ rpc_srv_read(hg_handle_t handle) {
             // write operation
             if(in.offset > 0)
                 origin_offsets[chnk_id_curr] =
-                        (gkfs::config::rpc::chunksize - in.offset) +
-                        ((chnk_id_file - in.chunk_start) - 1) *
-                                gkfs::config::rpc::chunksize;
+                        (in.chunk_size - in.offset) +
+                        ((chnk_id_file - in.chunk_start) - 1) * in.chunk_size;
             else
-                origin_offsets[chnk_id_curr] = (chnk_id_file - in.chunk_start) *
-                                               gkfs::config::rpc::chunksize;
+                origin_offsets[chnk_id_curr] =
+                        (chnk_id_file - in.chunk_start) * in.chunk_size;
             // last chunk might have different transfer_size
             if(chnk_id_curr == in.chunk_n - 1)
                 transfer_size = chnk_size_left_host;
@@ -628,6 +711,281 @@ rpc_srv_read(hg_handle_t handle) {
 }
 
 
+/**
+ * @brief Sets up the local buffers of a list I/O request and pulls the extent
+ * table of this daemon from the client.
+ * @param in RPC input
+ * @param hgi Mercury info of the request
+ * @param mid Margo instance
+ * @param extents Extent table, resized to the number of extents
+ * @param buf Data buffer, resized to the total size of all extents
+ * @param bulk_handle Local bulk handle exposing table and buffer
+ * @return Error code, 0 on success
+ */
+int
+setup_list_transfer(const rpc_list_data_in_t& in, const struct hg_info* hgi,
+                    margo_instance_id mid,
+                    vector<gkfs::rpc::chnk_extent>& extents, vector<char>& buf,
+                    hg_bulk_t* bulk_handle) {
+    if(!valid_data_host(in.data_host, in.host_size))
+        return EINVAL;
+    // the sizes are used to allocate the local buffers and must fit the
+    // client's exposed memory
+    auto client_size = margo_bulk_get_size(in.bulk_handle);
+    if(in.extent_n > gkfs::config::rpc::max_list_extents ||
+       in.total_size > gkfs::config::rpc::max_list_size) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Request exceeds limits: extent_n '{}' total_size '{}'",
+                __func__, in.extent_n, in.total_size);
+        return EINVAL;
+    }
+    hg_size_t table_size = in.extent_n * sizeof(gkfs::rpc::chnk_extent);
+    if(in.table_offset > client_size ||
+       table_size > client_size - in.table_offset ||
+       in.total_size > client_size) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Request exceeds client memory of size '{}'", __func__,
+                client_size);
+        return EINVAL;
+    }
+    extents.resize(in.extent_n);
+    buf.resize(in.total_size);
+    // the local bulk mirrors the client layout: table first, then data
+    void* seg_ptrs[2] = {extents.data(), buf.data()};
+    hg_size_t seg_sizes[2] = {table_size, in.total_size};
+    auto ret = margo_bulk_create(mid, 2, seg_ptrs, seg_sizes,
+                                 HG_BULK_READWRITE, bulk_handle);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle",
+                                      __func__);
+        *bulk_handle = nullptr;
+        return EBUSY;
+    }
+    ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr, in.bulk_handle,
+                              in.table_offset, *bulk_handle, 0, table_size);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Failed to pull extent table from client", __func__);
+        return EBUSY;
+    }
+    // validate extents as they are used to address local memory
+    uint64_t total = 0;
+    for(const auto& extent : extents) {
+        if(extent.size > in.chunk_size ||
+           extent.chnk_offset > in.chunk_size - extent.size ||
+           extent.origin_offset > client_size ||
+           extent.size > client_size - extent.origin_offset ||
+           extent.size > in.total_size - total) {
+            return EINVAL;
+        }
+        total += extent.size;
+#ifndef GKFS_ENABLE_FORWARDING
+        if(chunk_owner(in.path, extent.chnk_id, in.data_host, in.host_size) !=
+           in.host_id) {
+            return EINVAL;
+        }
+#endif
+    }
+    return total == in.total_size ? 0 : EINVAL;
+}
+
+/**
+ * @brief Serves a list write request, writing many chunk extents of
+ * non-contiguous file segments in one invocation.
+ * @internal
+ * The client places a table of all chunk extents in front of its data and
+ * tells each daemon which part of the table belongs to it. The daemon pulls
+ * its extent table, then pulls the data of each extent and starts a
+ * non-blocking Argobots tasklet to write it to the chunk storage, just like
+ * rpc_srv_write does for a contiguous range.
+ *
+ * All exceptions must be caught here and dealt with accordingly.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_write_list(hg_handle_t handle) {
+    rpc_list_data_in_t in{};
+    rpc_data_out_t out{};
+    hg_bulk_t bulk_handle = nullptr;
+    out.err = EIO;
+    out.io_size = 0;
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    GKFS_DATA->spdlogger()->debug(
+            "{}() path: '{}' extent_n '{}' total_size '{}' table_offset '{}'",
+            __func__, in.path, in.extent_n, in.total_size, in.table_offset);
+    if(in.extent_n == 0) {
+        out.err = 0;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+
+    vector<gkfs::rpc::chnk_extent> extents;
+    vector<char> buf;
+    out.err = setup_list_transfer(in, hgi, mid, extents, buf, &bulk_handle);
+    if(out.err != 0) {
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    auto table_size = in.extent_n * sizeof(gkfs::rpc::chnk_extent);
+
+    gkfs::data::ChunkWriteOperation chunk_op{in.path, in.extent_n,
+                                             in.chunk_size,
+                                             client_id(mid, hgi->addr)};
+    uint64_t local_offset = 0;
+    for(uint64_t idx = 0; idx < in.extent_n; idx++) {
+        const auto& extent = extents[idx];
+        ret = margo_bulk_transfer(mid, HG_BULK_PULL, hgi->addr, in.bulk_handle,
+                                  extent.origin_offset, bulk_handle,
+                                  table_size + local_offset, extent.size);
+        if(ret != HG_SUCCESS) {
+            GKFS_DATA->spdlogger()->error(
+                    "{}() Failed to pull data from client. file {} chunk {}",
+                    __func__, in.path, extent.chnk_id);
+            out.err = EBUSY;
+            break;
+        }
+#ifndef GKFS_ENABLE_FORWARDING
+        if(GKFS_DATA->enable_chunkstats()) {
+            GKFS_DATA->stats()->add_write(in.path, extent.chnk_id);
+        }
+#endif
+        try {
+            chunk_op.write_nonblock(idx, extent.chnk_id,
+                                    buf.data() + local_offset, extent.size,
+                                    extent.chnk_offset);
+        } catch(const gkfs::data::ChunkWriteOpException& e) {
+            GKFS_DATA->spdlogger()->error("{}() while write_nonblock err '{}'",
+                                          __func__, e.what());
+            out.err = EIO;
+            break;
+        }
+        local_offset += extent.size;
+    }
+    // wait for all started tasklets, even on error, as they use the buffer
+    auto write_result = chunk_op.wait_for_tasks();
+    if(out.err == 0) {
+        out.err = write_result.first;
+        out.io_size = write_result.second;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output response {}", __func__,
+                                  out.err);
+    auto handler_ret =
+            gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    if(GKFS_DATA->enable_stats()) {
+        GKFS_DATA->stats()->add_value_size(
+                gkfs::utils::Stats::SizeOp::write_size, out.io_size);
+    }
+    return handler_ret;
+}
+
+/**
+ * @brief Serves a list read request, reading many chunk extents of
+ * non-contiguous file segments in one invocation.
+ * @internal
+ * The daemon pulls its part of the client's extent table and starts a
+ * non-blocking Argobots tasklet per extent. Once a tasklet is finished, its
+ * data is pushed to the client's memory at the extent's origin offset.
+ * Missing chunks are sparse regions and are skipped.
+ *
+ * All exceptions must be caught here and dealt with accordingly.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_read_list(hg_handle_t handle) {
+    rpc_list_data_in_t in{};
+    rpc_data_out_t out{};
+    hg_bulk_t bulk_handle = nullptr;
+    out.err = EIO;
+    out.io_size = 0;
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    GKFS_DATA->spdlogger()->debug(
+            "{}() path: '{}' extent_n '{}' total_size '{}' table_offset '{}'",
+            __func__, in.path, in.extent_n, in.total_size, in.table_offset);
+    if(in.extent_n == 0) {
+        out.err = 0;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+
+    vector<gkfs::rpc::chnk_extent> extents;
+    vector<char> buf;
+    out.err = setup_list_transfer(in, hgi, mid, extents, buf, &bulk_handle);
+    if(out.err != 0) {
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    auto table_size = in.extent_n * sizeof(gkfs::rpc::chnk_extent);
+
+    vector<uint64_t> chnk_ids(in.extent_n);
+    vector<uint64_t> local_offsets(in.extent_n);
+    vector<uint64_t> origin_offsets(in.extent_n);
+    gkfs::data::ChunkReadOperation chunk_read_op{in.path, in.extent_n,
+                                                 client_id(mid, hgi->addr)};
+    uint64_t local_offset = 0;
+    for(uint64_t idx = 0; idx < in.extent_n; idx++) {
+        const auto& extent = extents[idx];
+        chnk_ids[idx] = extent.chnk_id;
+        local_offsets[idx] = table_size + local_offset;
+        origin_offsets[idx] = extent.origin_offset;
+#ifndef GKFS_ENABLE_FORWARDING
+        if(GKFS_DATA->enable_chunkstats()) {
+            GKFS_DATA->stats()->add_read(in.path, extent.chnk_id);
+        }
+#endif
+        try {
+            chunk_read_op.read_nonblock(idx, extent.chnk_id,
+                                        buf.data() + local_offset, extent.size,
+                                        extent.chnk_offset);
+        } catch(const gkfs::data::ChunkReadOpException& e) {
+            // This exception is caused by setup of Argobots variables. If this
+            // fails, something is really wrong
+            GKFS_DATA->spdlogger()->error("{}() while read_nonblock err '{}'",
+                                          __func__, e.what());
+            return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+        }
+        local_offset += extent.size;
+    }
+
+    gkfs::data::ChunkReadOperation::bulk_args bulk_args{};
+    bulk_args.mid = mid;
+    bulk_args.origin_addr = hgi->addr;
+    bulk_args.origin_bulk_handle = in.bulk_handle;
+    bulk_args.origin_offsets = &origin_offsets;
+    bulk_args.local_bulk_handle = bulk_handle;
+    bulk_args.local_offsets = &local_offsets;
+    bulk_args.chunk_ids = &chnk_ids;
+    // wait for all tasklets and push read data back to client
+    auto read_result = chunk_read_op.wait_for_tasks_and_push_back(bulk_args);
+    out.err = read_result.first;
+    out.io_size = read_result.second;
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output response, err: {}",
+                                  __func__, out.err);
+    auto handler_ret =
+            gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    if(GKFS_DATA->enable_stats()) {
+        GKFS_DATA->stats()->add_value_size(
+                gkfs::utils::Stats::SizeOp::read_size, out.io_size);
+    }
+    return handler_ret;
+}
+
+
 /**
  * @brief Serves a file truncate request and remove all corresponding chunk
  * files on this daemon.
@@ -643,7 +1001,7 @@ rpc_srv_read(hg_handle_t handle) {
  */
 hg_return_t
 rpc_srv_truncate(hg_handle_t handle) {
-    rpc_trunc_in_t in{};
+    rpc_trunc_data_in_t in{};
     rpc_err_out_t out{};
     out.err = EIO;
     // Getting some information from margo
@@ -653,13 +1011,18 @@ rpc_srv_truncate(hg_handle_t handle) {
                 "{}() Could not get RPC input data with err {}", __func__, ret);
         return gkfs::rpc::cleanup_respond(&handle, &in, &out);
     }
-    GKFS_DATA->spdlogger()->debug("{}() path: '{}', length: '{}'", __func__,
-                                  in.path, in.length);
+    GKFS_DATA->spdlogger()->debug(
+            "{}() path: '{}', length: '{}', chunk_size: '{}'", __func__,
+            in.path, in.length, in.chunk_size);
+    if(in.chunk_size == 0) {
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
 
     gkfs::data::ChunkTruncateOperation chunk_op{in.path};
     try {
         // start tasklet for truncate operation
-        chunk_op.truncate(in.length);
+        chunk_op.truncate(in.length, in.chunk_size);
     } catch(const gkfs::data::ChunkMetaOpException& e) {
         // This exception is caused by setup of Argobots variables. If this
         // fails, something is really wrong
@@ -711,16 +1074,432 @@ rpc_srv_get_chunk_stat(hg_handle_t handle) {
     return gkfs::rpc::cleanup_respond(&handle, &out);
 }
 
+/**
+ * @brief A piece of the copied range within a single chunk.
+ */
+struct copy_piece {
+    gkfs::rpc::chnk_id_t chnk_id; //!< Chunk id
+    uint64_t chnk_off;            //!< Offset within the chunk
+    size_t size;                  //!< Number of bytes
+    char* buf;                    //!< Data of the piece in the copy buffer
+};
+
+/**
+ * @brief A destination chunk piece pushed to the daemon that owns it.
+ */
+struct chunk_push {
+    hg_handle_t handle{HG_HANDLE_NULL};
+    hg_bulk_t bulk_handle{HG_BULK_NULL};
+    margo_request req{MARGO_REQUEST_NULL};
+    size_t size{};
+};
+
+/**
+ * @brief Starts pushing a piece of a single chunk to the daemon that owns it.
+ * @internal
+ * The regular write RPC is reused for daemon-to-daemon transfers. The buffer is
+ * exposed read-only and the peer pulls it exactly as it does for a client
+ * write that covers a single chunk. The request is non-blocking and finished
+ * with finish_push().
+ * @endinternal
+ * @param write_id Id of the write RPC
+ * @param path Destination file path
+ * @param piece Destination chunk piece
+ * @param chnk_size Chunk size of the destination file
+ * @param peer_id Host id of the owning daemon
+ * @param host_size Number of daemons
+ * @param data_host Data host of the destination file, -1 if none
+ * @param push Push state, only valid if 0 is returned
+ * @return Error code, 0 on success
+ */
+int
+start_push(hg_id_t write_id, const string& path, const copy_piece& piece,
+           uint64_t chnk_size, uint64_t peer_id, uint64_t host_size,
+           int64_t data_host, chunk_push& push) {
+    auto mid = RPC_DATA->server_rpc_mid();
+    auto peer = RPC_DATA->peer_addr(peer_id);
+    if(peer == HG_ADDR_NULL)
+        return ENOTSUP;
+    auto buf_ptr = static_cast<void*>(piece.buf);
+    auto bulk_size = static_cast<hg_size_t>(piece.size);
+    if(margo_create(mid, peer, write_id, &push.handle) != HG_SUCCESS)
+        return EIO;
+    auto ret = margo_bulk_create(mid, 1, &buf_ptr, &bulk_size,
+                                 HG_BULK_READ_ONLY, &push.bulk_handle);
+    if(ret == HG_SUCCESS) {
+        rpc_write_data_in_t in{};
+        in.path = path.c_str();
+        in.offset = static_cast<int64_t>(piece.chnk_off);
+        in.host_id = peer_id;
+        in.host_size = host_size;
+        in.chunk_n = 1;
+        in.chunk_start = piece.chnk_id;
+        in.chunk_end = piece.chnk_id;
+        in.total_chunk_size = piece.size;
+        in.chunk_size = chnk_size;
+        in.data_host = data_host;
+        in.bulk_handle = push.bulk_handle;
+        ret = margo_iforward(push.handle, &in, &push.req);
+    }
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Unable to push chunk '{}' of '{}' to peer '{}'", __func__,
+                piece.chnk_id, path, peer_id);
+        if(push.bulk_handle != HG_BULK_NULL)
+            margo_bulk_free(push.bulk_handle);
+        margo_destroy(push.handle);
+        return EIO;
+    }
+    push.size = piece.size;
+    return 0;
+}
+
+/**
+ * @brief Waits for a push started with start_push() and frees its resources.
+ * @param push Push state
+ * @return Error code reported by the peer, 0 on success
+ */
+int
+finish_push(chunk_push& push) {
+    rpc_data_out_t out{};
+    int err = EIO;
+    if(margo_wait(push.req) == HG_SUCCESS &&
+       margo_get_output(push.handle, &out) == HG_SUCCESS) {
+        err = out.err;
+        if(err == 0 && out.io_size != push.size)
+            err = EIO;
+        margo_free_output(push.handle, &out);
+    }
+    margo_bulk_free(push.bulk_handle);
+    margo_destroy(push.handle);
+    return err;
+}
+
+/**
+ * @brief Reads the local source pieces of a copy batch with I/O tasklets.
+ * Missing chunks are holes and leave their part of the buffer untouched.
+ * @param path Source file path
+ * @param pieces Source chunk pieces, all owned by this daemon
+ * @param client Client id for the I/O scheduler
+ * @return Error code, 0 on success
+ */
+int
+read_source(const string& path, const vector<copy_piece>& pieces,
+            uint64_t client) {
+    gkfs::data::ChunkReadOperation op{path, pieces.size(), client};
+    for(size_t idx = 0; idx < pieces.size(); idx++) {
+        const auto& p = pieces[idx];
+        op.read_nonblock(idx, p.chnk_id, p.buf, p.size, p.chnk_off);
+    }
+    return op.wait_for_tasks().first;
+}
+
+/**
+ * @brief Writes a copy batch to the destination file. Chunks owned by this
+ * daemon are written by I/O tasklets, all others are pushed to their owners.
+ * Both proceed concurrently.
+ * @param path Destination file path
+ * @param extents Destination file ranges as pairs of file offset and source
+ * piece holding their data
+ * @param chnk_size Chunk size of the destination file
+ * @param host_id Host id of this daemon
+ * @param host_size Number of daemons
+ * @param data_host Data host of the destination file, -1 if none
+ * @param client Client id for the I/O scheduler
+ * @return Error code, 0 on success. EIO if a chunk was written only partially
+ */
+int
+copy_to_destination(const string& path,
+                    const vector<pair<uint64_t, copy_piece>>& extents,
+                    uint64_t chnk_size, uint64_t host_id, uint64_t host_size,
+                    int64_t data_host, uint64_t client) {
+    vector<copy_piece> local{};
+    size_t local_size = 0;
+    vector<pair<copy_piece, uint64_t>> remote{};
+    for(const auto& [offset, src] : extents) {
+        size_t done = 0;
+        while(done < src.size) {
+            auto file_off = offset + done;
+            auto chnk_id =
+                    gkfs::utils::arithmetic::block_index(file_off, chnk_size);
+            copy_piece piece{chnk_id, file_off - chnk_id * chnk_size, 0,
+                             src.buf + done};
+            piece.size =
+                    min<size_t>(src.size - done, chnk_size - piece.chnk_off);
+            auto owner = chunk_owner(path, chnk_id, data_host, host_size);
+            if(owner == host_id) {
+                local.push_back(piece);
+                local_size += piece.size;
+            } else {
+                remote.emplace_back(piece, owner);
+            }
+            done += piece.size;
+        }
+    }
+
+    int err = 0;
+    vector<chunk_push> pushes{};
+    if(!remote.empty()) {
+        hg_id_t write_id;
+        hg_bool_t registered = 0;
+        auto ret = margo_registered_name(RPC_DATA->server_rpc_mid(),
+                                         gkfs::rpc::tag::write, &write_id,
+                                         &registered);
+        if(ret != HG_SUCCESS || !registered)
+            return EIO;
+        pushes.reserve(remote.size());
+        for(const auto& [piece, owner] : remote) {
+            chunk_push push{};
+            err = start_push(write_id, path, piece, chnk_size, owner,
+                             host_size, data_host, push);
+            if(err != 0)
+                break;
+            pushes.push_back(push);
+        }
+    }
+
+    if(err == 0 && !local.empty()) {
+        try {
+            gkfs::data::ChunkWriteOperation op{path, local.size(), chnk_size,
+                                               client};
+            for(size_t idx = 0; idx < local.size(); idx++) {
+                const auto& p = local[idx];
+                op.write_nonblock(idx, p.chnk_id, p.buf, p.size, p.chnk_off);
+            }
+            auto [write_err, written] = op.wait_for_tasks();
+            err = write_err;
+            if(err == 0 && written != local_size)
+                err = EIO;
+        } catch(const gkfs::data::ChunkOpException& e) {
+            GKFS_DATA->spdlogger()->error("{}() {}", __func__, e.what());
+            err = EBUSY;
+        }
+    }
+
+    // all started pushes are waited for as they use the copy buffer
+    for(auto& push : pushes) {
+        auto push_err = finish_push(push);
+        if(err == 0)
+            err = push_err;
+    }
+    return err;
+}
+
+/**
+ * @brief Serves a server-side copy request, copying the source chunks stored
+ * on this daemon to the destination file.
+ * @internal
+ * Each client request is sent to every daemon holding a source chunk within
+ * the copied range. The daemon reads its local chunk pieces (missing chunks
+ * are holes and copied as zeros) and writes them to the destination chunks.
+ * Destination chunks owned by this daemon are written to the chunk storage,
+ * all others are pushed to their owner via the write RPC. File data therefore
+ * never travels through the client.
+ *
+ * The local source chunks are processed in batches of copy_batch_size bytes.
+ * Reads and writes go through the I/O pool (or the I/O scheduler) as for
+ * client requests, and the pushes of a batch are in flight concurrently.
+ *
+ * The destination file size is updated by the client before the copy.
+ *
+ * All exceptions must be caught here and dealt with accordingly.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_copy_data(hg_handle_t handle) {
+    rpc_copy_data_in_t in{};
+    rpc_data_out_t out{};
+    out.err = EIO;
+    out.io_size = 0;
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug(
+            "{}() src '{}' src_offset '{}' dst '{}' dst_offset '{}' count '{}'",
+            __func__, in.src_path, in.src_offset, in.dst_path, in.dst_offset,
+            in.count);
+    if(in.src_chunk_size == 0 || in.dst_chunk_size == 0 ||
+       in.src_chunk_size > gkfs::config::rpc::max_chunksize ||
+       in.dst_chunk_size > gkfs::config::rpc::max_chunksize ||
+       !valid_data_host(in.src_data_host, in.host_size) ||
+       !valid_data_host(in.dst_data_host, in.host_size)) {
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    auto hgi = margo_get_info(handle);
+    const auto client = client_id(margo_hg_info_get_instance(hgi), hgi->addr);
+
+    const auto chnk_size = in.src_chunk_size;
+    const string src_path{in.src_path};
+    const string dst_path{in.dst_path};
+    const auto src_begin = static_cast<uint64_t>(in.src_offset);
+    const auto src_end = src_begin + in.count;
+    try {
+        out.err = 0;
+        vector<uint64_t> chnk_ids{};
+        if(in.count > 0) {
+            auto chnk_start = gkfs::utils::arithmetic::block_index(src_begin,
+                                                                   chnk_size);
+            auto chnk_end = gkfs::utils::arithmetic::block_index(src_end - 1,
+                                                                 chnk_size);
+            for(auto chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+                if(chunk_owner(src_path, chnk_id, in.src_data_host,
+                               in.host_size) == in.host_id)
+                    chnk_ids.push_back(chnk_id);
+            }
+        }
+        vector<char> buf{};
+        vector<copy_piece> pieces{};
+        vector<pair<uint64_t, copy_piece>> extents{};
+        size_t idx = 0;
+        while(idx < chnk_ids.size() && out.err == 0) {
+            size_t batch_size = 0;
+            pieces.clear();
+            extents.clear();
+            for(; idx < chnk_ids.size(); idx++) {
+                auto chnk_id = chnk_ids[idx];
+                auto begin = max<uint64_t>(src_begin, chnk_id * chnk_size);
+                auto end = min<uint64_t>(src_end, (chnk_id + 1) * chnk_size);
+                auto size = static_cast<size_t>(end - begin);
+                if(!pieces.empty() &&
+                   batch_size + size > gkfs::config::rpc::copy_batch_size)
+                    break;
+                pieces.push_back({chnk_id, begin - chnk_id * chnk_size, size,
+                                  nullptr});
+                extents.emplace_back(in.dst_offset + (begin - src_begin),
+                                     copy_piece{});
+                batch_size += size;
+            }
+            // holes and short chunk files are copied as zeros
+            buf.assign(batch_size, 0);
+            size_t buf_off = 0;
+            for(size_t i = 0; i < pieces.size(); i++) {
+                pieces[i].buf = buf.data() + buf_off;
+                extents[i].second = pieces[i];
+                buf_off += pieces[i].size;
+            }
+            out.err = read_source(src_path, pieces, client);
+            if(out.err != 0)
+                break;
+            out.err = copy_to_destination(dst_path, extents, in.dst_chunk_size,
+                                          in.host_id, in.host_size,
+                                          in.dst_data_host, client);
+            if(out.err == 0)
+                out.io_size += batch_size;
+        }
+    } catch(const gkfs::data::ChunkOpException& e) {
+        GKFS_DATA->spdlogger()->error("{}() {}", __func__, e.what());
+        out.err = EBUSY;
+    } catch(const ::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Unexpected error '{}'", __func__,
+                                      e.what());
+        out.err = EIO;
+    }
+
+    GKFS_DATA->spdlogger()->debug(
+            "{}() Sending output response err '{}' io_size '{}'", __func__,
+            out.err, out.io_size);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
+/**
+ * @brief Serves a fallocate request, reserving backend storage for all chunk
+ * files of a byte range that are stored on this daemon.
+ * @internal
+ * The request is sent in parallel to all daemons owning a chunk in the range.
+ * Chunk files are created if necessary and their space is reserved without
+ * changing their size by tasklets in the I/O pool. The file size in the
+ * metadata is handled by the client.
+ *
+ * All exceptions must be caught here and dealt with accordingly.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_fallocate(hg_handle_t handle) {
+    rpc_fallocate_in_t in{};
+    rpc_err_out_t out{};
+    out.err = EIO;
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Could not get RPC input data with err {}", __func__, ret);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug("{}() path: '{}', offset: '{}', length: '{}'",
+                                  __func__, in.path, in.offset, in.length);
+    if(in.chunk_size == 0 ||
+       in.chunk_size > gkfs::config::rpc::max_chunksize ||
+       !valid_data_host(in.data_host, in.host_size)) {
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    const auto chnk_size = in.chunk_size;
+    const string path{in.path};
+    const auto begin = static_cast<uint64_t>(in.offset);
+    const auto end = begin + in.length;
+    try {
+        out.err = 0;
+        vector<gkfs::rpc::chnk_id_t> chnk_ids{};
+        if(in.length > 0) {
+            auto chnk_start =
+                    gkfs::utils::arithmetic::block_index(begin, chnk_size);
+            auto chnk_end =
+                    gkfs::utils::arithmetic::block_index(end - 1, chnk_size);
+            for(auto chnk_id = chnk_start; chnk_id <= chnk_end; chnk_id++) {
+                if(chunk_owner(path, chnk_id, in.data_host, in.host_size) ==
+                   in.host_id)
+                    chnk_ids.push_back(chnk_id);
+            }
+        }
+        if(!chnk_ids.empty()) {
+            gkfs::data::ChunkAllocateOperation chunk_op{
+                    path, std::move(chnk_ids), begin, in.length, chnk_size};
+            chunk_op.allocate();
+            out.err = chunk_op.wait_for_tasks();
+        }
+    } catch(const gkfs::data::ChunkMetaOpException& e) {
+        // This exception is caused by setup of Argobots variables. If this
+        // fails, something is really wrong
+        GKFS_DATA->spdlogger()->error("{}() while fallocate err '{}'",
+                                      __func__, e.what());
+        out.err = EIO;
+    } catch(const ::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Unexpected error '{}'", __func__,
+                                      e.what());
+        out.err = EIO;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output response '{}'", __func__,
+                                  out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
 } // namespace
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_write)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_read)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_write_list)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_read_list)
+
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_truncate)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_chunk_stat)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_copy_data)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_fallocate)
+
 #ifdef GKFS_ENABLE_AGIOS
 void*
 agios_eventual_callback(int64_t request_id, void* info) {
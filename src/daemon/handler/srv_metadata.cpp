@@ -39,9 +39,14 @@
 #include <daemon/backend/metadata/db.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/ops/metadentry.hpp>
+#include <daemon/ops/data.hpp>
 
 #include <common/rpc/rpc_types.hpp>
 #include <common/statistics/stats.hpp>
+#include <common/tracing.hpp>
+
+#include <fnmatch.h>
+#include <regex.h>
 
 using namespace std;
 
@@ -74,6 +79,12 @@ rpc_srv_create(hg_handle_t handle) {
     GKFS_DATA->spdlogger()->debug("{}() Got RPC with path '{}'", __func__,
                                   in.path);
     gkfs::metadata::Metadata md(in.mode);
+    // chunk size inherited from the parent directory
+    if(in.chunk_size > 0)
+        md.chunk_size(in.chunk_size);
+    // daemon chosen by the client to hold all chunks of the file
+    if(S_ISREG(in.mode) && in.data_host >= 0)
+        md.data_host(in.data_host);
     try {
         // create metadentry
         gkfs::metadata::create(in.path, md);
@@ -188,7 +199,7 @@ rpc_srv_decr_size(hg_handle_t handle) {
                                   in.path, in.length);
 
     try {
-        GKFS_DATA->mdb()->decrease_size(in.path, in.length);
+        gkfs::metadata::decrease_size(in.path, in.length);
         out.err = 0;
     } catch(const std::exception& e) {
         GKFS_DATA->spdlogger()->error("{}() Failed to decrease size: '{}'",
@@ -248,6 +259,8 @@ rpc_srv_remove_metadata(hg_handle_t handle) {
         out.err = 0;
         out.mode = md.mode();
         out.size = md.size();
+        out.chunk_size = md.chunk_size();
+        out.data_host = md.data_host();
         if constexpr(gkfs::config::metadata::implicit_data_removal) {
             if(S_ISREG(md.mode()) && (md.size() != 0))
                 GKFS_DATA->storage()->destroy_chunk_space(in.path);
@@ -336,6 +349,65 @@ rpc_srv_remove_data(hg_handle_t handle) {
     return HG_SUCCESS;
 }
 
+/**
+ * @brief Serves a request to remove the subtree of a directory, i.e., all its
+ * entries' metadata and data chunks on this daemon.
+ * @internal
+ * Clients send this request to all daemons. The metadata of the subtree is
+ * removed with range deletions, the directory's own entry is kept. The chunk
+ * directories of all files below the directory are removed in parallel by
+ * tasklets in the I/O pool.
+ *
+ * All exceptions must be caught here and dealt with accordingly. Any errors are
+ * placed in the response.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_remove_subtree(hg_handle_t handle) {
+    rpc_path_only_in_t in{};
+    rpc_err_out_t out{};
+    out.err = EIO;
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Failed to retrieve input from handle", __func__);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug("{}() Got remove subtree RPC with path '{}'",
+                                  __func__, in.path);
+
+    try {
+        gkfs::metadata::remove_subtree(in.path);
+        auto files = GKFS_DATA->storage()->detach_chunk_spaces(in.path);
+        GKFS_DATA->spdlogger()->trace("{}() path '{}' removing '{}' files",
+                                      __func__, in.path, files.size());
+        gkfs::data::ChunkRemoveSubtreeOperation op(in.path, std::move(files));
+        op.remove();
+        out.err = op.wait_for_tasks();
+    } catch(const gkfs::metadata::DBException& e) {
+        GKFS_DATA->spdlogger()->error("{}(): path '{}' message '{}'", __func__,
+                                      in.path, e.what());
+        out.err = EIO;
+    } catch(const gkfs::data::ChunkStorageException& e) {
+        GKFS_DATA->spdlogger()->error(
+                "{}(): path '{}' errcode '{}' message '{}'", __func__, in.path,
+                e.code().value(), e.what());
+        out.err = e.code().value();
+    } catch(const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() path '{}' message '{}'", __func__,
+                                      in.path, e.what());
+        out.err = EBUSY;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output '{}'", __func__,
+                                  out.err);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+}
+
 /**
  * @brief Serves a request to update the metadata. This function is UNUSED.
  * @internal
@@ -420,15 +492,13 @@ rpc_srv_update_metadentry_size(hg_handle_t handle) {
     GKFS_DATA->spdlogger()->debug(
             "{}() path: '{}', size: '{}', offset: '{}', append: '{}'", __func__,
             in.path, in.size, in.offset, in.append);
+    gkfs::tracing::Span span("daemon.update_size", in.trace_id);
 
     try {
-        gkfs::metadata::update_size(in.path, in.size, in.offset,
-                                    (in.append == HG_TRUE));
+        // for appends, this is the end of the range reserved for the client
+        out.ret_size = gkfs::metadata::update_size(in.path, in.size, in.offset,
+                                                   (in.append == HG_TRUE));
         out.err = 0;
-        // TODO the actual size of the file could be different after the size
-        // update
-        // do to concurrency on size
-        out.ret_size = in.size + in.offset;
     } catch(const gkfs::metadata::NotFoundException& e) {
         GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__,
                                       in.path);
@@ -453,6 +523,71 @@ rpc_srv_update_metadentry_size(hg_handle_t handle) {
     return HG_SUCCESS;
 }
 
+/**
+ * @brief Serves a request to set the chunk size of a file or the default chunk
+ * size of a directory's new entries.
+ * @internal
+ * The chunk size of a file determines where its data is placed. It can
+ * therefore only be changed as long as the file is empty. For directories,
+ * the chunk size is passed on to files and directories created in it.
+ *
+ * All exceptions must be caught here and dealt with accordingly. Any errors are
+ * placed in the response.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_set_chunk_size(hg_handle_t handle) {
+    rpc_chunk_size_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS)
+        GKFS_DATA->spdlogger()->error(
+                "{}() Failed to retrieve input from handle", __func__);
+    assert(ret == HG_SUCCESS);
+    GKFS_DATA->spdlogger()->debug("{}() path: '{}', chunk_size: '{}'",
+                                  __func__, in.path, in.chunk_size);
+
+    try {
+        auto md = gkfs::metadata::get(in.path);
+        if(in.chunk_size < gkfs::config::rpc::min_chunksize ||
+           in.chunk_size > gkfs::config::rpc::max_chunksize) {
+            out.err = EINVAL;
+        } else if(S_ISREG(md.mode()) && md.size() > 0) {
+            // existing chunks would no longer be found
+            out.err = EBUSY;
+        } else {
+            // only sets the chunk size and leaves a concurrently updated size
+            // intact. It is not applied if the file has data by then.
+            gkfs::metadata::set_chunk_size(in.path, in.chunk_size);
+            auto new_md = gkfs::metadata::get(in.path);
+            out.err = new_md.chunk_size() == in.chunk_size ? 0 : EBUSY;
+        }
+    } catch(const gkfs::metadata::NotFoundException& e) {
+        GKFS_DATA->spdlogger()->debug("{}() Entry not found: '{}'", __func__,
+                                      in.path);
+        out.err = ENOENT;
+    } catch(const std::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to set chunk size: '{}'",
+                                      __func__, e.what());
+        out.err = EBUSY;
+    }
+
+    GKFS_DATA->spdlogger()->debug("{}() Sending output '{}'", __func__,
+                                  out.err);
+    auto hret = margo_respond(handle, &out);
+    if(hret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to respond", __func__);
+    }
+
+    // Destroy handle when finished
+    margo_free_input(handle, &in);
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
 /**
  * @brief Serves a request to return the current file size.
  * @internal
@@ -828,6 +963,182 @@ rpc_srv_get_dirents_extended(hg_handle_t handle) {
     return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
 }
 
+/**
+ * @brief Serves a request to find all file system objects below a directory
+ * which match a predicate, returning either the matches or their number and
+ * total size only.
+ * @internal
+ * The predicate consists of a glob or POSIX extended regex on the entry's name
+ * and inclusive size and ctime ranges as well as its file type. The local KV
+ * store is scanned for the first-level entries of the directory or, if
+ * recursive, its whole subtree, so that only matches are sent to the client.
+ *
+ * Unless only aggregates are requested, the matches are pushed to the client's
+ * bulk buffer as modes, sizes, ctimes, and '\0' terminated absolute paths. If
+ * the buffer is too small, ENOBUFS is returned together with the required
+ * buffer size in bulk_size so that the client can retry with a larger buffer.
+ *
+ * All exceptions must be caught here and dealt with accordingly. Any errors are
+ * placed in the response.
+ * @endinteral
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+rpc_srv_scan(hg_handle_t handle) {
+    rpc_scan_in_t in{};
+    rpc_scan_out_t out{};
+    out.err = EIO;
+    out.scanned = 0;
+    out.matched = 0;
+    out.size_sum = 0;
+    out.bulk_size = 0;
+    hg_bulk_t bulk_handle = nullptr;
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Could not get RPC input data with err '{}'", __func__,
+                ret);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    GKFS_DATA->spdlogger()->debug(
+            "{}() Got RPC: path '{}' recursive '{}' pattern '{}' aggregate '{}'",
+            __func__, in.path, in.recursive, in.pattern, in.aggregate);
+
+    const string pattern = in.pattern;
+    regex_t name_regex{};
+    if(!pattern.empty() && in.regex &&
+       ::regcomp(&name_regex, in.pattern, REG_EXTENDED | REG_NOSUB) != 0) {
+        GKFS_DATA->spdlogger()->error("{}() Invalid regex '{}'", __func__,
+                                      in.pattern);
+        out.err = EINVAL;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    auto match = [&](const string& path, const gkfs::metadata::Metadata& md) {
+        if(in.type != 0 && (md.mode() & S_IFMT) != in.type)
+            return false;
+        auto size = static_cast<uint64_t>(md.size());
+        if(size < in.size_min || size > in.size_max)
+            return false;
+        auto ctime = static_cast<int64_t>(md.ctime());
+        if(ctime < in.ctime_min || ctime > in.ctime_max)
+            return false;
+        if(pattern.empty())
+            return true;
+        auto name = path.c_str() + path.rfind('/') + 1;
+        if(in.regex)
+            return ::regexec(&name_regex, name, 0, nullptr, 0) == 0;
+        return ::fnmatch(in.pattern, name, 0) == 0;
+    };
+
+    // matches are only kept if they are sent to the client
+    vector<tuple<string, mode_t, size_t, time_t>> entries{};
+    size_t out_size = 0;
+    try {
+        gkfs::metadata::scan(
+                in.path, in.recursive,
+                [&](const string& path, const gkfs::metadata::Metadata& md) {
+                    out.scanned++;
+                    if(!match(path, md))
+                        return;
+                    out.matched++;
+                    out.size_sum += md.size();
+                    if(in.aggregate)
+                        return;
+                    out_size += path.size() + sizeof(char) + sizeof(mode_t) +
+                                sizeof(size_t) + sizeof(time_t);
+                    entries.emplace_back(path, md.mode(), md.size(),
+                                         md.ctime());
+                });
+    } catch(const ::exception& e) {
+        GKFS_DATA->spdlogger()->error("{}() Error during scan(): '{}'",
+                                      __func__, e.what());
+        if(!pattern.empty() && in.regex)
+            ::regfree(&name_regex);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+    if(!pattern.empty() && in.regex)
+        ::regfree(&name_regex);
+
+    GKFS_DATA->spdlogger()->trace(
+            "{}() path '{}' scanned '{}' entries with '{}' matches", __func__,
+            in.path, out.scanned, out.matched);
+
+    if(entries.empty()) {
+        out.err = 0;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    auto bulk_size = margo_bulk_get_size(in.bulk_handle);
+    out.bulk_size = out_size;
+    if(bulk_size < out_size) {
+        // the client retries with the required buffer size
+        GKFS_DATA->spdlogger()->debug(
+                "{}() Matches do not fit source buffer. bulk_size '{}' < out_size '{}'",
+                __func__, bulk_size, out_size);
+        out.err = ENOBUFS;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out);
+    }
+
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_info_get_instance(hgi);
+    void* bulk_buf; // buffer for bulk transfer
+    ret = margo_bulk_create(mid, 1, nullptr, &out_size, HG_BULK_READ_ONLY,
+                            &bulk_handle);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error("{}() Failed to create bulk handle",
+                                      __func__);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+    uint32_t actual_count; // number of segments. we use one here because we
+                           // push the whole buffer at once
+    ret = margo_bulk_access(bulk_handle, 0, out_size, HG_BULK_READ_ONLY, 1,
+                            &bulk_buf, &out_size, &actual_count);
+    if(ret != HG_SUCCESS || actual_count != 1) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Failed to access allocated buffer from bulk handle",
+                __func__);
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+
+    // Serialize output data on local buffer
+    auto out_buff_ptr = static_cast<char*>(bulk_buf);
+    auto mode_ptr = reinterpret_cast<mode_t*>(out_buff_ptr);
+    auto size_ptr = reinterpret_cast<size_t*>(
+            out_buff_ptr + entries.size() * sizeof(mode_t));
+    auto ctime_ptr = reinterpret_cast<time_t*>(
+            out_buff_ptr + entries.size() * (sizeof(mode_t) + sizeof(size_t)));
+    auto names_ptr = out_buff_ptr + entries.size() * (sizeof(mode_t) +
+                                                      sizeof(size_t) +
+                                                      sizeof(time_t));
+    for(auto const& e : entries) {
+        *mode_ptr++ = get<1>(e);
+        *size_ptr++ = get<2>(e);
+        *ctime_ptr++ = get<3>(e);
+        ::strcpy(names_ptr, get<0>(e).c_str());
+        // number of characters + \0 terminator
+        names_ptr += get<0>(e).size() + 1;
+    }
+
+    ret = margo_bulk_transfer(mid, HG_BULK_PUSH, hgi->addr, in.bulk_handle, 0,
+                              bulk_handle, 0, out_size);
+    if(ret != HG_SUCCESS) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Failed to push '{}' matches on path '{}' to client with bulk size '{}' and out_size '{}'",
+                __func__, entries.size(), in.path, bulk_size, out_size);
+        out.err = EBUSY;
+        return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+    }
+
+    out.err = 0;
+    GKFS_DATA->spdlogger()->debug(
+            "{}() Sending output response err '{}' matched '{}'. DONE",
+            __func__, out.err, out.matched);
+    return gkfs::rpc::cleanup_respond(&handle, &in, &out, &bulk_handle);
+}
+
 #if defined(HAS_SYMLINKS) || defined(HAS_RENAME)
 /**
  * @brief Serves a request create a symbolic link and supports rename
@@ -905,15 +1216,21 @@ DEFINE_MARGO_RPC_HANDLER(rpc_srv_remove_metadata)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_remove_data)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_remove_subtree)
+
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_update_metadentry_size)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_metadentry_size)
 
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_set_chunk_size)
+
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_dirents)
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_get_dirents_extended)
+
+DEFINE_MARGO_RPC_HANDLER(rpc_srv_scan)
 #ifdef HAS_SYMLINKS
 
 DEFINE_MARGO_RPC_HANDLER(rpc_srv_mk_symlink)
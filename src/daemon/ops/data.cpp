@@ -31,7 +31,9 @@
 
 #include <daemon/ops/data.hpp>
 #include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/scheduler/io_scheduler.hpp>
 #include <common/arithmetic/arithmetic.hpp>
+#include <common/tracing.hpp>
 #include <utility>
 
 extern "C" {
@@ -53,6 +55,7 @@ namespace gkfs::data {
  fields:
  * const string* path;
    size_t size;
+   size_t chunk_size;
    ABT_eventual* eventual;
  * This function is driven by the IO pool. So, there is a maximum allowed number
  of concurrent operations allowed per daemon.
@@ -69,12 +72,13 @@ ChunkTruncateOperation::truncate_abt(void* _arg) {
     auto* arg = static_cast<struct chunk_truncate_args*>(_arg);
     const string& path = *(arg->path);
     const size_t size = arg->size;
+    const size_t chunk_size = arg->chunk_size;
     int err_response = 0;
     try {
         // get chunk from where to cut off
-        auto chunk_id_start = block_index(size, gkfs::config::rpc::chunksize);
+        auto chunk_id_start = block_index(size, chunk_size);
         // do not last delete chunk if it is in the middle of a chunk
-        auto left_pad = block_overrun(size, gkfs::config::rpc::chunksize);
+        auto left_pad = block_overrun(size, chunk_size);
         if(left_pad != 0) {
             GKFS_DATA->storage()->truncate_chunk_file(path, chunk_id_start,
                                                       left_pad);
@@ -108,7 +112,7 @@ ChunkTruncateOperation::ChunkTruncateOperation(const string& path)
  * @endinternal
  */
 void
-ChunkTruncateOperation::truncate(size_t size) {
+ChunkTruncateOperation::truncate(size_t size, size_t chunk_size) {
     assert(!task_eventuals_[0]);
     GKFS_DATA->spdlogger()->trace(
             "ChunkTruncateOperation::{}() enter: path '{}' size '{}'", __func__,
@@ -126,6 +130,7 @@ ChunkTruncateOperation::truncate(size_t size) {
     auto& task_arg = task_arg_;
     task_arg.path = &path_;
     task_arg.size = size;
+    task_arg.chunk_size = chunk_size;
     task_arg.eventual = task_eventuals_[0];
 
     abt_err = ABT_task_create(RPC_DATA->io_pool(), truncate_abt, &task_arg_,
@@ -173,6 +178,7 @@ ChunkTruncateOperation::wait_for_task() {
    const char* buf;
    const gkfs::rpc::chnk_id_t* chnk_id;
    size_t size;
+   size_t chunk_size;
    off64_t off;
    ABT_eventual* eventual;
  * This function is driven by the IO pool. So, there is a maximum allowed number
@@ -187,10 +193,15 @@ ChunkWriteOperation::write_file_abt(void* _arg) {
     // Unpack args
     auto* arg = static_cast<struct chunk_write_args*>(_arg);
     const string& path = *(arg->path);
+    if(arg->enqueue_ns != 0)
+        gkfs::tracing::record(arg->trace_id, "daemon.io_queue",
+                              arg->enqueue_ns, gkfs::tracing::now_ns());
+    gkfs::tracing::Span span("daemon.pwrite", arg->trace_id);
     ssize_t wrote{0};
     try {
         wrote = GKFS_DATA->storage()->write_chunk(path, arg->chnk_id, arg->buf,
-                                                  arg->size, arg->off);
+                                                  arg->size, arg->off,
+                                                  arg->chunk_size);
     } catch(const ChunkStorageException& err) {
         GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
         wrote = -(err.code().value());
@@ -208,16 +219,19 @@ ChunkWriteOperation::clear_task_args() {
     task_args_.clear();
 }
 
-ChunkWriteOperation::ChunkWriteOperation(const string& path, size_t n)
-    : ChunkOperation{path, n} {
+ChunkWriteOperation::ChunkWriteOperation(const string& path, size_t n,
+                                         size_t chunk_size, uint64_t client)
+    : ChunkOperation{path, n}, chunk_size_(chunk_size) {
+    client_ = client;
     task_args_.resize(n);
 }
 
 /**
  * @internal
  * Write buffer from a single chunk referenced by its ID. Put task into IO
- * queue. On failure the write operations is aborted, throwing an error, and
- * cleaned up. The caller may repeat a failed call.
+ * queue, or submit it to the I/O scheduler if enabled. On failure the write
+ * operations is aborted, throwing an error, and cleaned up. The caller may
+ * repeat a failed call.
  * @endinternal
  */
 void
@@ -244,8 +258,22 @@ ChunkWriteOperation::write_nonblock(size_t idx, const uint64_t chunk_id,
     task_arg.buf = bulk_buf_ptr;
     task_arg.chnk_id = chunk_id;
     task_arg.size = size;
+    task_arg.chunk_size = chunk_size_;
     task_arg.off = offset;
     task_arg.eventual = task_eventuals_[idx];
+    task_arg.trace_id = trace_id_;
+    task_arg.enqueue_ns = (trace_id_ != 0 && gkfs::tracing::enabled())
+                                  ? gkfs::tracing::now_ns()
+                                  : 0;
+
+    if(GKFS_DATA->io_scheduler()) {
+        scheduled_ = true;
+        GKFS_DATA->io_scheduler()->submit(
+                {IoOp::write, client_, &path_, chunk_id,
+                 const_cast<char*>(bulk_buf_ptr), size, offset, chunk_size_,
+                 task_eventuals_[idx], {}, trace_id_});
+        return;
+    }
 
     abt_err = ABT_task_create(RPC_DATA->io_pool(), write_file_abt,
                               &task_args_[idx], &abt_tasks_[idx]);
@@ -322,6 +350,10 @@ ChunkReadOperation::read_file_abt(void* _arg) {
     // unpack args
     auto* arg = static_cast<struct chunk_read_args*>(_arg);
     const string& path = *(arg->path);
+    if(arg->enqueue_ns != 0)
+        gkfs::tracing::record(arg->trace_id, "daemon.io_queue",
+                              arg->enqueue_ns, gkfs::tracing::now_ns());
+    gkfs::tracing::Span span("daemon.pread", arg->trace_id);
     ssize_t read = 0;
     try {
         // Under expected circumstances (error or no error) read_chunk will
@@ -345,16 +377,19 @@ ChunkReadOperation::clear_task_args() {
     task_args_.clear();
 }
 
-ChunkReadOperation::ChunkReadOperation(const string& path, size_t n)
+ChunkReadOperation::ChunkReadOperation(const string& path, size_t n,
+                                       uint64_t client)
     : ChunkOperation{path, n} {
+    client_ = client;
     task_args_.resize(n);
 }
 
 /**
  * @internal
- * Read buffer to a single chunk referenced by its ID. Put task into IO queue.
- * On failure the read operations is aborted, throwing an error, and cleaned up.
- * The caller may repeat a failed call.
+ * Read buffer to a single chunk referenced by its ID. Put task into IO queue,
+ * or submit it to the I/O scheduler if enabled. On failure the read operations
+ * is aborted, throwing an error, and cleaned up. The caller may repeat a failed
+ * call.
  * @endinternal
  */
 void
@@ -382,6 +417,19 @@ ChunkReadOperation::read_nonblock(size_t idx, const uint64_t chunk_id,
     task_arg.size = size;
     task_arg.off = offset;
     task_arg.eventual = task_eventuals_[idx];
+    task_arg.trace_id = trace_id_;
+    task_arg.enqueue_ns = (trace_id_ != 0 && gkfs::tracing::enabled())
+                                  ? gkfs::tracing::now_ns()
+                                  : 0;
+
+    if(GKFS_DATA->io_scheduler()) {
+        scheduled_ = true;
+        GKFS_DATA->io_scheduler()->submit({IoOp::read, client_, &path_,
+                                           chunk_id, bulk_buf_ptr, size, offset,
+                                           0, task_eventuals_[idx], {},
+                                           trace_id_});
+        return;
+    }
 
     abt_err = ABT_task_create(RPC_DATA->io_pool(), read_file_abt,
                               &task_args_[idx], &abt_tasks_[idx]);
@@ -445,6 +493,7 @@ ChunkReadOperation::wait_for_tasks_and_push_back(const bulk_args& args) {
                     args.origin_offsets->at(idx), args.local_offsets->at(idx),
                     *task_size);
             assert(task_args_[idx].chnk_id == args.chunk_ids->at(idx));
+            gkfs::tracing::Span push_span("daemon.bulk_push", trace_id_);
             auto margo_err = margo_bulk_transfer(
                     args.mid, HG_BULK_PUSH, args.origin_addr,
                     args.origin_bulk_handle, args.origin_offsets->at(idx),
@@ -467,4 +516,260 @@ ChunkReadOperation::wait_for_tasks_and_push_back(const bulk_args& args) {
     return make_pair(io_err, total_read);
 }
 
+pair<int, size_t>
+ChunkReadOperation::wait_for_tasks() {
+    GKFS_DATA->spdlogger()->trace("ChunkReadOperation::{}() enter: path '{}'",
+                                  __func__, path_);
+    size_t total_read = 0;
+    int io_err = 0;
+    // all eventuals are waited for and freed, even after an error
+    for(auto& e : task_eventuals_) {
+        ssize_t* task_size = nullptr;
+        auto abt_err = ABT_eventual_wait(e, (void**) &task_size);
+        if(abt_err != ABT_SUCCESS) {
+            GKFS_DATA->spdlogger()->error(
+                    "ChunkReadOperation::{}() Error when waiting on ABT eventual",
+                    __func__);
+            io_err = EIO;
+            ABT_eventual_free(&e);
+            continue;
+        }
+        assert(task_size != nullptr);
+        // sparse regions do not have chunk files
+        if(io_err == 0 && *task_size < 0 && -(*task_size) != ENOENT)
+            io_err = -(*task_size);
+        else if(*task_size > 0)
+            total_read += *task_size;
+        ABT_eventual_free(&e);
+    }
+    if(io_err != 0)
+        total_read = 0;
+    return make_pair(io_err, total_read);
+}
+
+/* ------------------------------------------------------------------------
+ * ------------------------ REMOVE SUBTREE --------------------------------
+ * ------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Exclusively used by the Argobots tasklet. Removes the chunk directories of
+ * the files [begin, end). All files are attempted, the last error is returned.
+ * @endinternal
+ */
+void
+ChunkRemoveSubtreeOperation::remove_abt(void* _arg) {
+    assert(_arg);
+    auto* arg = static_cast<struct chunk_remove_args*>(_arg);
+    int err_response = 0;
+    for(auto i = arg->begin; i < arg->end; i++) {
+        const auto& path = (*arg->files)[i];
+        try {
+            GKFS_DATA->storage()->destroy_chunk_space(path);
+        } catch(const ChunkStorageException& err) {
+            GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
+            err_response = err.code().value();
+        } catch(const ::exception& err) {
+            GKFS_DATA->spdlogger()->error(
+                    "{}() Unexpected error removing chunks of file '{}'",
+                    __func__, path);
+            err_response = EIO;
+        }
+    }
+    ABT_eventual_set(arg->eventual, &err_response, sizeof(err_response));
+}
+
+void
+ChunkRemoveSubtreeOperation::clear_task_args() {
+    task_args_.clear();
+}
+
+ChunkRemoveSubtreeOperation::ChunkRemoveSubtreeOperation(const string& path,
+                                                         vector<string> files)
+    : ChunkOperation{path,
+                     std::min<size_t>(files.size(),
+                                      gkfs::config::rpc::daemon_io_xstreams)},
+      files_(std::move(files)) {
+    task_args_.resize(abt_tasks_.size());
+}
+
+/**
+ * @internal
+ * Each task removes a contiguous share of the files. Shares differ by at most
+ * one file.
+ * @endinternal
+ */
+void
+ChunkRemoveSubtreeOperation::remove() {
+    GKFS_DATA->spdlogger()->trace(
+            "ChunkRemoveSubtreeOperation::{}() enter: path '{}' files '{}' tasks '{}'",
+            __func__, path_, files_.size(), abt_tasks_.size());
+    const auto n = abt_tasks_.size();
+    for(size_t idx = 0; idx < n; idx++) {
+        auto abt_err = ABT_eventual_create(sizeof(int), &task_eventuals_[idx]);
+        if(abt_err != ABT_SUCCESS) {
+            auto err_str = fmt::format(
+                    "ChunkRemoveSubtreeOperation::{}() Failed to create ABT eventual with abt_err '{}'",
+                    __func__, abt_err);
+            throw ChunkMetaOpException(err_str);
+        }
+        auto& task_arg = task_args_[idx];
+        task_arg.files = &files_;
+        task_arg.begin = files_.size() * idx / n;
+        task_arg.end = files_.size() * (idx + 1) / n;
+        task_arg.eventual = task_eventuals_[idx];
+
+        abt_err = ABT_task_create(RPC_DATA->io_pool(), remove_abt,
+                                  &task_args_[idx], &abt_tasks_[idx]);
+        if(abt_err != ABT_SUCCESS) {
+            auto err_str = fmt::format(
+                    "ChunkRemoveSubtreeOperation::{}() Failed to create ABT task with abt_err '{}'",
+                    __func__, abt_err);
+            throw ChunkMetaOpException(err_str);
+        }
+    }
+}
+
+int
+ChunkRemoveSubtreeOperation::wait_for_tasks() {
+    GKFS_DATA->spdlogger()->trace(
+            "ChunkRemoveSubtreeOperation::{}() enter: path '{}'", __func__,
+            path_);
+    int remove_err = 0;
+    for(auto& e : task_eventuals_) {
+        int* task_err = nullptr;
+        auto abt_err = ABT_eventual_wait(e, (void**) &task_err);
+        if(abt_err != ABT_SUCCESS) {
+            GKFS_DATA->spdlogger()->error(
+                    "ChunkRemoveSubtreeOperation::{}() Error when waiting on ABT eventual",
+                    __func__);
+            remove_err = EIO;
+            ABT_eventual_free(&e);
+            continue;
+        }
+        assert(task_err != nullptr);
+        if(*task_err != 0)
+            remove_err = *task_err;
+        ABT_eventual_free(&e);
+    }
+    return remove_err;
+}
+
+/* ------------------------------------------------------------------------
+ * ---------------------------- ALLOCATE ----------------------------------
+ * ------------------------------------------------------------------------*/
+
+/**
+ * @internal
+ * Exclusively used by the Argobots tasklet. Reserves the chunks [begin, end)
+ * of the operation and stops at the first error.
+ * @endinternal
+ */
+void
+ChunkAllocateOperation::allocate_abt(void* _arg) {
+    assert(_arg);
+    auto* arg = static_cast<struct chunk_allocate_args*>(_arg);
+    const auto* op = arg->op;
+    const auto range_end = op->offset_ + op->length_;
+    int err_response = 0;
+    for(auto i = arg->begin; i < arg->end && err_response == 0; i++) {
+        auto chnk_id = op->chnk_ids_[i];
+        auto chnk_begin = std::max<uint64_t>(op->offset_,
+                                             chnk_id * op->chunk_size_);
+        auto chnk_end = std::min<uint64_t>(range_end,
+                                           (chnk_id + 1) * op->chunk_size_);
+        try {
+            GKFS_DATA->storage()->allocate_chunk(
+                    op->path_, chnk_id, chnk_begin - chnk_id * op->chunk_size_,
+                    chnk_end - chnk_begin);
+        } catch(const ChunkStorageException& err) {
+            GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
+            err_response = err.code().value();
+        } catch(const ::exception& err) {
+            GKFS_DATA->spdlogger()->error(
+                    "{}() Unexpected error allocating chunk {} of file '{}'",
+                    __func__, chnk_id, op->path_);
+            err_response = EIO;
+        }
+    }
+    ABT_eventual_set(arg->eventual, &err_response, sizeof(err_response));
+}
+
+void
+ChunkAllocateOperation::clear_task_args() {
+    task_args_.clear();
+}
+
+ChunkAllocateOperation::ChunkAllocateOperation(
+        const string& path, vector<gkfs::rpc::chnk_id_t> chnk_ids,
+        uint64_t offset, uint64_t length, size_t chunk_size)
+    : ChunkOperation{path,
+                     std::min<size_t>(chnk_ids.size(),
+                                      gkfs::config::rpc::daemon_io_xstreams)},
+      chnk_ids_(std::move(chnk_ids)), offset_(offset), length_(length),
+      chunk_size_(chunk_size) {
+    task_args_.resize(abt_tasks_.size());
+}
+
+/**
+ * @internal
+ * Each task allocates a contiguous share of the chunks. Shares differ by at
+ * most one chunk.
+ * @endinternal
+ */
+void
+ChunkAllocateOperation::allocate() {
+    GKFS_DATA->spdlogger()->trace(
+            "ChunkAllocateOperation::{}() enter: path '{}' chunks '{}' tasks '{}'",
+            __func__, path_, chnk_ids_.size(), abt_tasks_.size());
+    const auto n = abt_tasks_.size();
+    for(size_t idx = 0; idx < n; idx++) {
+        auto abt_err = ABT_eventual_create(sizeof(int), &task_eventuals_[idx]);
+        if(abt_err != ABT_SUCCESS) {
+            auto err_str = fmt::format(
+                    "ChunkAllocateOperation::{}() Failed to create ABT eventual with abt_err '{}'",
+                    __func__, abt_err);
+            throw ChunkMetaOpException(err_str);
+        }
+        auto& task_arg = task_args_[idx];
+        task_arg.op = this;
+        task_arg.begin = chnk_ids_.size() * idx / n;
+        task_arg.end = chnk_ids_.size() * (idx + 1) / n;
+        task_arg.eventual = task_eventuals_[idx];
+
+        abt_err = ABT_task_create(RPC_DATA->io_pool(), allocate_abt,
+                                  &task_args_[idx], &abt_tasks_[idx]);
+        if(abt_err != ABT_SUCCESS) {
+            auto err_str = fmt::format(
+                    "ChunkAllocateOperation::{}() Failed to create ABT task with abt_err '{}'",
+                    __func__, abt_err);
+            throw ChunkMetaOpException(err_str);
+        }
+    }
+}
+
+int
+ChunkAllocateOperation::wait_for_tasks() {
+    GKFS_DATA->spdlogger()->trace(
+            "ChunkAllocateOperation::{}() enter: path '{}'", __func__, path_);
+    int allocate_err = 0;
+    for(auto& e : task_eventuals_) {
+        int* task_err = nullptr;
+        auto abt_err = ABT_eventual_wait(e, (void**) &task_err);
+        if(abt_err != ABT_SUCCESS) {
+            GKFS_DATA->spdlogger()->error(
+                    "ChunkAllocateOperation::{}() Error when waiting on ABT eventual",
+                    __func__);
+            allocate_err = EIO;
+            ABT_eventual_free(&e);
+            continue;
+        }
+        assert(task_err != nullptr);
+        if(*task_err != 0)
+            allocate_err = *task_err;
+        ABT_eventual_free(&e);
+    }
+    return allocate_err;
+}
+
 } // namespace gkfs::data
@@ -31,8 +31,89 @@
 #include <daemon/backend/data/chunk_storage.hpp>
 #include <daemon/backend/metadata/metadata_module.hpp>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 using namespace std;
 
+namespace {
+
+/**
+ * In-memory size of a file that received O_APPEND writes on its metadata
+ * owner. Appends reserve their offset with a single fetch_add on `size`; the
+ * value is merged into the KV store lazily and `persisted` tracks the last
+ * merged size.
+ */
+struct AppendCounter {
+    std::atomic<size_t> size;
+    std::atomic<size_t> persisted;
+    std::atomic<unsigned int> pending{0};
+
+    explicit AppendCounter(size_t initial_size)
+        : size(initial_size), persisted(initial_size) {}
+};
+
+// Appends and size updates take the shared lock. Creating and dropping
+// counters takes the exclusive lock so that a counter is never initialized
+// from a stale KV store size.
+std::shared_mutex append_mutex;
+std::unordered_map<std::string, std::unique_ptr<AppendCounter>>
+        append_counters;
+
+/**
+ * Merges the counter's size into the KV store. Increase operands take the
+ * maximum for non-append updates, so persisting the same size twice is
+ * harmless.
+ * @param path
+ * @param counter
+ * @param force persist even if the size has not changed since the last merge
+ */
+void
+persist_counter(const std::string& path, AppendCounter& counter,
+                bool force = false) {
+    auto size = counter.size.load();
+    auto persisted = counter.persisted.load();
+    if(!force && size <= persisted)
+        return;
+    GKFS_DATA->mdb()->increase_size(path, size, false);
+    while(persisted < size &&
+          !counter.persisted.compare_exchange_weak(persisted, size)) {
+    }
+}
+
+/**
+ * Reserves `io_size` bytes at the current end of file
+ * @param path
+ * @param counter
+ * @param io_size
+ * @return the end of the reserved range
+ */
+size_t
+reserve_append(const std::string& path, AppendCounter& counter,
+               size_t io_size) {
+    auto end = counter.size.fetch_add(io_size) + io_size;
+    if(++counter.pending % gkfs::config::metadata::append_flush_interval == 0)
+        persist_counter(path, counter);
+    return end;
+}
+
+/**
+ * Persists the append counter of a path if one exists
+ * @param path
+ */
+void
+flush_counter(const std::string& path) {
+    shared_lock<shared_mutex> lock(append_mutex);
+    auto it = append_counters.find(path);
+    if(it != append_counters.end())
+        persist_counter(path, *it->second);
+}
+
+} // namespace
+
 namespace gkfs::metadata {
 
 /**
@@ -54,6 +135,7 @@ get(const std::string& path) {
  */
 std::string
 get_str(const std::string& path) {
+    flush_counter(path);
     return GKFS_DATA->mdb()->get(path);
 }
 
@@ -85,9 +167,25 @@ get_dirents(const std::string& dir) {
  */
 std::vector<std::tuple<std::string, bool, size_t, time_t>>
 get_dirents_extended(const std::string& dir) {
+    // entries carry sizes which must include pending appends
+    flush_sizes();
     return GKFS_DATA->mdb()->get_dirents_extended(dir);
 }
 
+/**
+ * Calls a function for each entry below given directory, see
+ * MetadataDB::scan()
+ * @param dir
+ * @param recursive
+ * @param fn
+ */
+void
+scan(const std::string& dir, bool recursive, const scan_fn& fn) {
+    // entries carry sizes which must include pending appends
+    flush_sizes();
+    GKFS_DATA->mdb()->scan(dir, recursive, fn);
+}
+
 
 /**
  * Creates metadata (if required) and dentry at the same time
@@ -126,18 +224,119 @@ create(const std::string& path, Metadata& md) {
 void
 update(const string& path, Metadata& md) {
     GKFS_DATA->mdb()->update(path, path, md.serialize());
+    // the serialized size may predate concurrent appends
+    shared_lock<shared_mutex> lock(append_mutex);
+    auto it = append_counters.find(path);
+    if(it != append_counters.end())
+        persist_counter(path, *it->second, true);
 }
 
 /**
  * Updates a metadentry's size atomically and returns the corresponding size
- * after update
+ * after update.
+ *
+ * Appends are served from an in-memory counter on the metadata owner which
+ * reserves [end - io_size, end) with a single fetch_add. Concurrent appends
+ * therefore always receive disjoint ranges. A zero-sized update at offset 0
+ * persists and drops the counter. Clients send it on fsync and close of a file
+ * they appended to, so counters do not outlive their writers. Dropping is safe
+ * while others still append: all reservations are made under the shared lock,
+ * and the next append re-initializes the counter from the persisted size.
  * @param path
  * @param io_size
- * @return the updated size
+ * @param offset ignored for appends
+ * @param append
+ * @return the end of the written range
+ * @throws gkfs::metadata::NotFoundException
  */
-void
+size_t
 update_size(const string& path, size_t io_size, off64_t offset, bool append) {
-    GKFS_DATA->mdb()->increase_size(path, io_size + offset, append);
+    if(append) {
+        {
+            shared_lock<shared_mutex> lock(append_mutex);
+            auto it = append_counters.find(path);
+            if(it != append_counters.end())
+                return reserve_append(path, *it->second, io_size);
+        }
+        unique_lock<shared_mutex> lock(append_mutex);
+        auto it = append_counters.find(path);
+        if(it == append_counters.end()) {
+            // bypass get() which would take the lock again
+            auto size = Metadata(GKFS_DATA->mdb()->get(path)).size();
+            it = append_counters
+                         .emplace(path, make_unique<AppendCounter>(size))
+                         .first;
+        }
+        return reserve_append(path, *it->second, io_size);
+    }
+
+    if(io_size == 0 && offset == 0) {
+        unique_lock<shared_mutex> lock(append_mutex);
+        auto it = append_counters.find(path);
+        if(it != append_counters.end()) {
+            persist_counter(path, *it->second);
+            append_counters.erase(it);
+        }
+        return 0;
+    }
+
+    auto end = io_size + offset;
+    shared_lock<shared_mutex> lock(append_mutex);
+    GKFS_DATA->mdb()->increase_size(path, end, false);
+    auto it = append_counters.find(path);
+    if(it != append_counters.end()) {
+        auto& counter = *it->second;
+        auto size = counter.size.load();
+        while(size < end && !counter.size.compare_exchange_weak(size, end)) {
+        }
+        persist_counter(path, counter);
+    }
+    return end;
+}
+
+/**
+ * Decreases a metadentry's size, e.g., for truncate. The append counter is
+ * persisted and dropped first, so it is re-initialized from the new size.
+ * @param path
+ * @param length new size
+ * @throws gkfs::metadata::DBException
+ */
+void
+decrease_size(const string& path, size_t length) {
+    unique_lock<shared_mutex> lock(append_mutex);
+    auto it = append_counters.find(path);
+    if(it != append_counters.end()) {
+        persist_counter(path, *it->second);
+        append_counters.erase(it);
+    }
+    GKFS_DATA->mdb()->decrease_size(path, length);
+}
+
+/**
+ * Sets a metadentry's chunk size. It is only changed if the metadentry is not a
+ * regular file with data. Pending appends are persisted first, so their size
+ * is taken into account.
+ * @param path
+ * @param chunk_size
+ * @throws gkfs::metadata::DBException
+ */
+void
+set_chunk_size(const string& path, size_t chunk_size) {
+    unique_lock<shared_mutex> lock(append_mutex);
+    auto it = append_counters.find(path);
+    if(it != append_counters.end())
+        persist_counter(path, *it->second);
+    GKFS_DATA->mdb()->update_chunk_size(path, chunk_size);
+}
+
+/**
+ * Persists all pending append counters, e.g., before shutdown
+ */
+void
+flush_sizes() {
+    shared_lock<shared_mutex> lock(append_mutex);
+    for(auto& [path, counter] : append_counters)
+        persist_counter(path, *counter);
 }
 
 /**
@@ -153,10 +352,37 @@ remove(const string& path) {
      * not an error in this case because removes can be broadcast to catch all
      * data chunks but only one node will hold the kv store entry.
      */
+    {
+        unique_lock<shared_mutex> lock(append_mutex);
+        append_counters.erase(path);
+    }
     try {
         GKFS_DATA->mdb()->remove(path); // remove metadata from KV store
     } catch(const NotFoundException& e) {
     }
 }
 
+/**
+ * Removes all metadentries below a directory, i.e., its subtree, including
+ * their append counters
+ * @param dir
+ * @throws gkfs::metadata::DBException
+ */
+void
+remove_subtree(const string& dir) {
+    auto prefix = dir;
+    if(prefix.back() != '/')
+        prefix.push_back('/');
+    {
+        unique_lock<shared_mutex> lock(append_mutex);
+        for(auto it = append_counters.begin(); it != append_counters.end();) {
+            if(it->first.compare(0, prefix.size(), prefix) == 0)
+                it = append_counters.erase(it);
+            else
+                ++it;
+        }
+    }
+    GKFS_DATA->mdb()->remove_subtree(dir);
+}
+
 } // namespace gkfs::metadata
\ No newline at end of file
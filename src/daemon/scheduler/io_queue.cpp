@@ -0,0 +1,182 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <daemon/scheduler/io_queue.hpp>
+
+#include <utility>
+
+using namespace std;
+
+namespace gkfs::data {
+
+IoQueue::IoQueue(size_t quantum, chrono::milliseconds write_deadline,
+                 size_t max_merge_size)
+    : quantum_(quantum), write_deadline_(write_deadline),
+      max_merge_size_(max_merge_size) {}
+
+pair<map<string, IoQueue::FileQueue>::iterator, bool>
+IoQueue::select(ClientQueue& client,
+                chrono::steady_clock::time_point now) const {
+    auto& files = client.files;
+    // writes past their deadline go first, oldest first
+    auto expired = files.end();
+    for(auto it = files.begin(); it != files.end(); ++it) {
+        const auto& writes = it->second.writes;
+        if(writes.empty() || now - writes.front().arrival < write_deadline_)
+            continue;
+        if(expired == files.end() ||
+           writes.front().arrival < expired->second.writes.front().arrival)
+            expired = it;
+    }
+    if(expired != files.end())
+        return {expired, true};
+    // visit files round robin, starting after the last one served
+    auto next = [&](auto has_requests) {
+        auto start = files.upper_bound(client.last_file);
+        for(auto it = start; it != files.end(); ++it) {
+            if(has_requests(it->second))
+                return it;
+        }
+        for(auto it = files.begin(); it != start; ++it) {
+            if(has_requests(it->second))
+                return it;
+        }
+        return files.end();
+    };
+    auto file = next([](const FileQueue& f) { return !f.reads.empty(); });
+    if(file != files.end())
+        return {file, false};
+    return {next([](const FileQueue& f) { return !f.writes.empty(); }), true};
+}
+
+vector<IoRequest>
+IoQueue::take(deque<IoRequest>& queue, bool is_write) const {
+    vector<IoRequest> batch{queue.front()};
+    queue.pop_front();
+    auto end = batch.front().off + static_cast<off64_t>(batch.front().size);
+    auto total = batch.front().size;
+    auto continues = [&](const IoRequest& req) {
+        return req.chnk_id == batch.front().chnk_id && req.off == end &&
+               total + req.size <= max_merge_size_;
+    };
+    auto add = [&](const IoRequest& req) {
+        batch.push_back(req);
+        end += static_cast<off64_t>(req.size);
+        total += req.size;
+    };
+    if(is_write) {
+        while(!queue.empty() && continues(queue.front())) {
+            add(queue.front());
+            queue.pop_front();
+        }
+        return batch;
+    }
+    for(auto found = true; found;) {
+        found = false;
+        for(auto it = queue.begin(); it != queue.end(); ++it) {
+            if(continues(*it)) {
+                add(*it);
+                queue.erase(it);
+                found = true;
+                break;
+            }
+        }
+    }
+    return batch;
+}
+
+void
+IoQueue::push(IoRequest req) {
+    auto [client, inserted] = clients_.try_emplace(req.client);
+    if(inserted) {
+        // a client that is alone starts its turn right away
+        if(active_.empty())
+            client->second.deficit = static_cast<int64_t>(quantum_);
+        active_.push_back(req.client);
+    }
+    auto& file = client->second.files[*req.path];
+    if(req.op == IoOp::read)
+        file.reads.push_back(req);
+    else
+        file.writes.push_back(req);
+    size_++;
+}
+
+/**
+ * @internal
+ * The client at the front of the round robin order is served as long as its
+ * deficit covers the next request. Otherwise, it moves to the back. A client
+ * is granted a quantum whenever it reaches the front. A merged batch may overdraw the
+ * deficit, which is then paid back in the client's next turns.
+ * @endinternal
+ */
+vector<IoRequest>
+IoQueue::pop(chrono::steady_clock::time_point now) {
+    if(active_.empty())
+        return {};
+    while(true) {
+        auto id = active_.front();
+        auto& client = clients_.at(id);
+        auto [file, is_write] = select(client, now);
+        auto& queue = is_write ? file->second.writes : file->second.reads;
+        if(client.deficit < static_cast<int64_t>(queue.front().size)) {
+            active_.pop_front();
+            active_.push_back(id);
+            clients_.at(active_.front()).deficit +=
+                    static_cast<int64_t>(quantum_);
+            continue;
+        }
+        auto batch = take(queue, is_write);
+        for(const auto& req : batch)
+            client.deficit -= static_cast<int64_t>(req.size);
+        size_ -= batch.size();
+        client.last_file = file->first;
+        if(file->second.reads.empty() && file->second.writes.empty())
+            client.files.erase(file);
+        if(client.files.empty()) {
+            clients_.erase(id);
+            active_.pop_front();
+            if(!active_.empty())
+                clients_.at(active_.front()).deficit +=
+                        static_cast<int64_t>(quantum_);
+        }
+        return batch;
+    }
+}
+
+size_t
+IoQueue::size() const {
+    return size_;
+}
+
+bool
+IoQueue::empty() const {
+    return size_ == 0;
+}
+
+} // namespace gkfs::data
@@ -0,0 +1,165 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <daemon/scheduler/io_scheduler.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
+#include <daemon/classes/fs_data.hpp>
+#include <common/statistics/stats.hpp>
+#include <common/tracing.hpp>
+
+#include <algorithm>
+#include <memory>
+
+extern "C" {
+#include <sys/uio.h>
+}
+
+using namespace std;
+
+namespace gkfs::data {
+
+IoScheduler::IoScheduler(ABT_pool pool, unsigned int max_inflight)
+    : queue_(gkfs::config::scheduler::quantum,
+             chrono::milliseconds(gkfs::config::scheduler::write_deadline),
+             gkfs::config::scheduler::max_merge_size),
+      max_inflight_(max_inflight), pool_(pool) {}
+
+void
+IoScheduler::dispatch(unique_lock<mutex>& lock) {
+    while(inflight_ < max_inflight_ && !queue_.empty()) {
+        auto batch = make_unique<Batch>(Batch{this, queue_.pop()});
+        inflight_++;
+        lock.unlock();
+        auto abt_err = ABT_task_create(pool_, run_batch, batch.get(), nullptr);
+        if(abt_err == ABT_SUCCESS) {
+            // the tasklet owns the batch now
+            batch.release();
+        } else {
+            GKFS_DATA->spdlogger()->error(
+                    "IoScheduler::{}() Failed to create ABT task with abt_err '{}'",
+                    __func__, abt_err);
+            ssize_t err = -EIO;
+            for(const auto& req : batch->requests)
+                ABT_eventual_set(static_cast<ABT_eventual>(req.completion),
+                                 &err, sizeof(err));
+        }
+        lock.lock();
+        if(abt_err != ABT_SUCCESS)
+            inflight_--;
+    }
+}
+
+/**
+ * @internal
+ * A batch covers a contiguous range of one chunk file. Each request is handed
+ * its share of the transferred bytes in file order, so that a short read at
+ * the end of the chunk file is reported to the requests it affects.
+ * @endinternal
+ */
+void
+IoScheduler::run_batch(void* _arg) {
+    assert(_arg);
+    unique_ptr<Batch> batch(static_cast<Batch*>(_arg));
+    const auto& requests = batch->requests;
+    const auto& first = requests.front();
+    vector<struct iovec> iov{};
+    iov.reserve(requests.size());
+    size_t size = 0;
+    for(const auto& req : requests) {
+        iov.push_back({req.buf, req.size});
+        size += req.size;
+    }
+    auto start_ns = gkfs::tracing::enabled() ? gkfs::tracing::now_ns() : 0;
+    auto start = chrono::steady_clock::now();
+    ssize_t ret{0};
+    try {
+        if(first.op == IoOp::write)
+            ret = GKFS_DATA->storage()->writev_chunk(
+                    *first.path, first.chnk_id, iov.data(),
+                    static_cast<int>(iov.size()), first.off, first.chunk_size);
+        else
+            ret = GKFS_DATA->storage()->readv_chunk(
+                    *first.path, first.chnk_id, iov.data(),
+                    static_cast<int>(iov.size()), first.off);
+    } catch(const ChunkStorageException& err) {
+        GKFS_DATA->spdlogger()->error("{}() {}", __func__, err.what());
+        ret = -(err.code().value());
+    } catch(const ::exception& err) {
+        GKFS_DATA->spdlogger()->error(
+                "{}() Unexpected error on chunk {} of file {}", __func__,
+                first.chnk_id, *first.path);
+        ret = -EIO;
+    }
+    if(start_ns != 0) {
+        // the queue time of each request is derived from the steady clock
+        auto end_ns = gkfs::tracing::now_ns();
+        auto* name = first.op == IoOp::write ? "daemon.pwrite" : "daemon.pread";
+        for(const auto& req : requests) {
+            if(req.trace_id == 0)
+                continue;
+            auto queued = chrono::duration_cast<chrono::nanoseconds>(
+                                  start - req.arrival)
+                                  .count();
+            gkfs::tracing::record(req.trace_id, "daemon.io_queue",
+                                  start_ns - queued, start_ns);
+            gkfs::tracing::record(req.trace_id, name, start_ns, end_ns);
+        }
+    }
+    auto left = ret;
+    for(const auto& req : requests) {
+        auto result = ret;
+        if(ret >= 0) {
+            result = min(left, static_cast<ssize_t>(req.size));
+            left -= result;
+        }
+        ABT_eventual_set(static_cast<ABT_eventual>(req.completion), &result,
+                         sizeof(result));
+    }
+    if(GKFS_DATA->enable_stats()) {
+        GKFS_DATA->stats()->add_value_size(
+                gkfs::utils::Stats::SizeOp::sched_io_size, size);
+        for(size_t i = 1; i < requests.size(); i++)
+            GKFS_DATA->stats()->add_value_iops(
+                    gkfs::utils::Stats::IopsOp::iops_sched_merge);
+    }
+
+    auto* scheduler = batch->scheduler;
+    unique_lock<mutex> lock(scheduler->mutex_);
+    scheduler->inflight_--;
+    scheduler->dispatch(lock);
+}
+
+void
+IoScheduler::submit(IoRequest req) {
+    req.arrival = chrono::steady_clock::now();
+    unique_lock<mutex> lock(mutex_);
+    queue_.push(req);
+    dispatch(lock);
+}
+
+} // namespace gkfs::data
@@ -28,8 +28,14 @@
 
 #include <daemon/util.hpp>
 #include <daemon/daemon.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
 
 #include <common/rpc/rpc_util.hpp>
+#include <common/hosts_file.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <regex>
 
 using namespace std;
 
@@ -40,7 +46,9 @@ namespace gkfs::utils {
  * Appends a single line to an existing shared hosts file with the RPC
  * connection information of this daemon. If it doesn't exist, it is created.
  * The line includes the hostname (and rootdir_suffix if applicable) and the RPC
- * server's listening address.
+ * server's listening address. With the weighted distributor, the daemon's
+ * weight follows as a third column. Unless set by the user, it is the capacity
+ * of the chunk storage in GiB.
  *
  * NOTE, the shared file system must support strong consistency semantics to
  * ensure each daemon can write its information to the file even if the write
@@ -63,8 +71,22 @@ populate_hosts_file() {
                     ? gkfs::rpc::get_my_hostname(true)
                     : fmt::format("{}#{}", gkfs::rpc::get_my_hostname(true),
                                   GKFS_DATA->rootdir_suffix());
+#ifdef GKFS_USE_WEIGHTED_DISTRIBUTION
+    auto weight = GKFS_DATA->host_weight();
+    if(weight <= 0.0) {
+        auto stat = GKFS_DATA->storage()->chunk_stat();
+        auto capacity = static_cast<double>(stat.chunk_total) * stat.chunk_size;
+        weight = std::max(1.0, capacity / (1024.0 * 1024.0 * 1024.0));
+    }
+    GKFS_DATA->spdlogger()->info("{}() Distribution weight: {}", __func__,
+                                 weight);
+    lfstream << fmt::format("{} {} {}", hostname, RPC_DATA->self_addr_str(),
+                            weight)
+             << std::endl;
+#else
     lfstream << fmt::format("{} {}", hostname, RPC_DATA->self_addr_str())
              << std::endl;
+#endif
     if(!lfstream) {
         throw runtime_error(
                 fmt::format("Failed to write on hosts file '{}': {}",
@@ -85,4 +107,26 @@ destroy_hosts_file() {
     std::remove(GKFS_DATA->hosts_file().c_str());
 }
 
+/**
+ * @internal
+ * Host ids are positions in the sorted list of hosts file entries, see
+ * gkfs::utils::parse_hosts_file(). The daemon resolves host ids received in
+ * RPC inputs exactly as the client does.
+ * @endinternal
+ */
+vector<string>
+read_hosts_file(vector<double>* weights) {
+    auto entries = parse_hosts_file(GKFS_DATA->hosts_file());
+    vector<string> uris{};
+    uris.reserve(entries.size());
+    if(weights)
+        weights->clear();
+    for(auto& e : entries) {
+        uris.emplace_back(std::move(e.uri));
+        if(weights)
+            weights->push_back(e.weight);
+    }
+    return uris;
+}
+
 } // namespace gkfs::utils
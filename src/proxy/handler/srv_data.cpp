@@ -0,0 +1,365 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief Provides all Margo RPC handler definitions called by Mercury on client
+ * request for all file system data operations that go through the proxy.
+ * @internal
+ * A client sends a single request covering all chunks of an I/O operation to
+ * the proxy. The proxy transfers the data between the client's memory and its
+ * own buffer once and splits the request into one request per daemon, exactly
+ * as the client does without a proxy. The daemons then transfer the data
+ * from or to the proxy's buffer. Requests larger than the buffer are relayed
+ * in pieces.
+ * @endinternal
+ */
+
+#include <proxy/proxy.hpp>
+#include <proxy/handler/rpc_defs.hpp>
+
+#include <common/rpc/rpc_types.hpp>
+#include <common/arithmetic/arithmetic.hpp>
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <new>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Splits a request covering all chunks into one non-blocking request
+ * per daemon and waits for all of them.
+ * @tparam InputType rpc_write_data_in_t or rpc_read_data_in_t
+ * @param mid Margo instance
+ * @param name RPC name
+ * @param client_in Client input covering all chunks of the operation
+ * @param bulk_handle Proxy buffer holding the whole operation's data
+ * @return pair<error code, accumulated I/O size of all daemons>
+ */
+template <typename InputType>
+pair<int, size_t>
+relay_chunks(margo_instance_id mid, const char* name,
+             const InputType& client_in, hg_bulk_t bulk_handle) {
+    // import pow2-optimized arithmetic functions
+    using namespace gkfs::utils::arithmetic;
+
+    const string path(client_in.path);
+    const uint64_t chunksize = client_in.chunk_size;
+    if(chunksize == 0 || chunksize > gkfs::config::rpc::max_chunksize)
+        return make_pair(EINVAL, 0);
+    const uint64_t offset =
+            client_in.chunk_start * chunksize + client_in.offset;
+    const uint64_t size = client_in.total_chunk_size;
+
+    hg_id_t rpc_id{};
+    hg_bool_t flag{};
+    auto ret = margo_registered_name(mid, name, &rpc_id, &flag);
+    if(ret != HG_SUCCESS || !flag) {
+        PROXY_DATA->log()->error("{}() RPC '{}' is not registered", __func__,
+                                 name);
+        return make_pair(EBUSY, 0);
+    }
+
+    // number of chunks per daemon in order of first appearance
+    map<uint64_t, uint64_t> target_chnks{};
+    vector<uint64_t> targets{};
+    uint64_t chnk_start_target = 0;
+    uint64_t chnk_end_target = 0;
+    vector<gkfs::rpc::host_t> owners{};
+    if(client_in.data_host >= 0) {
+        // files with a data host keep all chunks on that daemon
+        owners.assign(client_in.chunk_end - client_in.chunk_start + 1,
+                      client_in.data_host);
+    } else {
+        owners = PROXY_DATA->distributor()->locate_data_range(
+                path, client_in.chunk_start, client_in.chunk_end);
+    }
+    for(auto chnk_id = client_in.chunk_start; chnk_id <= client_in.chunk_end;
+        chnk_id++) {
+        uint64_t target = owners[chnk_id - client_in.chunk_start];
+        if(target_chnks[target]++ == 0)
+            targets.push_back(target);
+        if(chnk_id == client_in.chunk_start)
+            chnk_start_target = target;
+        if(chnk_id == client_in.chunk_end)
+            chnk_end_target = target;
+    }
+
+    struct request {
+        uint64_t target;
+        hg_handle_t handle;
+        margo_request req;
+    };
+    vector<InputType> inputs{};
+    inputs.reserve(targets.size());
+    vector<request> requests{};
+    requests.reserve(targets.size());
+    auto err = 0;
+
+    for(const auto target : targets) {
+        // total chunk_size for target
+        auto total_chunk_size = target_chnks[target] * chunksize;
+        // receiver of first chunk must subtract the offset from first chunk
+        if(target == chnk_start_target)
+            total_chunk_size -= block_overrun(offset, chunksize);
+        // receiver of last chunk must subtract
+        if(target == chnk_end_target && !is_aligned(offset + size, chunksize))
+            total_chunk_size -= block_underrun(offset + size, chunksize);
+
+        auto& in = inputs.emplace_back(client_in);
+        in.host_id = target;
+        in.host_size = PROXY_DATA->host_uris().size();
+        in.chunk_n = target_chnks[target];
+        in.total_chunk_size = total_chunk_size;
+        in.bulk_handle = bulk_handle;
+
+        auto addr = PROXY_DATA->host_addr(target);
+        hg_handle_t handle = HG_HANDLE_NULL;
+        if(addr == HG_ADDR_NULL ||
+           margo_create(mid, addr, rpc_id, &handle) != HG_SUCCESS) {
+            err = EBUSY;
+            break;
+        }
+        margo_request req = MARGO_REQUEST_NULL;
+        if(margo_iforward(handle, &in, &req) != HG_SUCCESS) {
+            PROXY_DATA->log()->error(
+                    "{}() Unable to send non-blocking rpc for path '{}' [peer: {}]",
+                    __func__, path, target);
+            margo_destroy(handle);
+            err = EBUSY;
+            break;
+        }
+        requests.push_back({target, handle, req});
+    }
+
+    // All sent requests are waited for, regardless of errors, as they use the
+    // proxy's buffer
+    size_t io_size = 0;
+    for(auto& r : requests) {
+        rpc_data_out_t out{};
+        if(margo_wait(r.req) == HG_SUCCESS &&
+           margo_get_output(r.handle, &out) == HG_SUCCESS) {
+            if(out.err != 0) {
+                PROXY_DATA->log()->error("{}() Daemon '{}' reported error: {}",
+                                         __func__, r.target, out.err);
+                err = out.err;
+            }
+            io_size += out.io_size;
+            margo_free_output(r.handle, &out);
+        } else {
+            PROXY_DATA->log()->error(
+                    "{}() Failed to get rpc output for path '{}' [peer: {}]",
+                    __func__, path, r.target);
+            err = EIO;
+        }
+        margo_destroy(r.handle);
+    }
+    return make_pair(err, io_size);
+}
+
+/**
+ * @brief Relays one piece of a client's write or read through the proxy's
+ * buffer.
+ * @tparam InputType rpc_write_data_in_t or rpc_read_data_in_t
+ * @param mid Margo instance
+ * @param name RPC name
+ * @param write true for writes, false for reads
+ * @param piece_in Input covering the chunks of this piece
+ * @param client_addr Address of the client
+ * @param client_bulk Bulk handle of the client's buffer
+ * @param client_offset Offset of the piece in the client's buffer
+ * @param buf Proxy buffer of at least piece_in.total_chunk_size bytes
+ * @return pair<error code, accumulated I/O size of all daemons>
+ */
+template <typename InputType>
+pair<int, size_t>
+relay_piece(margo_instance_id mid, const char* name, bool write,
+            const InputType& piece_in, hg_addr_t client_addr,
+            hg_bulk_t client_bulk, hg_size_t client_offset, char* buf) {
+    hg_size_t size = piece_in.total_chunk_size;
+    void* buf_ptr = buf;
+    // the bulk handle must match the piece as daemons derive the size of the
+    // first chunk's transfer from it
+    hg_bulk_t bulk_handle = HG_BULK_NULL;
+    auto ret = margo_bulk_create(mid, 1, &buf_ptr, &size, HG_BULK_READWRITE,
+                                 &bulk_handle);
+    if(ret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to create bulk handle",
+                                 __func__);
+        return make_pair(EBUSY, 0);
+    }
+    pair<int, size_t> result{EIO, 0};
+    if(write) {
+        ret = margo_bulk_transfer(mid, HG_BULK_PULL, client_addr, client_bulk,
+                                  client_offset, bulk_handle, 0, size);
+        if(ret != HG_SUCCESS) {
+            PROXY_DATA->log()->error(
+                    "{}() Failed to pull data from client for path '{}'",
+                    __func__, piece_in.path);
+        }
+    } else {
+        // sparse regions which are not transferred by any daemon are zeroed
+        memset(buf, 0, size);
+    }
+    if(ret == HG_SUCCESS)
+        result = relay_chunks(mid, name, piece_in, bulk_handle);
+    if(ret == HG_SUCCESS && !write && result.first == 0) {
+        ret = margo_bulk_transfer(mid, HG_BULK_PUSH, client_addr, client_bulk,
+                                  client_offset, bulk_handle, 0, size);
+        if(ret != HG_SUCCESS) {
+            PROXY_DATA->log()->error(
+                    "{}() Failed to push data to client for path '{}'",
+                    __func__, piece_in.path);
+            result = make_pair(EIO, 0);
+        }
+    }
+    margo_bulk_free(bulk_handle);
+    return result;
+}
+
+/**
+ * @brief Serves a write or read request of a client through the proxy.
+ * @internal
+ * The data is staged in a buffer of at most relay_buffer_size bytes. Larger
+ * requests are relayed piece by piece, each piece ending on a chunk boundary
+ * unless a single chunk exceeds the buffer.
+ * @endinternal
+ * @tparam InputType rpc_write_data_in_t or rpc_read_data_in_t
+ * @param handle Mercury RPC handle
+ * @param name RPC name
+ * @param write true for writes, false for reads
+ * @return Mercury error code to Mercury
+ */
+template <typename InputType>
+hg_return_t
+relay_data(hg_handle_t handle, const char* name, bool write) {
+    // import pow2-optimized arithmetic functions
+    using namespace gkfs::utils::arithmetic;
+
+    InputType in{};
+    rpc_data_out_t out{};
+    out.err = EIO;
+    out.io_size = 0;
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to retrieve input from handle",
+                                 __func__);
+        margo_destroy(handle);
+        return ret;
+    }
+    auto hgi = margo_get_info(handle);
+    auto mid = margo_hg_handle_get_instance(handle);
+    auto bulk_size = margo_bulk_get_size(in.bulk_handle);
+    PROXY_DATA->log()->debug(
+            "{}() path: '{}', size: '{}', chunks: [{}, {}], write: '{}'",
+            __func__, in.path, bulk_size, in.chunk_start, in.chunk_end, write);
+
+    const uint64_t chunksize = in.chunk_size;
+    const uint64_t size = in.total_chunk_size;
+    unique_ptr<char[]> buf{};
+    if(chunksize == 0 || chunksize > gkfs::config::rpc::max_chunksize ||
+       size == 0 || size > bulk_size) {
+        out.err = EINVAL;
+    } else {
+        try {
+            buf.reset(new char[min<uint64_t>(
+                    size, gkfs::config::proxy::relay_buffer_size)]);
+        } catch(const bad_alloc&) {
+            PROXY_DATA->log()->error(
+                    "{}() Failed to allocate relay buffer for path '{}'",
+                    __func__, in.path);
+            out.err = ENOMEM;
+        }
+    }
+    if(buf) {
+        const uint64_t offset = in.chunk_start * chunksize + in.offset;
+        const uint64_t max_piece = gkfs::config::proxy::relay_buffer_size;
+        out.err = 0;
+        for(uint64_t done = 0; done < size && out.err == 0;) {
+            auto piece_offset = offset + done;
+            auto piece_size = min(size - done, max_piece);
+            if(done + piece_size < size) {
+                auto end = align_left(piece_offset + piece_size, chunksize);
+                if(end > piece_offset)
+                    piece_size = end - piece_offset;
+            }
+            InputType piece_in = in;
+            piece_in.offset = block_overrun(piece_offset, chunksize);
+            piece_in.chunk_start = block_index(piece_offset, chunksize);
+            piece_in.chunk_end =
+                    block_index(piece_offset + piece_size - 1, chunksize);
+            piece_in.chunk_n = piece_in.chunk_end - piece_in.chunk_start + 1;
+            piece_in.total_chunk_size = piece_size;
+            auto [err, io_size] =
+                    relay_piece(mid, name, write, piece_in, hgi->addr,
+                                in.bulk_handle, done, buf.get());
+            out.err = err;
+            out.io_size += io_size;
+            done += piece_size;
+        }
+        if(out.err != 0)
+            out.io_size = 0;
+    }
+
+    auto hret = margo_respond(handle, &out);
+    if(hret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to respond", __func__);
+    }
+    margo_free_input(handle, &in);
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
+} // namespace
+
+/**
+ * @brief Serves a write request by splitting it into one request per daemon.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_write(hg_handle_t handle) {
+    return relay_data<rpc_write_data_in_t>(handle, gkfs::rpc::tag::write, true);
+}
+
+/**
+ * @brief Serves a read request by splitting it into one request per daemon.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_read(hg_handle_t handle) {
+    return relay_data<rpc_read_data_in_t>(handle, gkfs::rpc::tag::read, false);
+}
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_write)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_read)
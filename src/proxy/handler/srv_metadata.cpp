@@ -0,0 +1,385 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief Provides all Margo RPC handler definitions called by Mercury on client
+ * request for all file system metadata operations that go through the proxy.
+ * @internal
+ * The proxy registers the daemon's RPC names and types. Each request is
+ * relayed as-is to the daemon owning the path's metadata, using the same
+ * distributor as clients without a proxy. Stat results are cached for all
+ * clients on the node and dropped when a path is modified through the proxy.
+ * Clients using the proxy must therefore send all metadata modifications
+ * through it.
+ * @endinternal
+ */
+
+#include <proxy/proxy.hpp>
+#include <proxy/util.hpp>
+#include <proxy/handler/rpc_defs.hpp>
+
+#include <common/rpc/rpc_types.hpp>
+
+using namespace std;
+
+namespace {
+
+/**
+ * @brief Relays a decoded metadata request to the daemon owning the path's
+ * metadata and responds with the daemon's output.
+ * @tparam InputType RPC input type with a `path` member
+ * @tparam OutputType RPC output type with an `err` member
+ * @param handle Mercury RPC handle
+ * @param name RPC name
+ * @param in Decoded input which is not freed here
+ * @param on_output Called with the path and the daemon's output before
+ * responding
+ */
+template <typename InputType, typename OutputType, typename Callback>
+void
+relay_input(hg_handle_t handle, const char* name, InputType& in,
+            Callback&& on_output) {
+    OutputType out{};
+    const string path(in.path);
+    PROXY_DATA->log()->debug("{}() Relaying '{}' for path '{}'", __func__,
+                             name, path);
+
+    auto host = PROXY_DATA->distributor()->locate_file_metadata(path);
+    hg_handle_t daemon_handle = HG_HANDLE_NULL;
+    auto ret = gkfs::proxy::forward_to_daemon(name, host, &in, &out,
+                                              daemon_handle);
+    if(ret != HG_SUCCESS) {
+        out = OutputType{};
+        out.err = EBUSY;
+    }
+    on_output(path, out);
+
+    auto hret = margo_respond(handle, &out);
+    if(hret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to respond", __func__);
+    }
+
+    if(daemon_handle != HG_HANDLE_NULL) {
+        margo_free_output(daemon_handle, &out);
+        margo_destroy(daemon_handle);
+    }
+}
+
+/**
+ * @brief Relays a metadata request to the daemon owning the path's metadata.
+ * @param handle Mercury RPC handle
+ * @param name RPC name
+ * @param on_output Called with the path and the daemon's output before
+ * responding
+ * @return Mercury error code to Mercury
+ */
+template <typename InputType, typename OutputType, typename Callback>
+hg_return_t
+relay_metadata(hg_handle_t handle, const char* name, Callback&& on_output) {
+    InputType in{};
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to retrieve input from handle",
+                                 __func__);
+        margo_destroy(handle);
+        return ret;
+    }
+    relay_input<InputType, OutputType>(handle, name, in,
+                                       std::forward<Callback>(on_output));
+    margo_free_input(handle, &in);
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
+/**
+ * @brief Relays a request that modifies a path's metadata and drops the path
+ * from the stat cache.
+ */
+template <typename InputType, typename OutputType>
+hg_return_t
+relay_modify(hg_handle_t handle, const char* name) {
+    return relay_metadata<InputType, OutputType>(
+            handle, name, [](const string& path, const OutputType&) {
+                PROXY_DATA->invalidate_stat(path);
+            });
+}
+
+} // namespace
+
+/**
+ * @brief Relays a request to create a new file system object.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_create(hg_handle_t handle) {
+    return relay_modify<rpc_mk_node_in_t, rpc_err_out_t>(
+            handle, gkfs::rpc::tag::create);
+}
+
+/**
+ * @brief Serves a stat request from the proxy's cache or relays it.
+ * @internal
+ * Cached entries are shared by all clients on this node and expire after the
+ * configured TTL. Modifications by other nodes may therefore be visible with
+ * that delay. A relayed result is not cached if the path was modified through
+ * the proxy in the meantime, as it may predate the modification.
+ * @endinternal
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_stat(hg_handle_t handle) {
+    rpc_path_only_in_t in{};
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to retrieve input from handle",
+                                 __func__);
+        margo_destroy(handle);
+        return ret;
+    }
+    auto cached = PROXY_DATA->cached_stat(in.path);
+    if(cached) {
+        rpc_stat_out_t out{};
+        out.err = 0;
+        out.db_val = cached->c_str();
+        auto hret = margo_respond(handle, &out);
+        if(hret != HG_SUCCESS) {
+            PROXY_DATA->log()->error("{}() Failed to respond", __func__);
+        }
+    } else {
+        auto generation = PROXY_DATA->stat_generation(in.path);
+        relay_input<rpc_path_only_in_t, rpc_stat_out_t>(
+                handle, gkfs::rpc::tag::stat, in,
+                [generation](const string& path, const rpc_stat_out_t& out) {
+                    if(out.err == 0)
+                        PROXY_DATA->cache_stat(path, out.db_val, generation);
+                });
+    }
+
+    margo_free_input(handle, &in);
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
+/**
+ * @brief Relays a request to decrease the file size, e.g., for truncate.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_decr_size(hg_handle_t handle) {
+    return relay_modify<rpc_trunc_in_t, rpc_err_out_t>(
+            handle, gkfs::rpc::tag::decr_size);
+}
+
+/**
+ * @brief Relays a request to remove a file system object's metadata.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_remove_metadata(hg_handle_t handle) {
+    return relay_modify<rpc_rm_node_in_t, rpc_rm_metadata_out_t>(
+            handle, gkfs::rpc::tag::remove_metadata);
+}
+
+/**
+ * @brief Relays a request to update a file system object's metadata.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_update_metadentry(hg_handle_t handle) {
+    return relay_modify<rpc_update_metadentry_in_t, rpc_err_out_t>(
+            handle, gkfs::rpc::tag::update_metadentry);
+}
+
+/**
+ * @brief Relays a request to update the file size.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_update_metadentry_size(hg_handle_t handle) {
+    return relay_modify<rpc_update_metadentry_size_in_t,
+                        rpc_update_metadentry_size_out_t>(
+            handle, gkfs::rpc::tag::update_metadentry_size);
+}
+
+/**
+ * @brief Relays a request to change the chunk size of a file or directory.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_set_chunk_size(hg_handle_t handle) {
+    return relay_modify<rpc_chunk_size_in_t, rpc_err_out_t>(
+            handle, gkfs::rpc::tag::set_chunk_size);
+}
+
+/**
+ * @brief Relays a request to return the current file size. The size is never
+ * served from the cache as it is used for appends and SEEK_END.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_get_metadentry_size(hg_handle_t handle) {
+    return relay_metadata<rpc_path_only_in_t, rpc_get_metadentry_size_out_t>(
+            handle, gkfs::rpc::tag::get_metadentry_size,
+            [](const string&, const rpc_get_metadentry_size_out_t&) {});
+}
+
+#ifdef HAS_SYMLINKS
+/**
+ * @brief Relays a request to create a symlink. Also used by rename to link the
+ * old and the new path.
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_mk_symlink(hg_handle_t handle) {
+    return relay_modify<rpc_mk_symlink_in_t, rpc_err_out_t>(
+            handle, gkfs::rpc::tag::mk_symlink);
+}
+#endif
+
+/**
+ * @brief Relays a request to remove a directory's subtree to all daemons.
+ * @internal
+ * Clients send a single request to the proxy, which drops all cached entries
+ * of the subtree and forwards the request to each daemon in parallel.
+ * @endinternal
+ * @param handle Mercury RPC handle
+ * @return Mercury error code to Mercury
+ */
+hg_return_t
+proxy_rpc_srv_remove_subtree(hg_handle_t handle) {
+    rpc_path_only_in_t in{};
+    rpc_err_out_t out{};
+
+    auto ret = margo_get_input(handle, &in);
+    if(ret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to retrieve input from handle",
+                                 __func__);
+        margo_destroy(handle);
+        return ret;
+    }
+    const string path(in.path);
+    PROXY_DATA->log()->debug("{}() Relaying to all daemons for path '{}'",
+                             __func__, path);
+    PROXY_DATA->invalidate_stat_subtree(path);
+
+    auto* mid = PROXY_DATA->server_rpc_mid();
+    hg_id_t rpc_id{};
+    hg_bool_t flag{};
+    out.err = 0;
+    ret = margo_registered_name(mid, gkfs::rpc::tag::remove_subtree, &rpc_id,
+                                &flag);
+    if(ret != HG_SUCCESS || !flag)
+        out.err = EBUSY;
+
+    struct request {
+        uint64_t target;
+        hg_handle_t handle;
+        margo_request req;
+    };
+    vector<request> requests{};
+    const auto host_size = PROXY_DATA->host_uris().size();
+    for(uint64_t target = 0; out.err == 0 && target < host_size; target++) {
+        auto addr = PROXY_DATA->host_addr(target);
+        hg_handle_t daemon_handle = HG_HANDLE_NULL;
+        if(addr == HG_ADDR_NULL ||
+           margo_create(mid, addr, rpc_id, &daemon_handle) != HG_SUCCESS) {
+            out.err = EBUSY;
+            break;
+        }
+        margo_request req = MARGO_REQUEST_NULL;
+        if(margo_iforward(daemon_handle, &in, &req) != HG_SUCCESS) {
+            PROXY_DATA->log()->error(
+                    "{}() Unable to send non-blocking rpc for path '{}' [peer: {}]",
+                    __func__, path, target);
+            margo_destroy(daemon_handle);
+            out.err = EBUSY;
+            break;
+        }
+        requests.push_back({target, daemon_handle, req});
+    }
+    for(auto& r : requests) {
+        rpc_err_out_t daemon_out{};
+        if(margo_wait(r.req) == HG_SUCCESS &&
+           margo_get_output(r.handle, &daemon_out) == HG_SUCCESS) {
+            if(daemon_out.err != 0) {
+                PROXY_DATA->log()->error("{}() Daemon '{}' reported error: {}",
+                                         __func__, r.target, daemon_out.err);
+                out.err = daemon_out.err;
+            }
+            margo_free_output(r.handle, &daemon_out);
+        } else {
+            PROXY_DATA->log()->error(
+                    "{}() Failed to get rpc output for path '{}' [peer: {}]",
+                    __func__, path, r.target);
+            out.err = EBUSY;
+        }
+        margo_destroy(r.handle);
+    }
+    // entries may have been cached while the daemons removed them
+    PROXY_DATA->invalidate_stat_subtree(path);
+
+    auto hret = margo_respond(handle, &out);
+    if(hret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to respond", __func__);
+    }
+    margo_free_input(handle, &in);
+    margo_destroy(handle);
+    return HG_SUCCESS;
+}
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_create)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_stat)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_decr_size)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_remove_metadata)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_update_metadentry)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_update_metadentry_size)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_set_chunk_size)
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_get_metadentry_size)
+
+#ifdef HAS_SYMLINKS
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_mk_symlink)
+#endif
+
+DEFINE_MARGO_RPC_HANDLER(proxy_rpc_srv_remove_subtree)
@@ -0,0 +1,348 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/**
+ * @brief The main source file to launch the node-local proxy.
+ * @internal
+ * The proxy is started once per node. It accepts the clients' RPCs on the same
+ * RPC names as the daemons and relays them to the daemons. Thereby, all
+ * processes on a node share the proxy's daemon connections and its stat
+ * cache. Local clients reach the proxy via shared memory.
+ * @endinternal
+ */
+
+#include <proxy/proxy.hpp>
+#include <proxy/util.hpp>
+#include <proxy/handler/rpc_defs.hpp>
+#include <version.hpp>
+#include <common/log_util.hpp>
+#include <common/env_util.hpp>
+#include <common/rpc/rpc_types.hpp>
+#include <daemon/env.hpp>
+
+#include <CLI/CLI.hpp>
+
+#include <iostream>
+#include <csignal>
+#include <condition_variable>
+
+using namespace std;
+
+static condition_variable shutdown_please; // handler for shutdown signaling
+static mutex mtx; // mutex to wait on shutdown conditional variable
+
+struct cli_options {
+    string hosts_file;
+    string pid_file;
+    string listen;
+    long stat_cache_ttl;
+};
+
+/**
+ * @brief Registers all RPCs served by the proxy.
+ * @internal
+ * RPC names and types are identical to the daemon's so that clients use the
+ * same RPC definitions for the proxy and the daemons, and the proxy uses the
+ * same RPC ids to forward requests to the daemons.
+ * @endinternal
+ * @param mid margo instance
+ */
+void
+register_server_rpcs(margo_instance_id mid) {
+    MARGO_REGISTER(mid, gkfs::rpc::tag::create, rpc_mk_node_in_t, rpc_err_out_t,
+                   proxy_rpc_srv_create);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::stat, rpc_path_only_in_t,
+                   rpc_stat_out_t, proxy_rpc_srv_stat);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::decr_size, rpc_trunc_in_t,
+                   rpc_err_out_t, proxy_rpc_srv_decr_size);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::remove_metadata, rpc_rm_node_in_t,
+                   rpc_rm_metadata_out_t, proxy_rpc_srv_remove_metadata);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::update_metadentry,
+                   rpc_update_metadentry_in_t, rpc_err_out_t,
+                   proxy_rpc_srv_update_metadentry);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::get_metadentry_size, rpc_path_only_in_t,
+                   rpc_get_metadentry_size_out_t,
+                   proxy_rpc_srv_get_metadentry_size);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::update_metadentry_size,
+                   rpc_update_metadentry_size_in_t,
+                   rpc_update_metadentry_size_out_t,
+                   proxy_rpc_srv_update_metadentry_size);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::set_chunk_size, rpc_chunk_size_in_t,
+                   rpc_err_out_t, proxy_rpc_srv_set_chunk_size);
+#ifdef HAS_SYMLINKS
+    MARGO_REGISTER(mid, gkfs::rpc::tag::mk_symlink, rpc_mk_symlink_in_t,
+                   rpc_err_out_t, proxy_rpc_srv_mk_symlink);
+#endif
+    MARGO_REGISTER(mid, gkfs::rpc::tag::remove_subtree, rpc_path_only_in_t,
+                   rpc_err_out_t, proxy_rpc_srv_remove_subtree);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::write, rpc_write_data_in_t,
+                   rpc_data_out_t, proxy_rpc_srv_write);
+    MARGO_REGISTER(mid, gkfs::rpc::tag::read, rpc_read_data_in_t,
+                   rpc_data_out_t, proxy_rpc_srv_read);
+}
+
+/**
+ * @brief Initializes the proxy RPC server which is also used to forward
+ * requests to the daemons.
+ * @throws std::runtime_error on failure
+ */
+void
+init_rpc_server() {
+    hg_addr_t addr_self = nullptr;
+    hg_size_t addr_self_cstring_sz = 128;
+    char addr_self_cstring[128];
+    struct hg_init_info hg_options = HG_INIT_INFO_INITIALIZER;
+    hg_options.auto_sm = PROXY_DATA->use_auto_sm() ? HG_TRUE : HG_FALSE;
+    hg_options.stats = HG_FALSE;
+    if(gkfs::rpc::protocol::ofi_psm2 == PROXY_DATA->rpc_protocol())
+        hg_options.na_init_info.progress_mode = NA_NO_BLOCK;
+    // Start Margo (this will also initialize Argobots and Mercury internally)
+    auto margo_config = fmt::format(
+            R"({{ "use_progress_thread" : true, "rpc_thread_count" : {} }})",
+            gkfs::config::proxy::handler_xstreams);
+    struct margo_init_info args = {nullptr};
+    args.json_config = margo_config.c_str();
+    args.hg_init_info = &hg_options;
+    auto* mid = margo_init_ext(PROXY_DATA->bind_addr().c_str(),
+                               MARGO_SERVER_MODE, &args);
+    if(mid == MARGO_INSTANCE_NULL) {
+        throw runtime_error("Failed to initialize the Margo RPC server");
+    }
+    auto hret = margo_addr_self(mid, &addr_self);
+    if(hret != HG_SUCCESS) {
+        margo_finalize(mid);
+        throw runtime_error("Failed to retrieve server RPC address");
+    }
+    hret = margo_addr_to_string(mid, addr_self_cstring, &addr_self_cstring_sz,
+                                addr_self);
+    if(hret != HG_SUCCESS) {
+        margo_addr_free(mid, addr_self);
+        margo_finalize(mid);
+        throw runtime_error("Failed to convert server RPC address to string");
+    }
+    margo_addr_free(mid, addr_self);
+
+    PROXY_DATA->self_addr_str(addr_self_cstring);
+    PROXY_DATA->log()->info("{}() Accepting RPCs on address {}", __func__,
+                            addr_self_cstring);
+    PROXY_DATA->server_rpc_mid(mid);
+    register_server_rpcs(mid);
+}
+
+/**
+ * @brief Initializes the proxy environment.
+ * @internal
+ * Sets up the distributor in the same way as the daemons, starts the RPC
+ * server, and publishes the proxy's address for the clients on this node.
+ * @endinternal
+ * @throws std::runtime_error if any step fails
+ */
+void
+init_environment() {
+    auto hosts_size =
+            static_cast<unsigned int>(PROXY_DATA->host_uris().size());
+#ifdef GKFS_USE_GUIDED_DISTRIBUTION
+    auto distributor =
+            std::make_shared<gkfs::rpc::GuidedDistributor>(0, hosts_size);
+#elif defined(GKFS_USE_STRIPED_DISTRIBUTION)
+    auto distributor =
+            std::make_shared<gkfs::rpc::StripedDistributor>(0, hosts_size);
+#elif defined(GKFS_USE_WEIGHTED_DISTRIBUTION)
+    auto distributor = std::make_shared<gkfs::rpc::WeightedDistributor>(
+            0, hosts_size, PROXY_DATA->host_weights());
+#else
+    auto distributor =
+            std::make_shared<gkfs::rpc::SimpleHashDistributor>(0, hosts_size);
+#endif
+    PROXY_DATA->distributor(distributor);
+
+    init_rpc_server();
+    gkfs::proxy::write_pid_file();
+    PROXY_DATA->log()->info("{}() pid file written to '{}'", __func__,
+                            PROXY_DATA->pid_file());
+}
+
+/**
+ * @brief Destroys the proxy environment.
+ * @internal
+ * The pid file is removed first so that new clients no longer connect to the
+ * proxy while it is shutting down.
+ * @endinternal
+ */
+void
+destroy_environment() {
+    gkfs::proxy::remove_pid_file();
+    PROXY_DATA->release_host_addrs();
+    if(PROXY_DATA->server_rpc_mid() != nullptr) {
+        PROXY_DATA->log()->info("{}() Finalizing margo RPC server", __func__);
+        margo_finalize(PROXY_DATA->server_rpc_mid());
+        PROXY_DATA->server_rpc_mid(nullptr);
+    }
+}
+
+/**
+ * @brief Handler for proxy shutdown signal handling.
+ * @param dummy unused but required by signal() called in main()
+ */
+void
+shutdown_handler(int dummy) {
+    PROXY_DATA->log()->info("{}() Received signal: '{}'", __func__,
+                            strsignal(dummy));
+    shutdown_please.notify_all();
+}
+
+/**
+ * @brief Initializes the proxy logging environment from the environment
+ * variables GKFS_PROXY_LOG_PATH and GKFS_PROXY_LOG_LEVEL.
+ */
+void
+initialize_loggers() {
+    std::string path = gkfs::env::get_var(PROXY_ENV_PREFIX "LOG_PATH",
+                                          gkfs::config::log::proxy_log_path);
+    spdlog::level::level_enum level =
+            gkfs::log::get_level(gkfs::config::log::proxy_log_level);
+    char* env_level = getenv(PROXY_ENV_PREFIX "LOG_LEVEL");
+    if(env_level != nullptr) {
+        level = gkfs::log::get_level(env_level);
+    }
+    gkfs::log::setup({"main"}, level, path);
+}
+
+/**
+ * @brief Parses command line arguments from user
+ *
+ * @param opts CLI values
+ * @param desc CLI allowed options
+ * @throws std::runtime_error if the hosts file cannot be read
+ */
+void
+parse_input(const cli_options& opts, const CLI::App& desc) {
+    if(desc.count("--hosts-file")) {
+        PROXY_DATA->hosts_file(opts.hosts_file);
+    } else {
+        PROXY_DATA->hosts_file(gkfs::env::get_var(gkfs::env::HOSTS_FILE,
+                                                  gkfs::config::hostfile_path));
+    }
+    PROXY_DATA->pid_file(desc.count("--pid-file")
+                                 ? opts.pid_file
+                                 : gkfs::config::proxy::pid_path);
+    if(desc.count("--stat-cache-ttl")) {
+        PROXY_DATA->stat_cache_ttl(
+                std::chrono::milliseconds(opts.stat_cache_ttl));
+    }
+
+    vector<double> weights{};
+    auto uris = gkfs::proxy::read_hosts_file(&weights);
+    PROXY_DATA->log()->info("{}() Read {} daemon(s) from hosts file '{}'",
+                            __func__, uris.size(), PROXY_DATA->hosts_file());
+    PROXY_DATA->host_uris(uris);
+    PROXY_DATA->host_weights(weights);
+
+    // The proxy uses the daemons' protocol as it forwards requests to them
+    string rpc_protocol = gkfs::rpc::protocol::na_sm;
+    for(const auto* protocol :
+        {gkfs::rpc::protocol::ofi_sockets, gkfs::rpc::protocol::ofi_tcp,
+         gkfs::rpc::protocol::ofi_psm2, gkfs::rpc::protocol::ofi_verbs}) {
+        if(uris.front().find(protocol) != string::npos) {
+            rpc_protocol = protocol;
+            break;
+        }
+    }
+    PROXY_DATA->rpc_protocol(rpc_protocol);
+    PROXY_DATA->bind_addr(desc.count("--listen")
+                                  ? fmt::format("{}://{}", rpc_protocol,
+                                                opts.listen)
+                                  : rpc_protocol);
+    PROXY_DATA->log()->info("{}() RPC protocol '{}' bind address '{}'",
+                            __func__, rpc_protocol, PROXY_DATA->bind_addr());
+}
+
+/**
+ * @brief The initial function called when launching the proxy.
+ * @internal
+ * Launches all subroutines and waits on a conditional variable to shut it down.
+ * Proxy will react to SIGINT and SIGTERM.
+ * @endinternal
+ * @param argc number of command line arguments
+ * @param argv list of the command line arguments
+ * @return exit status: EXIT_SUCCESS (0) or EXIT_FAILURE (1)
+ */
+int
+main(int argc, const char* argv[]) {
+    CLI::App desc{"Allowed options"};
+    cli_options opts{};
+    // clang-format off
+    desc.add_option("--hosts-file,-H", opts.hosts_file,
+                    "Path to the shared hosts file written by the daemons. "
+                    "Default: './gkfs_hosts.txt' or LIBGKFS_HOSTS_FILE.");
+    desc.add_option("--pid-file,-p", opts.pid_file,
+                    "Path to the file in which the proxy publishes its pid and "
+                    "address for the clients. Default: '/tmp/gkfs_proxy.pid'.");
+    desc.add_option("--listen,-l", opts.listen,
+                    "Address or interface to bind the proxy on.");
+    desc.add_option("--stat-cache-ttl", opts.stat_cache_ttl,
+                    "Time in milliseconds for which stat results are cached. "
+                    "0 disables the cache. Default: 1000.");
+    desc.add_flag("--version", "Print version and exit.");
+    // clang-format on
+    try {
+        desc.parse(argc, argv);
+    } catch(const CLI::ParseError& e) {
+        return desc.exit(e);
+    }
+
+    if(desc.count("--version")) {
+        cout << GKFS_VERSION_STRING << endl;
+        return EXIT_SUCCESS;
+    }
+    initialize_loggers();
+    PROXY_DATA->log(spdlog::get("main"));
+
+    try {
+        parse_input(opts, desc);
+        PROXY_DATA->log()->info("{}() Initializing environment", __func__);
+        init_environment();
+    } catch(const std::exception& e) {
+        auto emsg =
+                fmt::format("Failed to initialize environment: {}", e.what());
+        PROXY_DATA->log()->error(emsg);
+        cerr << emsg << endl;
+        destroy_environment();
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT, shutdown_handler);
+    signal(SIGTERM, shutdown_handler);
+
+    unique_lock<mutex> lk(mtx);
+    // Wait for shutdown signal to initiate shutdown protocols
+    shutdown_please.wait(lk);
+    PROXY_DATA->log()->info("{}() Shutting down...", __func__);
+    destroy_environment();
+    PROXY_DATA->log()->info("{}() Complete. Exiting...", __func__);
+    return EXIT_SUCCESS;
+}
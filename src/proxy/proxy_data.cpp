@@ -0,0 +1,275 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <proxy/proxy_data.hpp>
+
+#include <functional>
+
+using namespace std;
+
+namespace gkfs {
+
+namespace proxy {
+
+// Getter/Setter
+
+const std::shared_ptr<spdlog::logger>&
+ProxyData::log() const {
+    return spdlogger_;
+}
+
+void
+ProxyData::log(const std::shared_ptr<spdlog::logger>& log) {
+    ProxyData::spdlogger_ = log;
+}
+
+margo_instance*
+ProxyData::server_rpc_mid() {
+    return server_rpc_mid_;
+}
+
+void
+ProxyData::server_rpc_mid(margo_instance* server_rpc_mid) {
+    ProxyData::server_rpc_mid_ = server_rpc_mid;
+}
+
+const std::string&
+ProxyData::rpc_protocol() const {
+    return rpc_protocol_;
+}
+
+void
+ProxyData::rpc_protocol(const std::string& rpc_protocol) {
+    ProxyData::rpc_protocol_ = rpc_protocol;
+}
+
+bool
+ProxyData::use_auto_sm() const {
+    return use_auto_sm_;
+}
+
+void
+ProxyData::use_auto_sm(bool use_auto_sm) {
+    ProxyData::use_auto_sm_ = use_auto_sm;
+}
+
+const std::string&
+ProxyData::self_addr_str() const {
+    return self_addr_str_;
+}
+
+void
+ProxyData::self_addr_str(const std::string& addr_str) {
+    ProxyData::self_addr_str_ = addr_str;
+}
+
+const std::string&
+ProxyData::bind_addr() const {
+    return bind_addr_;
+}
+
+void
+ProxyData::bind_addr(const std::string& addr) {
+    ProxyData::bind_addr_ = addr;
+}
+
+const std::string&
+ProxyData::hosts_file() const {
+    return hosts_file_;
+}
+
+void
+ProxyData::hosts_file(const std::string& hosts_file) {
+    ProxyData::hosts_file_ = hosts_file;
+}
+
+const std::string&
+ProxyData::pid_file() const {
+    return pid_file_;
+}
+
+void
+ProxyData::pid_file(const std::string& pid_file) {
+    ProxyData::pid_file_ = pid_file;
+}
+
+const std::vector<std::string>&
+ProxyData::host_uris() const {
+    return host_uris_;
+}
+
+void
+ProxyData::host_uris(const std::vector<std::string>& host_uris) {
+    lock_guard<mutex> lock(host_mutex_);
+    ProxyData::host_uris_ = host_uris;
+    host_addrs_.assign(host_uris_.size(), HG_ADDR_NULL);
+}
+
+const std::vector<double>&
+ProxyData::host_weights() const {
+    return host_weights_;
+}
+
+void
+ProxyData::host_weights(const std::vector<double>& host_weights) {
+    ProxyData::host_weights_ = host_weights;
+}
+
+const std::shared_ptr<gkfs::rpc::Distributor>&
+ProxyData::distributor() const {
+    return distributor_;
+}
+
+void
+ProxyData::distributor(
+        const std::shared_ptr<gkfs::rpc::Distributor>& distributor) {
+    ProxyData::distributor_ = distributor;
+}
+
+void
+ProxyData::stat_cache_ttl(std::chrono::milliseconds ttl) {
+    ProxyData::stat_cache_ttl_ = ttl;
+}
+
+hg_addr_t
+ProxyData::host_addr(uint64_t host_id) {
+    string uri;
+    {
+        lock_guard<mutex> lock(host_mutex_);
+        if(host_id >= host_uris_.size()) {
+            spdlogger_->error(
+                    "{}() host id '{}' not in hosts file with '{}' entries",
+                    __func__, host_id, host_uris_.size());
+            return HG_ADDR_NULL;
+        }
+        if(host_addrs_[host_id] != HG_ADDR_NULL)
+            return host_addrs_[host_id];
+        uri = host_uris_[host_id];
+    }
+    // The lookup is done without holding the lock as it may yield to other
+    // ULTs
+    hg_addr_t addr = HG_ADDR_NULL;
+    auto ret = margo_addr_lookup(server_rpc_mid_, uri.c_str(), &addr);
+    if(ret != HG_SUCCESS) {
+        spdlogger_->error("{}() Failed to lookup address '{}'", __func__, uri);
+        return HG_ADDR_NULL;
+    }
+    lock_guard<mutex> lock(host_mutex_);
+    if(host_addrs_[host_id] != HG_ADDR_NULL) {
+        // another ULT was faster
+        margo_addr_free(server_rpc_mid_, addr);
+        return host_addrs_[host_id];
+    }
+    host_addrs_[host_id] = addr;
+    return addr;
+}
+
+void
+ProxyData::release_host_addrs() {
+    lock_guard<mutex> lock(host_mutex_);
+    for(auto& addr : host_addrs_) {
+        if(addr != HG_ADDR_NULL)
+            margo_addr_free(server_rpc_mid_, addr);
+    }
+    host_addrs_.assign(host_addrs_.size(), HG_ADDR_NULL);
+}
+
+std::optional<std::string>
+ProxyData::cached_stat(const std::string& path) {
+    if(stat_cache_ttl_.count() == 0)
+        return {};
+    lock_guard<mutex> lock(stat_cache_mutex_);
+    auto it = stat_cache_.find(path);
+    if(it == stat_cache_.end())
+        return {};
+    if(it->second.expiry < chrono::steady_clock::now()) {
+        stat_cache_.erase(it);
+        return {};
+    }
+    return it->second.metadata;
+}
+
+uint64_t&
+ProxyData::stat_generation_slot(const std::string& path) {
+    return stat_generations_[hash<string>{}(path) % stat_generations_.size()];
+}
+
+uint64_t
+ProxyData::stat_generation(const std::string& path) {
+    lock_guard<mutex> lock(stat_cache_mutex_);
+    return stat_generation_slot(path);
+}
+
+void
+ProxyData::cache_stat(const std::string& path, const std::string& metadata,
+                      uint64_t generation) {
+    if(stat_cache_ttl_.count() == 0)
+        return;
+    auto now = chrono::steady_clock::now();
+    lock_guard<mutex> lock(stat_cache_mutex_);
+    // modified while the stat was relayed
+    if(stat_generation_slot(path) != generation)
+        return;
+    if(stat_cache_.size() >= gkfs::config::proxy::stat_cache_size) {
+        for(auto it = stat_cache_.begin(); it != stat_cache_.end();) {
+            if(it->second.expiry < now)
+                it = stat_cache_.erase(it);
+            else
+                ++it;
+        }
+        // all entries are recent, start over
+        if(stat_cache_.size() >= gkfs::config::proxy::stat_cache_size)
+            stat_cache_.clear();
+    }
+    stat_cache_[path] = stat_entry{metadata, now + stat_cache_ttl_};
+}
+
+void
+ProxyData::invalidate_stat(const std::string& path) {
+    lock_guard<mutex> lock(stat_cache_mutex_);
+    stat_cache_.erase(path);
+    ++stat_generation_slot(path);
+}
+
+void
+ProxyData::invalidate_stat_subtree(const std::string& dir) {
+    auto prefix = dir.back() == '/' ? dir : dir + '/';
+    lock_guard<mutex> lock(stat_cache_mutex_);
+    for(auto it = stat_cache_.begin(); it != stat_cache_.end();) {
+        if(it->first == dir || it->first.compare(0, prefix.size(), prefix) == 0)
+            it = stat_cache_.erase(it);
+        else
+            ++it;
+    }
+    // paths below the directory hash to any slot
+    for(auto& generation : stat_generations_)
+        ++generation;
+}
+
+} // namespace proxy
+} // namespace gkfs
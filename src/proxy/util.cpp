@@ -0,0 +1,135 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+#include <proxy/util.hpp>
+
+#include <common/hosts_file.hpp>
+
+#include <cstring>
+#include <fstream>
+
+extern "C" {
+#include <unistd.h>
+}
+
+using namespace std;
+
+namespace gkfs::proxy {
+
+/**
+ * @internal
+ * Reads the daemon URIs from the shared hosts file with the parser shared with
+ * the client and daemons, so that host ids match theirs.
+ * @endinternal
+ * @param weights[out] if given, the daemons' weights indexed by host id
+ * @return daemon URIs indexed by host id
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+vector<string>
+read_hosts_file(vector<double>* weights) {
+    const auto& hosts_file = PROXY_DATA->hosts_file();
+    auto entries = gkfs::utils::parse_hosts_file(hosts_file);
+    if(entries.empty()) {
+        throw runtime_error(fmt::format("Hostfile empty: '{}'", hosts_file));
+    }
+    vector<string> uris{};
+    uris.reserve(entries.size());
+    if(weights)
+        weights->clear();
+    for(auto& e : entries) {
+        uris.emplace_back(std::move(e.uri));
+        if(weights)
+            weights->push_back(e.weight);
+    }
+    return uris;
+}
+
+/**
+ * @internal
+ * Publishes the proxy's pid and RPC address for the clients on this node. The
+ * first line holds the pid, the second line the address.
+ * @endinternal
+ * @throws std::runtime_error if the file cannot be written
+ */
+void
+write_pid_file() {
+    const auto& pid_file = PROXY_DATA->pid_file();
+    ofstream ofs(pid_file, ios::out | ios::trunc);
+    if(!ofs) {
+        throw runtime_error(fmt::format("Failed to open pid file '{}': {}",
+                                        pid_file, strerror(errno)));
+    }
+    ofs << getpid() << '\n' << PROXY_DATA->self_addr_str() << '\n';
+    if(!ofs) {
+        throw runtime_error(fmt::format("Failed to write pid file '{}': {}",
+                                        pid_file, strerror(errno)));
+    }
+}
+
+void
+remove_pid_file() {
+    if(::unlink(PROXY_DATA->pid_file().c_str()) != 0 && errno != ENOENT) {
+        PROXY_DATA->log()->warn("{}() Failed to remove pid file '{}': {}",
+                                __func__, PROXY_DATA->pid_file(),
+                                strerror(errno));
+    }
+}
+
+hg_return_t
+forward_to_daemon(const char* name, uint64_t host_id, void* in, void* out,
+                  hg_handle_t& handle) {
+    auto* mid = PROXY_DATA->server_rpc_mid();
+    hg_id_t rpc_id{};
+    hg_bool_t flag{};
+    auto ret = margo_registered_name(mid, name, &rpc_id, &flag);
+    if(ret != HG_SUCCESS || !flag) {
+        PROXY_DATA->log()->error("{}() RPC '{}' is not registered", __func__,
+                                 name);
+        return ret != HG_SUCCESS ? ret : HG_NOENTRY;
+    }
+    auto addr = PROXY_DATA->host_addr(host_id);
+    if(addr == HG_ADDR_NULL)
+        return HG_OTHER_ERROR;
+    handle = HG_HANDLE_NULL;
+    ret = margo_create(mid, addr, rpc_id, &handle);
+    if(ret != HG_SUCCESS)
+        return ret;
+    ret = margo_forward(handle, in);
+    if(ret == HG_SUCCESS)
+        ret = margo_get_output(handle, out);
+    if(ret != HG_SUCCESS) {
+        PROXY_DATA->log()->error("{}() Failed to forward '{}' to host '{}': {}",
+                                 __func__, name, host_id,
+                                 HG_Error_to_string(ret));
+        margo_destroy(handle);
+        handle = HG_HANDLE_NULL;
+    }
+    return ret;
+}
+
+} // namespace gkfs::proxy
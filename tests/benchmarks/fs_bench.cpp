@@ -0,0 +1,501 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+/*
+ * mdtest/IOR-style benchmark for a single node that does not require MPI.
+ *
+ * All phases run in a directory, e.g., below the GekkoFS mountdir with the
+ * client library preloaded, by a number of threads that start together at a
+ * barrier. A phase's time is the wall-clock time until the last thread is done.
+ *
+ * - create, stat, remove: each thread works on its own files in a shared
+ *   directory (mdtest -F -u like)
+ * - write/read, sequential and random, for each transfer size: each thread
+ *   works on its own file (IOR -F like), random offsets are a permutation of
+ *   the file's blocks
+ * - readdir: all threads list the same directory with many entries
+ * - append: all threads append fixed-size records to one shared file
+ *
+ * Results are written as JSON so that they can be compared between commits.
+ * Run gkfs_fs_bench -h for the options, or use gkfs_bench_local.sh, which
+ * starts daemons on localhost and runs this benchmark against them.
+ */
+
+#include <algorithm>
+#include <barrier>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+struct bench_options {
+    std::string dir;
+    std::string output;
+    std::string label;
+    unsigned int threads{1};
+    unsigned int repetitions{3};
+    unsigned long items{1000};
+    unsigned long entries{10000};
+    unsigned long appends{1000};
+    size_t append_size{4096};
+    size_t file_size{64UL * 1024 * 1024};
+    std::vector<size_t> xfer_sizes{4096, 64UL * 1024, 1024UL * 1024};
+    unsigned int seed{42};
+};
+
+struct bench_result {
+    std::string name;
+    std::string unit;
+    size_t xfer_size{0};
+    // work of one repetition, in operations or bytes depending on the unit
+    double work{0};
+    std::vector<double> seconds{};
+};
+
+[[noreturn]] void
+fail(const std::string& what, const std::string& path) {
+    std::fprintf(stderr, "gkfs_fs_bench: %s '%s' failed: %s\n", what.c_str(),
+                 path.c_str(), std::strerror(errno));
+    std::exit(EXIT_FAILURE);
+}
+
+/**
+ * Runs fn(thread_id) on all threads, which start at a common barrier, and
+ * returns the elapsed wall-clock time in seconds
+ */
+double
+run_threads(unsigned int threads, const std::function<void(unsigned int)>& fn) {
+    std::barrier start_barrier(threads + 1);
+    std::vector<std::thread> workers{};
+    workers.reserve(threads);
+    for(unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            start_barrier.arrive_and_wait();
+            fn(t);
+        });
+    }
+    start_barrier.arrive_and_wait();
+    auto start = std::chrono::steady_clock::now();
+    for(auto& w : workers) {
+        w.join();
+    }
+    std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+std::string
+item_path(const std::string& dir, unsigned int thread, unsigned long item) {
+    return dir + "/t" + std::to_string(thread) + ".f" + std::to_string(item);
+}
+
+void
+create_file(const std::string& path) {
+    auto fd = ::open(path.c_str(), O_CREAT | O_WRONLY | O_EXCL, 0644);
+    if(fd < 0)
+        fail("create", path);
+    ::close(fd);
+}
+
+void
+make_dir(const std::string& path) {
+    if(::mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+        fail("mkdir", path);
+}
+
+void
+bench_metadata(const bench_options& opts, std::vector<bench_result>& results) {
+    auto dir = opts.dir + "/md";
+    make_dir(dir);
+    bench_result create{"create", "ops/s"}, stat{"stat", "ops/s"},
+            remove{"remove", "ops/s"};
+    create.work = stat.work = remove.work =
+            static_cast<double>(opts.items) * opts.threads;
+
+    for(unsigned int rep = 0; rep < opts.repetitions; rep++) {
+        create.seconds.push_back(run_threads(opts.threads, [&](auto t) {
+            for(unsigned long i = 0; i < opts.items; i++)
+                create_file(item_path(dir, t, i));
+        }));
+        stat.seconds.push_back(run_threads(opts.threads, [&](auto t) {
+            struct stat st {};
+            for(unsigned long i = 0; i < opts.items; i++) {
+                auto path = item_path(dir, t, i);
+                if(::stat(path.c_str(), &st) != 0)
+                    fail("stat", path);
+            }
+        }));
+        remove.seconds.push_back(run_threads(opts.threads, [&](auto t) {
+            for(unsigned long i = 0; i < opts.items; i++) {
+                auto path = item_path(dir, t, i);
+                if(::unlink(path.c_str()) != 0)
+                    fail("unlink", path);
+            }
+        }));
+    }
+    ::rmdir(dir.c_str());
+    results.push_back(std::move(create));
+    results.push_back(std::move(stat));
+    results.push_back(std::move(remove));
+}
+
+/**
+ * Writes or reads a thread's file in transfer-sized blocks, in the given block
+ * order
+ */
+void
+file_io(const std::string& path, bool write, size_t xfer,
+        const std::vector<size_t>& blocks) {
+    auto fd = write ? ::open(path.c_str(), O_CREAT | O_WRONLY, 0644)
+                    : ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        fail("open", path);
+    std::vector<char> buf(xfer, 'g');
+    for(auto block : blocks) {
+        auto offset = static_cast<off_t>(block * xfer);
+        auto ret = write ? ::pwrite(fd, buf.data(), xfer, offset)
+                         : ::pread(fd, buf.data(), xfer, offset);
+        if(ret != static_cast<ssize_t>(xfer))
+            fail(write ? "pwrite" : "pread", path);
+    }
+    ::close(fd);
+}
+
+void
+bench_io(const bench_options& opts, std::vector<bench_result>& results) {
+    auto dir = opts.dir + "/io";
+    make_dir(dir);
+    for(auto xfer : opts.xfer_sizes) {
+        auto nblocks = std::max<size_t>(opts.file_size / xfer, 1);
+        std::vector<size_t> seq(nblocks);
+        std::iota(seq.begin(), seq.end(), 0);
+        // a different permutation per thread, but the same for every run
+        std::vector<std::vector<size_t>> rand(opts.threads, seq);
+        for(unsigned int t = 0; t < opts.threads; t++) {
+            std::mt19937_64 gen(opts.seed + t);
+            std::shuffle(rand[t].begin(), rand[t].end(), gen);
+        }
+        std::vector<bench_result> phases{{"write_seq", "MiB/s", xfer},
+                                         {"read_seq", "MiB/s", xfer},
+                                         {"write_rand", "MiB/s", xfer},
+                                         {"read_rand", "MiB/s", xfer}};
+        for(auto& p : phases)
+            p.work = static_cast<double>(nblocks * xfer) * opts.threads;
+
+        for(unsigned int rep = 0; rep < opts.repetitions; rep++) {
+            for(auto& p : phases) {
+                auto write = p.name.rfind("write", 0) == 0;
+                auto random = p.name.find("rand") != std::string::npos;
+                p.seconds.push_back(run_threads(opts.threads, [&](auto t) {
+                    file_io(item_path(dir, t, 0), write, xfer,
+                            random ? rand[t] : seq);
+                }));
+            }
+            for(unsigned int t = 0; t < opts.threads; t++) {
+                auto path = item_path(dir, t, 0);
+                if(::unlink(path.c_str()) != 0)
+                    fail("unlink", path);
+            }
+        }
+        for(auto& p : phases)
+            results.push_back(std::move(p));
+    }
+    ::rmdir(dir.c_str());
+}
+
+void
+bench_readdir(const bench_options& opts, std::vector<bench_result>& results) {
+    auto dir = opts.dir + "/readdir";
+    make_dir(dir);
+    run_threads(opts.threads, [&](auto t) {
+        for(auto i = t; i < opts.entries; i += opts.threads)
+            create_file(item_path(dir, 0, i));
+    });
+    bench_result readdir{"readdir", "entries/s"};
+    readdir.work = static_cast<double>(opts.entries) * opts.threads;
+    for(unsigned int rep = 0; rep < opts.repetitions; rep++) {
+        readdir.seconds.push_back(run_threads(opts.threads, [&](auto) {
+            auto* dirp = ::opendir(dir.c_str());
+            if(!dirp)
+                fail("opendir", dir);
+            unsigned long count = 0;
+            while(auto* dent = ::readdir(dirp)) {
+                if(std::strcmp(dent->d_name, ".") != 0 &&
+                   std::strcmp(dent->d_name, "..") != 0)
+                    count++;
+            }
+            ::closedir(dirp);
+            if(count != opts.entries) {
+                errno = EIO;
+                fail("readdir (entry count " + std::to_string(count) + ")",
+                     dir);
+            }
+        }));
+    }
+    run_threads(opts.threads, [&](auto t) {
+        for(auto i = t; i < opts.entries; i += opts.threads)
+            ::unlink(item_path(dir, 0, i).c_str());
+    });
+    ::rmdir(dir.c_str());
+    results.push_back(std::move(readdir));
+}
+
+void
+bench_append(const bench_options& opts, std::vector<bench_result>& results) {
+    auto path = opts.dir + "/append";
+    bench_result append{"append_shared", "ops/s", opts.append_size};
+    append.work = static_cast<double>(opts.appends) * opts.threads;
+    for(unsigned int rep = 0; rep < opts.repetitions; rep++) {
+        create_file(path);
+        append.seconds.push_back(run_threads(opts.threads, [&](auto) {
+            auto fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+            if(fd < 0)
+                fail("open", path);
+            std::vector<char> buf(opts.append_size, 'a');
+            for(unsigned long i = 0; i < opts.appends; i++) {
+                if(::write(fd, buf.data(), buf.size()) !=
+                   static_cast<ssize_t>(buf.size()))
+                    fail("append", path);
+            }
+            ::close(fd);
+        }));
+        // appends must not overwrite each other
+        struct stat st {};
+        if(::stat(path.c_str(), &st) != 0)
+            fail("stat", path);
+        if(static_cast<double>(st.st_size) !=
+           append.work * static_cast<double>(opts.append_size)) {
+            errno = EIO;
+            fail("append (file size " + std::to_string(st.st_size) + ")",
+                 path);
+        }
+        if(::unlink(path.c_str()) != 0)
+            fail("unlink", path);
+    }
+    results.push_back(std::move(append));
+}
+
+std::string
+json_escape(const std::string& s) {
+    std::string out{};
+    for(auto c : s) {
+        if(c == '"' || c == '\\') {
+            out.push_back('\\');
+            out.push_back(c);
+        } else if(static_cast<unsigned char>(c) < 0x20) {
+            char esc[8];
+            std::snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        } else {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+std::string
+to_json(const bench_options& opts, const std::vector<bench_result>& results) {
+    std::ostringstream os{};
+    os.precision(6);
+    os << "{\n"
+       << "  \"benchmark\": \"gkfs_fs_bench\",\n"
+       << "  \"label\": \"" << json_escape(opts.label) << "\",\n"
+       << "  \"timestamp\": " << std::time(nullptr) << ",\n"
+       << "  \"config\": {\n"
+       << "    \"dir\": \"" << json_escape(opts.dir) << "\",\n"
+       << "    \"threads\": " << opts.threads << ",\n"
+       << "    \"repetitions\": " << opts.repetitions << ",\n"
+       << "    \"items\": " << opts.items << ",\n"
+       << "    \"entries\": " << opts.entries << ",\n"
+       << "    \"appends\": " << opts.appends << ",\n"
+       << "    \"append_size\": " << opts.append_size << ",\n"
+       << "    \"file_size\": " << opts.file_size << "\n"
+       << "  },\n"
+       << "  \"results\": [";
+    for(size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        auto scale = r.unit == "MiB/s" ? 1024.0 * 1024.0 : 1.0;
+        std::vector<double> rates{};
+        for(auto s : r.seconds)
+            rates.push_back(s > 0 ? r.work / scale / s : 0);
+        auto [min, max] = std::minmax_element(rates.begin(), rates.end());
+        auto mean = std::accumulate(rates.begin(), rates.end(), 0.0) /
+                    static_cast<double>(rates.size());
+        os << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", "
+           << "\"xfer_size\": " << r.xfer_size << ", "
+           << "\"unit\": \"" << r.unit << "\", "
+           << "\"mean\": " << mean << ", \"min\": " << *min
+           << ", \"max\": " << *max << ", \"seconds\": [";
+        for(size_t j = 0; j < r.seconds.size(); j++)
+            os << (j ? ", " : "") << r.seconds[j];
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+    return os.str();
+}
+
+size_t
+parse_size(const std::string& s) {
+    size_t pos = 0;
+    auto value = std::stoull(s, &pos);
+    switch(pos < s.size() ? std::tolower(s[pos]) : 0) {
+        case 'g':
+            value *= 1024;
+            [[fallthrough]];
+        case 'm':
+            value *= 1024;
+            [[fallthrough]];
+        case 'k':
+            value *= 1024;
+            break;
+        default:
+            break;
+    }
+    return value;
+}
+
+void
+usage(const char* prog) {
+    std::printf(
+            "usage: %s -d <dir> [options]\n"
+            "  -d <dir>      directory in which the benchmark runs (required)\n"
+            "  -o <file>     JSON output file (default stdout)\n"
+            "  -l <label>    label stored with the results, e.g., a commit\n"
+            "  -t <threads>  number of threads (default 1)\n"
+            "  -i <reps>     repetitions of each phase (default 3)\n"
+            "  -n <items>    files per thread for create/stat/remove (default 1000)\n"
+            "  -e <entries>  directory entries for readdir (default 10000)\n"
+            "  -a <appends>  appends per thread to the shared file (default 1000)\n"
+            "  -A <size>     size of an append (default 4k)\n"
+            "  -b <size>     file size per thread for write/read (default 64m)\n"
+            "  -s <sizes>    comma-separated transfer sizes (default 4k,64k,1m)\n"
+            "  -S <seed>     seed of the random offsets (default 42)\n"
+            "  -P <phases>   comma-separated subset of md,io,readdir,append\n",
+            prog);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[]) {
+    bench_options opts{};
+    std::string phases{"md,io,readdir,append"};
+    int opt;
+    try {
+        while((opt = getopt(argc, argv, "d:o:l:t:i:n:e:a:A:b:s:S:P:h")) != -1) {
+            switch(opt) {
+                case 'd':
+                    opts.dir = optarg;
+                    break;
+                case 'o':
+                    opts.output = optarg;
+                    break;
+                case 'l':
+                    opts.label = optarg;
+                    break;
+                case 't':
+                    opts.threads = std::max(1UL, std::stoul(optarg));
+                    break;
+                case 'i':
+                    opts.repetitions = std::max(1UL, std::stoul(optarg));
+                    break;
+                case 'n':
+                    opts.items = std::stoul(optarg);
+                    break;
+                case 'e':
+                    opts.entries = std::stoul(optarg);
+                    break;
+                case 'a':
+                    opts.appends = std::stoul(optarg);
+                    break;
+                case 'A':
+                    opts.append_size = std::max<size_t>(parse_size(optarg), 1);
+                    break;
+                case 'b':
+                    opts.file_size = parse_size(optarg);
+                    break;
+                case 's': {
+                    opts.xfer_sizes.clear();
+                    std::istringstream is{optarg};
+                    for(std::string s; std::getline(is, s, ',');)
+                        opts.xfer_sizes.push_back(
+                                std::max<size_t>(parse_size(s), 1));
+                    break;
+                }
+                case 'S':
+                    opts.seed = std::stoul(optarg);
+                    break;
+                case 'P':
+                    phases = optarg;
+                    break;
+                case 'h':
+                    usage(argv[0]);
+                    return EXIT_SUCCESS;
+                default:
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+            }
+        }
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "gkfs_fs_bench: invalid argument: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    if(opts.dir.empty()) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    make_dir(opts.dir);
+
+    auto enabled = [&](const std::string& phase) {
+        return ("," + phases + ",").find("," + phase + ",") !=
+               std::string::npos;
+    };
+    std::vector<bench_result> results{};
+    if(enabled("md"))
+        bench_metadata(opts, results);
+    if(enabled("io"))
+        bench_io(opts, results);
+    if(enabled("readdir"))
+        bench_readdir(opts, results);
+    if(enabled("append"))
+        bench_append(opts, results);
+
+    auto json = to_json(opts, results);
+    if(opts.output.empty()) {
+        std::fputs(json.c_str(), stdout);
+    } else {
+        auto* f = std::fopen(opts.output.c_str(), "w");
+        if(!f)
+            fail("fopen", opts.output);
+        std::fputs(json.c_str(), f);
+        std::fclose(f);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+#!/usr/bin/env bash
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+usage_short() {
+    echo "
+usage: gkfs_bench_local.sh [-h] [-n <daemons>] [-P <protocol>] [-w <workdir>] [-o <output>]
+                           daemon_bin preload_lib bench_bin [-- bench_args]
+    "
+}
+
+help_msg() {
+
+    usage_short
+    echo "
+This script starts GekkoFS daemons on localhost, runs gkfs_fs_bench against them with the client library preloaded,
+and shuts the daemons down again. Results are written as JSON.
+
+positional arguments:
+    daemon_bin      path to the gkfs_daemon binary
+    preload_lib     path to the libgkfs_intercept.so client library
+    bench_bin       path to the gkfs_fs_bench binary
+    bench_args      arguments passed on to gkfs_fs_bench, e.g., -t 4 -n 5000
+
+
+optional arguments:
+    -h, --help      shows this help message and exits
+    -n              number of daemons started on localhost (defaults to 1)
+    -P              RPC protocol of the daemons, e.g., ofi+sockets, ofi+tcp, or na+sm (defaults to ofi+sockets)
+    -l              interface the daemons listen on for ofi protocols (defaults to lo)
+    -d              metadata backend of the daemons (defaults to rocksdb)
+    -w              work directory for the daemons' rootdir, mountdir, hostsfile, and logs (defaults to /dev/shm/gkfs_bench)
+    -o              JSON output file (defaults to stdout)
+    -L              label stored with the results (defaults to the output of git describe)
+    "
+}
+
+NUM_DAEMONS=1
+PROTOCOL="ofi+sockets"
+LISTEN="lo"
+DBBACKEND="rocksdb"
+WORKDIR="/dev/shm/gkfs_bench"
+OUTPUT=""
+LABEL=""
+POSITIONAL=()
+BENCH_ARGS=()
+while [[ $# -gt 0 ]]; do
+    key="$1"
+
+    case ${key} in
+    -n)
+        NUM_DAEMONS="$2"
+        shift 2
+        ;;
+    -P)
+        PROTOCOL="$2"
+        shift 2
+        ;;
+    -l)
+        LISTEN="$2"
+        shift 2
+        ;;
+    -d)
+        DBBACKEND="$2"
+        shift 2
+        ;;
+    -w)
+        WORKDIR="$2"
+        shift 2
+        ;;
+    -o)
+        OUTPUT="$2"
+        shift 2
+        ;;
+    -L)
+        LABEL="$2"
+        shift 2
+        ;;
+    -h | --help)
+        help_msg
+        exit
+        ;;
+    --)
+        shift
+        BENCH_ARGS=("$@")
+        break
+        ;;
+    *)
+        POSITIONAL+=("$1")
+        shift
+        ;;
+    esac
+done
+
+if [[ ${#POSITIONAL[@]} -ne 3 ]]; then
+    echo "ERROR: Missing positional arguments"
+    usage_short
+    exit 1
+fi
+DAEMON_BIN=$(readlink -f "${POSITIONAL[0]}")
+PRELOAD_LIB=$(readlink -f "${POSITIONAL[1]}")
+BENCH_BIN=$(readlink -f "${POSITIONAL[2]}")
+if [[ -z ${LABEL} ]]; then
+    LABEL=$(git -C "$(dirname "$0")" describe --always --dirty 2> /dev/null)
+fi
+
+ROOTDIR="${WORKDIR}/rootdir"
+MOUNTDIR="${WORKDIR}/mountdir"
+HOSTSFILE="${WORKDIR}/gkfs_hosts.txt"
+DAEMON_PIDS=()
+
+#######################################
+# Stops all started daemons and removes their data
+#######################################
+stop_daemons() {
+    for pid in "${DAEMON_PIDS[@]}"; do
+        kill -s SIGINT "${pid}" 2> /dev/null
+    done
+    for pid in "${DAEMON_PIDS[@]}"; do
+        wait "${pid}" 2> /dev/null
+    done
+    rm -rf "${ROOTDIR}" "${HOSTSFILE}"
+}
+trap stop_daemons EXIT
+
+rm -rf "${ROOTDIR}" "${HOSTSFILE}"
+mkdir -p "${ROOTDIR}" "${MOUNTDIR}" || exit 1
+
+DAEMON_ARGS=(-r "${ROOTDIR}" -m "${MOUNTDIR}" -H "${HOSTSFILE}" -P "${PROTOCOL}" -d "${DBBACKEND}")
+if [[ ${PROTOCOL} == ofi+* ]]; then
+    DAEMON_ARGS+=(-l "${LISTEN}")
+fi
+for ((i = 0; i < NUM_DAEMONS; i++)); do
+    GKFS_DAEMON_LOG_PATH="${WORKDIR}/gkfs_daemon_${i}.log" \
+        "${DAEMON_BIN}" "${DAEMON_ARGS[@]}" -s "daemon${i}" > /dev/null 2>&1 &
+    DAEMON_PIDS+=($!)
+done
+
+# wait until all daemons registered in the hostsfile
+wait_cnt=0
+until [[ $(($(wc -l "${HOSTSFILE}" 2> /dev/null | awk '{print $1}') + 0)) -eq ${NUM_DAEMONS} ]]; do
+    sleep 1
+    wait_cnt=$((wait_cnt + 1))
+    if [[ ${wait_cnt} -gt 60 ]]; then
+        echo "ERROR: Daemons failed to start. See ${WORKDIR}/gkfs_daemon_*.log"
+        exit 1
+    fi
+done
+
+OUTPUT_ARGS=()
+if [[ -n ${OUTPUT} ]]; then
+    OUTPUT_ARGS=(-o "${OUTPUT}")
+fi
+LIBGKFS_HOSTS_FILE="${HOSTSFILE}" LIBGKFS_LOG=errors LIBGKFS_LOG_OUTPUT="${WORKDIR}/gkfs_client.log" \
+    LD_PRELOAD="${PRELOAD_LIB}" "${BENCH_BIN}" -d "${MOUNTDIR}/bench" -l "${LABEL}" "${OUTPUT_ARGS[@]}" "${BENCH_ARGS[@]}"
@@ -0,0 +1,142 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+/*
+ * Measures the cost of syscalls on file descriptors that do not belong to
+ * GekkoFS, e.g., /dev/null or a pipe, which the interception library must pass
+ * on to the kernel.
+ *
+ * Each syscall is issued through libc, which is intercepted if the library is
+ * preloaded, and, on x86_64, through a raw syscall instruction in this binary,
+ * which syscall_intercept does not patch. The difference is the per-syscall
+ * overhead of the preload library. Without LD_PRELOAD, both columns match.
+ *
+ * Usage: gkfs_syscall_overhead [iterations]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+#if defined(__x86_64__)
+long
+raw_syscall(long number, long arg0, long arg1, long arg2) {
+    long ret;
+    asm volatile("syscall"
+                 : "=a"(ret)
+                 : "a"(number), "D"(arg0), "S"(arg1), "d"(arg2)
+                 : "rcx", "r11", "memory");
+    return ret;
+}
+#endif
+
+double
+ns_per_op(unsigned long iterations, const std::function<void()>& op) {
+    // warm up caches and the interception library's lazy initialization
+    for(unsigned long i = 0; i < iterations / 10; i++) {
+        op();
+    }
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned long i = 0; i < iterations; i++) {
+        op();
+    }
+    std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void
+report(const char* name, unsigned long iterations,
+       const std::function<void()>& libc_op,
+       const std::function<void()>& raw_op) {
+    auto libc_ns = ns_per_op(iterations, libc_op);
+#if defined(__x86_64__)
+    auto raw_ns = ns_per_op(iterations, raw_op);
+    std::printf("%-8s %12.1f %12.1f %12.1f\n", name, libc_ns, raw_ns,
+                libc_ns - raw_ns);
+#else
+    std::printf("%-8s %12.1f %12s %12s\n", name, libc_ns, "-", "-");
+#endif
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[]) {
+    unsigned long iterations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    auto null_fd = open("/dev/null", O_RDWR);
+    auto zero_fd = open("/dev/zero", O_RDONLY);
+    int pipe_fds[2];
+    if(null_fd < 0 || zero_fd < 0 || pipe(pipe_fds) != 0) {
+        std::perror("gkfs_syscall_overhead");
+        return EXIT_FAILURE;
+    }
+    char buf[1];
+    struct stat st {};
+
+    // the interception library exports gkfs_* functions
+    auto preloaded = dlsym(RTLD_DEFAULT, "gkfs_getsingleserverdir") != nullptr;
+    std::printf("# iterations: %lu, GekkoFS preloaded: %s\n", iterations,
+                preloaded ? "yes" : "no");
+    std::printf("%-8s %12s %12s %12s\n", "# syscall", "libc [ns]", "raw [ns]",
+                "overhead");
+
+    report(
+            "read", iterations, [&] { (void) read(zero_fd, buf, 1); },
+            [&] {
+#if defined(__x86_64__)
+                raw_syscall(SYS_read, zero_fd, reinterpret_cast<long>(buf), 1);
+#endif
+            });
+    report(
+            "write", iterations, [&] { (void) write(null_fd, buf, 1); },
+            [&] {
+#if defined(__x86_64__)
+                raw_syscall(SYS_write, null_fd, reinterpret_cast<long>(buf), 1);
+#endif
+            });
+    report(
+            "lseek", iterations, [&] { (void) lseek(null_fd, 0, SEEK_SET); },
+            [&] {
+#if defined(__x86_64__)
+                raw_syscall(SYS_lseek, null_fd, 0, SEEK_SET);
+#endif
+            });
+    // glibc's fstat() may issue newfstatat or statx, so call SYS_fstat directly
+    report(
+            "fstat", iterations,
+            [&] { (void) syscall(SYS_fstat, pipe_fds[0], &st); },
+            [&] {
+#if defined(__x86_64__)
+                raw_syscall(SYS_fstat, pipe_fds[0],
+                            reinterpret_cast<long>(&st), 0);
+#endif
+            });
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(zero_fd);
+    close(null_fd);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import json
+import pytest
+from harness.logger import logger
+
+io_phases = ['write_seq', 'read_seq', 'write_rand', 'read_rand']
+
+def check_result(result, name, unit, repetitions):
+    assert result['name'] == name
+    assert result['unit'] == unit
+    assert len(result['seconds']) == repetitions
+    assert all(s > 0 for s in result['seconds'])
+    assert 0 < result['min'] <= result['mean'] <= result['max']
+
+def test_fs_bench_smoke(gkfs_daemon, gkfs_shell, gkfs_client):
+    """
+    Run all phases of gkfs_fs_bench on GekkoFS with small parameters and check
+    its JSON output.
+    """
+
+    benchdir = gkfs_daemon.mountdir / 'bench'
+    output = gkfs_shell.cwd / 'fs_bench.json'
+
+    logger.info("running gkfs_fs_bench")
+    cmd = gkfs_shell.gkfs_fs_bench(
+            '-d', benchdir,
+            '-o', output,
+            '-l', 'smoke',
+            '-t', 2,
+            '-i', 2,
+            '-n', 16,
+            '-e', 32,
+            '-a', 16,
+            '-A', '1k',
+            '-b', '1m',
+            '-s', '64k,512k',
+            timeout=300)
+    assert cmd.exit_code == 0
+
+    with open(output) as f:
+        bench = json.load(f)
+
+    assert bench['benchmark'] == 'gkfs_fs_bench'
+    assert bench['label'] == 'smoke'
+    assert bench['config'] == {
+            'dir': str(benchdir),
+            'threads': 2,
+            'repetitions': 2,
+            'items': 16,
+            'entries': 32,
+            'appends': 16,
+            'append_size': 1024,
+            'file_size': 1024 * 1024 }
+
+    results = bench['results']
+    assert [r['name'] for r in results] == \
+            ['create', 'stat', 'remove'] + io_phases * 2 + \
+            ['readdir', 'append_shared']
+
+    for r in results[:3]:
+        check_result(r, r['name'], 'ops/s', 2)
+
+    for r, xfer in zip(results[3:11], [64 * 1024] * 4 + [512 * 1024] * 4):
+        check_result(r, r['name'], 'MiB/s', 2)
+        assert r['xfer_size'] == xfer
+
+    check_result(results[11], 'readdir', 'entries/s', 2)
+    check_result(results[12], 'append_shared', 'ops/s', 2)
+    assert results[12]['xfer_size'] == 1024
+
+    # the benchmark removes all files it created
+    ret = gkfs_client.readdir(benchdir)
+    assert len(ret.dirents) == 0
+
+@pytest.mark.parametrize("phases,expected", [
+    ('md', ['create', 'stat', 'remove']),
+    ('readdir,append', ['readdir', 'append_shared']),
+    ('io', io_phases)])
+def test_fs_bench_phases(gkfs_daemon, gkfs_shell, phases, expected):
+    """
+    Run a subset of the gkfs_fs_bench phases and check the JSON output written
+    to stdout.
+    """
+
+    cmd = gkfs_shell.gkfs_fs_bench(
+            '-d', gkfs_daemon.mountdir / 'bench',
+            '-P', phases,
+            '-i', 1,
+            '-n', 8,
+            '-e', 8,
+            '-a', 8,
+            '-b', '256k',
+            '-s', '64k',
+            timeout=300)
+    assert cmd.exit_code == 0
+
+    bench = json.loads(cmd.stdout.decode())
+    assert [r['name'] for r in bench['results']] == expected
+    for r in bench['results']:
+        assert len(r['seconds']) == 1
@@ -27,6 +27,7 @@
 ################################################################################
 
 import pytest
+import sh
 import logging
 from collections import namedtuple
 from _pytest.logging import caplog as _caplog
@@ -34,7 +35,7 @@ from pathlib import Path
 from harness.logger import logger, initialize_logging, finalize_logging
 from harness.cli import add_cli_options, set_default_log_formatter
 from harness.workspace import Workspace, FileCreator
-from harness.gkfs import Daemon, Client, ShellClient, FwdDaemon, FwdClient, ShellFwdClient, FwdDaemonCreator, FwdClientCreator
+from harness.gkfs import Daemon, Client, ShellClient, FwdDaemon, FwdClient, ShellFwdClient, FwdDaemonCreator, FwdClientCreator, DaemonCreator, Proxy
 from harness.reporter import report_test_status, report_test_headline, report_assertion_pass
 
 def pytest_configure(config):
@@ -118,10 +119,66 @@ def gkfs_daemon_parallaxdb(test_workspace, request):
     yield daemon.run()
     daemon.shutdown()
 
+@pytest.fixture
+def gkfs_daemon_memorydb(test_workspace, request):
+    """
+    Initializes a local gekkofs daemon
+    """
+
+    interface = request.config.getoption('--interface')
+    daemon = Daemon(interface, "memorydb", test_workspace)
+
+    yield daemon.run()
+    daemon.shutdown()
+
+@pytest.fixture
+def gkfs_daemon_parent_keys(test_workspace, request):
+    """
+    Initializes a local gekkofs daemon whose RocksDB keys are encoded as
+    (parent, name)
+    """
+
+    interface = request.config.getoption('--interface')
+    dbconfig = test_workspace.twd / 'dbconfig'
+    dbconfig.write_text('use_parent_keys = true\n')
+    daemon = Daemon(interface, "rocksdb", test_workspace, dbconfig=dbconfig)
+
+    yield daemon.run()
+    daemon.shutdown()
+
 @pytest.fixture(params=['gkfs_daemon_rocksdb'])
 def gkfs_daemon(request):
     return request.getfixturevalue(request.param)
 
+@pytest.fixture
+def gkfs_daemon_factory(test_workspace, request):
+    """
+    Returns a factory that can create several gekkofs daemons sharing
+    the test workspace. The daemons are shut down at teardown.
+    """
+
+    interface = request.config.getoption('--interface')
+    factory = DaemonCreator(interface, "rocksdb", test_workspace)
+
+    yield factory
+    factory.shutdown()
+
+@pytest.fixture
+def gkfs_proxy(test_workspace, gkfs_daemon):
+    """
+    Initializes a node-local gekkofs proxy for a co-running daemon. Its stat
+    cache does not expire during a test. Tests using it are skipped if the
+    proxy was not built.
+    """
+
+    try:
+        proxy = Proxy(test_workspace, stat_cache_ttl=600000)
+    except sh.CommandNotFound:
+        pytest.skip("gkfs_proxy not available")
+
+    yield proxy.run()
+    proxy.shutdown()
+
 
 @pytest.fixture
 def gkfs_client(test_workspace):
@@ -0,0 +1,115 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import errno
+import os
+import stat
+
+# default chunk size of the daemon, see gkfs::config::rpc::chunksize
+default_chunk_size = 512 * 1024
+
+
+def create_file(client, file):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+
+def test_set_get_chunk_size(gkfs_daemon, gkfs_client):
+    """The chunk size of a file can be changed as long as it is empty."""
+    file = gkfs_daemon.mountdir / "file"
+    create_file(gkfs_client, file)
+
+    ret = gkfs_client.chunk_size(file)
+    assert ret.retval == default_chunk_size
+
+    ret = gkfs_client.chunk_size(file, '--set', 64 * 1024)
+    assert ret.retval == 64 * 1024
+
+    ret = gkfs_client.chunk_size(file)
+    assert ret.retval == 64 * 1024
+
+    # out of [min_chunksize, max_chunksize]
+    ret = gkfs_client.chunk_size(file, '--set', 1024)
+    assert ret.retval == -1
+    assert ret.errno == errno.EINVAL
+
+    # data is written with the new chunk size and over multiple chunks
+    buf_length = 256 * 1024
+    ret = gkfs_client.write_validate(file, buf_length)
+    assert ret.retval == 1
+
+    # the file's chunks would no longer be found
+    ret = gkfs_client.chunk_size(file, '--set', 128 * 1024)
+    assert ret.retval == -1
+    assert ret.errno == errno.EBUSY
+
+    ret = gkfs_client.chunk_size(file)
+    assert ret.retval == 64 * 1024
+
+    ret = gkfs_client.chunk_size(gkfs_daemon.mountdir / "missing")
+    assert ret.retval == -1
+    assert ret.errno == errno.ENOENT
+
+
+def test_inherit_chunk_size(gkfs_daemon, gkfs_client):
+    """Files and directories inherit the chunk size of their parent."""
+    topdir = gkfs_daemon.mountdir / "dir"
+    subdir = topdir / "sub"
+    file = subdir / "file"
+    other = gkfs_daemon.mountdir / "other"
+
+    ret = gkfs_client.mkdir(topdir, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval == 0
+
+    ret = gkfs_client.chunk_size(topdir, '--set', 1024 * 1024)
+    assert ret.retval == 1024 * 1024
+
+    ret = gkfs_client.mkdir(subdir, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval == 0
+
+    ret = gkfs_client.chunk_size(subdir)
+    assert ret.retval == 1024 * 1024
+
+    create_file(gkfs_client, file)
+    ret = gkfs_client.chunk_size(file)
+    assert ret.retval == 1024 * 1024
+
+    # files outside of the directory keep the default
+    create_file(gkfs_client, other)
+    ret = gkfs_client.chunk_size(other)
+    assert ret.retval == default_chunk_size
+
+    buf_length = 3 * 1024 * 1024
+    ret = gkfs_client.write_validate(file, buf_length)
+    assert ret.retval == 1
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == buf_length
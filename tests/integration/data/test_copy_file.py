@@ -0,0 +1,135 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import os
+import stat
+
+# default chunk size of the daemon, see gkfs::config::rpc::chunksize
+chunk_size = 512 * 1024
+
+
+def create_random_file(client, file, length):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    ret = client.write_random(file, length)
+    assert ret.retval == length
+
+
+def test_copy_file_range(gkfs_daemon, gkfs_client):
+    """A file spanning multiple chunks is copied by the daemons."""
+    src = gkfs_daemon.mountdir / "src"
+    dst = gkfs_daemon.mountdir / "dst"
+    length = 3 * chunk_size + 4321
+    create_random_file(gkfs_client, src, length)
+
+    ret = gkfs_client.copy_file(src, dst, length)
+    assert ret.retval == length
+
+    ret = gkfs_client.stat(dst)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == length
+
+    ret = gkfs_client.file_compare(src, dst, length)
+    assert ret.retval == 0
+
+    # copying beyond the end of the source file is cut short
+    other = gkfs_daemon.mountdir / "other"
+    ret = gkfs_client.copy_file(src, other, 2 * length)
+    assert ret.retval == length
+
+
+def test_copy_file_range_offsets(gkfs_daemon, gkfs_client):
+    """Unaligned source and destination ranges crossing chunk boundaries."""
+    src = gkfs_daemon.mountdir / "src"
+    dst = gkfs_daemon.mountdir / "dst"
+    buf = b'0123456789' * 100
+    src_offset = chunk_size - 500
+    dst_offset = 2 * chunk_size - 250
+
+    ret = gkfs_client.open(src,
+                           os.O_CREAT | os.O_WRONLY,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    ret = gkfs_client.pwrite(src, buf, len(buf), src_offset)
+    assert ret.retval == len(buf)
+
+    ret = gkfs_client.copy_file(src, dst, len(buf),
+                                '--src-offset', src_offset,
+                                '--dst-offset', dst_offset)
+    assert ret.retval == len(buf)
+
+    ret = gkfs_client.stat(dst)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == dst_offset + len(buf)
+
+    ret = gkfs_client.pread(dst, len(buf), dst_offset)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
+
+    # the hole in front of the copied range reads as zeros
+    ret = gkfs_client.pread(dst, 100, dst_offset - 100)
+    assert ret.retval == 100
+    assert ret.buf == bytes(100)
+
+
+def test_sendfile(gkfs_daemon, gkfs_client):
+    """sendfile() between two GekkoFS files is served by the daemons."""
+    src = gkfs_daemon.mountdir / "src"
+    dst = gkfs_daemon.mountdir / "dst"
+    length = 2 * chunk_size + 1234
+    create_random_file(gkfs_client, src, length)
+
+    ret = gkfs_client.copy_file(src, dst, length, '--sendfile')
+    assert ret.retval == length
+
+    ret = gkfs_client.stat(dst)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == length
+
+    ret = gkfs_client.file_compare(src, dst, length)
+    assert ret.retval == 0
+
+
+def test_sendfile_to_external_file(gkfs_daemon, gkfs_client):
+    """sendfile() from a GekkoFS file to a file outside of GekkoFS."""
+    src = gkfs_daemon.mountdir / "src"
+    dst = gkfs_daemon.cwd / "external_dst"
+    length = chunk_size + 789
+    create_random_file(gkfs_client, src, length)
+
+    ret = gkfs_client.copy_file(src, dst, length, '--sendfile')
+    assert ret.retval == length
+
+    assert os.stat(dst).st_size == length
+
+    ret = gkfs_client.file_compare(src, dst, length)
+    assert ret.retval == 0
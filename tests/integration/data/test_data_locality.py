@@ -0,0 +1,101 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import os
+import stat
+
+
+def test_data_locality(gkfs_daemon, gkfs_client):
+    """Files created with LIBGKFS_DATA_LOCALITY store all chunks on the local
+    daemon. Their data must be readable, truncatable, and removable.
+    """
+    gkfs_client.setenv('LIBGKFS_DATA_LOCALITY', '1')
+    file = gkfs_daemon.mountdir / "file_local"
+
+    ret = gkfs_client.open(file,
+                           os.O_CREAT | os.O_WRONLY,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    # write over multiple chunks
+    buf_length = 2 * 1024 * 1024
+    ret = gkfs_client.write_validate(file, buf_length)
+    assert ret.retval == 1
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == buf_length
+
+    ret = gkfs_client.truncate(file, buf_length // 2)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.statbuf.st_size == buf_length // 2
+
+    ret = gkfs_client.unlink(file)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == -1
+
+
+def test_data_locality_two_daemons(gkfs_daemon_factory, gkfs_client):
+    """With two daemons, all chunks of a file created with
+    LIBGKFS_DATA_LOCALITY are stored on the local daemon only. Both daemons
+    share the node, the client picks the first one, i.e., host '0'.
+    """
+    local = gkfs_daemon_factory.create()
+    remote = gkfs_daemon_factory.create()
+
+    gkfs_client.setenv('LIBGKFS_DATA_LOCALITY', '1')
+    file = local.mountdir / "file_local"
+
+    ret = gkfs_client.open(file,
+                           os.O_CREAT | os.O_WRONLY,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    # write over multiple chunks
+    buf_length = 2 * 1024 * 1024
+    ret = gkfs_client.write_validate(file, buf_length)
+    assert ret.retval == 1
+
+    local_chunks = local.datadir / "chunks" / "file_local"
+    remote_chunks = remote.datadir / "chunks" / "file_local"
+
+    assert local_chunks.is_dir()
+    assert len(list(local_chunks.iterdir())) > 1
+    assert not remote_chunks.exists()
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == buf_length
+
+    ret = gkfs_client.unlink(file)
+    assert ret.retval == 0
+    assert not local_chunks.exists()
@@ -0,0 +1,132 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+import errno
+import os
+import stat
+
+# default chunk size of the daemon, see gkfs::config::rpc::chunksize
+chunk_size = 512 * 1024
+
+
+def chunk_ids(daemon, name):
+    """Returns the sorted chunk ids stored for a file on a daemon."""
+    chunk_dir = daemon.datadir / "chunks" / name
+    if not chunk_dir.exists():
+        return []
+    return sorted(int(c.name) for c in chunk_dir.iterdir())
+
+
+def create_file(client, file, buf):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    if buf:
+        ret = client.pwrite(file, buf, len(buf), 0)
+        assert ret.retval == len(buf)
+
+
+def test_fallocate(gkfs_daemon, gkfs_client):
+    """The default mode allocates the chunks of a range and extends the file,
+    but never shrinks it."""
+    file = gkfs_daemon.mountdir / "file"
+    buf = b'42'
+    create_file(gkfs_client, file, buf)
+
+    offset = chunk_size - 100
+    length = chunk_size + 200
+    ret = gkfs_client.fallocate(file, offset, length)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == offset + length
+    assert chunk_ids(gkfs_daemon, "file") == [0, 1, 2]
+
+    ret = gkfs_client.pread(file, len(buf), 0)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
+
+    ret = gkfs_client.fallocate(file, 0, 10)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == offset + length
+
+
+def test_fallocate_keep_size(gkfs_daemon, gkfs_client):
+    """FALLOC_FL_KEEP_SIZE allocates the chunks of a range only."""
+    file = gkfs_daemon.mountdir / "file"
+    create_file(gkfs_client, file, b'')
+
+    ret = gkfs_client.fallocate(file, 0, 2 * chunk_size, '--keep-size')
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == 0
+    assert chunk_ids(gkfs_daemon, "file") == [0, 1]
+
+    # the file can be written as usual
+    buf = b'42'
+    ret = gkfs_client.pwrite(file, buf, len(buf), chunk_size)
+    assert ret.retval == len(buf)
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == chunk_size + len(buf)
+
+
+def test_fallocate_errors(gkfs_daemon, gkfs_client):
+    """Unsupported modes, empty ranges, read-only files and ranges beyond the
+    maximum file size are refused."""
+    file = gkfs_daemon.mountdir / "file"
+    create_file(gkfs_client, file, b'42')
+
+    ret = gkfs_client.fallocate(file, 0, 10, '--punch-hole', '--keep-size')
+    assert ret.retval == -1
+    assert ret.errno == errno.EOPNOTSUPP
+
+    ret = gkfs_client.fallocate(file, 0, 0)
+    assert ret.retval == -1
+    assert ret.errno == errno.EINVAL
+
+    ret = gkfs_client.fallocate(file, 0, 10, '--rdonly')
+    assert ret.retval == -1
+    assert ret.errno == errno.EBADF
+
+    # the end of the range overflows the file size
+    ret = gkfs_client.fallocate(file, 2**63 - 10, 20)
+    assert ret.retval == -1
+    assert ret.errno == errno.EFBIG
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == 2
+    assert chunk_ids(gkfs_daemon, "file") == [0]
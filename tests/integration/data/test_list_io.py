@@ -0,0 +1,68 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import errno
+import pytest
+
+# default chunk size of the daemon, see gkfs::config::rpc::chunksize
+chunk_size = 512 * 1024
+# see gkfs::config::rpc::max_list_extents
+max_list_extents = 64 * 1024
+
+
+@pytest.mark.parametrize("segments,length,stride", [
+    (1, 4096, 4096),
+    (16, 1000, 4096),
+    # segments crossing chunk boundaries
+    (8, chunk_size // 2, chunk_size - 1000),
+    (4, 3 * chunk_size, 4 * chunk_size),
+])
+def test_list_io(gkfs_daemon, gkfs_client, segments, length, stride):
+    """Non-contiguous segments written with gkfs_write_list() are read back
+    with gkfs_read_list()."""
+    file = gkfs_daemon.mountdir / "file"
+
+    ret = gkfs_client.list_io(file, segments, length, stride)
+    assert ret.retval == segments * length
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == (segments - 1) * stride + length
+
+
+def test_list_io_limits(gkfs_daemon, gkfs_client):
+    """Requests with more extents for a daemon than it accepts are rejected."""
+    file = gkfs_daemon.mountdir / "file"
+
+    # all extents are in the first chunk and go to a single daemon
+    ret = gkfs_client.list_io(file, max_list_extents + 1, 1, 2)
+    assert ret.retval == -1
+    assert ret.errno == errno.EINVAL
+
+    ret = gkfs_client.list_io(file, max_list_extents, 1, 2)
+    assert ret.retval == max_list_extents
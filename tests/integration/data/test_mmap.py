@@ -0,0 +1,140 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+import os
+import stat
+import pytest
+
+# the tests assume the usual page size
+page_size = 4096
+
+
+def create_file(client, file, length):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    ret = client.write_random(file, length)
+    assert ret.retval == length
+
+
+def test_mmap_write_munmap(gkfs_daemon, gkfs_client):
+    """Data written to a shared mapping is written back by munmap()."""
+    file = gkfs_daemon.mountdir / "file"
+    length = 3 * page_size
+    create_file(gkfs_client, file, length)
+
+    buf = b'mapped'
+    offset = page_size - 3
+    ret = gkfs_client.mmap_write(file, length, offset, buf)
+    assert ret.retval == 0
+
+    ret = gkfs_client.pread(file, len(buf), offset)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
+
+    # the mapping does not change the file size
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == length
+
+
+def test_mmap_writeback_dirty_pages(gkfs_daemon, gkfs_client):
+    """Pages not modified through a mapping are not written back, so they
+    do not overwrite writes made through the file descriptor meanwhile."""
+    file = gkfs_daemon.mountdir / "file"
+    length = 4 * page_size
+    create_file(gkfs_client, file, length)
+
+    buf = b'mapped'
+    external = b'external'
+    external_offset = 3 * page_size + 10
+    ret = gkfs_client.mmap_write(file, length, 100, buf,
+                                 '--external-offset', external_offset,
+                                 '--external-data', external)
+    assert ret.retval == 0
+
+    ret = gkfs_client.pread(file, len(buf), 100)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
+
+    ret = gkfs_client.pread(file, len(external), external_offset)
+    assert ret.retval == len(external)
+    assert ret.buf == external
+
+
+@pytest.mark.parametrize("fixed", ["file", "anonymous"])
+def test_mmap_fixed_replacement(gkfs_daemon, gkfs_client, fixed):
+    """A MAP_FIXED mapping over a written mapping writes it back first."""
+    file = gkfs_daemon.mountdir / "file"
+    length = 2 * page_size
+    create_file(gkfs_client, file, length)
+
+    buf = b'replaced'
+    offset = page_size + 42
+    ret = gkfs_client.mmap_write(file, length, offset, buf, '--fixed', fixed)
+    assert ret.retval == 0
+
+    ret = gkfs_client.pread(file, len(buf), offset)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
+
+
+@pytest.mark.parametrize("protect", ["none", "read"])
+def test_mmap_writeback_protected(gkfs_daemon, gkfs_client, protect):
+    """Pages whose protection was reduced with mprotect(), even to PROT_NONE,
+    are written back by msync() and munmap()."""
+    file = gkfs_daemon.mountdir / "file"
+    length = 2 * page_size
+    create_file(gkfs_client, file, length)
+
+    buf = b'protected'
+    offset = page_size + 7
+    ret = gkfs_client.mmap_write(file, length, offset, buf,
+                                 '--protect', protect)
+    assert ret.retval == 0
+
+    ret = gkfs_client.pread(file, len(buf), offset)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
+
+
+def test_mmap_writeback_upgraded(gkfs_daemon, gkfs_client):
+    """A shared mapping that is made writable with mprotect() is written
+    back."""
+    file = gkfs_daemon.mountdir / "file"
+    length = 2 * page_size
+    create_file(gkfs_client, file, length)
+
+    buf = b'upgraded'
+    ret = gkfs_client.mmap_write(file, length, 3, buf, '--upgrade')
+    assert ret.retval == 0
+
+    ret = gkfs_client.pread(file, len(buf), 3)
+    assert ret.retval == len(buf)
+    assert ret.buf == buf
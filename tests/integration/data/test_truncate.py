@@ -158,3 +158,57 @@ def test_fail_truncate(gkfs_daemon, gkfs_client):
     assert ret.statbuf.st_size == buf_length+1
 
 
+
+
+def chunk_ids(daemons, name):
+    """Returns the sorted chunk ids stored for a file on all daemons."""
+    ids = []
+    for d in daemons:
+        chunk_dir = d.datadir / "chunks" / name
+        if chunk_dir.exists():
+            ids.extend(int(c.name) for c in chunk_dir.iterdir())
+    return sorted(ids)
+
+
+def test_truncate_two_daemons(gkfs_daemon_factory, gkfs_client):
+    """Truncate removes exactly the chunks beyond the new size on all daemons,
+    both when shrinking by a single chunk and across several chunks.
+    """
+    daemons = [gkfs_daemon_factory.create(), gkfs_daemon_factory.create()]
+    # default chunk size of the daemon, see gkfs::config::rpc::chunksize
+    chunk_size = 512 * 1024
+    truncfile = daemons[0].mountdir / "trunc_file"
+
+    ret = gkfs_client.open(truncfile, os.O_CREAT | os.O_WRONLY, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    buf_length = 4 * chunk_size + chunk_size // 2
+    ret = gkfs_client.write_random(truncfile, buf_length)
+    assert ret.retval == buf_length
+    assert chunk_ids(daemons, "trunc_file") == [0, 1, 2, 3, 4]
+
+    # removes only the last chunk, which is fewer chunks than daemons
+    trunc_size = 3 * chunk_size + chunk_size // 2
+    ret = gkfs_client.truncate(truncfile, trunc_size)
+    assert ret.retval == 0
+    assert chunk_ids(daemons, "trunc_file") == [0, 1, 2, 3]
+
+    # cuts across several chunks, exactly at a chunk boundary
+    trunc_size = chunk_size
+    ret = gkfs_client.truncate(truncfile, trunc_size)
+    assert ret.retval == 0
+    assert chunk_ids(daemons, "trunc_file") == [0]
+
+    ret = gkfs_client.stat(truncfile)
+    assert ret.statbuf.st_size == trunc_size
+
+    # random content is seeded, a fresh file holds the same data
+    truncfile_verify = daemons[0].mountdir / "trunc_file_verify"
+    ret = gkfs_client.open(truncfile_verify, os.O_CREAT | os.O_WRONLY, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+    ret = gkfs_client.write_random(truncfile_verify, trunc_size)
+    assert ret.retval == trunc_size
+
+    ret = gkfs_client.file_compare(truncfile, truncfile_verify, trunc_size)
+    assert ret.retval == 0
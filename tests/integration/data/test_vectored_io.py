@@ -0,0 +1,124 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+import os
+import stat
+import pytest
+
+# default chunk size of the daemon, see gkfs::config::rpc::chunksize
+chunk_size = 512 * 1024
+
+
+def create_file(client, file):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+
+
+@pytest.mark.parametrize("offset", [
+    # both buffers span the chunk boundary
+    chunk_size - 1,
+    # the boundary falls between the buffers
+    chunk_size - 5,
+    # the second buffer spans the boundary
+    chunk_size - 7,
+])
+def test_vectored_io_chunk_boundary(gkfs_daemon, gkfs_client, offset):
+    """Vectored writes and reads whose buffers cross a chunk boundary at
+    different positions. Reads need not split the data like the writes."""
+    file = gkfs_daemon.mountdir / "file"
+    create_file(gkfs_client, file)
+
+    buf_0 = b'01234'
+    buf_1 = b'abcdefghij'
+    ret = gkfs_client.pwritev(file, buf_0, buf_1, 2, offset)
+    assert ret.retval == len(buf_0) + len(buf_1)
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == offset + len(buf_0) + len(buf_1)
+
+    ret = gkfs_client.preadv(file, len(buf_0), len(buf_1), offset)
+    assert ret.retval == len(buf_0) + len(buf_1)
+    assert ret.buf_0 == buf_0
+    assert ret.buf_1 == buf_1
+
+    data = buf_0 + buf_1
+    ret = gkfs_client.preadv(file, 3, len(data) - 3, offset)
+    assert ret.retval == len(data)
+    assert ret.buf_0 == data[:3]
+    assert ret.buf_1 == data[3:]
+
+    ret = gkfs_client.pread(file, len(data), offset)
+    assert ret.retval == len(data)
+    assert ret.buf == data
+
+
+def test_vectored_io_large_buffers(gkfs_daemon_factory, gkfs_client):
+    """Buffers of several chunk fragments on two daemons."""
+    daemons = [gkfs_daemon_factory.create(), gkfs_daemon_factory.create()]
+    file = daemons[0].mountdir / "file"
+    create_file(gkfs_client, file)
+
+    # command line arguments are limited to 128 KiB each
+    buf_0 = b'a' * (100 * 1024)
+    buf_1 = b'b' * (100 * 1024)
+    offset = 2 * chunk_size - len(buf_0) - 10
+    ret = gkfs_client.pwritev(file, buf_0, buf_1, 2, offset)
+    assert ret.retval == len(buf_0) + len(buf_1)
+
+    ret = gkfs_client.preadv(file, len(buf_0), len(buf_1), offset)
+    assert ret.retval == len(buf_0) + len(buf_1)
+    assert ret.buf_0 == buf_0
+    assert ret.buf_1 == buf_1
+
+    ret = gkfs_client.pread(file, 20, 2 * chunk_size - 10)
+    assert ret.retval == 20
+    assert ret.buf == b'a' * 10 + b'b' * 10
+
+
+def test_vectored_io_eof(gkfs_daemon, gkfs_client):
+    """Vectored reads across the end of file are short, reads at the end of
+    file are empty."""
+    file = gkfs_daemon.mountdir / "file"
+    create_file(gkfs_client, file)
+
+    buf_0 = b'01234'
+    buf_1 = b'56789'
+    offset = chunk_size - 3
+    ret = gkfs_client.pwritev(file, buf_0, buf_1, 2, offset)
+    assert ret.retval == len(buf_0) + len(buf_1)
+
+    size = offset + len(buf_0) + len(buf_1)
+    ret = gkfs_client.preadv(file, 4, 100, size - 6)
+    assert ret.retval == 6
+    assert ret.buf_0 == b'4567'
+    assert ret.buf_1[:2] == b'89'
+
+    ret = gkfs_client.preadv(file, 4, 4, size)
+    assert ret.retval == 0
@@ -289,6 +289,19 @@ def test_extended(gkfs_daemon, gkfs_shell, gkfs_client):
     assert cmd.exit_code == 0
     assert cmd.stdout.decode() == "MATCHED 0/4\n"
 
+    cmd = gkfs_shell.sfind(
+            topdir,
+            '-M',
+            gkfs_daemon.mountdir,
+            '-S',
+            1,
+            '-name',
+            '*_a'
+            )
+
+    assert cmd.exit_code == 0
+    assert cmd.stdout.decode() == "MATCHED 1/4\n"
+
 @pytest.mark.skip(reason="invalid errno returned on success")
 @pytest.mark.parametrize("directory_path",
     [ nonexisting ])
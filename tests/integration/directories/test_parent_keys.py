@@ -0,0 +1,102 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+import errno
+import os
+import stat
+
+
+def create_file(client, file, buf):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    ret = client.write(file, buf, len(buf))
+    assert ret.retval == len(buf)
+
+
+def names(client, dir):
+    ret = client.readdir(dir)
+    return sorted(d.d_name for d in ret.dirents)
+
+
+def create_tree(mountdir, client):
+    """Directories whose names are prefixes of each other"""
+    for d in ["d", "d/x", "d.x", "d0", "dx"]:
+        ret = client.mkdir(mountdir / d,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+        assert ret.retval == 0
+    for f in ["f", "d/a", "d/x/b", "d.x/c", "d0/e"]:
+        create_file(client, mountdir / f, b'42')
+
+
+def test_parent_keys_readdir(gkfs_daemon_parent_keys, gkfs_client):
+    """Directories list only their own first-level entries"""
+    mountdir = gkfs_daemon_parent_keys.mountdir
+    create_tree(mountdir, gkfs_client)
+
+    assert names(gkfs_client, mountdir) == ["d", "d.x", "d0", "dx", "f"]
+    assert names(gkfs_client, mountdir / "d") == ["a", "x"]
+    assert names(gkfs_client, mountdir / "d" / "x") == ["b"]
+    assert names(gkfs_client, mountdir / "d.x") == ["c"]
+    assert names(gkfs_client, mountdir / "dx") == []
+
+    ret = gkfs_client.stat(mountdir / "d" / "x" / "b")
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == 2
+
+
+def test_parent_keys_rename(gkfs_daemon_parent_keys, gkfs_client):
+    """Renamed files are listed under their new name and parent only"""
+    mountdir = gkfs_daemon_parent_keys.mountdir
+    create_tree(mountdir, gkfs_client)
+
+    ret = gkfs_client.rename(mountdir / "d" / "a", mountdir / "dx" / "a")
+    assert ret.retval == 0
+
+    ret = gkfs_client.rename(mountdir / "d" / "x" / "b",
+                             mountdir / "d" / "x" / "renamed")
+    assert ret.retval == 0
+
+    assert names(gkfs_client, mountdir / "d") == ["x"]
+    assert names(gkfs_client, mountdir / "dx") == ["a"]
+    assert names(gkfs_client, mountdir / "d" / "x") == ["renamed"]
+
+    for old in [mountdir / "d" / "a", mountdir / "d" / "x" / "b"]:
+        ret = gkfs_client.stat(old)
+        assert ret.retval == -1
+        assert ret.errno == errno.ENOENT
+
+    ret = gkfs_client.read(mountdir / "dx" / "a", 2)
+    assert ret.retval == 2
+    assert ret.buf == b'42'
+
+    # the old name can be used again
+    create_file(gkfs_client, mountdir / "d" / "a", b'new')
+    assert names(gkfs_client, mountdir / "d") == ["a", "x"]
+    ret = gkfs_client.read(mountdir / "d" / "a", 3)
+    assert ret.buf == b'new'
@@ -0,0 +1,53 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+import os
+import pytest
+
+
+@pytest.mark.parametrize("mode", ["rmdir", "rename", "chdir"])
+def test_path_cache_invalidation(gkfs_daemon, gkfs_client, mode):
+    """An external directory the client resolved before is replaced by a
+    symlink into GekkoFS. The client must not keep treating it as a
+    directory outside of GekkoFS, whether it was removed or renamed, with
+    absolute paths or paths relative to the working directory."""
+    mountdir = gkfs_daemon.mountdir
+    extdir = gkfs_daemon.cwd / "ext"
+    extdir.mkdir()
+
+    ret = gkfs_client.path_cache_validate(mode, extdir, mountdir)
+    assert ret.retval == 0
+
+    # the file is created in GekkoFS, not in the directory underneath the
+    # mount point that the kernel would follow the symlink to
+    ret = gkfs_client.stat(mountdir / "gkfs_file")
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == 2
+    assert not os.path.exists(mountdir / "gkfs_file")
+
+    if mode == "rename":
+        assert (extdir / "moved" / "ext_file").exists()
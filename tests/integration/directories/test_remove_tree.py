@@ -0,0 +1,102 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import errno
+import os
+import stat
+
+
+def create_file(client, file, buf):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    ret = client.write(file, buf, len(buf))
+    assert ret.retval == len(buf)
+
+
+def test_remove_tree(gkfs_daemon, gkfs_client):
+    """gkfs_remove_tree() removes a directory with its subtree. A sibling whose
+    name starts with the directory's name and ':' shares the prefix of the
+    directory's chunk directories and must be kept.
+    """
+    topdir = gkfs_daemon.mountdir / "dir"
+    subdir = topdir / "sub"
+    sibling = gkfs_daemon.mountdir / "dir:x"
+    files = [topdir / "a", topdir / "b:c", subdir / "d"]
+
+    for d in [topdir, subdir]:
+        ret = gkfs_client.mkdir(d, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+        assert ret.retval == 0
+
+    buf = b'42'
+    for f in files:
+        create_file(gkfs_client, f, buf)
+    sibling_buf = b'sibling'
+    create_file(gkfs_client, sibling, sibling_buf)
+
+    ret = gkfs_client.remove_tree(topdir)
+    assert ret.retval == 0
+
+    for path in [topdir, subdir] + files:
+        ret = gkfs_client.stat(path)
+        assert ret.retval == -1
+        assert ret.errno == errno.ENOENT
+
+    ret = gkfs_client.stat(sibling)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == len(sibling_buf)
+
+    ret = gkfs_client.read(sibling, len(sibling_buf))
+    assert ret.retval == len(sibling_buf)
+    assert ret.buf == sibling_buf
+
+    # the directory can be created again and is empty
+    ret = gkfs_client.mkdir(topdir, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval == 0
+    ret = gkfs_client.readdir(topdir)
+    assert len(ret.dirents) == 0
+
+
+def test_remove_tree_file(gkfs_daemon, gkfs_client):
+    """gkfs_remove_tree() of a file removes the file"""
+    file = gkfs_daemon.mountdir / "file"
+    create_file(gkfs_client, file, b'42')
+
+    ret = gkfs_client.remove_tree(file)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == -1
+    assert ret.errno == errno.ENOENT
+
+
+def test_remove_tree_nonexisting(gkfs_daemon, gkfs_client):
+    ret = gkfs_client.remove_tree(gkfs_daemon.mountdir / "nonexisting")
+    assert ret.retval == -1
+    assert ret.errno == errno.ENOENT
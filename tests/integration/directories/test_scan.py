@@ -0,0 +1,186 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+import errno
+import os
+import stat
+import time
+
+
+def create_file(client, file, length):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    if length > 0:
+        ret = client.write_random(file, length)
+        assert ret.retval == length
+
+
+def create_tree(mountdir, client):
+    """Creates a directory tree below mountdir / "scan" and returns the paths
+    of its directories and files with their sizes"""
+    topdir = mountdir / "scan"
+    dirs = [topdir, topdir / "sub", topdir / "sub" / "deep"]
+    files = {topdir / "a.txt": 10,
+             topdir / "b.log": 100,
+             topdir / "sub" / "c.txt": 1000,
+             topdir / "sub" / "deep" / "d.txt": 0}
+
+    for d in dirs:
+        ret = client.mkdir(d, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+        assert ret.retval == 0
+    for f, length in files.items():
+        create_file(client, f, length)
+    return topdir, dirs, files
+
+
+def paths(*entries):
+    return sorted(str(e) for e in entries)
+
+
+def test_scan_recursive(gkfs_daemon, gkfs_client):
+    """A scan returns the first-level entries or the whole subtree"""
+    topdir, dirs, files = create_tree(gkfs_daemon.mountdir, gkfs_client)
+
+    ret = gkfs_client.scan(topdir)
+    assert ret.retval == 0
+    assert ret.paths == paths(topdir / "a.txt", topdir / "b.log",
+                              topdir / "sub")
+    assert ret.scanned == 3
+    assert ret.matched == 3
+
+    ret = gkfs_client.scan(topdir, '--recursive')
+    assert ret.retval == 0
+    assert ret.paths == paths(*dirs[1:], *files)
+    assert ret.matched == len(dirs) - 1 + len(files)
+    assert ret.size_sum == sum(files.values())
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--type', 'dir')
+    assert ret.retval == 0
+    assert ret.paths == paths(*dirs[1:])
+    assert ret.scanned == len(dirs) - 1 + len(files)
+
+
+def test_scan_name(gkfs_daemon, gkfs_client):
+    """Names are matched with globs or POSIX extended regexes"""
+    topdir, dirs, files = create_tree(gkfs_daemon.mountdir, gkfs_client)
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--name', '*.txt')
+    assert ret.retval == 0
+    assert ret.paths == paths(topdir / "a.txt", topdir / "sub" / "c.txt",
+                              topdir / "sub" / "deep" / "d.txt")
+
+    # globs match whole names only
+    ret = gkfs_client.scan(topdir, '--recursive', '--name', 'txt')
+    assert ret.retval == 0
+    assert ret.paths == []
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--regex',
+                           '--name', '^[ab]\\.')
+    assert ret.retval == 0
+    assert ret.paths == paths(topdir / "a.txt", topdir / "b.log")
+
+    # the regex is applied to the name, not to the path
+    ret = gkfs_client.scan(topdir, '--recursive', '--regex', '--name', 'sub/')
+    assert ret.retval == 0
+    assert ret.paths == []
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--regex', '--name', '(')
+    assert ret.retval == -1
+    assert ret.errno == errno.EINVAL
+
+
+def test_scan_filters(gkfs_daemon, gkfs_client):
+    """Size and ctime ranges are inclusive"""
+    topdir, dirs, files = create_tree(gkfs_daemon.mountdir, gkfs_client)
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--type', 'file',
+                           '--size-min', 10, '--size-max', 100)
+    assert ret.retval == 0
+    assert ret.paths == paths(topdir / "a.txt", topdir / "b.log")
+    assert ret.size_sum == 110
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--type', 'file',
+                           '--size-max', 0)
+    assert ret.retval == 0
+    assert ret.paths == paths(topdir / "sub" / "deep" / "d.txt")
+
+    # ctimes are 0 unless the daemons keep them, but never in the future
+    tomorrow = int(time.time()) + 24 * 3600
+    ret = gkfs_client.scan(topdir, '--recursive', '--type', 'file',
+                           '--ctime-min', 0, '--ctime-max', tomorrow)
+    assert ret.retval == 0
+    assert ret.paths == paths(*files)
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--ctime-min', tomorrow)
+    assert ret.retval == 0
+    assert ret.paths == []
+    assert ret.matched == 0
+    assert ret.scanned == len(dirs) - 1 + len(files)
+
+
+def test_scan_aggregate(gkfs_daemon, gkfs_client):
+    """Without a callback, only the number and size of matches is returned"""
+    topdir, dirs, files = create_tree(gkfs_daemon.mountdir, gkfs_client)
+
+    ret = gkfs_client.scan(topdir, '--recursive', '--aggregate',
+                           '--name', '*.txt')
+    assert ret.retval == 0
+    assert ret.paths == []
+    assert ret.matched == 3
+    assert ret.size_sum == 1010
+    assert ret.scanned == len(dirs) - 1 + len(files)
+
+    # a single daemon can be asked
+    ret = gkfs_client.scan(topdir, '--recursive', '--aggregate',
+                           '--server', 0)
+    assert ret.retval == 0
+    assert ret.matched == len(dirs) - 1 + len(files)
+
+    ret = gkfs_client.scan(topdir, '--aggregate', '--server', 1)
+    assert ret.retval == -1
+    assert ret.errno == errno.EINVAL
+
+
+def test_scan_overflow(gkfs_daemon, gkfs_client):
+    """Matches which do not fit the initial buffer are fetched with a retry"""
+    topdir = gkfs_daemon.mountdir / "scan_overflow"
+    ret = gkfs_client.mkdir(topdir, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval == 0
+
+    # about 100 KiB of matches, more than the initial 64 KiB buffer
+    count = 2000
+    ret = gkfs_client.directory_validate(topdir, count)
+    assert ret.retval == count
+
+    ret = gkfs_client.scan(topdir)
+    assert ret.retval == 0
+    assert ret.matched == count
+    assert len(ret.paths) == count
+    assert ret.paths == paths(*[topdir / f"file_auto_{i}"
+                                for i in range(count)])
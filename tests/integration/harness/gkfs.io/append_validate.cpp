@@ -0,0 +1,220 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+/* C includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct append_validate_options {
+    bool verbose{};
+    std::string pathname;
+    ::size_t writes{};
+    ::size_t size{};
+    std::string tag{"0"};
+    ::size_t check{};
+
+    REFL_DECL_STRUCT(append_validate_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(::size_t, writes),
+                     REFL_DECL_MEMBER(::size_t, size),
+                     REFL_DECL_MEMBER(std::string, tag),
+                     REFL_DECL_MEMBER(::size_t, check));
+};
+
+struct append_validate_output {
+    int retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(append_validate_output, REFL_DECL_MEMBER(int, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const append_validate_output& out) {
+    record = serialize(out);
+}
+
+namespace {
+
+// a record starts with "<tag>:<index>:" and is padded with '.' up to its
+// trailing newline
+std::string
+make_record(const std::string& tag, ::size_t index, ::size_t size) {
+    auto record = fmt::format("{}:{}:", tag, index);
+    record.resize(size - 1, '.');
+    record.push_back('\n');
+    return record;
+}
+
+/**
+ * Appends `writes` records with O_APPEND
+ * @return 1 if all records were written, -1 on error
+ */
+int
+append_records(const append_validate_options& opts) {
+    auto fd = ::open(opts.pathname.c_str(), O_WRONLY | O_APPEND);
+    if(fd == -1)
+        return -1;
+    for(::size_t i = 0; i < opts.writes; i++) {
+        auto record = make_record(opts.tag, i, opts.size);
+        auto rv = ::write(fd, record.data(), record.size());
+        if(rv != static_cast<::ssize_t>(record.size())) {
+            if(rv >= 0)
+                errno = EIO;
+            ::close(fd);
+            return -1;
+        }
+    }
+    return ::close(fd) == 0 ? 1 : -1;
+}
+
+/**
+ * Checks that the file consists of `check` intact and distinct records
+ * @return 1 if valid, 0 if not, -1 on error
+ */
+int
+check_records(const append_validate_options& opts) {
+    struct ::stat st {};
+    if(::stat(opts.pathname.c_str(), &st) != 0)
+        return -1;
+    if(static_cast<::size_t>(st.st_size) != opts.check * opts.size)
+        return 0;
+    auto fd = ::open(opts.pathname.c_str(), O_RDONLY);
+    if(fd == -1)
+        return -1;
+    std::vector<char> buf(st.st_size);
+    ::size_t total = 0;
+    ::ssize_t rv = 0;
+    do {
+        rv = ::read(fd, buf.data() + total, buf.size() - total);
+        if(rv > 0)
+            total += rv;
+    } while(rv > 0 && total < buf.size());
+    ::close(fd);
+    if(rv < 0)
+        return -1;
+    if(total != buf.size())
+        return 0;
+
+    std::set<std::string> headers;
+    for(::size_t off = 0; off < buf.size(); off += opts.size) {
+        std::string record(buf.data() + off, opts.size);
+        // "<tag>:<index>:" without the padding
+        auto sep = record.find(':');
+        sep = sep == std::string::npos ? sep : record.find(':', sep + 1);
+        if(sep == std::string::npos)
+            return 0;
+        auto header = record.substr(0, sep + 1);
+        auto expected = header;
+        expected.resize(opts.size - 1, '.');
+        expected.push_back('\n');
+        if(record != expected || !headers.insert(header).second)
+            return 0;
+    }
+    return 1;
+}
+
+} // namespace
+
+void
+append_validate_exec(const append_validate_options& opts) {
+
+    int rv = -1;
+    errno = 0;
+    if(opts.size < 2) {
+        errno = EINVAL;
+    } else {
+        rv = opts.check > 0 ? check_records(opts) : append_records(opts);
+    }
+
+    if(opts.verbose) {
+        fmt::print("append_validate(pathname=\"{}\", writes={}, size={}, "
+                   "check={}) = {}, errno: {} [{}]\n",
+                   opts.pathname, opts.writes, opts.size, opts.check, rv,
+                   errno, ::strerror(errno));
+        return;
+    }
+
+    json out = append_validate_output{rv, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+append_validate_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<append_validate_options>();
+    auto* cmd = app.add_subcommand(
+            "append_validate",
+            "Append tagged records with O_APPEND or check that a file "
+            "consists of intact and distinct records");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_option("pathname", opts->pathname, "File name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("writes", opts->writes, "Number of records to append")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("size", opts->size, "Size of each record")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("-t,--tag", opts->tag,
+                    "Tag identifying the writer in its records")
+            ->type_name("");
+
+    cmd->add_option("-c,--check", opts->check,
+                    "Check for this number of records instead of appending")
+            ->type_name("");
+
+    cmd->callback([opts]() { append_validate_exec(*opts); });
+}
@@ -0,0 +1,121 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+
+using json = nlohmann::json;
+
+struct chunk_size_options {
+    bool verbose{};
+    std::string pathname;
+    ::size_t set{};
+
+    REFL_DECL_STRUCT(chunk_size_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(::size_t, set));
+};
+
+struct chunk_size_output {
+    ::ssize_t retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(chunk_size_output, REFL_DECL_MEMBER(::ssize_t, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const chunk_size_output& out) {
+    record = serialize(out);
+}
+
+void
+chunk_size_exec(const chunk_size_options& opts) {
+
+    // gkfs_{set,get}_chunk_size() are provided by the preloaded client library
+    using set_chunk_size_fn = int (*)(const char*, size_t);
+    using get_chunk_size_fn = ssize_t (*)(const char*);
+    auto set_fn = reinterpret_cast<set_chunk_size_fn>(
+            ::dlsym(RTLD_DEFAULT, "gkfs_set_chunk_size"));
+    auto get_fn = reinterpret_cast<get_chunk_size_fn>(
+            ::dlsym(RTLD_DEFAULT, "gkfs_get_chunk_size"));
+
+    ::ssize_t rv = -1;
+    errno = ENOSYS;
+    if(set_fn && get_fn) {
+        // a chunk size of 0 only queries the current chunk size
+        rv = opts.set == 0 ? 0 : set_fn(opts.pathname.c_str(), opts.set);
+        if(rv == 0)
+            rv = get_fn(opts.pathname.c_str());
+    }
+
+    if(opts.verbose) {
+        fmt::print("gkfs_get_chunk_size(pathname=\"{}\") = {}, errno: {} "
+                   "[{}]\n",
+                   opts.pathname, rv, errno, ::strerror(errno));
+        return;
+    }
+
+    json out = chunk_size_output{rv, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+chunk_size_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<chunk_size_options>();
+    auto* cmd = app.add_subcommand(
+            "chunk_size", "Execute the gkfs_set_chunk_size() and "
+                          "gkfs_get_chunk_size() library calls");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_option("pathname", opts->pathname, "File or directory name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("-s,--set", opts->set,
+                    "Chunk size to set before it is returned")
+            ->type_name("");
+
+    cmd->callback([opts]() { chunk_size_exec(*opts); });
+}
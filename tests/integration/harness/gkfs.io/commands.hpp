@@ -123,8 +123,36 @@ dup_validate_init(CLI::App& app);
 void
 syscall_coverage_init(CLI::App& app);
 
+void
+path_cache_validate_init(CLI::App& app);
+
 void
 rename_init(CLI::App& app);
 
+void
+copy_file_init(CLI::App& app);
+
+void
+append_validate_init(CLI::App& app);
+
+void
+mmap_write_init(CLI::App& app);
+
+void
+fallocate_init(CLI::App& app);
+
+// GekkoFS extensions
+void
+remove_tree_init(CLI::App& app);
+
+void
+chunk_size_init(CLI::App& app);
+
+void
+list_io_init(CLI::App& app);
+
+void
+scan_init(CLI::App& app);
+
 
 #endif // IO_COMMANDS_HPP
@@ -0,0 +1,173 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct copy_file_options {
+    bool verbose{};
+    bool sendfile{};
+    std::string src_path;
+    std::string dst_path;
+    ::size_t count{};
+    ::size_t src_offset{};
+    ::size_t dst_offset{};
+
+    REFL_DECL_STRUCT(copy_file_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(bool, sendfile),
+                     REFL_DECL_MEMBER(std::string, src_path),
+                     REFL_DECL_MEMBER(std::string, dst_path),
+                     REFL_DECL_MEMBER(::size_t, count),
+                     REFL_DECL_MEMBER(::size_t, src_offset),
+                     REFL_DECL_MEMBER(::size_t, dst_offset));
+};
+
+struct copy_file_output {
+    ::ssize_t retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(copy_file_output, REFL_DECL_MEMBER(::ssize_t, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const copy_file_output& out) {
+    record = serialize(out);
+}
+
+void
+copy_file_exec(const copy_file_options& opts) {
+
+    auto src_fd = ::open(opts.src_path.c_str(), O_RDONLY);
+    if(src_fd == -1) {
+        json out = copy_file_output{src_fd, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+    auto dst_fd = ::open(opts.dst_path.c_str(), O_WRONLY | O_CREAT,
+                         S_IRWXU | S_IRWXG | S_IRWXO);
+    if(dst_fd == -1) {
+        json out = copy_file_output{dst_fd, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    // sendfile() writes at the current position of the destination
+    if(opts.sendfile &&
+       ::lseek(dst_fd, opts.dst_offset, SEEK_SET) == (off_t) -1) {
+        json out = copy_file_output{-1, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    // copy until count bytes are copied, the end of the source file is
+    // reached, or an error occurs
+    off64_t src_off = opts.src_offset;
+    off64_t dst_off = opts.dst_offset;
+    ::ssize_t rv = 0;
+    ::size_t total = 0;
+    do {
+        if(opts.sendfile)
+            rv = ::sendfile(dst_fd, src_fd, &src_off, opts.count - total);
+        else
+            rv = ::copy_file_range(src_fd, &src_off, dst_fd, &dst_off,
+                                   opts.count - total, 0);
+        if(rv > 0)
+            total += rv;
+    } while(rv > 0 && total < opts.count);
+
+    ::ssize_t retval = rv < 0 ? rv : static_cast<::ssize_t>(total);
+
+    if(opts.verbose) {
+        fmt::print("{}(src=\"{}\", dst=\"{}\", count={}) = {}, errno: {} "
+                   "[{}]\n",
+                   opts.sendfile ? "sendfile" : "copy_file_range",
+                   opts.src_path, opts.dst_path, opts.count, retval, errno,
+                   ::strerror(errno));
+        return;
+    }
+
+    json out = copy_file_output{retval, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+copy_file_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<copy_file_options>();
+    auto* cmd = app.add_subcommand(
+            "copy_file",
+            "Copy a file range with copy_file_range() or sendfile()");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_flag("--sendfile", opts->sendfile,
+                  "Use sendfile() instead of copy_file_range()");
+
+    cmd->add_option("src_path", opts->src_path, "Source file name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("dst_path", opts->dst_path, "Destination file name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("count", opts->count, "Number of bytes to copy")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("--src-offset", opts->src_offset,
+                    "Offset in the source file")
+            ->type_name("");
+
+    cmd->add_option("--dst-offset", opts->dst_offset,
+                    "Offset in the destination file")
+            ->type_name("");
+
+    cmd->callback([opts]() { copy_file_exec(*opts); });
+}
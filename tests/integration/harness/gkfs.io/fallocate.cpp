@@ -0,0 +1,139 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct fallocate_options {
+    bool verbose{};
+    bool keep_size{};
+    bool punch_hole{};
+    bool rdonly{};
+    std::string pathname;
+    ::off_t offset{};
+    ::off_t len{};
+
+    REFL_DECL_STRUCT(fallocate_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(bool, keep_size),
+                     REFL_DECL_MEMBER(bool, punch_hole),
+                     REFL_DECL_MEMBER(bool, rdonly),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(::off_t, offset),
+                     REFL_DECL_MEMBER(::off_t, len));
+};
+
+struct fallocate_output {
+    int retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(fallocate_output, REFL_DECL_MEMBER(int, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const fallocate_output& out) {
+    record = serialize(out);
+}
+
+void
+fallocate_exec(const fallocate_options& opts) {
+
+    auto fd = ::open(opts.pathname.c_str(), opts.rdonly ? O_RDONLY : O_WRONLY);
+    if(fd == -1) {
+        json out = fallocate_output{fd, errno};
+        fmt::print("{}\n", out.dump(2));
+        return;
+    }
+
+    int mode = 0;
+    if(opts.keep_size)
+        mode |= FALLOC_FL_KEEP_SIZE;
+    if(opts.punch_hole)
+        mode |= FALLOC_FL_PUNCH_HOLE;
+
+    auto rv = ::fallocate(fd, mode, opts.offset, opts.len);
+
+    if(opts.verbose) {
+        fmt::print("fallocate(pathname=\"{}\", mode={}, offset={}, len={}) = "
+                   "{}, errno: {} [{}]\n",
+                   opts.pathname, mode, opts.offset, opts.len, rv, errno,
+                   ::strerror(errno));
+        return;
+    }
+
+    json out = fallocate_output{rv, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+fallocate_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<fallocate_options>();
+    auto* cmd = app.add_subcommand("fallocate",
+                                   "Execute the fallocate() system call");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_flag("--keep-size", opts->keep_size,
+                  "Pass FALLOC_FL_KEEP_SIZE");
+
+    cmd->add_flag("--punch-hole", opts->punch_hole,
+                  "Pass FALLOC_FL_PUNCH_HOLE");
+
+    cmd->add_flag("--rdonly", opts->rdonly, "Open the file read-only");
+
+    cmd->add_option("pathname", opts->pathname, "File name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("offset", opts->offset, "Offset of the range")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("len", opts->len, "Length of the range")
+            ->required()
+            ->type_name("");
+
+    cmd->callback([opts]() { fallocate_exec(*opts); });
+}
@@ -0,0 +1,172 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <vector>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct list_io_options {
+    bool verbose{};
+    std::string pathname;
+    int segments;
+    ::size_t length;
+    ::size_t stride;
+
+    REFL_DECL_STRUCT(list_io_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(int, segments),
+                     REFL_DECL_MEMBER(::size_t, length),
+                     REFL_DECL_MEMBER(::size_t, stride));
+};
+
+struct list_io_output {
+    ::ssize_t retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(list_io_output, REFL_DECL_MEMBER(::ssize_t, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const list_io_output& out) {
+    record = serialize(out);
+}
+
+/*
+ * Writes `segments` file segments of `length` bytes every `stride` bytes from
+ * a single buffer with gkfs_write_list(), reads them back with
+ * gkfs_read_list() and compares the data. Returns the number of bytes read.
+ */
+void
+list_io_exec(const list_io_options& opts) {
+
+    // gkfs_{write,read}_list() are provided by the preloaded client library
+    using list_fn = ::ssize_t (*)(int, int, const struct iovec*, int,
+                                  const off64_t*, const size_t*);
+    auto write_fn = reinterpret_cast<list_fn>(
+            ::dlsym(RTLD_DEFAULT, "gkfs_write_list"));
+    auto read_fn = reinterpret_cast<list_fn>(
+            ::dlsym(RTLD_DEFAULT, "gkfs_read_list"));
+
+    auto output = [&](::ssize_t rv) {
+        if(opts.verbose) {
+            fmt::print("list_io(pathname=\"{}\", segments={}, length={}, "
+                       "stride={}) = {}, errno: {} [{}]\n",
+                       opts.pathname, opts.segments, opts.length, opts.stride,
+                       rv, errno, ::strerror(errno));
+            return;
+        }
+        json out = list_io_output{rv, errno};
+        fmt::print("{}\n", out.dump(2));
+    };
+
+    if(!write_fn || !read_fn) {
+        errno = ENOSYS;
+        return output(-1);
+    }
+
+    int fd = ::open(opts.pathname.c_str(), O_CREAT | O_RDWR, 0644);
+    if(fd == -1)
+        return output(-1);
+
+    auto count = static_cast<::size_t>(opts.segments);
+    std::vector<off64_t> offsets(count);
+    std::vector<::size_t> lengths(count, opts.length);
+    for(::size_t i = 0; i < count; i++)
+        offsets[i] = static_cast<off64_t>(i * opts.stride);
+
+    std::vector<char> data(count * opts.length);
+    for(::size_t i = 0; i < data.size(); i++)
+        data[i] = char((i % 10) + '0');
+    struct iovec wiov = {data.data(), data.size()};
+
+    auto rv = write_fn(fd, 1, &wiov, opts.segments, offsets.data(),
+                       lengths.data());
+    if(rv < 0 || ::size_t(rv) != data.size()) {
+        ::close(fd);
+        return output(rv < 0 ? rv : -1);
+    }
+
+    std::vector<char> read_data(data.size());
+    struct iovec riov = {read_data.data(), read_data.size()};
+    rv = read_fn(fd, 1, &riov, opts.segments, offsets.data(), lengths.data());
+    ::close(fd);
+    if(rv >= 0 && read_data != data) {
+        errno = EINVAL;
+        rv = -1;
+    }
+    output(rv);
+}
+
+void
+list_io_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<list_io_options>();
+    auto* cmd = app.add_subcommand(
+            "list_io", "Execute the gkfs_write_list() and gkfs_read_list() "
+                       "library calls and compare the data");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_option("pathname", opts->pathname, "File name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("segments", opts->segments, "Number of file segments")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("length", opts->length, "Bytes per file segment")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("stride", opts->stride, "Distance of file segments")
+            ->required()
+            ->type_name("");
+
+    cmd->callback([opts]() { list_io_exec(*opts); });
+}
@@ -67,7 +67,17 @@ init_commands(CLI::App& app) {
     unlink_init(app);
     dup_validate_init(app);
     syscall_coverage_init(app);
+    path_cache_validate_init(app);
     rename_init(app);
+    copy_file_init(app);
+    append_validate_init(app);
+    mmap_write_init(app);
+    fallocate_init(app);
+    // GekkoFS extensions
+    remove_tree_init(app);
+    chunk_size_init(app);
+    list_io_init(app);
+    scan_init(app);
 }
 
 
@@ -0,0 +1,219 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+struct mmap_write_options {
+    bool verbose{};
+    std::string pathname;
+    ::size_t length{};
+    ::size_t offset{};
+    std::string data;
+    ::size_t external_offset{};
+    std::string external_data;
+    std::string fixed;
+    bool upgrade{};
+    std::string protect;
+
+    REFL_DECL_STRUCT(mmap_write_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(::size_t, length),
+                     REFL_DECL_MEMBER(::size_t, offset),
+                     REFL_DECL_MEMBER(std::string, data),
+                     REFL_DECL_MEMBER(::size_t, external_offset),
+                     REFL_DECL_MEMBER(std::string, external_data),
+                     REFL_DECL_MEMBER(std::string, fixed),
+                     REFL_DECL_MEMBER(bool, upgrade),
+                     REFL_DECL_MEMBER(std::string, protect));
+};
+
+struct mmap_write_output {
+    int retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(mmap_write_output, REFL_DECL_MEMBER(int, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const mmap_write_output& out) {
+    record = serialize(out);
+}
+
+void
+mmap_write_exec(const mmap_write_options& opts) {
+
+    auto output = [&opts](int retval) {
+        if(opts.verbose) {
+            fmt::print("mmap_write(pathname=\"{}\", length={}, offset={}) = "
+                       "{}, errno: {} [{}]\n",
+                       opts.pathname, opts.length, opts.offset, retval, errno,
+                       ::strerror(errno));
+            return;
+        }
+        json out = mmap_write_output{retval, errno};
+        fmt::print("{}\n", out.dump(2));
+    };
+
+    auto fd = ::open(opts.pathname.c_str(), O_RDWR);
+    if(fd == -1) {
+        output(-1);
+        return;
+    }
+
+    auto* addr = ::mmap(nullptr, opts.length,
+                        opts.upgrade ? PROT_READ : PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+    if(addr == MAP_FAILED) {
+        output(-1);
+        return;
+    }
+    // a mapping which becomes writable later must be written back as well
+    if(opts.upgrade &&
+       ::mprotect(addr, opts.length, PROT_READ | PROT_WRITE) != 0) {
+        output(-1);
+        return;
+    }
+    ::memcpy(static_cast<char*>(addr) + opts.offset, opts.data.c_str(),
+             opts.data.size());
+
+    // a write through the file descriptor to pages which were not modified
+    // through the mapping must survive the write-back of the mapping
+    if(!opts.external_data.empty() &&
+       ::pwrite(fd, opts.external_data.c_str(), opts.external_data.size(),
+                opts.external_offset) == -1) {
+        output(-1);
+        return;
+    }
+
+    // pages without read access must still be written back
+    if(!opts.protect.empty()) {
+        auto prot = opts.protect == "none" ? PROT_NONE : PROT_READ;
+        if(::mprotect(addr, opts.length, prot) != 0 ||
+           ::msync(addr, opts.length, MS_SYNC) != 0) {
+            output(-1);
+            return;
+        }
+    }
+
+    // replace the mapping with a new one at the same address, which must
+    // write back the replaced mapping first
+    void* fixed_addr = addr;
+    if(opts.fixed == "file") {
+        fixed_addr = ::mmap(addr, opts.length, PROT_READ,
+                            MAP_SHARED | MAP_FIXED, fd, 0);
+    } else if(opts.fixed == "anonymous") {
+        fixed_addr = ::mmap(addr, opts.length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    }
+    if(fixed_addr == MAP_FAILED) {
+        output(-1);
+        return;
+    }
+
+    auto rv = ::munmap(fixed_addr, opts.length);
+    if(rv == 0) {
+        rv = ::close(fd);
+    }
+    output(rv);
+}
+
+void
+mmap_write_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<mmap_write_options>();
+    auto* cmd = app.add_subcommand(
+            "mmap_write",
+            "Write to a shared file mapping and unmap it with munmap()");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_option("pathname", opts->pathname, "File name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("length", opts->length,
+                    "Length of the mapping, starting at file offset 0")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("offset", opts->offset,
+                    "Offset in the mapping to write the data to")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("data", opts->data, "Data to write to the mapping")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("--external-offset", opts->external_offset,
+                    "File offset for --external-data")
+            ->type_name("");
+
+    cmd->add_option("--external-data", opts->external_data,
+                    "Data to write with pwrite() while the file is mapped")
+            ->type_name("");
+
+    cmd->add_option("--fixed", opts->fixed,
+                    "Replace the mapping with a MAP_FIXED 'file' or "
+                    "'anonymous' mapping before unmapping it")
+            ->check(CLI::IsMember({"file", "anonymous"}))
+            ->type_name("");
+
+    cmd->add_flag("--upgrade", opts->upgrade,
+                  "Map the file read-only and make the mapping writable with "
+                  "mprotect() before writing to it");
+
+    cmd->add_option("--protect", opts->protect,
+                    "Change the protection of the mapping to 'none' or "
+                    "'read' and msync() it before unmapping it")
+            ->check(CLI::IsMember({"none", "read"}))
+            ->type_name("");
+
+    cmd->callback([opts]() { mmap_write_exec(*opts); });
+}
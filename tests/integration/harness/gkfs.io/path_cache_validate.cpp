@@ -0,0 +1,191 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <string>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+// Replaces an external directory, which the client has resolved before, with a
+// symlink into GekkoFS and checks that a file below it is created in GekkoFS.
+struct path_cache_validate_options {
+    bool verbose{};
+    std::string mode;
+    std::string extdir;
+    std::string target;
+
+    REFL_DECL_STRUCT(path_cache_validate_options,
+                     REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, mode),
+                     REFL_DECL_MEMBER(std::string, extdir),
+                     REFL_DECL_MEMBER(std::string, target));
+};
+
+struct path_cache_validate_output {
+    int retval;
+    int errnum;
+
+    REFL_DECL_STRUCT(path_cache_validate_output,
+                     REFL_DECL_MEMBER(int, retval),
+                     REFL_DECL_MEMBER(int, errnum));
+};
+
+void
+to_json(json& record, const path_cache_validate_output& out) {
+    record = serialize(out);
+}
+
+/**
+ * Creates a symlink in a child process without the client library, which
+ * refuses symlinks into GekkoFS. Thus, only the calling process' own changes
+ * can have invalidated its path resolution.
+ * @returns 0 on success, -1 otherwise
+ */
+int
+symlink_unintercepted(const std::string& target, const std::string& link) {
+    const char* argv[] = {"ln", "-s", target.c_str(), link.c_str(), nullptr};
+    char path[] = "PATH=/usr/bin:/bin";
+    char* envp[] = {path, nullptr};
+    pid_t pid;
+    if(::posix_spawnp(&pid, "ln", nullptr, nullptr,
+                      const_cast<char* const*>(argv), envp) != 0)
+        return -1;
+    int status;
+    if(::waitpid(pid, &status, 0) == -1)
+        return -1;
+    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        errno = EIO;
+        return -1;
+    }
+    return 0;
+}
+
+int
+path_cache_validate(const path_cache_validate_options& opts) {
+    // with 'chdir', all paths below extdir are passed relative to it
+    auto prefix = opts.extdir + "/";
+    if(opts.mode == "chdir") {
+        if(::chdir(opts.extdir.c_str()) != 0)
+            return -1;
+        prefix.clear();
+    }
+    auto sub = prefix + "sub";
+    auto ext_file = sub + "/ext_file";
+
+    // resolving a path below the directory caches it
+    if(::mkdir(sub.c_str(), S_IRWXU) != 0)
+        return -1;
+    auto fd = ::open(ext_file.c_str(), O_CREAT | O_WRONLY, S_IRWXU);
+    if(fd == -1)
+        return -1;
+    ::close(fd);
+
+    if(opts.mode == "rename") {
+        if(::rename(sub.c_str(), (prefix + "moved").c_str()) != 0)
+            return -1;
+    } else {
+        if(::unlink(ext_file.c_str()) != 0 || ::rmdir(sub.c_str()) != 0)
+            return -1;
+    }
+    if(symlink_unintercepted(opts.target, opts.extdir + "/sub") != 0)
+        return -1;
+
+    fd = ::open((sub + "/gkfs_file").c_str(), O_CREAT | O_WRONLY, S_IRWXU);
+    if(fd == -1)
+        return -1;
+    auto rv = ::write(fd, "42", 2) == 2 ? 0 : -1;
+    ::close(fd);
+    return rv;
+}
+
+void
+path_cache_validate_exec(const path_cache_validate_options& opts) {
+
+    auto rv = path_cache_validate(opts);
+
+    if(opts.verbose) {
+        fmt::print("path_cache_validate(mode={}, extdir=\"{}\", target=\"{}\") "
+                   "= {}, errno: {} [{}]\n",
+                   opts.mode, opts.extdir, opts.target, rv, errno,
+                   ::strerror(errno));
+        return;
+    }
+
+    json out = path_cache_validate_output{rv, errno};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+path_cache_validate_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<path_cache_validate_options>();
+    auto* cmd = app.add_subcommand(
+            "path_cache_validate",
+            "Replace a resolved external directory with a symlink into "
+            "GekkoFS and create a file below it");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_option("mode", opts->mode,
+                    "How the directory is replaced: 'rmdir', 'rename', or "
+                    "'chdir' for rmdir with paths relative to extdir")
+            ->required()
+            ->check(CLI::IsMember({"rmdir", "rename", "chdir"}))
+            ->type_name("");
+
+    cmd->add_option("extdir", opts->extdir, "External directory")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("target", opts->target,
+                    "GekkoFS directory the symlink points to")
+            ->required()
+            ->type_name("");
+
+    cmd->callback([opts]() { path_cache_validate_exec(*opts); });
+}
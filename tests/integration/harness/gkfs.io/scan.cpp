@@ -0,0 +1,217 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  This file is part of GekkoFS.
+
+  GekkoFS is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  GekkoFS is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.
+
+  SPDX-License-Identifier: GPL-3.0-or-later
+*/
+/* C++ includes */
+#include <CLI/CLI.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include <commands.hpp>
+#include <reflection.hpp>
+#include <serialize.hpp>
+
+/* C includes */
+#include <dlfcn.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+
+using json = nlohmann::json;
+
+// Predicate and aggregates of gkfs_scan(), as declared by the client library
+struct gkfs_scan_filter {
+    const char* name;
+    int name_regex;
+    uint64_t size_min;
+    uint64_t size_max;
+    int64_t ctime_min;
+    int64_t ctime_max;
+    mode_t type;
+    int recursive;
+};
+
+struct gkfs_scan_stats {
+    uint64_t scanned;
+    uint64_t matched;
+    uint64_t size_sum;
+};
+
+struct scan_options {
+    bool verbose{};
+    std::string pathname;
+    std::string name;
+    bool regex{};
+    uint64_t size_min{};
+    uint64_t size_max{std::numeric_limits<uint64_t>::max()};
+    int64_t ctime_min{std::numeric_limits<int64_t>::min()};
+    int64_t ctime_max{std::numeric_limits<int64_t>::max()};
+    std::string type;
+    bool recursive{};
+    bool aggregate{};
+    int server{-1};
+
+    REFL_DECL_STRUCT(scan_options, REFL_DECL_MEMBER(bool, verbose),
+                     REFL_DECL_MEMBER(std::string, pathname),
+                     REFL_DECL_MEMBER(std::string, name),
+                     REFL_DECL_MEMBER(bool, regex),
+                     REFL_DECL_MEMBER(uint64_t, size_min),
+                     REFL_DECL_MEMBER(uint64_t, size_max),
+                     REFL_DECL_MEMBER(int64_t, ctime_min),
+                     REFL_DECL_MEMBER(int64_t, ctime_max),
+                     REFL_DECL_MEMBER(std::string, type),
+                     REFL_DECL_MEMBER(bool, recursive),
+                     REFL_DECL_MEMBER(bool, aggregate),
+                     REFL_DECL_MEMBER(int, server));
+};
+
+struct scan_output {
+    int retval;
+    int errnum;
+    uint64_t scanned;
+    uint64_t matched;
+    uint64_t size_sum;
+    std::vector<std::string> paths;
+
+    REFL_DECL_STRUCT(scan_output, REFL_DECL_MEMBER(int, retval),
+                     REFL_DECL_MEMBER(int, errnum),
+                     REFL_DECL_MEMBER(uint64_t, scanned),
+                     REFL_DECL_MEMBER(uint64_t, matched),
+                     REFL_DECL_MEMBER(uint64_t, size_sum),
+                     REFL_DECL_MEMBER(std::vector<std::string>, paths));
+};
+
+void
+to_json(json& record, const scan_output& out) {
+    record = serialize(out);
+}
+
+void
+scan_exec(const scan_options& opts) {
+
+    // gkfs_scan() is provided by the preloaded client library
+    using scan_cb = int (*)(const char*, mode_t, size_t, time_t, void*);
+    using scan_fn = int (*)(const char*, const struct gkfs_scan_filter*, int,
+                            scan_cb, void*, struct gkfs_scan_stats*);
+    auto fn = reinterpret_cast<scan_fn>(::dlsym(RTLD_DEFAULT, "gkfs_scan"));
+
+    struct gkfs_scan_filter filter {};
+    filter.name = opts.name.empty() ? nullptr : opts.name.c_str();
+    filter.name_regex = opts.regex;
+    filter.size_min = opts.size_min;
+    filter.size_max = opts.size_max;
+    filter.ctime_min = opts.ctime_min;
+    filter.ctime_max = opts.ctime_max;
+    if(opts.type == "file")
+        filter.type = S_IFREG;
+    else if(opts.type == "dir")
+        filter.type = S_IFDIR;
+    filter.recursive = opts.recursive;
+
+    // a NULL callback only returns the aggregates
+    scan_cb cb = nullptr;
+    if(!opts.aggregate) {
+        cb = [](const char* path, mode_t, size_t, time_t, void* arg) {
+            static_cast<std::vector<std::string>*>(arg)->emplace_back(path);
+            return 0;
+        };
+    }
+
+    struct gkfs_scan_stats stats {};
+    std::vector<std::string> paths;
+    int rv = -1;
+    errno = ENOSYS;
+    if(fn)
+        rv = fn(opts.pathname.c_str(), &filter, opts.server, cb, &paths,
+                &stats);
+    std::sort(paths.begin(), paths.end());
+
+    if(opts.verbose) {
+        fmt::print("gkfs_scan(pathname=\"{}\") = {}, matched: {}, errno: {} "
+                   "[{}]\n",
+                   opts.pathname, rv, stats.matched, errno, ::strerror(errno));
+        return;
+    }
+
+    json out = scan_output{rv,           errno,          stats.scanned,
+                           stats.matched, stats.size_sum, paths};
+    fmt::print("{}\n", out.dump(2));
+}
+
+void
+scan_init(CLI::App& app) {
+
+    // Create the option and subcommand objects
+    auto opts = std::make_shared<scan_options>();
+    auto* cmd = app.add_subcommand("scan",
+                                   "Execute the gkfs_scan() library call");
+
+    // Add options to cmd, binding them to opts
+    cmd->add_flag("-v,--verbose", opts->verbose,
+                  "Produce human readable output");
+
+    cmd->add_option("pathname", opts->pathname, "Directory name")
+            ->required()
+            ->type_name("");
+
+    cmd->add_option("--name", opts->name, "Glob on the entries' names")
+            ->type_name("");
+
+    cmd->add_flag("--regex", opts->regex,
+                  "Treat --name as POSIX extended regex");
+
+    cmd->add_option("--size-min", opts->size_min, "Minimum size")
+            ->type_name("");
+
+    cmd->add_option("--size-max", opts->size_max, "Maximum size")
+            ->type_name("");
+
+    cmd->add_option("--ctime-min", opts->ctime_min, "Minimum ctime")
+            ->type_name("");
+
+    cmd->add_option("--ctime-max", opts->ctime_max, "Maximum ctime")
+            ->type_name("");
+
+    cmd->add_option("--type", opts->type, "'file' or 'dir'")
+            ->check(CLI::IsMember({"file", "dir"}))
+            ->type_name("");
+
+    cmd->add_flag("-r,--recursive", opts->recursive, "Scan the whole subtree");
+
+    cmd->add_flag("--aggregate", opts->aggregate,
+                  "Only return the number and total size of matches");
+
+    cmd->add_option("--server", opts->server,
+                    "Daemon to ask, all daemons by default")
+            ->type_name("");
+
+    cmd->callback([opts]() { scan_exec(*opts); });
+}
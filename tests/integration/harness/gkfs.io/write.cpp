@@ -49,11 +49,13 @@ struct write_options {
     std::string pathname;
     std::string data;
     ::size_t count;
+    bool append{};
 
     REFL_DECL_STRUCT(write_options, REFL_DECL_MEMBER(bool, verbose),
                      REFL_DECL_MEMBER(std::string, pathname),
                      REFL_DECL_MEMBER(std::string, data),
-                     REFL_DECL_MEMBER(::size_t, count));
+                     REFL_DECL_MEMBER(::size_t, count),
+                     REFL_DECL_MEMBER(bool, append));
 };
 
 struct write_output {
@@ -72,7 +74,8 @@ to_json(json& record, const write_output& out) {
 void
 write_exec(const write_options& opts) {
 
-    auto fd = ::open(opts.pathname.c_str(), O_WRONLY);
+    auto fd = ::open(opts.pathname.c_str(),
+                     opts.append ? O_WRONLY | O_APPEND : O_WRONLY);
 
     if(fd == -1) {
         if(opts.verbose) {
@@ -125,5 +128,9 @@ write_init(CLI::App& app) {
             ->required()
             ->type_name("");
 
+    cmd->add_option("append", opts->append, "Open the file with O_APPEND")
+            ->default_val(false)
+            ->type_name("");
+
     cmd->callback([opts]() { write_exec(*opts); });
 }
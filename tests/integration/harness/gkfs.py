@@ -47,6 +47,11 @@ gkfs_client_log_file = 'gkfs_client.log'
 gkfs_client_log_level = 'all'
 gkfs_daemon_active_log_pattern = r'Startup successful. Daemon is ready.'
 
+gkfs_proxy_cmd = 'gkfs_proxy'
+gkfs_proxy_log_file = 'gkfs_proxy.log'
+gkfs_proxy_log_level = 'debug'
+gkfs_proxy_pid_file = 'gkfs_proxy.pid'
+
 gkfwd_daemon_cmd = 'gkfwd_daemon'
 gkfwd_client_cmd = 'gkfs.io'
 gkfwd_client_lib_file = 'libgkfwd_intercept.so'
@@ -224,15 +229,63 @@ class FwdClientCreator:
         return FwdClient(self._workspace, identifier)
 
 
-class Daemon:
+class DaemonCreator:
+    """
+    Factory that allows tests to create several daemons in a workspace. Each
+    daemon uses its own rootdir suffix, so that they can share a node.
+    """
+
     def __init__(self, interface, database, workspace):
+        self._interface = interface
+        self._database = database
+        self._workspace = workspace
+        self._daemons = []
+
+    def create(self):
+        """
+        Create and run a daemon in the tests workspace. Daemons are assigned
+        the suffixes 'daemon0', 'daemon1', ... in creation order, which is also
+        the order of their host ids.
+
+        Returns
+        -------
+        The `Daemon` object to interact with the daemon.
+        """
+
+        suffix = f"daemon{len(self._daemons)}"
+        daemon = Daemon(self._interface, self._database, self._workspace,
+                        suffix)
+        daemon.run()
+        self._daemons.append(daemon)
+
+        return daemon
+
+    def shutdown(self):
+        """
+        Shut down all daemons created by the factory.
+        """
+
+        for daemon in reversed(self._daemons):
+            daemon.shutdown()
+        self._daemons.clear()
+
+
+class Daemon:
+    def __init__(self, interface, database, workspace, suffix=None,
+                 dbconfig=None):
 
         self._address = get_ephemeral_address(interface)
         self._workspace = workspace
         self._database = database
+        self._suffix = suffix
+        self._dbconfig = dbconfig
         self._cmd = sh.Command(gkfs_daemon_cmd, self._workspace.bindirs)
         self._env = os.environ.copy()
-        self._metadir = self.rootdir
+        self._metadir = self.datadir
+        self._log_file = (gkfs_daemon_log_file if suffix is None else
+                          f"gkfs_daemon_{suffix}.log")
+        self._stats_file = ('stats.log' if suffix is None else
+                            f"stats_{suffix}.log")
         libdirs = ':'.join(
                 filter(None, [os.environ.get('LD_LIBRARY_PATH', '')] +
                              [str(p) for p in self._workspace.libdirs]))
@@ -240,7 +293,7 @@ class Daemon:
         self._patched_env = {
             'LD_LIBRARY_PATH'      : libdirs,
             'GKFS_HOSTS_FILE'      : self.cwd / gkfs_hosts_file,
-            'GKFS_DAEMON_LOG_PATH' : self.logdir / gkfs_daemon_log_file,
+            'GKFS_DAEMON_LOG_PATH' : self.logdir / self._log_file,
             'GKFS_DAEMON_LOG_LEVEL': gkfs_daemon_log_level,
         }
         self._env.update(self._patched_env)
@@ -252,9 +305,13 @@ class Daemon:
                 '-l', self._address,
                 '--metadir', self._metadir,
                 '--dbbackend', self._database,
-                '--output-stats', self.logdir / 'stats.log',
+                '--output-stats', self.logdir / self._stats_file,
                 '--enable-collection',
                 '--enable-chunkstats']
+        if self._suffix is not None:
+            args.extend(['--rootdir-suffix', self._suffix])
+        if self._dbconfig is not None:
+            args.extend(['--dbconfig', self._dbconfig])
         if self._database == "parallaxdb" :
             args.append('--clean-rootdir-finish')
 
@@ -315,7 +372,7 @@ class Daemon:
         while perf_counter() - init_time < timeout:
             try:
                 # logger.debug(f"checking log file")
-                with open(self.logdir / gkfs_daemon_log_file) as log:
+                with open(self.logdir / self._log_file) as log:
                     for line in islice(log, max_lines):
                         if re.search(gkfs_daemon_active_log_pattern, line) is not None:
                             return
@@ -353,6 +410,16 @@ class Daemon:
     def rootdir(self):
         return self._workspace.rootdir
 
+    @property
+    def datadir(self):
+        """
+        The directory where the daemon stores its chunks and metadata, i.e.,
+        the rootdir with the daemon's suffix appended if it has one.
+        """
+        if self._suffix is None:
+            return self.rootdir
+        return self.rootdir / self._suffix
+
     @property
     def mountdir(self):
         return self._workspace.mountdir
@@ -365,6 +432,85 @@ class Daemon:
     def interface(self):
         return self._interface
 
+class Proxy:
+    """
+    A class to represent the node-local GekkoFS proxy of a workspace. Clients
+    use it if LIBGKFS_PROXY_PID_FILE is set to its `pid_file`.
+    """
+    def __init__(self, workspace, stat_cache_ttl=None):
+
+        self._workspace = workspace
+        self._stat_cache_ttl = stat_cache_ttl
+        self._cmd = sh.Command(gkfs_proxy_cmd, self._workspace.bindirs)
+        self._env = os.environ.copy()
+
+        libdirs = ':'.join(
+                filter(None, [os.environ.get('LD_LIBRARY_PATH', '')] +
+                             [str(p) for p in self._workspace.libdirs]))
+
+        self._patched_env = {
+            'LD_LIBRARY_PATH'     : libdirs,
+            'GKFS_PROXY_LOG_PATH' : self.logdir / gkfs_proxy_log_file,
+            'GKFS_PROXY_LOG_LEVEL': gkfs_proxy_log_level,
+        }
+        self._env.update(self._patched_env)
+
+    def run(self):
+
+        args = ['--hosts-file', self.cwd / gkfs_hosts_file,
+                '--pid-file', self.pid_file]
+        if self._stat_cache_ttl is not None:
+            args.extend(['--stat-cache-ttl', self._stat_cache_ttl])
+
+        logger.debug(f"spawning proxy")
+        logger.debug(f"cmdline: {self._cmd} " + " ".join(map(str, args)))
+        logger.debug(f"patched env:\n{pformat(self._patched_env)}")
+
+        self._proc = self._cmd(
+                args,
+                _env=self._env,
+                _bg=True,
+            )
+
+        logger.debug(f"proxy process spawned (PID={self._proc.pid})")
+
+        # the proxy publishes its address once it is ready
+        init_time = perf_counter()
+        while not self.pid_file.exists():
+            if not _process_exists(self._proc.pid):
+                raise RuntimeError(f"process {self._proc.pid} is not running")
+            if perf_counter() - init_time > 60.0:
+                self.shutdown()
+                raise RuntimeError("initialization timeout exceeded")
+            time.sleep(0.1)
+
+        logger.debug("proxy is ready")
+
+        return self
+
+    def shutdown(self):
+        logger.debug(f"terminating proxy")
+
+        try:
+            self._proc.terminate()
+            self._proc.wait()
+        except sh.SignalException_SIGTERM:
+            pass
+        except Exception:
+            raise
+
+    @property
+    def cwd(self):
+        return self._workspace.twd
+
+    @property
+    def logdir(self):
+        return self._workspace.logdir
+
+    @property
+    def pid_file(self):
+        return self.logdir / gkfs_proxy_pid_file
+
 class _proxy_exec():
     def __init__(self, client, name):
         self._client = client
@@ -431,6 +577,14 @@ class Client:
 
         return self._preload_library
 
+    def setenv(self, name, value):
+        """
+        Set an environment variable for all following client runs
+        """
+
+        self._patched_env[name] = value
+        self._env[name] = value
+
     def run(self, cmd, *args):
 
         logger.debug(f"running client")
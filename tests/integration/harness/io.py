@@ -435,6 +435,15 @@ class SyscallCoverageOutputSchema(Schema):
     def make_object(self, data, **kwargs):
         return namedtuple('SyscallCoverageReturn', ['retval', 'errno', 'syscall'])(**data)
 
+class PathCacheValidateOutputSchema(Schema):
+    """Schema to deserialize the results of a path_cache_validate execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('PathCacheValidateReturn', ['retval', 'errno'])(**data)
+
 class SymlinkOutputSchema(Schema):
     """Schema to deserialize the results of an symlink execution"""
 
@@ -474,6 +483,87 @@ class RenameOutputSchema(Schema):
     def make_object(self, data, **kwargs):
         return namedtuple('RenameReturn', ['retval', 'errno'])(**data)
 
+class CopyFileOutputSchema(Schema):
+    """Schema to deserialize the results of a copy_file_range() or sendfile()
+    execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('CopyFileReturn', ['retval', 'errno'])(**data)
+
+class AppendValidateOutputSchema(Schema):
+    """Schema to deserialize the results of appending or checking records"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('AppendValidateReturn', ['retval', 'errno'])(**data)
+
+class MmapWriteOutputSchema(Schema):
+    """Schema to deserialize the results of a mmap_write execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('MmapWriteReturn', ['retval', 'errno'])(**data)
+
+class FallocateOutputSchema(Schema):
+    """Schema to deserialize the results of a fallocate() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('FallocateReturn', ['retval', 'errno'])(**data)
+
+class RemoveTreeOutputSchema(Schema):
+    """Schema to deserialize the results of a gkfs_remove_tree() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('RemoveTreeReturn', ['retval', 'errno'])(**data)
+
+class ChunkSizeOutputSchema(Schema):
+    """Schema to deserialize the results of a gkfs_set_chunk_size() and
+    gkfs_get_chunk_size() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('ChunkSizeReturn', ['retval', 'errno'])(**data)
+
+class ListIOOutputSchema(Schema):
+    """Schema to deserialize the results of a gkfs_write_list() and
+    gkfs_read_list() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('ListIOReturn', ['retval', 'errno'])(**data)
+
+class ScanOutputSchema(Schema):
+    """Schema to deserialize the results of a gkfs_scan() execution"""
+    retval = fields.Integer(required=True)
+    errno = Errno(data_key='errnum', required=True)
+    scanned = fields.Integer(required=True)
+    matched = fields.Integer(required=True)
+    size_sum = fields.Integer(required=True)
+    paths = fields.List(fields.String(), required=True)
+
+    @post_load
+    def make_object(self, data, **kwargs):
+        return namedtuple('ScanReturn',
+                ['retval', 'errno', 'scanned', 'matched', 'size_sum',
+                 'paths'])(**data)
+
 class IOParser:
 
     OutputSchemas = {
@@ -501,6 +591,14 @@ class IOParser:
         'access' : AccessOutputSchema(),
         'statfs' : StatfsOutputSchema(),
         'rename' : RenameOutputSchema(),
+        'copy_file' : CopyFileOutputSchema(),
+        'append_validate' : AppendValidateOutputSchema(),
+        'mmap_write' : MmapWriteOutputSchema(),
+        'fallocate' : FallocateOutputSchema(),
+        'remove_tree' : RemoveTreeOutputSchema(),
+        'chunk_size' : ChunkSizeOutputSchema(),
+        'list_io' : ListIOOutputSchema(),
+        'scan' : ScanOutputSchema(),
         # UTIL
         'file_compare': FileCompareOutputSchema(),
         'chdir'   : ChdirOutputSchema(),
@@ -508,6 +606,7 @@ class IOParser:
         'symlink' : SymlinkOutputSchema(),
         'dup_validate' : DupValidateOutputSchema(),
         'syscall_coverage' : SyscallCoverageOutputSchema(),
+        'path_cache_validate' : PathCacheValidateOutputSchema(),
         
     }
 
@@ -0,0 +1,73 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import errno
+import os
+import stat
+
+
+def test_unreachable_host(gkfs_daemon, gkfs_client):
+    """A daemon whose endpoint cannot be looked up makes the requests sent to
+    it fail with an error. The client must neither crash nor hang, and the
+    requests sent to the reachable daemon must succeed.
+    """
+    hosts_file = gkfs_client.cwd / 'gkfs_hosts.txt'
+    hostname, uri = hosts_file.read_text().splitlines()[0].split()[:2]
+    protocol = uri[:uri.index('://')]
+
+    # the root directory "/" is located on the first, reachable daemon
+    broken_hosts_file = gkfs_client.cwd / 'gkfs_hosts_unreachable.txt'
+    broken_hosts_file.write_text(f"{hostname} {uri}\n"
+                                 f"unreachable.invalid "
+                                 f"{protocol}://unreachable.invalid:1\n")
+    gkfs_client.setenv('LIBGKFS_HOSTS_FILE', broken_hosts_file)
+
+    created = []
+    failed = 0
+    for i in range(32):
+        file = gkfs_daemon.mountdir / f"file_{i}"
+        ret = gkfs_client.open(file,
+                               os.O_CREAT | os.O_WRONLY,
+                               stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+        if ret.retval == -1:
+            assert ret.errno in (errno.EBUSY, errno.EIO)
+            failed += 1
+        else:
+            created.append(file)
+
+    # metadata of both hosts is requested
+    assert failed > 0
+    assert len(created) > 0
+
+    for file in created:
+        ret = gkfs_client.stat(file)
+        assert ret.retval == 0
+
+    # a directory listing needs all daemons
+    ret = gkfs_client.readdir(gkfs_daemon.mountdir)
+    assert ret.errno in (errno.EBUSY, errno.EIO)
@@ -35,6 +35,7 @@ import ctypes
 import sh
 import sys
 import pytest
+from concurrent.futures import ThreadPoolExecutor
 from harness.logger import logger
 
 nonexisting = "nonexisting"
@@ -102,3 +103,72 @@ def test_pwritev(gkfs_daemon, gkfs_client):
     ret = gkfs_client.pwritev(file, buf_0, buf_1, 2, 1024)
 
     assert ret.retval == len(buf_0) + len(buf_1) # Return the number of written bytes
+
+def test_write_append(gkfs_daemon, gkfs_client):
+
+    file = gkfs_daemon.mountdir / "file"
+
+    ret = gkfs_client.open(file,
+                           os.O_CREAT | os.O_WRONLY,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+
+    assert ret.retval == 10000
+
+    buf_0 = b'42'
+    buf_1 = b'24'
+    ret = gkfs_client.write(file, buf_0, len(buf_0))
+    assert ret.retval == len(buf_0)
+
+    # each write opens the file anew, so the data must end up at the end
+    ret = gkfs_client.write(file, buf_1, len(buf_1), 1)
+    assert ret.retval == len(buf_1)
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == len(buf_0) + len(buf_1)
+
+    ret = gkfs_client.read(file, len(buf_0) + len(buf_1))
+    assert ret.buf == buf_0 + buf_1
+    assert ret.retval == len(buf_0) + len(buf_1)
+
+def test_write_append_concurrent(gkfs_daemon, gkfs_client):
+    """Concurrent O_APPEND writers receive non-overlapping offsets."""
+
+    file = gkfs_daemon.mountdir / "file"
+
+    ret = gkfs_client.open(file,
+                           os.O_CREAT | os.O_WRONLY,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+
+    assert ret.retval == 10000
+
+    writers = 4
+    writes = 200
+    record_size = 100
+
+    with ThreadPoolExecutor(max_workers=writers) as executor:
+        results = list(executor.map(
+            lambda tag: gkfs_client.append_validate(file, writes, record_size,
+                                                    '--tag', tag),
+            range(writers)))
+
+    for ret in results:
+        assert ret.retval == 1
+
+    # all counters are persisted and released on close
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == writers * writes * record_size
+
+    # every record is intact and found exactly once
+    ret = gkfs_client.append_validate(file, 0, record_size,
+                                      '--check', writers * writes)
+    assert ret.retval == 1
+
+    # appends after the counter was released continue at the end of file
+    ret = gkfs_client.append_validate(file, 1, record_size, '--tag', writers)
+    assert ret.retval == 1
+
+    ret = gkfs_client.append_validate(file, 0, record_size,
+                                      '--check', writers * writes + 1)
+    assert ret.retval == 1
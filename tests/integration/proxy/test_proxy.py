@@ -0,0 +1,109 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import errno
+import os
+import stat
+
+
+def create_file(client, file, buf=b''):
+    ret = client.open(file,
+                      os.O_CREAT | os.O_WRONLY,
+                      stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    if buf:
+        ret = client.write(file, buf, len(buf))
+        assert ret.retval == len(buf)
+
+
+def test_proxy_stat_write(gkfs_daemon, gkfs_proxy, gkfs_client):
+    """A file's size is updated in the proxy's stat cache by writes."""
+    gkfs_client.setenv('LIBGKFS_PROXY_PID_FILE', gkfs_proxy.pid_file)
+    file = gkfs_daemon.mountdir / "file"
+
+    create_file(gkfs_client, file)
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == 0
+
+    buf = b'42' * 1024
+    ret = gkfs_client.write(file, buf, len(buf))
+    assert ret.retval == len(buf)
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == len(buf)
+
+
+def test_proxy_stat_unlink(gkfs_daemon, gkfs_proxy, gkfs_client):
+    """Removed files are dropped from the proxy's stat cache."""
+    gkfs_client.setenv('LIBGKFS_PROXY_PID_FILE', gkfs_proxy.pid_file)
+    file = gkfs_daemon.mountdir / "file"
+
+    create_file(gkfs_client, file, b'42')
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+
+    ret = gkfs_client.unlink(file)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == -1
+    assert ret.errno == errno.ENOENT
+
+
+def test_proxy_stat_remove_tree(gkfs_daemon, gkfs_proxy, gkfs_client):
+    """Subtrees removed with gkfs_remove_tree() are dropped from the proxy's
+    stat cache, siblings sharing the directory's name as prefix are kept."""
+    gkfs_client.setenv('LIBGKFS_PROXY_PID_FILE', gkfs_proxy.pid_file)
+    topdir = gkfs_daemon.mountdir / "dir"
+    subdir = topdir / "sub"
+    files = [topdir / "a", subdir / "b"]
+    sibling = gkfs_daemon.mountdir / "dirx"
+
+    for d in [topdir, subdir]:
+        ret = gkfs_client.mkdir(d, stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+        assert ret.retval == 0
+    for f in files + [sibling]:
+        create_file(gkfs_client, f, b'42')
+        ret = gkfs_client.stat(f)
+        assert ret.retval == 0
+
+    ret = gkfs_client.remove_tree(topdir)
+    assert ret.retval == 0
+
+    for f in files + [subdir]:
+        ret = gkfs_client.stat(f)
+        assert ret.retval == -1
+        assert ret.errno == errno.ENOENT
+
+    ret = gkfs_client.stat(topdir)
+    assert ret.retval == 0
+    ret = gkfs_client.stat(sibling)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == 2
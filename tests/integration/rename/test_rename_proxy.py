@@ -0,0 +1,60 @@
+################################################################################
+# Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain            #
+# Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany          #
+#                                                                              #
+# This software was partially supported by the                                 #
+# EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).    #
+#                                                                              #
+# This software was partially supported by the                                 #
+# ADA-FS project under the SPPEXA project funded by the DFG.                   #
+#                                                                              #
+# This file is part of GekkoFS.                                                #
+#                                                                              #
+# GekkoFS is free software: you can redistribute it and/or modify              #
+# it under the terms of the GNU General Public License as published by         #
+# the Free Software Foundation, either version 3 of the License, or            #
+# (at your option) any later version.                                          #
+#                                                                              #
+# GekkoFS is distributed in the hope that it will be useful,                   #
+# but WITHOUT ANY WARRANTY; without even the implied warranty of               #
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                #
+# GNU General Public License for more details.                                 #
+#                                                                              #
+# You should have received a copy of the GNU General Public License            #
+# along with GekkoFS.  If not, see <https://www.gnu.org/licenses/>.            #
+#                                                                              #
+# SPDX-License-Identifier: GPL-3.0-or-later                                    #
+################################################################################
+
+import errno
+import os
+import stat
+
+
+def test_rename_proxy(gkfs_daemon, gkfs_proxy, gkfs_client):
+    """Renamed files are updated in the proxy's stat cache for both paths."""
+    gkfs_client.setenv('LIBGKFS_PROXY_PID_FILE', gkfs_proxy.pid_file)
+    file = gkfs_daemon.mountdir / "file"
+    file2 = gkfs_daemon.mountdir / "file2"
+
+    ret = gkfs_client.open(file,
+                           os.O_CREAT | os.O_WRONLY,
+                           stat.S_IRWXU | stat.S_IRWXG | stat.S_IRWXO)
+    assert ret.retval != -1
+    buf = b'42'
+    ret = gkfs_client.write(file, buf, len(buf))
+    assert ret.retval == len(buf)
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == 0
+
+    ret = gkfs_client.rename(file, file2)
+    assert ret.retval == 0
+
+    ret = gkfs_client.stat(file)
+    assert ret.retval == -1
+    assert ret.errno == errno.ENOENT
+
+    ret = gkfs_client.stat(file2)
+    assert ret.retval == 0
+    assert ret.statbuf.st_size == len(buf)
@@ -0,0 +1,79 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
+#include <config.hpp>
+#include <fmt/format.h>
+
+#include "helpers/helpers.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t chunk_size = gkfs::config::rpc::chunksize;
+constexpr gkfs::rpc::chnk_id_t chunk_count = 64;
+
+} // namespace
+
+TEST_CASE(" chunk storage I/O ", "[!benchmark][ChunkStorage]") {
+
+    helpers::temporary_directory tmp{};
+    auto root = tmp.dirname().string();
+    gkfs::data::ChunkStorage storage(root, chunk_size, false);
+
+    const std::string path = "/scratch/run/rank_00042/step_000042.h5";
+    std::vector<char> buf(chunk_size, 'x');
+    // a 32 MiB file whose chunks all exist
+    for(gkfs::rpc::chnk_id_t id = 0; id < chunk_count; id++)
+        storage.write_chunk(path, id, buf.data(), chunk_size, 0, chunk_size);
+
+    for(size_t size : {size_t{4096}, size_t{65536}, chunk_size}) {
+        auto label = fmt::format("{} KiB", size / 1024);
+
+        BENCHMARK_ADVANCED("write_chunk " + label)
+        (Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                auto id = static_cast<gkfs::rpc::chnk_id_t>(i) % chunk_count;
+                auto off = static_cast<off64_t>((i * size) % chunk_size);
+                return storage.write_chunk(path, id, buf.data(), size, off,
+                                           chunk_size);
+            });
+        };
+
+        BENCHMARK_ADVANCED("read_chunk " + label)
+        (Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                auto id = static_cast<gkfs::rpc::chnk_id_t>(i) % chunk_count;
+                auto off = static_cast<off64_t>((i * size) % chunk_size);
+                return storage.read_chunk(path, id, buf.data(), size, off);
+            });
+        };
+    }
+
+    // a write that creates the chunk file of a new file
+    size_t next_file = 0;
+    BENCHMARK_ADVANCED("write_chunk 4 KiB to a new file")
+    (Catch::Benchmark::Chronometer meter) {
+        std::vector<std::string> paths{};
+        for(int i = 0; i < meter.runs(); i++)
+            paths.push_back(
+                    fmt::format("/scratch/run/rank_{:05}/new.h5", next_file++));
+        meter.measure([&](int i) {
+            return storage.write_chunk(paths[i], 0, buf.data(), 4096, 0,
+                                       chunk_size);
+        });
+    };
+}
@@ -0,0 +1,112 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <common/arithmetic/arithmetic.hpp>
+#include <common/rpc/distributor.hpp>
+#include <config.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace gkfs::utils::arithmetic;
+
+namespace {
+
+// deeply nested paths of checkpoint files as written by typical HPC apps
+std::vector<std::string>
+checkpoint_paths(size_t count) {
+    std::vector<std::string> paths{};
+    for(size_t i = 0; i < count; i++)
+        paths.push_back("/scratch/project_4711/run_" + std::to_string(i % 16) +
+                        "/checkpoints/rank_" + std::to_string(i) +
+                        "/step_000042.h5");
+    return paths;
+}
+
+} // namespace
+
+TEST_CASE(" distributor lookups ", "[!benchmark][Distributor]") {
+
+    constexpr unsigned int hosts = 64;
+    gkfs::rpc::SimpleHashDistributor simple(0, hosts);
+    gkfs::rpc::StripedDistributor striped(0, hosts, 4);
+    auto paths = checkpoint_paths(1024);
+
+    BENCHMARK_ADVANCED("SimpleHashDistributor::locate_data")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return simple.locate_data(paths[i % paths.size()], i % 128);
+        });
+    };
+
+    BENCHMARK_ADVANCED("SimpleHashDistributor::locate_file_metadata")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return simple.locate_file_metadata(paths[i % paths.size()]);
+        });
+    };
+
+    BENCHMARK_ADVANCED("StripedDistributor::locate_data")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return striped.locate_data(paths[i % paths.size()], i % 128);
+        });
+    };
+
+    // the chunks of a 64 MiB write with the default chunk size
+    BENCHMARK("SimpleHashDistributor::locate_data 128 chunks") {
+        unsigned int sum = 0;
+        for(gkfs::rpc::chunkid_t id = 0; id < 128; id++)
+            sum += simple.locate_data(paths[0], id);
+        return sum;
+    };
+}
+
+TEST_CASE(" block arithmetic ", "[!benchmark][utils::arithmetic]") {
+
+    // chunk sizes are runtime values since they are stored per file
+    std::vector<size_t> chunk_sizes{gkfs::config::rpc::chunksize, 1'000'000};
+    const auto& chunk_size = chunk_sizes[0];
+    // unaligned offsets and sizes of a strided access pattern
+    std::vector<uint64_t> offsets{};
+    for(uint64_t i = 0; i < 1024; i++)
+        offsets.push_back(i * 1'000'003);
+
+    BENCHMARK_ADVANCED("block_index")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return block_index(offsets[i % offsets.size()], chunk_size);
+        });
+    };
+
+    BENCHMARK_ADVANCED("block_overrun")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return block_overrun(offsets[i % offsets.size()], chunk_size);
+        });
+    };
+
+    BENCHMARK_ADVANCED("block_count")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return block_count(offsets[i % offsets.size()], 4'000'000,
+                               chunk_size);
+        });
+    };
+
+    // chunk sizes set with gkfs_set_chunk_size() need not be a power of 2
+    BENCHMARK_ADVANCED("block_index (non-power of 2)")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int i) {
+            return block_index(offsets[i % offsets.size()], chunk_sizes[1]);
+        });
+    };
+}
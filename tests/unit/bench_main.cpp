@@ -0,0 +1,27 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#define CATCH_CONFIG_RUNNER
+#include <catch2/catch.hpp>
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+int
+main(int argc, char* argv[]) {
+    // the daemon's storage backends log to these loggers, which are set up by
+    // the daemon otherwise. Without sinks, nothing is written.
+    for(const auto* name : {"DataModule", "MetadataModule"})
+        spdlog::register_logger(std::make_shared<spdlog::logger>(name));
+    return Catch::Session().run(argc, argv);
+}
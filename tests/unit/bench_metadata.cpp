@@ -0,0 +1,54 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <common/metadata.hpp>
+
+#include <string>
+
+TEST_CASE(" metadata serialization ", "[!benchmark][Metadata]") {
+
+    // a file in the middle of a checkpoint write
+    gkfs::metadata::Metadata file(S_IFREG | 0644);
+    file.init_ACM_time();
+    file.size(17'179'869'184);
+    file.blocks(33'554'432);
+    auto file_str = file.serialize();
+
+    gkfs::metadata::Metadata dir(S_IFDIR | 0755);
+    dir.init_ACM_time();
+    auto dir_str = dir.serialize();
+
+    BENCHMARK("serialize file") {
+        return file.serialize();
+    };
+
+    BENCHMARK("serialize directory") {
+        return dir.serialize();
+    };
+
+    BENCHMARK("parse file") {
+        return gkfs::metadata::Metadata(file_str);
+    };
+
+    BENCHMARK("parse directory") {
+        return gkfs::metadata::Metadata(dir_str);
+    };
+
+    // what a size update does without merge operators
+    BENCHMARK("parse, update size, and serialize file") {
+        gkfs::metadata::Metadata md(file_str);
+        md.size(md.size() + 4096);
+        return md.serialize();
+    };
+}
@@ -0,0 +1,132 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <daemon/backend/metadata/db.hpp>
+#include <daemon/backend/metadata/metadata_backend.hpp>
+#include <common/metadata.hpp>
+#include <fmt/format.h>
+
+#include "helpers/helpers.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t dir_count = 64;
+constexpr size_t files_per_dir = 1024;
+
+// /scratch/run/rank_<dir>/step_<file>.h5, i.e., one directory per MPI rank
+std::string
+dir_path(size_t dir) {
+    return fmt::format("/scratch/run/rank_{:05}", dir);
+}
+
+std::string
+file_path(size_t n) {
+    return fmt::format("{}/step_{:06}.h5", dir_path(n % dir_count),
+                       n / dir_count);
+}
+
+std::vector<std::string>
+backends() {
+    std::vector<std::string> ids{std::string(gkfs::metadata::memory_backend)};
+#ifdef GKFS_ENABLE_ROCKSDB
+    ids.emplace_back(gkfs::metadata::rocksdb_backend);
+#endif
+    return ids;
+}
+
+} // namespace
+
+TEST_CASE(" metadata database operations ", "[!benchmark][MetadataDB]") {
+
+    for(const auto& id : backends()) {
+
+        helpers::temporary_directory tmp{};
+        gkfs::metadata::MetadataDB db(tmp.dirname().string(), id);
+
+        gkfs::metadata::Metadata dir_md(S_IFDIR | 0755);
+        dir_md.init_ACM_time();
+        gkfs::metadata::Metadata file_md(S_IFREG | 0644);
+        file_md.init_ACM_time();
+        const auto file_str = file_md.serialize();
+
+        for(const auto& dir : {"/scratch", "/scratch/run"})
+            db.put(dir, dir_md.serialize());
+        for(size_t d = 0; d < dir_count; d++)
+            db.put(dir_path(d), dir_md.serialize());
+        const auto files = dir_count * files_per_dir;
+        std::vector<std::string> keys{};
+        keys.reserve(files);
+        for(size_t n = 0; n < files; n++) {
+            keys.push_back(file_path(n));
+            db.put(keys.back(), file_str);
+        }
+        // keys not in the database yet, in the shape of new files
+        size_t next_file = files;
+        std::vector<std::string> missing_keys{};
+        for(size_t n = 0; n < files_per_dir; n++)
+            missing_keys.push_back(
+                    fmt::format("{}/tmp_{:06}.h5", dir_path(n % dir_count), n));
+
+        BENCHMARK_ADVANCED(id + " put_no_exist (create)")
+        (Catch::Benchmark::Chronometer meter) {
+            std::vector<std::string> new_keys{};
+            for(int i = 0; i < meter.runs(); i++)
+                new_keys.push_back(file_path(next_file++));
+            meter.measure(
+                    [&](int i) { db.put_no_exist(new_keys[i], file_str); });
+        };
+
+        BENCHMARK_ADVANCED(id + " get (stat)")
+        (Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) { return db.get(keys[i % keys.size()]); });
+        };
+
+        BENCHMARK_ADVANCED(id + " get (stat of missing entry)")
+        (Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                try {
+                    return db.get(missing_keys[i % missing_keys.size()]);
+                } catch(const gkfs::metadata::NotFoundException&) {
+                    return std::string{};
+                }
+            });
+        };
+
+        BENCHMARK_ADVANCED(id + " increase_size (merge)")
+        (Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                db.increase_size(keys[i % keys.size()],
+                                 static_cast<size_t>(i + 1) * 4096, false);
+            });
+        };
+
+        BENCHMARK_ADVANCED(id + " increase_size (append)")
+        (Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int) { db.increase_size(keys[0], 4096, true); });
+        };
+
+        BENCHMARK(id + " get_dirents (" + std::to_string(files_per_dir) +
+                  " entries)") {
+            return db.get_dirents(dir_path(1)).size();
+        };
+
+        BENCHMARK(id + " get_dirents_extended (" +
+                  std::to_string(files_per_dir) + " entries)") {
+            return db.get_dirents_extended(dir_path(2)).size();
+        };
+    }
+}
@@ -0,0 +1,255 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <daemon/backend/data/chunk_storage.hpp>
+
+#include "helpers/helpers.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <sys/stat.h>
+}
+
+namespace {
+
+constexpr size_t chunk_size = 4096;
+
+std::vector<std::string>
+sorted(std::vector<std::string> v) {
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// chunk ids of the chunk files stored for a file
+std::vector<unsigned long>
+chunk_files(const std::string& root, const std::string& chunk_dir) {
+    std::vector<unsigned long> ids;
+    for(const auto& entry : fs::directory_iterator(fs::path(root) / chunk_dir))
+        ids.push_back(std::stoul(entry.path().filename().string()));
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+void
+write_chunks(gkfs::data::ChunkStorage& storage, const std::string& file,
+             gkfs::rpc::chnk_id_t first, gkfs::rpc::chnk_id_t last) {
+    const std::string data(chunk_size, 'x');
+    for(auto id = first; id <= last; id++)
+        REQUIRE(storage.write_chunk(file, id, data.data(), data.size(), 0,
+                                    chunk_size) ==
+                static_cast<ssize_t>(data.size()));
+}
+
+} // namespace
+
+SCENARIO(" subtree chunk spaces are detached by path ",
+         "[ChunkStorage][remove_subtree]") {
+
+    GIVEN(" a directory and a sibling whose name starts with its name ") {
+
+        helpers::temporary_directory tmp{};
+        auto root = tmp.dirname().string();
+        gkfs::data::ChunkStorage storage(root, chunk_size, false);
+
+        const std::vector<std::string> inside = {"/dir/a", "/dir/b:c",
+                                                 "/dir/sub/d"};
+        // "/dir:x" and "/dir/x" share the chunk directory name "dir:x"
+        const std::vector<std::string> outside = {"/dir:x", "/dir:x/e", "/dirx",
+                                                  "/other"};
+        const std::string data(16, 'x');
+        for(const auto* files : {&inside, &outside})
+            for(const auto& file : *files)
+                REQUIRE(storage.write_chunk(file, 0, data.data(), data.size(),
+                                            0, chunk_size) ==
+                        static_cast<ssize_t>(data.size()));
+
+        WHEN(" the directory's chunk spaces are detached ") {
+            auto files = storage.detach_chunk_spaces("/dir");
+
+            THEN(" only files in the subtree are returned ") {
+                REQUIRE(sorted(files) == sorted(inside));
+            }
+
+            AND_WHEN(" they are destroyed ") {
+                for(const auto& file : files)
+                    storage.destroy_chunk_space(file);
+
+                THEN(" the sibling's chunks are kept ") {
+                    std::string buf(data.size(), '\0');
+                    for(const auto& file : outside)
+                        REQUIRE(storage.read_chunk(file, 0, buf.data(),
+                                                   buf.size(), 0) ==
+                                static_cast<ssize_t>(data.size()));
+                    REQUIRE(buf == data);
+                }
+            }
+        }
+
+        WHEN(" the root's chunk spaces are detached ") {
+            auto files = storage.detach_chunk_spaces("/");
+
+            THEN(" all files are returned ") {
+                auto all = inside;
+                all.insert(all.end(), outside.begin(), outside.end());
+                REQUIRE(sorted(files) == sorted(all));
+            }
+        }
+    }
+}
+
+SCENARIO(" truncate removes the chunks beyond the new size ",
+         "[ChunkStorage][truncate]") {
+
+    GIVEN(" a file with five chunks created by the chunk storage ") {
+
+        helpers::temporary_directory tmp{};
+        auto root = tmp.dirname().string();
+        gkfs::data::ChunkStorage storage(root, chunk_size, false);
+        write_chunks(storage, "/file", 0, 4);
+
+        WHEN(" it is shrunk to the middle of its second chunk ") {
+            storage.trim_chunk_space("/file", 2);
+            storage.truncate_chunk_file("/file", 1, chunk_size / 2);
+
+            THEN(" the chunks after the cut-off are removed ") {
+                REQUIRE(chunk_files(root, "file") ==
+                        std::vector<unsigned long>{0, 1});
+                REQUIRE(fs::file_size(fs::path(root) / "file" / "0") ==
+                        chunk_size);
+                REQUIRE(fs::file_size(fs::path(root) / "file" / "1") ==
+                        chunk_size / 2);
+            }
+
+            AND_WHEN(" chunks are written again and it is shrunk to a chunk "
+                     "boundary ") {
+                write_chunks(storage, "/file", 3, 5);
+                storage.trim_chunk_space("/file", 1);
+
+                THEN(" the rewritten chunks are removed as well ") {
+                    REQUIRE(chunk_files(root, "file") ==
+                            std::vector<unsigned long>{0});
+                }
+            }
+        }
+
+        WHEN(" it is shrunk to zero ") {
+            storage.trim_chunk_space("/file", 0);
+
+            THEN(" all chunks are removed ") {
+                REQUIRE(chunk_files(root, "file").empty());
+            }
+        }
+
+        WHEN(" a file without chunks on this daemon is shrunk ") {
+            THEN(" nothing is to be done ") {
+                REQUIRE_NOTHROW(storage.trim_chunk_space("/missing", 0));
+            }
+        }
+    }
+
+    GIVEN(" a file with chunks from before the chunk storage started ") {
+
+        helpers::temporary_directory tmp{};
+        auto root = tmp.dirname().string();
+        {
+            gkfs::data::ChunkStorage previous(root, chunk_size, false);
+            write_chunks(previous, "/file", 0, 4);
+        }
+        gkfs::data::ChunkStorage storage(root, chunk_size, false);
+        write_chunks(storage, "/file", 2, 2);
+
+        WHEN(" it is shrunk across chunk boundaries ") {
+            storage.trim_chunk_space("/file", 1);
+
+            THEN(" the chunks unknown to the index are removed as well ") {
+                REQUIRE(chunk_files(root, "file") ==
+                        std::vector<unsigned long>{0});
+            }
+        }
+    }
+}
+
+SCENARIO(" chunk files are allocated without changing their size ",
+         "[ChunkStorage][fallocate]") {
+
+    GIVEN(" a chunk storage ") {
+
+        helpers::temporary_directory tmp{};
+        auto root = tmp.dirname().string();
+        gkfs::data::ChunkStorage storage(root, chunk_size, false);
+        const auto chunk0 = fs::path(root) / "file" / "0";
+
+        WHEN(" a range of a new chunk file is allocated ") {
+            storage.allocate_chunk("/file", 0, chunk_size / 2, chunk_size / 2);
+
+            THEN(" the chunk file is created empty with reserved blocks ") {
+                REQUIRE(fs::file_size(chunk0) == 0);
+                struct stat st {};
+                REQUIRE(::stat(chunk0.c_str(), &st) == 0);
+                REQUIRE(static_cast<size_t>(st.st_blocks) * 512 >=
+                        chunk_size / 2);
+                char buf[16];
+                REQUIRE(storage.read_chunk("/file", 0, buf, sizeof(buf), 0) ==
+                        0);
+            }
+
+            AND_WHEN(" the file is shrunk to zero ") {
+                storage.trim_chunk_space("/file", 0);
+
+                THEN(" the allocated chunk file is removed ") {
+                    REQUIRE(chunk_files(root, "file").empty());
+                }
+            }
+        }
+
+        WHEN(" a chunk file with data is allocated beyond its end ") {
+            const std::string data(16, 'x');
+            REQUIRE(storage.write_chunk("/file", 0, data.data(), data.size(),
+                                        0, chunk_size) ==
+                    static_cast<ssize_t>(data.size()));
+            storage.allocate_chunk("/file", 0, 0, chunk_size);
+
+            THEN(" its size and data are kept ") {
+                REQUIRE(fs::file_size(chunk0) == data.size());
+                std::string buf(chunk_size, '\0');
+                REQUIRE(storage.read_chunk("/file", 0, buf.data(), buf.size(),
+                                           0) ==
+                        static_cast<ssize_t>(data.size()));
+                REQUIRE(buf.substr(0, data.size()) == data);
+            }
+        }
+    }
+
+    GIVEN(" a chunk storage with preallocation ") {
+
+        helpers::temporary_directory tmp{};
+        auto root = tmp.dirname().string();
+        gkfs::data::ChunkStorage storage(root, chunk_size, true);
+
+        WHEN(" a new chunk file is written partially ") {
+            const std::string data(16, 'x');
+            REQUIRE(storage.write_chunk("/file", 0, data.data(), data.size(),
+                                        0, chunk_size) ==
+                    static_cast<ssize_t>(data.size()));
+
+            THEN(" the file size is the amount written ") {
+                REQUIRE(fs::file_size(fs::path(root) / "file" / "0") ==
+                        data.size());
+            }
+        }
+    }
+}
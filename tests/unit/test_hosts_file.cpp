@@ -0,0 +1,79 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <common/hosts_file.hpp>
+#include <helpers/helpers.hpp>
+
+#include <stdexcept>
+#include <string>
+
+SCENARIO(" hosts files are parsed in host id order ", "[hosts_file]") {
+
+    GIVEN(" a hosts file with unsorted entries ") {
+        helpers::temporary_directory tmp{};
+        auto path = tmp.dirname() / "gkfs_hosts.txt";
+        helpers::temporary_file file{path,
+                                     "node2 ofi+tcp://10.0.0.2:1234\n"
+                                     "node1#b ofi+tcp://10.0.0.1:1235 2\n"
+                                     "node1#a ofi+tcp://10.0.0.1:1234 0.5\n"};
+
+        WHEN(" the hosts file is parsed ") {
+            auto entries = gkfs::utils::parse_hosts_file(path);
+
+            THEN(" entries are sorted by hostname including the suffix ") {
+                REQUIRE(entries.size() == 3);
+                REQUIRE(entries[0].hostname == "node1#a");
+                REQUIRE(entries[0].uri == "ofi+tcp://10.0.0.1:1234");
+                REQUIRE(entries[1].hostname == "node1#b");
+                REQUIRE(entries[2].hostname == "node2");
+            }
+
+            THEN(" a missing weight defaults to 1 ") {
+                REQUIRE(entries[0].weight == 0.5);
+                REQUIRE(entries[1].weight == 2.0);
+                REQUIRE(entries[2].weight == 1.0);
+            }
+        }
+    }
+
+    GIVEN(" malformed hosts files ") {
+        helpers::temporary_directory tmp{};
+        auto path = tmp.dirname() / "gkfs_hosts.txt";
+
+        WHEN(" a line has no URI ") {
+            helpers::temporary_file file{path, "node1\n"};
+
+            THEN(" parsing fails ") {
+                REQUIRE_THROWS_AS(gkfs::utils::parse_hosts_file(path),
+                                  std::runtime_error);
+            }
+        }
+
+        WHEN(" a weight is zero ") {
+            helpers::temporary_file file{path, "node1 ofi+tcp://n1:1234 0\n"};
+
+            THEN(" parsing fails ") {
+                REQUIRE_THROWS_AS(gkfs::utils::parse_hosts_file(path),
+                                  std::runtime_error);
+            }
+        }
+
+        WHEN(" the hosts file does not exist ") {
+            THEN(" parsing fails ") {
+                REQUIRE_THROWS_AS(gkfs::utils::parse_hosts_file(path),
+                                  std::runtime_error);
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <daemon/scheduler/io_queue.hpp>
+
+using namespace std::chrono_literals;
+using gkfs::data::IoOp;
+using gkfs::data::IoQueue;
+using gkfs::data::IoRequest;
+
+namespace {
+
+const std::string file_a = "/file_a";
+const std::string file_b = "/file_b";
+
+IoRequest
+request(IoOp op, uint64_t client, const std::string& path, uint64_t chnk_id,
+        off64_t off, size_t size,
+        std::chrono::steady_clock::time_point arrival =
+                std::chrono::steady_clock::now()) {
+    return IoRequest{op,  client, &path,   chnk_id, nullptr,
+                     size, off,   1 << 20, nullptr, arrival};
+}
+
+} // namespace
+
+SCENARIO(" the I/O queue merges adjacent requests ", "[IoQueue]") {
+
+    GIVEN(" an I/O queue with a maximum merge size of 16 KiB ") {
+
+        IoQueue q{1 << 20, 1000ms, 16384};
+
+        WHEN(" sequential writes on one chunk are queued ") {
+            for(off64_t off = 0; off < 4 * 4096; off += 4096)
+                q.push(request(IoOp::write, 0, file_a, 0, off, 4096));
+            q.push(request(IoOp::write, 0, file_a, 0, 4 * 4096, 4096));
+
+            THEN(" they are issued as one batch up to the merge size ") {
+                auto batch = q.pop();
+                REQUIRE(batch.size() == 4);
+                for(size_t i = 0; i < batch.size(); i++)
+                    REQUIRE(batch[i].off == static_cast<off64_t>(i * 4096));
+                REQUIRE(q.size() == 1);
+                REQUIRE(q.pop().size() == 1);
+                REQUIRE(q.empty());
+            }
+        }
+
+        WHEN(" writes with a gap or on another chunk are queued ") {
+            q.push(request(IoOp::write, 0, file_a, 0, 0, 4096));
+            q.push(request(IoOp::write, 0, file_a, 1, 4096, 4096));
+            q.push(request(IoOp::write, 0, file_a, 0, 4096, 4096));
+            q.push(request(IoOp::write, 0, file_a, 0, 12288, 4096));
+
+            THEN(" writes are only merged with the writes right behind them ") {
+                REQUIRE(q.pop().size() == 1);
+                REQUIRE(q.pop().front().chnk_id == 1);
+                REQUIRE(q.pop().size() == 1);
+                REQUIRE(q.pop().size() == 1);
+                REQUIRE(q.empty());
+            }
+        }
+
+        WHEN(" adjacent reads are interleaved with other reads ") {
+            q.push(request(IoOp::read, 0, file_a, 0, 0, 4096));
+            q.push(request(IoOp::read, 0, file_a, 3, 0, 4096));
+            q.push(request(IoOp::read, 0, file_a, 0, 4096, 4096));
+
+            THEN(" the adjacent reads are merged ") {
+                auto batch = q.pop();
+                REQUIRE(batch.size() == 2);
+                REQUIRE(batch[1].off == 4096);
+                REQUIRE(q.pop().front().chnk_id == 3);
+            }
+        }
+    }
+}
+
+SCENARIO(" the I/O queue prioritizes reads over writes ", "[IoQueue]") {
+
+    GIVEN(" an I/O queue with a write deadline of 100 ms ") {
+
+        IoQueue q{1 << 20, 100ms, 16384};
+        auto now = std::chrono::steady_clock::now();
+
+        WHEN(" a write and a read are queued ") {
+            q.push(request(IoOp::write, 0, file_a, 0, 0, 4096, now));
+            q.push(request(IoOp::read, 0, file_b, 0, 0, 4096, now));
+
+            THEN(" the read goes first before the deadline ") {
+                REQUIRE(q.pop(now).front().op == IoOp::read);
+                REQUIRE(q.pop(now).front().op == IoOp::write);
+            }
+
+            THEN(" the write goes first after the deadline ") {
+                REQUIRE(q.pop(now + 200ms).front().op == IoOp::write);
+                REQUIRE(q.pop(now + 200ms).front().op == IoOp::read);
+            }
+        }
+    }
+}
+
+SCENARIO(" the I/O queue shares the disk fairly among clients ", "[IoQueue]") {
+
+    GIVEN(" an I/O queue with a quantum of 64 KiB ") {
+
+        IoQueue q{65536, 1000ms, 65536};
+
+        WHEN(" one client queues many more requests than another ") {
+            for(uint64_t chnk_id = 0; chnk_id < 8; chnk_id++)
+                q.push(request(IoOp::write, 1, file_a, chnk_id, 0, 65536));
+            for(uint64_t chnk_id = 0; chnk_id < 2; chnk_id++)
+                q.push(request(IoOp::write, 2, file_b, chnk_id, 0, 65536));
+
+            THEN(" the clients are served in turns ") {
+                std::vector<uint64_t> order{};
+                while(!q.empty())
+                    order.push_back(q.pop().front().client);
+                REQUIRE(order.size() == 10);
+                REQUIRE(order[0] == 1);
+                REQUIRE(order[1] == 2);
+                REQUIRE(order[2] == 1);
+                REQUIRE(order[3] == 2);
+                for(size_t i = 4; i < order.size(); i++)
+                    REQUIRE(order[i] == 1);
+            }
+        }
+
+        WHEN(" a client writes to several files ") {
+            for(off64_t off = 0; off < 2 * 65536; off += 65536) {
+                q.push(request(IoOp::write, 1, file_a, 0, off, 65536));
+                q.push(request(IoOp::write, 1, file_b, 0, off, 65536));
+            }
+
+            THEN(" its files are served in turns ") {
+                REQUIRE(*q.pop().front().path == file_a);
+                REQUIRE(*q.pop().front().path == file_b);
+                REQUIRE(*q.pop().front().path == file_a);
+                REQUIRE(*q.pop().front().path == file_b);
+            }
+        }
+    }
+}
@@ -0,0 +1,143 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <client/log_ring.hpp>
+#include <fmt/format.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using gkfs::log::detail::log_ring;
+
+namespace {
+
+// drains all published messages of the ring
+std::vector<std::string>
+drain_all(log_ring& ring) {
+    std::vector<std::string> messages;
+    std::vector<struct iovec> iov(16);
+    while(ring.drain(iov.data(), iov.size(), [&](struct iovec* v, size_t n) {
+        for(size_t i = 0; i < n; i++)
+            messages.emplace_back(static_cast<char*>(v[i].iov_base),
+                                  v[i].iov_len);
+    }) > 0) {
+    }
+    return messages;
+}
+
+} // namespace
+
+SCENARIO(" the log ring keeps messages in order ", "[log_ring]") {
+
+    GIVEN(" a log ring of 256 bytes ") {
+        log_ring ring{256};
+
+        WHEN(" messages are pushed and drained ") {
+            REQUIRE(ring.push("first", 5));
+            REQUIRE(ring.push("second message", 14));
+            REQUIRE(ring.push("", 0));
+
+            THEN(" they are drained in order and the ring is empty ") {
+                auto messages = drain_all(ring);
+                REQUIRE(messages ==
+                        std::vector<std::string>{"first", "second message",
+                                                 ""});
+                REQUIRE(ring.used() == 0);
+                REQUIRE(drain_all(ring).empty());
+            }
+        }
+
+        WHEN(" messages wrap around the end of the buffer ") {
+            std::vector<std::string> expected;
+            for(int i = 0; i < 100; i++) {
+                auto msg = fmt::format("message {:03}-{}", i,
+                                       std::string(i % 40, 'x'));
+                REQUIRE(ring.push(msg.data(), msg.size()));
+                expected.push_back(msg);
+                if(i % 3 == 2) {
+                    auto drained = drain_all(ring);
+                    REQUIRE(drained.size() == 3);
+                    REQUIRE(std::equal(drained.begin(), drained.end(),
+                                       expected.end() - 3));
+                }
+            }
+
+            THEN(" no message is lost or torn ") {
+                REQUIRE(drain_all(ring) ==
+                        std::vector<std::string>{expected.back()});
+                REQUIRE(ring.dropped() == 0);
+            }
+        }
+
+        WHEN(" more messages are pushed than fit into the ring ") {
+            std::string msg(56, 'a');
+            size_t pushed = 0;
+            for(int i = 0; i < 10; i++)
+                pushed += ring.push(msg.data(), msg.size());
+
+            THEN(" the remaining messages are dropped and counted ") {
+                // each message takes 64 bytes with its header
+                REQUIRE(pushed == 4);
+                REQUIRE(ring.dropped() == 6);
+                REQUIRE(drain_all(ring).size() == 4);
+                REQUIRE(ring.push(msg.data(), msg.size()));
+            }
+        }
+    }
+}
+
+SCENARIO(" the log ring accepts messages from many threads ", "[log_ring]") {
+
+    GIVEN(" a log ring of 4 KiB ") {
+        log_ring ring{4096};
+
+        WHEN(" several threads push while the ring is drained ") {
+            constexpr int producers = 4;
+            constexpr int n = 20000;
+            std::atomic<int> done{0};
+            std::vector<std::thread> threads;
+            for(int t = 0; t < producers; t++) {
+                threads.emplace_back([&ring, &done, t] {
+                    for(int i = 0; i < n; i++) {
+                        auto msg = fmt::format("{} {}", t, i);
+                        ring.push(msg.data(), msg.size());
+                    }
+                    done++;
+                });
+            }
+            std::vector<std::string> messages;
+            while(done < producers || ring.used() > 0) {
+                auto drained = drain_all(ring);
+                messages.insert(messages.end(), drained.begin(),
+                                drained.end());
+            }
+            for(auto& th : threads)
+                th.join();
+
+            THEN(" each message is either drained intact or dropped ") {
+                REQUIRE(messages.size() + ring.dropped() == producers * n);
+                std::vector<int> last(producers, -1);
+                for(const auto& msg : messages) {
+                    int t, i;
+                    REQUIRE(sscanf(msg.c_str(), "%d %d", &t, &i) == 2);
+                    REQUIRE(msg == fmt::format("{} {}", t, i));
+                    // messages of one thread keep their order
+                    REQUIRE(i > last[t]);
+                    last[t] = i;
+                }
+            }
+        }
+    }
+}
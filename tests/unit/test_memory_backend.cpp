@@ -0,0 +1,283 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <daemon/backend/metadata/memory_backend.hpp>
+#include <daemon/backend/metadata/metadata_module.hpp>
+#include <daemon/backend/exceptions.hpp>
+#include <common/metadata.hpp>
+
+#include "helpers/helpers.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using gkfs::metadata::MemoryBackend;
+using gkfs::metadata::Metadata;
+
+namespace {
+
+std::string
+dir_value() {
+    Metadata md(S_IFDIR | 0755);
+    return md.serialize();
+}
+
+std::string
+file_value(size_t size = 0) {
+    Metadata md(S_IFREG | 0644);
+    md.size(size);
+    return md.serialize();
+}
+
+/// The backend expects directories with a trailing slash
+std::vector<std::string>
+scan_paths(const MemoryBackend& db, const std::string& dir, bool recursive) {
+    std::vector<std::string> paths{};
+    db.scan(dir, recursive,
+            [&](const std::string& path, const Metadata&) {
+                paths.push_back(path);
+            });
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::vector<std::pair<std::string, bool>>
+sorted_dirents(const MemoryBackend& db, const std::string& dir) {
+    auto entries = db.get_dirents(dir);
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+} // namespace
+
+SCENARIO(" the memory backend stores, updates and removes entries ",
+         "[MemoryBackend]") {
+
+    GIVEN(" a memory backend without snapshots ") {
+        MemoryBackend db("", 0);
+
+        db.put("/", dir_value());
+        db.put("/dir", dir_value());
+        db.put("/dir/file", file_value(42));
+
+        THEN(" stored entries are found ") {
+            REQUIRE(db.exists("/dir/file"));
+            REQUIRE(Metadata(db.get("/dir/file")).size() == 42);
+            REQUIRE_FALSE(db.exists("/dir/other"));
+            REQUIRE_THROWS_AS(db.get("/dir/other"),
+                              gkfs::metadata::NotFoundException);
+        }
+
+        WHEN(" an existing entry is put again ") {
+            db.put("/dir/file", file_value(7));
+
+            THEN(" the entry is left unchanged ") {
+                REQUIRE(Metadata(db.get("/dir/file")).size() == 42);
+            }
+        }
+
+        WHEN(" an entry is put only if it does not exist ") {
+            db.put_no_exist("/dir/new", file_value(7));
+
+            THEN(" new entries are stored and existing ones refused ") {
+                REQUIRE(Metadata(db.get("/dir/new")).size() == 7);
+                REQUIRE_THROWS_AS(db.put_no_exist("/dir/file", file_value()),
+                                  gkfs::metadata::ExistsException);
+                REQUIRE(Metadata(db.get("/dir/file")).size() == 42);
+            }
+        }
+
+        WHEN(" an entry is updated in place ") {
+            db.update("/dir/file", "/dir/file", file_value(100));
+
+            THEN(" its value is replaced ") {
+                REQUIRE(Metadata(db.get("/dir/file")).size() == 100);
+            }
+        }
+
+        WHEN(" an entry is moved to another directory ") {
+            db.put("/other", dir_value());
+            db.update("/dir/file", "/other/moved", file_value(42));
+
+            THEN(" it is only found under its new key ") {
+                REQUIRE_FALSE(db.exists("/dir/file"));
+                REQUIRE(Metadata(db.get("/other/moved")).size() == 42);
+                REQUIRE(db.get_dirents("/dir/").empty());
+                REQUIRE(db.get_dirents("/other/") ==
+                        std::vector<std::pair<std::string, bool>>{
+                                {"moved", false}});
+            }
+        }
+
+        WHEN(" a missing entry is updated ") {
+            THEN(" the update fails and nothing is stored ") {
+                REQUIRE_THROWS_AS(
+                        db.update("/dir/missing", "/dir/x", file_value()),
+                        gkfs::metadata::NotFoundException);
+                REQUIRE_FALSE(db.exists("/dir/x"));
+            }
+        }
+
+        WHEN(" the size of an entry changes ") {
+            db.increase_size("/dir/file", 10, false);
+            auto kept = Metadata(db.get("/dir/file")).size();
+            db.increase_size("/dir/file", 10, true);
+            auto appended = Metadata(db.get("/dir/file")).size();
+            db.decrease_size("/dir/file", 5);
+
+            THEN(" sizes only grow on writes and shrink on truncation ") {
+                REQUIRE(kept == 42);
+                REQUIRE(appended == 52);
+                REQUIRE(Metadata(db.get("/dir/file")).size() == 5);
+            }
+        }
+
+        WHEN(" an entry is removed ") {
+            db.remove("/dir/file");
+
+            THEN(" it is gone and cannot be removed again ") {
+                REQUIRE_FALSE(db.exists("/dir/file"));
+                REQUIRE_THROWS_AS(db.remove("/dir/file"),
+                                  gkfs::metadata::NotFoundException);
+                REQUIRE(db.exists("/dir"));
+            }
+        }
+    }
+}
+
+SCENARIO(" the memory backend lists and scans directories ",
+         "[MemoryBackend][get_dirents][scan]") {
+
+    GIVEN(" a directory tree ") {
+        MemoryBackend db("", 0);
+
+        db.put("/", dir_value());
+        for(const auto* dir : {"/a", "/a/b", "/a/b/c", "/ab", "/a-"})
+            db.put(dir, dir_value());
+        for(const auto* file : {"/f", "/a/f", "/a/b/f", "/a/b/c/f", "/ab/f",
+                                "/a-/f"})
+            db.put(file, file_value(1));
+
+        THEN(" directories list only their first-level entries ") {
+            REQUIRE(sorted_dirents(db, "/") ==
+                    std::vector<std::pair<std::string, bool>>{
+                            {"a", true}, {"a-", true}, {"ab", true},
+                            {"f", false}});
+            REQUIRE(sorted_dirents(db, "/a/") ==
+                    std::vector<std::pair<std::string, bool>>{
+                            {"b", true}, {"f", false}});
+            REQUIRE(db.get_dirents("/a/b/c/f/").empty());
+        }
+
+        THEN(" extended entries carry the sizes ") {
+            auto entries = db.get_dirents_extended("/a/b/");
+            std::sort(entries.begin(), entries.end());
+            REQUIRE(entries.size() == 2);
+            REQUIRE(std::get<0>(entries[0]) == "c");
+            REQUIRE(std::get<1>(entries[0]));
+            REQUIRE(std::get<0>(entries[1]) == "f");
+            REQUIRE_FALSE(std::get<1>(entries[1]));
+            REQUIRE(std::get<2>(entries[1]) == 1);
+        }
+
+        THEN(" scans visit first-level entries or the whole subtree ") {
+            REQUIRE(scan_paths(db, "/a/", false) ==
+                    std::vector<std::string>{"/a/b", "/a/f"});
+            // the subtree ranges neither include siblings sharing the name
+            // as prefix nor the directory itself
+            REQUIRE(scan_paths(db, "/a/", true) ==
+                    std::vector<std::string>{"/a/b", "/a/b/c", "/a/b/c/f",
+                                             "/a/b/f", "/a/f"});
+            // the root's own entry is excluded from its subtree
+            auto all = scan_paths(db, "/", true);
+            REQUIRE(all.size() == 11);
+            REQUIRE(std::find(all.begin(), all.end(), "/") == all.end());
+        }
+
+        WHEN(" a nested subtree is removed ") {
+            db.remove_subtree("/a/b/");
+
+            THEN(" only the entries below it are gone ") {
+                REQUIRE(db.exists("/a/b"));
+                REQUIRE(db.get_dirents("/a/b/").empty());
+                REQUIRE_FALSE(db.exists("/a/b/c/f"));
+                REQUIRE(db.exists("/a/f"));
+                REQUIRE(db.exists("/ab/f"));
+                REQUIRE(db.exists("/a-/f"));
+                REQUIRE(scan_paths(db, "/", true).size() == 8);
+            }
+        }
+    }
+}
+
+SCENARIO(" the memory backend persists its entries in snapshots ",
+         "[MemoryBackend][snapshot]") {
+
+    GIVEN(" a memory backend with snapshots ") {
+        // snapshots are logged, the logger is set up by MetadataDB otherwise
+        GKFS_METADATA_MOD->log(spdlog::get(GKFS_METADATA_MOD->LOGGER_NAME));
+
+        helpers::temporary_directory tmp{};
+        const auto path = (tmp.dirname() / "memorydb").string();
+        const auto snapshot =
+                tmp.dirname() / "memorydb" /
+                gkfs::config::metadata::memory_snapshot_file;
+
+        {
+            MemoryBackend db(path, 3600);
+            db.put("/", dir_value());
+            db.put("/dir", dir_value());
+            db.put("/dir/file", file_value(42));
+            db.put("/dir/gone", file_value());
+            db.remove("/dir/gone");
+        }
+
+        THEN(" a snapshot is written on shutdown ") {
+            REQUIRE(fs::exists(snapshot));
+        }
+
+        WHEN(" the backend is restarted ") {
+            MemoryBackend db(path, 3600);
+
+            THEN(" it holds the entries of the snapshot ") {
+                REQUIRE(db.exists("/"));
+                REQUIRE(Metadata(db.get("/dir/file")).size() == 42);
+                REQUIRE_FALSE(db.exists("/dir/gone"));
+                REQUIRE(db.get_dirents("/dir/") ==
+                        std::vector<std::pair<std::string, bool>>{
+                                {"file", false}});
+            }
+        }
+
+        WHEN(" the backend is restarted without snapshots ") {
+            MemoryBackend db(path, 0);
+
+            THEN(" it is empty ") {
+                REQUIRE_FALSE(db.exists("/dir/file"));
+            }
+        }
+
+        WHEN(" the snapshot is truncated within an entry ") {
+            auto size = fs::file_size(snapshot);
+            fs::resize_file(snapshot, size - 1);
+
+            THEN(" the backend refuses to start ") {
+                REQUIRE_THROWS_AS(MemoryBackend(path, 3600),
+                                  gkfs::metadata::DBException);
+            }
+        }
+    }
+}
@@ -0,0 +1,391 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <daemon/backend/metadata/db.hpp>
+#include <daemon/classes/fs_data.hpp>
+#include <common/metadata.hpp>
+
+#include "helpers/helpers.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// A metadata backend and the contents of its configuration file, if any
+struct backend {
+    std::string id;
+    std::string dbconfig;
+};
+
+std::vector<backend>
+backends() {
+    std::vector<backend> ids{{gkfs::metadata::memory_backend, {}}};
+#ifdef GKFS_ENABLE_ROCKSDB
+    ids.push_back({gkfs::metadata::rocksdb_backend, "use_parent_keys = false"});
+    ids.push_back({gkfs::metadata::rocksdb_backend, "use_parent_keys = true"});
+#endif
+    return ids;
+}
+
+/**
+ * A metadata database in a temporary directory, opened with the backend's
+ * configuration
+ */
+struct test_db {
+    helpers::temporary_directory tmp{};
+    std::unique_ptr<gkfs::metadata::MetadataDB> db;
+
+    explicit test_db(const backend& b) {
+        std::string dbconfig{};
+        if(!b.dbconfig.empty()) {
+            dbconfig = (tmp.dirname() / "dbconfig").string();
+            std::ofstream(dbconfig) << b.dbconfig << '\n';
+        }
+        GKFS_DATA->dbconfig(dbconfig);
+        db = std::make_unique<gkfs::metadata::MetadataDB>(
+                (tmp.dirname() / "db").string(), b.id);
+        GKFS_DATA->dbconfig("");
+    }
+};
+
+std::string
+dir_value() {
+    gkfs::metadata::Metadata md(S_IFDIR | 0755);
+    return md.serialize();
+}
+
+std::string
+file_value() {
+    gkfs::metadata::Metadata md(S_IFREG | 0644);
+    return md.serialize();
+}
+
+std::vector<std::string>
+scan_paths(const gkfs::metadata::MetadataDB& db, const std::string& dir) {
+    std::vector<std::string> paths{};
+    db.scan(dir, true,
+            [&](const std::string& path, const gkfs::metadata::Metadata&) {
+                paths.push_back(path);
+            });
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace
+
+SCENARIO(" subtree removal only removes entries below the directory ",
+         "[MetadataDB][remove_subtree]") {
+
+    for(const auto& b : backends()) {
+
+        GIVEN(" a directory and siblings sharing its name as prefix with " +
+              b.id + " " + b.dbconfig) {
+
+            test_db t(b);
+            auto& db = *t.db;
+
+            db.put("/", dir_value());
+            for(const auto& dir : {"/dir", "/dir/sub", "/dir:x"})
+                db.put(dir, dir_value());
+            const std::vector<std::string> inside = {"/dir/a", "/dir/sub",
+                                                     "/dir/sub/b"};
+            const std::vector<std::string> outside = {
+                    "/di", "/dir", "/dir.x", "/dir0", "/dir:x", "/dir:x/c",
+                    "/dirx"};
+            for(const auto* files : {&inside, &outside})
+                for(const auto& file : *files)
+                    if(!db.exists(file))
+                        db.put(file, file_value());
+
+            THEN(" a recursive scan returns the subtree ") {
+                REQUIRE(scan_paths(db, "/dir") == inside);
+            }
+
+            WHEN(" the directory's subtree is removed ") {
+                db.remove_subtree("/dir");
+
+                THEN(" its entries are gone but all others are kept ") {
+                    for(const auto& file : inside)
+                        REQUIRE_FALSE(db.exists(file));
+                    for(const auto& file : outside)
+                        REQUIRE(db.exists(file));
+                    REQUIRE(scan_paths(db, "/dir").empty());
+                    REQUIRE(db.get_dirents("/dir").empty());
+                    REQUIRE(db.get_dirents("/dir:x").size() == 1);
+                }
+            }
+
+            WHEN(" the root's subtree is removed ") {
+                db.remove_subtree("/");
+
+                THEN(" all entries but the root are gone ") {
+                    REQUIRE(db.exists("/"));
+                    for(const auto* files : {&inside, &outside})
+                        for(const auto& file : *files)
+                            REQUIRE_FALSE(db.exists(file));
+                    REQUIRE(scan_paths(db, "/").empty());
+                }
+            }
+        }
+    }
+}
+
+SCENARIO(" chunk size updates keep sizes and existing chunks intact ",
+         "[MetadataDB][update_chunk_size]") {
+
+    for(const auto& b : backends()) {
+
+        GIVEN(" an empty file and a directory with " + b.id + " " +
+              b.dbconfig) {
+
+            test_db t(b);
+            auto& db = *t.db;
+            const size_t chunk_size = 2 * gkfs::config::rpc::chunksize;
+
+            db.put("/", dir_value());
+            db.put("/dir", dir_value());
+            db.put("/file", file_value());
+
+            WHEN(" the chunk size of the empty file is set ") {
+                db.update_chunk_size("/file", chunk_size);
+
+                THEN(" it is changed ") {
+                    gkfs::metadata::Metadata md(db.get("/file"));
+                    REQUIRE(md.chunk_size() == chunk_size);
+                    REQUIRE(md.size() == 0);
+                }
+            }
+
+            WHEN(" the file's size increases before the chunk size is set ") {
+                db.increase_size("/file", 42, false);
+                db.update_chunk_size("/file", chunk_size);
+
+                THEN(" the size is kept and the chunk size is unchanged ") {
+                    gkfs::metadata::Metadata md(db.get("/file"));
+                    REQUIRE(md.size() == 42);
+                    REQUIRE(md.chunk_size() == gkfs::config::rpc::chunksize);
+                }
+            }
+
+            WHEN(" the file's size increases after the chunk size is set ") {
+                db.update_chunk_size("/file", chunk_size);
+                db.increase_size("/file", 42, false);
+
+                THEN(" both updates are kept ") {
+                    gkfs::metadata::Metadata md(db.get("/file"));
+                    REQUIRE(md.size() == 42);
+                    REQUIRE(md.chunk_size() == chunk_size);
+                }
+            }
+
+            WHEN(" the chunk size of the directory is set ") {
+                db.update_chunk_size("/dir", chunk_size);
+
+                THEN(" it is changed ") {
+                    gkfs::metadata::Metadata md(db.get("/dir"));
+                    REQUIRE(md.chunk_size() == chunk_size);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO(" directories list their entries after renames ",
+         "[MetadataDB][get_dirents][rename]") {
+
+    using dirents = std::vector<std::pair<std::string, bool>>;
+    auto sorted_dirents = [](const gkfs::metadata::MetadataDB& db,
+                             const std::string& dir) {
+        auto entries = db.get_dirents(dir);
+        std::sort(entries.begin(), entries.end());
+        return entries;
+    };
+
+    for(const auto& b : backends()) {
+
+        GIVEN(" directories whose names are prefixes of each other with " +
+              b.id + " " + b.dbconfig) {
+
+            test_db t(b);
+            auto& db = *t.db;
+
+            db.put("/", dir_value());
+            for(const auto& dir : {"/d", "/d/x", "/d.x", "/d0", "/dx"})
+                db.put(dir, dir_value());
+            for(const auto& file : {"/f", "/d/a", "/d/x/b", "/d.x/c", "/d0/e"})
+                db.put(file, file_value());
+
+            THEN(" each directory lists only its own first-level entries ") {
+                REQUIRE(sorted_dirents(db, "/") ==
+                        dirents{{"d", true},
+                                {"d.x", true},
+                                {"d0", true},
+                                {"dx", true},
+                                {"f", false}});
+                REQUIRE(sorted_dirents(db, "/d") ==
+                        dirents{{"a", false}, {"x", true}});
+                REQUIRE(sorted_dirents(db, "/d/x") == dirents{{"b", false}});
+                REQUIRE(sorted_dirents(db, "/d.x") == dirents{{"c", false}});
+                REQUIRE(db.get_dirents("/dx").empty());
+            }
+
+            WHEN(" a file is moved to another directory ") {
+                gkfs::metadata::Metadata md(db.get("/d/a"));
+                md.size(42);
+                db.update("/d/a", "/dx/a", md.serialize());
+
+                THEN(" it is listed in the new directory only ") {
+                    REQUIRE(sorted_dirents(db, "/d") == dirents{{"x", true}});
+                    REQUIRE(sorted_dirents(db, "/dx") ==
+                            dirents{{"a", false}});
+                    auto entries = db.get_dirents_extended("/dx");
+                    REQUIRE(entries.size() == 1);
+                    REQUIRE(std::get<2>(entries[0]) == 42);
+                }
+            }
+
+            WHEN(" a file is renamed within its directory ") {
+                gkfs::metadata::Metadata md(db.get("/d/x/b"));
+                db.update("/d/x/b", "/d/x/renamed", md.serialize());
+
+                THEN(" the directory lists the new name ") {
+                    REQUIRE(sorted_dirents(db, "/d/x") ==
+                            dirents{{"renamed", false}});
+                    REQUIRE(scan_paths(db, "/d") ==
+                            std::vector<std::string>{"/d/a", "/d/x",
+                                                     "/d/x/renamed"});
+                }
+            }
+
+#ifdef HAS_RENAME
+            WHEN(" a renamed file is kept for its open file descriptors ") {
+                // the old entry is marked with negative blocks
+                gkfs::metadata::Metadata md(db.get("/d/a"));
+                db.put("/dx/a", md.serialize());
+                md.blocks(-1);
+                db.update("/d/a", "/d/a", md.serialize());
+
+                THEN(" only the new entry is listed ") {
+                    REQUIRE(db.exists("/d/a"));
+                    REQUIRE(sorted_dirents(db, "/d") == dirents{{"x", true}});
+                    REQUIRE(sorted_dirents(db, "/dx") ==
+                            dirents{{"a", false}});
+                }
+            }
+#endif // HAS_RENAME
+        }
+    }
+}
+
+#ifdef GKFS_ENABLE_ROCKSDB
+SCENARIO(" the RocksDB backend serves all operations with each profile ",
+         "[MetadataDB][rocksdb][profile]") {
+
+    for(const auto* profile : {gkfs::config::rocksdb::profile_default,
+                               gkfs::config::rocksdb::profile_create,
+                               gkfs::config::rocksdb::profile_stat,
+                               gkfs::config::rocksdb::profile_readdir}) {
+        for(const auto* parent_keys : {"false", "true"}) {
+
+            backend b{gkfs::metadata::rocksdb_backend,
+                      fmt::format("profile = {}\nuse_parent_keys = {}",
+                                  profile, parent_keys)};
+
+            GIVEN(" a directory tree with " + b.dbconfig) {
+
+                test_db t(b);
+                auto& db = *t.db;
+
+                db.put("/", dir_value());
+                db.put("/dir", dir_value());
+                db.put("/dir/sub", dir_value());
+                for(const auto& file : {"/dir/a", "/dir/b", "/dir/sub/c"})
+                    db.put(file, file_value());
+
+                THEN(" lookups, readdir, and scans find the entries ") {
+                    REQUIRE(db.exists("/dir/sub/c"));
+                    REQUIRE_FALSE(db.exists("/dir/missing"));
+                    auto dirents = db.get_dirents("/dir");
+                    std::sort(dirents.begin(), dirents.end());
+                    REQUIRE(dirents ==
+                            std::vector<std::pair<std::string, bool>>{
+                                    {"a", false}, {"b", false}, {"sub", true}});
+                    REQUIRE(scan_paths(db, "/dir") ==
+                            std::vector<std::string>{"/dir/a", "/dir/b",
+                                                     "/dir/sub",
+                                                     "/dir/sub/c"});
+                }
+
+                WHEN(" entries are updated and removed ") {
+                    db.increase_size("/dir/a", 42, false);
+                    gkfs::metadata::Metadata md(db.get("/dir/b"));
+                    db.update("/dir/b", "/dir/d", md.serialize());
+                    db.remove("/dir/sub/c");
+
+                    THEN(" the changes are visible ") {
+                        REQUIRE(gkfs::metadata::Metadata(db.get("/dir/a"))
+                                        .size() == 42);
+                        REQUIRE_FALSE(db.exists("/dir/b"));
+                        REQUIRE(db.exists("/dir/d"));
+                        REQUIRE(db.get_dirents("/dir/sub").empty());
+                    }
+                }
+            }
+        }
+    }
+
+    GIVEN(" a database created with parent keys ") {
+        helpers::temporary_directory tmp{};
+        const auto dbconfig = (tmp.dirname() / "dbconfig").string();
+        auto open = [&](bool parent_keys) {
+            std::ofstream(dbconfig)
+                    << "use_parent_keys = " << std::boolalpha << parent_keys
+                    << '\n';
+            GKFS_DATA->dbconfig(dbconfig);
+            try {
+                auto db = std::make_unique<gkfs::metadata::MetadataDB>(
+                        (tmp.dirname() / "db").string(),
+                        gkfs::metadata::rocksdb_backend);
+                GKFS_DATA->dbconfig("");
+                return db;
+            } catch(...) {
+                GKFS_DATA->dbconfig("");
+                throw;
+            }
+        };
+        {
+            auto db = open(true);
+            db->put("/", dir_value());
+            db->put("/file", file_value());
+        }
+
+        THEN(" it is only opened with parent keys again ") {
+            REQUIRE_THROWS(open(false));
+            REQUIRE(open(true)->exists("/file"));
+        }
+    }
+
+    GIVEN(" an unknown profile ") {
+        backend b{gkfs::metadata::rocksdb_backend, "profile = unknown"};
+
+        THEN(" the database is not opened ") {
+            REQUIRE_THROWS(test_db(b));
+        }
+    }
+}
+#endif
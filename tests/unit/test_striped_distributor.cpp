@@ -0,0 +1,74 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <common/rpc/distributor.hpp>
+#include <set>
+
+SCENARIO(" the striped distributor places chunks round-robin ",
+         "[Distributor]") {
+
+    GIVEN(" a striped distributor with 10 daemons and a stripe count of 4 ") {
+
+        auto d = gkfs::rpc::StripedDistributor(0, 10, 4);
+        const std::string path = "/dir/file";
+
+        THEN(" a file's chunks are placed on 4 consecutive daemons ") {
+            std::set<gkfs::rpc::host_t> owners{};
+            for(gkfs::rpc::chunkid_t id = 0; id < 100; id++) {
+                owners.insert(d.locate_data(path, id));
+            }
+            REQUIRE(owners.size() == 4);
+            auto start = d.locate_file_metadata(path);
+            for(gkfs::rpc::chunkid_t id = 0; id < 100; id++) {
+                REQUIRE(d.locate_data(path, id) == (start + id % 4) % 10);
+            }
+        }
+
+        THEN(" a range lookup matches the per-chunk lookup ") {
+            for(gkfs::rpc::chunkid_t start : {0u, 3u, 7u, 1001u}) {
+                auto owners = d.locate_data_range(path, start, start + 37);
+                REQUIRE(owners.size() == 38);
+                for(gkfs::rpc::chunkid_t i = 0; i < owners.size(); i++) {
+                    REQUIRE(owners[i] == d.locate_data(path, start + i));
+                }
+            }
+        }
+    }
+
+    GIVEN(" a striped distributor with fewer daemons than the stripe count ") {
+
+        auto d = gkfs::rpc::StripedDistributor(0, 3, 8);
+
+        THEN(" the stripe count is capped at the number of daemons ") {
+            REQUIRE(d.stripe_count() == 3);
+            std::set<gkfs::rpc::host_t> owners{};
+            for(gkfs::rpc::chunkid_t id = 0; id < 100; id++) {
+                auto owner = d.locate_data("/file", id);
+                REQUIRE(owner < 3);
+                owners.insert(owner);
+            }
+            REQUIRE(owners.size() == 3);
+        }
+
+        WHEN(" the daemon learns a different number of daemons ") {
+            auto owner = d.locate_data("/file", 5, 16);
+
+            THEN(" the stripe count is recomputed ") {
+                REQUIRE(d.stripe_count() == 8);
+                REQUIRE(owner == d.locate_data("/file", 5));
+                REQUIRE(owner < 16);
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <common/tracing.hpp>
+#include <config.hpp>
+#include <fmt/format.h>
+#include "helpers/helpers.hpp"
+
+#include <thread>
+
+namespace tracing = gkfs::tracing;
+
+namespace {
+
+std::string
+dump_to_string(const helpers::temporary_directory& tmpdir) {
+    auto path = tmpdir.dirname() / "trace.json";
+    REQUIRE(tracing::dump(path) == 0);
+    std::string json;
+    helpers::load_string_file(path, json);
+    return json;
+}
+
+size_t
+count(const std::string& haystack, const std::string& needle) {
+    size_t n = 0;
+    for(auto pos = haystack.find(needle); pos != std::string::npos;
+        pos = haystack.find(needle, pos + needle.size()))
+        n++;
+    return n;
+}
+
+} // namespace
+
+// tracing cannot be disabled once enabled, so this case must come first
+SCENARIO(" spans are not recorded while tracing is disabled ", "[tracing]") {
+
+    GIVEN(" tracing is disabled ") {
+        REQUIRE(!tracing::enabled());
+
+        WHEN(" a traced request is issued ") {
+            tracing::TraceContext ctx;
+            { tracing::Span span("test.disabled"); }
+
+            THEN(" no trace id is assigned ") {
+                REQUIRE(tracing::current_trace_id() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO(" trace contexts assign one trace id per request ", "[tracing]") {
+
+    GIVEN(" tracing is enabled ") {
+        tracing::enable("test_tracing");
+
+        WHEN(" trace contexts are nested ") {
+            uint64_t outer_id, inner_id;
+            {
+                tracing::TraceContext outer;
+                outer_id = tracing::current_trace_id();
+                {
+                    tracing::TraceContext inner;
+                    inner_id = tracing::current_trace_id();
+                }
+                REQUIRE(tracing::current_trace_id() == outer_id);
+            }
+
+            THEN(" the nested context shares the id of the outer one ") {
+                REQUIRE(outer_id != 0);
+                REQUIRE(inner_id == outer_id);
+                REQUIRE(tracing::current_trace_id() == 0);
+            }
+        }
+
+        WHEN(" two requests are issued one after another ") {
+            uint64_t first, second;
+            {
+                tracing::TraceContext ctx;
+                first = tracing::current_trace_id();
+            }
+            {
+                tracing::TraceContext ctx;
+                second = tracing::current_trace_id();
+            }
+
+            THEN(" they get different ids ") {
+                REQUIRE(first != second);
+            }
+        }
+    }
+}
+
+SCENARIO(" recorded spans are dumped as Chrome trace JSON ", "[tracing]") {
+
+    GIVEN(" tracing is enabled ") {
+        tracing::enable("test_tracing");
+        helpers::temporary_directory tmpdir;
+
+        WHEN(" spans are recorded by several threads ") {
+            std::vector<uint64_t> ids(4);
+            std::vector<std::thread> threads;
+            for(size_t i = 0; i < ids.size(); i++) {
+                threads.emplace_back([&ids, i] {
+                    tracing::TraceContext ctx;
+                    ids[i] = tracing::current_trace_id();
+                    tracing::Span outer("test.request");
+                    tracing::Span inner("test.stage",
+                                        tracing::current_trace_id());
+                });
+            }
+            for(auto& t : threads)
+                t.join();
+            // spans of untraced requests are dropped
+            { tracing::Span untraced("test.untraced"); }
+
+            THEN(" all spans appear in the dump with their trace id ") {
+                auto json = dump_to_string(tmpdir);
+                REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+                REQUIRE(json.find("test_tracing") != std::string::npos);
+                REQUIRE(json.find("test.untraced") == std::string::npos);
+                for(auto id : ids) {
+                    auto tag = fmt::format("\"trace_id\": \"{:#018x}\"", id);
+                    REQUIRE(count(json, tag) == 2);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO(" a thread keeps only its most recent spans ", "[tracing]") {
+
+    GIVEN(" tracing is enabled ") {
+        tracing::enable("test_tracing");
+        helpers::temporary_directory tmpdir;
+
+        WHEN(" a thread records more spans than its ring holds ") {
+            constexpr size_t ring_size = gkfs::config::tracing::ring_size;
+            std::thread([] {
+                tracing::TraceContext ctx;
+                auto id = tracing::current_trace_id();
+                for(size_t i = 0; i < ring_size + 100; i++)
+                    tracing::record(id, "test.ring", i + 1, i + 2);
+            }).join();
+
+            THEN(" the oldest spans are overwritten ") {
+                auto json = dump_to_string(tmpdir);
+                REQUIRE(count(json, "\"test.ring\"") == ring_size);
+            }
+        }
+    }
+}
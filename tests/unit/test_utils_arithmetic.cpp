@@ -976,3 +976,57 @@ SCENARIO(" the number of chunks involved in an operation can be computed "
         }
     }
 }
+
+SCENARIO(" block arithmetic supports block sizes that are not a power of 2 ",
+         "[utils][numeric][block_size]") {
+
+    GIVEN(" a block size that is not a power of 2 ") {
+
+        const std::size_t block_size =
+                GENERATE(std::size_t{3}, std::size_t{7}, std::size_t{1000},
+                         std::size_t{4095}, std::size_t{4097},
+                         std::size_t{3} * 1024 * 1024,
+                         std::size_t{1000} * 1000);
+
+        const uint64_t offset = GENERATE_COPY(
+                uint64_t{0},
+                take(test_reps, random(uint64_t{1}, uint64_t{1} << 40)));
+
+        CAPTURE(offset, block_size);
+
+        WHEN(" block boundaries are computed ") {
+
+            const uint64_t index = offset / block_size;
+            const uint64_t overrun = offset % block_size;
+
+            THEN(" the results match the division-based definitions ") {
+                REQUIRE(is_aligned(offset, block_size) == (overrun == 0));
+                REQUIRE(align_left(offset, block_size) == index * block_size);
+                REQUIRE(align_right(offset, block_size) ==
+                        (index + 1) * block_size);
+                REQUIRE(block_overrun(offset, block_size) == overrun);
+                REQUIRE(block_underrun(offset, block_size) ==
+                        block_size - overrun);
+                REQUIRE(block_index(offset, block_size) == index);
+            }
+        }
+
+        WHEN(" the blocks of a range are counted ") {
+
+            const std::size_t size = GENERATE_COPY(
+                    std::size_t{0}, std::size_t{1}, block_size - 1, block_size,
+                    7 * block_size + 1);
+
+            CAPTURE(size);
+
+            THEN(" the computed block count corresponds to the number "
+                 "of blocks involved in the operation ") {
+                const std::size_t expected_n =
+                        size == 0 ? 0
+                                  : (offset + size - 1) / block_size -
+                                            offset / block_size + 1;
+                REQUIRE(block_count(offset, size, block_size) == expected_n);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  Copyright 2018-2022, Barcelona Supercomputing Center (BSC), Spain
+  Copyright 2015-2022, Johannes Gutenberg Universitaet Mainz, Germany
+
+  This software was partially supported by the
+  EC H2020 funded project NEXTGenIO (Project ID: 671951, www.nextgenio.eu).
+
+  This software was partially supported by the
+  ADA-FS project under the SPPEXA project funded by the DFG.
+
+  SPDX-License-Identifier: MIT
+*/
+
+#include <catch2/catch.hpp>
+#include <common/rpc/distributor.hpp>
+
+SCENARIO(" the weighted distributor spreads chunks by weight ",
+         "[Distributor]") {
+
+    GIVEN(" a weighted distributor with one daemon four times larger ") {
+
+        auto d = gkfs::rpc::WeightedDistributor(0, 5, {4.0, 1.0, 1.0, 1.0, 1.0});
+        const std::string path = "/dir/file";
+        constexpr unsigned int chunks = 80000;
+
+        THEN(" each daemon receives a share proportional to its weight ") {
+            std::vector<unsigned int> counts(5, 0);
+            for(gkfs::rpc::chunkid_t id = 0; id < chunks; id++) {
+                counts[d.locate_data(path, id)]++;
+            }
+            REQUIRE(counts[0] == Approx(chunks / 2).epsilon(0.05));
+            for(unsigned int host = 1; host < 5; host++) {
+                REQUIRE(counts[host] == Approx(chunks / 8).epsilon(0.05));
+            }
+        }
+
+        THEN(" a range lookup matches the per-chunk lookup ") {
+            for(gkfs::rpc::chunkid_t start : {0u, 3u, 7u, 1001u}) {
+                auto owners = d.locate_data_range(path, start, start + 37);
+                REQUIRE(owners.size() == 38);
+                for(gkfs::rpc::chunkid_t i = 0; i < owners.size(); i++) {
+                    REQUIRE(owners[i] == d.locate_data(path, start + i));
+                }
+            }
+        }
+
+        WHEN(" a daemon is added ") {
+            auto grown = gkfs::rpc::WeightedDistributor(
+                    0, 6, {4.0, 1.0, 1.0, 1.0, 1.0, 1.0});
+
+            THEN(" only chunks moving to the new daemon change owner ") {
+                unsigned int moved = 0;
+                for(gkfs::rpc::chunkid_t id = 0; id < chunks; id++) {
+                    auto before = d.locate_data(path, id);
+                    auto after = grown.locate_data(path, id);
+                    if(before != after) {
+                        REQUIRE(after == 5);
+                        moved++;
+                    }
+                }
+                REQUIRE(moved == Approx(chunks / 9).epsilon(0.05));
+            }
+        }
+    }
+
+    GIVEN(" a daemon-side weighted distributor with invalid weights ") {
+
+        auto d = gkfs::rpc::WeightedDistributor(
+                [](unsigned int) { return std::vector<double>{1.0, 2.0}; });
+
+        WHEN(" the daemon learns the number of daemons ") {
+            auto owner = d.locate_data("/file", 5, 4);
+
+            THEN(" uniform weights are used ") {
+                REQUIRE(owner < 4);
+                REQUIRE(d.weights() == std::vector<double>(4, 1.0));
+                REQUIRE(d.locate_directory_metadata("/").size() == 4);
+            }
+        }
+    }
+}